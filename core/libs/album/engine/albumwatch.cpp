@@ -34,13 +34,19 @@
 // Local includes
 
 #include "digikam_debug.h"
+#include "digikam_config.h"
 #include "album.h"
 #include "albummanager.h"
 #include "collectionlocation.h"
 #include "collectionmanager.h"
 #include "dbengineparameters.h"
+#include "iteminfo.h"
 #include "scancontroller.h"
 
+#ifdef HAVE_INOTIFY
+#   include "albumwatchinotify.h"
+#endif
+
 namespace Digikam
 {
 
@@ -49,7 +55,8 @@ class Q_DECL_HIDDEN AlbumWatch::Private
 public:
 
     explicit Private()
-      : dirWatch(0)
+      : dirWatch(0),
+        inotifyWatch(0)
     {
     }
 
@@ -60,6 +67,7 @@ public:
 public:
 
     QFileSystemWatcher* dirWatch;
+    AlbumWatchInotify*  inotifyWatch;
 
     DbEngineParameters  params;
     QStringList         fileNameBlackList;
@@ -147,15 +155,38 @@ AlbumWatch::AlbumWatch(AlbumManager* const parent)
     : QObject(parent),
       d(new Private)
 {
-    d->dirWatch = new QFileSystemWatcher(this);
+#ifdef HAVE_INOTIFY
+    d->inotifyWatch = new AlbumWatchInotify(this);
+
+    if (d->inotifyWatch->isValid())
+    {
+        qCDebug(DIGIKAM_GENERAL_LOG) << "AlbumWatch use inotify";
+
+        connect(d->inotifyWatch, SIGNAL(signalEntryMoved(QString,QString,bool)),
+                this, SLOT(slotInotifyEntryMoved(QString,QString,bool)));
+
+        connect(d->inotifyWatch, SIGNAL(signalDirectoriesChanged(QStringList)),
+                this, SLOT(slotInotifyDirectoriesChanged(QStringList)));
+    }
+    else
+    {
+        delete d->inotifyWatch;
+        d->inotifyWatch = 0;
+    }
+#endif
+
+    if (!d->inotifyWatch)
+    {
+        d->dirWatch = new QFileSystemWatcher(this);
 
-    qCDebug(DIGIKAM_GENERAL_LOG) << "AlbumWatch use QFileSystemWatcher";
+        qCDebug(DIGIKAM_GENERAL_LOG) << "AlbumWatch use QFileSystemWatcher";
 
-    connect(d->dirWatch, SIGNAL(directoryChanged(QString)),
-            this, SLOT(slotQFSWatcherDirty(QString)));
+        connect(d->dirWatch, SIGNAL(directoryChanged(QString)),
+                this, SLOT(slotQFSWatcherDirty(QString)));
 
-    connect(d->dirWatch, SIGNAL(fileChanged(QString)),
-            this, SLOT(slotQFSWatcherDirty(QString)));
+        connect(d->dirWatch, SIGNAL(fileChanged(QString)),
+                this, SLOT(slotQFSWatcherDirty(QString)));
+    }
 
     connect(parent, SIGNAL(signalAlbumAdded(Album*)),
             this, SLOT(slotAlbumAdded(Album*)));
@@ -177,6 +208,11 @@ AlbumWatch::~AlbumWatch()
 
 void AlbumWatch::clear()
 {
+    if (d->inotifyWatch)
+    {
+        d->inotifyWatch->clear();
+    }
+
     if (d->dirWatch && !d->dirWatch->directories().isEmpty())
     {
         d->dirWatch->removePaths(d->dirWatch->directories());
@@ -190,6 +226,12 @@ void AlbumWatch::removeWatchedPAlbums(const PAlbum* const album)
         return;
     }
 
+    if (d->inotifyWatch)
+    {
+        d->inotifyWatch->removeDirectory(album->folderPath());
+        return;
+    }
+
     foreach(const QString& dir, d->dirWatch->directories())
     {
         if (dir.startsWith(album->folderPath()))
@@ -209,14 +251,25 @@ void AlbumWatch::setDbEngineParameters(const DbEngineParameters& params)
     if (params.isSQLite())
     {
         d->fileNameBlackList << QLatin1String("thumbnails-digikam.db") << QLatin1String("thumbnails-digikam.db-journal");
+        d->fileNameBlackList << QLatin1String("thumbnails-digikam.db-wal") << QLatin1String("thumbnails-digikam.db-shm");
         d->fileNameBlackList << QLatin1String("recognition.db") << QLatin1String("recognition.db-journal");
+        d->fileNameBlackList << QLatin1String("recognition.db-wal") << QLatin1String("recognition.db-shm");
+        d->fileNameBlackList << QLatin1String("similarity.db") << QLatin1String("similarity.db-journal");
+        d->fileNameBlackList << QLatin1String("similarity.db-wal") << QLatin1String("similarity.db-shm");
+        d->fileNameBlackList << QLatin1String("similarity-haar.cache");
 
         QFileInfo dbFile(params.SQLiteDatabaseFile());
         d->fileNameBlackList << dbFile.fileName() << dbFile.fileName() + QLatin1String("-journal");
+        d->fileNameBlackList << dbFile.fileName() + QLatin1String("-wal") << dbFile.fileName() + QLatin1String("-shm");
 
         // ensure this is done after setting up the black list
         d->dbPathModificationDateList = d->buildDirectoryModList(dbFile);
     }
+
+    if (d->inotifyWatch)
+    {
+        d->inotifyWatch->setFileNameBlackList(d->fileNameBlackList);
+    }
 }
 
 void AlbumWatch::slotAlbumAdded(Album* a)
@@ -241,7 +294,14 @@ void AlbumWatch::slotAlbumAdded(Album* a)
         return;
     }
 
-    d->dirWatch->addPath(dir);
+    if (d->inotifyWatch)
+    {
+        d->inotifyWatch->addDirectory(dir);
+    }
+    else
+    {
+        d->dirWatch->addPath(dir);
+    }
 }
 
 void AlbumWatch::slotAlbumAboutToBeDeleted(Album* a)
@@ -259,7 +319,14 @@ void AlbumWatch::slotAlbumAboutToBeDeleted(Album* a)
         return;
     }
 
-    d->dirWatch->removePath(dir);
+    if (d->inotifyWatch)
+    {
+        d->inotifyWatch->removeDirectory(dir);
+    }
+    else
+    {
+        d->dirWatch->removePath(dir);
+    }
 }
 
 void AlbumWatch::rescanDirectory(const QString& dir)
@@ -293,4 +360,52 @@ void AlbumWatch::slotQFSWatcherDirty(const QString& path)
     }
 }
 
+void AlbumWatch::slotInotifyEntryMoved(const QString& srcPath, const QString& dstPath, bool isDirectory)
+{
+    // Tell the scanner about moves inside the collection, so that albums and items keep their properties
+    QFileInfo dstInfo(dstPath);
+
+    if (isDirectory)
+    {
+        PAlbum* const album = AlbumManager::instance()->findPAlbum(QUrl::fromLocalFile(srcPath));
+
+        if (album)
+        {
+            ScanController::instance()->hintAtMoveOrCopyOfAlbum(album, dstInfo.path(), dstInfo.fileName());
+        }
+    }
+    else
+    {
+        PAlbum* const dstAlbum = AlbumManager::instance()->findPAlbum(QUrl::fromLocalFile(dstInfo.path()));
+
+        if (!dstAlbum)
+        {
+            return;
+        }
+
+        ItemInfo info = ItemInfo::fromLocalFile(srcPath);
+
+        if (!info.isNull())
+        {
+            ScanController::instance()->hintAtMoveOrCopyOfItem(info.id(), dstAlbum, dstInfo.fileName());
+        }
+    }
+}
+
+void AlbumWatch::slotInotifyDirectoriesChanged(const QStringList& paths)
+{
+    // Database files are already filtered out by their names,
+    // other files of the database directory by their dates
+
+    foreach(const QString& path, paths)
+    {
+        if (d->inDirWatchParametersBlackList(QFileInfo(path), path))
+        {
+            continue;
+        }
+
+        rescanDirectory(path);
+    }
+}
+
 } // namespace Digikam
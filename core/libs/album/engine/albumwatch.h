@@ -29,6 +29,7 @@
 
 #include <QObject>
 #include <QString>
+#include <QStringList>
 #include <QUrl>
 
 namespace Digikam
@@ -38,6 +39,7 @@ class Album;
 class PAlbum;
 class AlbumManager;
 class DbEngineParameters;
+class AlbumWatchInotify;
 
 class AlbumWatch : public QObject
 {
@@ -57,6 +59,8 @@ protected Q_SLOTS:
     void slotAlbumAdded(Album* album);
     void slotAlbumAboutToBeDeleted(Album* album);
     void slotQFSWatcherDirty(const QString& path);
+    void slotInotifyEntryMoved(const QString& srcPath, const QString& dstPath, bool isDirectory);
+    void slotInotifyDirectoriesChanged(const QStringList& paths);
 
 private:
 
@@ -0,0 +1,383 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-11-10
+ * Description : Linux inotify backend of the directory watch
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "albumwatchinotify.h"
+
+// C ANSI includes
+
+#include <sys/inotify.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+// Qt includes
+
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QSet>
+#include <QSocketNotifier>
+#include <QTimer>
+
+// Local includes
+
+#include "digikam_debug.h"
+
+namespace Digikam
+{
+
+/// Only changes of the directory entries are of interest. Files written in place are
+/// not reported, as every write of the database files or of a scanned file would be.
+static const uint32_t s_watchMask = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR;
+
+/// Changes are collected until no event was read during this interval
+static const int s_coalescingInterval = 1000;
+
+class Q_DECL_HIDDEN AlbumWatchInotify::Private
+{
+public:
+
+    explicit Private()
+      : fd(-1),
+        notifier(0),
+        flushTimer(0),
+        limitReached(false)
+    {
+    }
+
+    void addWatch(const QString& path);
+    void removeWatch(int wd);
+    void forgetWatch(int wd);
+    void removeWatches(const QString& path);
+    void reportTopLevelDirectories();
+    bool inBlackList(const QString& name) const;
+
+public:
+
+    int                     fd;
+    QSocketNotifier*        notifier;
+    QTimer*                 flushTimer;
+    bool                    limitReached;
+
+    QHash<int, QString>     paths;
+    QHash<QString, int>     descriptors;
+
+    QStringList             fileNameBlackList;
+    QSet<QString>           changedDirectories;
+
+    /// Source paths of moves, by inotify cookie, until the destination event is read
+    QHash<quint32, QString> movedFrom;
+};
+
+void AlbumWatchInotify::Private::addWatch(const QString& path)
+{
+    if (descriptors.contains(path))
+    {
+        return;
+    }
+
+    int wd = inotify_add_watch(fd, QFile::encodeName(path).constData(), s_watchMask);
+
+    if (wd == -1)
+    {
+        if (errno == ENOSPC)
+        {
+            if (!limitReached)
+            {
+                qCWarning(DIGIKAM_GENERAL_LOG) << "Reached the maximum number of inotify watches."
+                                               << "Changes in" << path << "and further directories"
+                                               << "are not detected. Raise fs.inotify.max_user_watches.";
+                limitReached = true;
+            }
+        }
+        else
+        {
+            qCDebug(DIGIKAM_GENERAL_LOG) << "Cannot watch" << path << ":" << strerror(errno);
+        }
+
+        return;
+    }
+
+    // A moved directory keeps its descriptor
+    descriptors.remove(paths.value(wd));
+    paths.insert(wd, path);
+    descriptors.insert(path, wd);
+}
+
+void AlbumWatchInotify::Private::removeWatch(int wd)
+{
+    inotify_rm_watch(fd, wd);
+    forgetWatch(wd);
+}
+
+void AlbumWatchInotify::Private::forgetWatch(int wd)
+{
+    descriptors.remove(paths.take(wd));
+}
+
+void AlbumWatchInotify::Private::removeWatches(const QString& path)
+{
+    const QString prefix = path + QLatin1Char('/');
+    QList<int> wds;
+
+    for (QHash<QString, int>::const_iterator it = descriptors.constBegin() ; it != descriptors.constEnd() ; ++it)
+    {
+        if (it.key() == path || it.key().startsWith(prefix))
+        {
+            wds << it.value();
+        }
+    }
+
+    foreach (int wd, wds)
+    {
+        removeWatch(wd);
+    }
+}
+
+void AlbumWatchInotify::Private::reportTopLevelDirectories()
+{
+    // Events were lost. A scan of the top level directories covers all others.
+
+    foreach (const QString& path, descriptors.keys())
+    {
+        if (!descriptors.contains(QFileInfo(path).path()))
+        {
+            changedDirectories << path;
+        }
+    }
+}
+
+bool AlbumWatchInotify::Private::inBlackList(const QString& name) const
+{
+    // Temporary files, as the journals of the databases, start with the name of their file
+
+    foreach (const QString& bannedName, fileNameBlackList)
+    {
+        if (name.startsWith(bannedName))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// -------------------------------------------------------------------------------------
+
+AlbumWatchInotify::AlbumWatchInotify(QObject* const parent)
+    : QObject(parent),
+      d(new Private)
+{
+    d->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+    if (d->fd == -1)
+    {
+        qCWarning(DIGIKAM_GENERAL_LOG) << "Cannot initialize inotify:" << strerror(errno);
+        return;
+    }
+
+    d->notifier   = new QSocketNotifier(d->fd, QSocketNotifier::Read, this);
+
+    connect(d->notifier, SIGNAL(activated(int)),
+            this, SLOT(slotReadEvents()));
+
+    d->flushTimer = new QTimer(this);
+    d->flushTimer->setSingleShot(true);
+    d->flushTimer->setInterval(s_coalescingInterval);
+
+    connect(d->flushTimer, SIGNAL(timeout()),
+            this, SLOT(slotFlushChanges()));
+}
+
+AlbumWatchInotify::~AlbumWatchInotify()
+{
+    if (d->fd != -1)
+    {
+        close(d->fd);
+    }
+
+    delete d;
+}
+
+bool AlbumWatchInotify::isValid() const
+{
+    return (d->fd != -1);
+}
+
+void AlbumWatchInotify::setFileNameBlackList(const QStringList& fileNames)
+{
+    d->fileNameBlackList = fileNames;
+}
+
+void AlbumWatchInotify::addDirectory(const QString& path, bool recursive)
+{
+    const QString cleanPath = QDir::cleanPath(path);
+
+    d->addWatch(cleanPath);
+
+    if (!recursive)
+    {
+        return;
+    }
+
+    QDirIterator it(cleanPath, QDir::Dirs | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+
+    while (it.hasNext())
+    {
+        d->addWatch(it.next());
+    }
+}
+
+void AlbumWatchInotify::removeDirectory(const QString& path)
+{
+    d->removeWatches(QDir::cleanPath(path));
+}
+
+void AlbumWatchInotify::clear()
+{
+    foreach (int wd, d->paths.keys())
+    {
+        d->removeWatch(wd);
+    }
+
+    d->changedDirectories.clear();
+    d->movedFrom.clear();
+}
+
+void AlbumWatchInotify::slotReadEvents()
+{
+    // Events are aligned to the size of their integer members
+    quint32 buffer[4096];
+
+    forever
+    {
+        const ssize_t length = read(d->fd, buffer, sizeof(buffer));
+
+        if (length <= 0)
+        {
+            // EAGAIN: all events are read
+            break;
+        }
+
+        const char* ptr       = reinterpret_cast<const char*>(buffer);
+        const char* const end = ptr + length;
+
+        while (ptr < end)
+        {
+            const struct inotify_event* const event = reinterpret_cast<const struct inotify_event*>(ptr);
+            ptr                                    += sizeof(struct inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW)
+            {
+                d->reportTopLevelDirectories();
+                continue;
+            }
+
+            if (event->mask & IN_IGNORED)
+            {
+                // The directory was removed, or the watch was removed by us
+                d->forgetWatch(event->wd);
+                continue;
+            }
+
+            const QString dir = d->paths.value(event->wd);
+
+            if (dir.isEmpty() || !event->len)
+            {
+                continue;
+            }
+
+            const QString name = QFile::decodeName(event->name);
+
+            if (d->inBlackList(name))
+            {
+                continue;
+            }
+
+            const QString path = dir + QLatin1Char('/') + name;
+            const bool isDir   = (event->mask & IN_ISDIR);
+
+            if (event->mask & IN_MOVED_FROM)
+            {
+                d->movedFrom.insert(event->cookie, path);
+
+                if (isDir)
+                {
+                    d->removeWatches(path);
+                }
+            }
+            else if (event->mask & IN_MOVED_TO)
+            {
+                const QString srcPath = d->movedFrom.take(event->cookie);
+
+                if (isDir)
+                {
+                    addDirectory(path, true);
+                }
+
+                if (!srcPath.isEmpty())
+                {
+                    emit signalEntryMoved(srcPath, path, isDir);
+                }
+            }
+            else if (isDir && (event->mask & IN_CREATE))
+            {
+                // Subdirectories may have been created before the watch was added
+                addDirectory(path, true);
+            }
+            else if (isDir && (event->mask & IN_DELETE))
+            {
+                d->removeWatches(path);
+            }
+
+            d->changedDirectories << dir;
+        }
+    }
+
+    // Restart the timer, a copy of many files is reported once when it is done
+
+    if (!d->changedDirectories.isEmpty())
+    {
+        d->flushTimer->start();
+    }
+}
+
+void AlbumWatchInotify::slotFlushChanges()
+{
+    // Sources without destination were moved out of the watched trees
+    d->movedFrom.clear();
+
+    if (d->changedDirectories.isEmpty())
+    {
+        return;
+    }
+
+    QStringList paths = d->changedDirectories.toList();
+    d->changedDirectories.clear();
+
+    emit signalDirectoriesChanged(paths);
+}
+
+} // namespace Digikam
@@ -0,0 +1,96 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-11-10
+ * Description : Linux inotify backend of the directory watch
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_ALBUM_WATCH_INOTIFY_H
+#define DIGIKAM_ALBUM_WATCH_INOTIFY_H
+
+// Qt includes
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+
+namespace Digikam
+{
+
+/** Watches directory trees with a single inotify instance.
+ *
+ *  Unlike QFileSystemWatcher, the name of each changed entry is known:
+ *  events on blacklisted file names are dropped, moves inside the watched
+ *  trees are reported with their source and destination, and the changed
+ *  directories are reported once the events stopped for a coalescing interval.
+ *  Directories created or moved into a watched tree are watched recursively.
+ */
+class AlbumWatchInotify : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    explicit AlbumWatchInotify(QObject* const parent = 0);
+    ~AlbumWatchInotify();
+
+    /** Returns false if inotify is not available. The watch cannot be used then.
+     */
+    bool isValid() const;
+
+    /** Events on entries whose file name starts with one of these names are ignored.
+     */
+    void setFileNameBlackList(const QStringList& fileNames);
+
+    /** Watches the directory, and all its subdirectories if recursive is true.
+     */
+    void addDirectory(const QString& path, bool recursive = false);
+
+    /** Stops watching the directory and all its subdirectories.
+     */
+    void removeDirectory(const QString& path);
+
+    void clear();
+
+Q_SIGNALS:
+
+    /** Emitted when a file or directory was moved from a watched directory to a watched directory.
+     *  This signal is emitted before signalDirectoriesChanged() for both parent directories.
+     */
+    void signalEntryMoved(const QString& srcPath, const QString& dstPath, bool isDirectory);
+
+    /** Emitted with all directories whose entries were added, removed or renamed
+     *  since the last emission, when no more event was read during the coalescing interval.
+     */
+    void signalDirectoriesChanged(const QStringList& paths);
+
+private Q_SLOTS:
+
+    void slotReadEvents();
+    void slotFlushChanges();
+
+private:
+
+    class Private;
+    Private* const d;
+};
+
+} // namespace Digikam
+
+#endif // DIGIKAM_ALBUM_WATCH_INOTIFY_H
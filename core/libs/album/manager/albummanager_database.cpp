@@ -388,6 +388,16 @@ bool AlbumManager::setDatabase(const DbEngineParameters& params, bool priority,
     DbEngineGuiErrorHandler* const thumbnailsDBHandler = new DbEngineGuiErrorHandler(ThumbsDbAccess::parameters());
     ThumbsDbAccess::initDbEngineErrorHandler(thumbnailsDBHandler);
 
+    // Activate the disk cache of previews, if enabled.
+
+    if (ApplicationSettings::instance()->getPreviewPyramidCache())
+    {
+        PreviewPyramidCache::instance()->initialize(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) +
+                                                    QLatin1String("/previews"),
+                                                    (qint64)ApplicationSettings::instance()->getPreviewPyramidCacheSize() * 1048576,
+                                                    new ThumbsDbInfoProvider());
+    }
+
     // Activate the similarity database.
 
     SimilarityDbAccess::setParameters(params.similarityParameters());
@@ -66,6 +66,7 @@ extern "C"
 #include <QVBoxLayout>
 #include <QMessageBox>
 #include <QSet>
+#include <QStandardPaths>
 
 // KDE includes
 
@@ -104,6 +105,7 @@ extern "C"
 #include "tagscache.h"
 #include "thumbsdbaccess.h"
 #include "thumbnailloadthread.h"
+#include "previewpyramidcache.h"
 #include "dnotificationwrapper.h"
 #include "dbjobinfo.h"
 #include "dbjobsmanager.h"
@@ -75,6 +75,16 @@ void CollectionScanner::setDeferredFileScanning(bool defer)
     d->deferredFileScanning = defer;
 }
 
+void CollectionScanner::setParallelScanning(bool parallel)
+{
+    d->pipeline.setEnabled(parallel);
+}
+
+void CollectionScanner::setPerformFastScan(bool fast)
+{
+    d->performFastScan = fast;
+}
+
 QStringList CollectionScanner::deferredAlbumPaths() const
 {
     return d->deferredAlbumPaths.toList();
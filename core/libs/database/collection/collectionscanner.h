@@ -114,6 +114,22 @@ public:
     void setDeferredFileScanning(bool defer);
     QStringList deferredAlbumPaths() const;
 
+    /**
+     * Call this to load new and modified files on a pool of threads
+     * while scanning albums. The database is still written by the
+     * scanning thread, with the same result as a sequential scan.
+     * Default is off.
+     */
+    void setParallelScanning(bool parallel);
+
+    /**
+     * Call this to skip the files of all albums whose directory was not modified
+     * since the album was last scanned. Only added, removed and renamed entries change
+     * the modification date of a directory, files modified in place are not detected.
+     * Subalbums are still checked. Default is off.
+     */
+    void setPerformFastScan(bool fast);
+
     // -----------------------------------------------------------------------------
 
     /** @name Scan operations
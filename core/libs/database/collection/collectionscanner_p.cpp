@@ -25,6 +25,11 @@
 
 #include "collectionscanner_p.h"
 
+// Qt includes
+
+#include <QThread>
+#include <QtConcurrent>    // krazy:exclude=includes
+
 namespace Digikam
 {
 
@@ -76,6 +81,18 @@ bool CollectionScannerHintContainerImplementation::hasAnyNormalHint(qlonglong id
            metadataAdjustedHints.contains(id);
 }
 
+bool CollectionScannerHintContainerImplementation::hasAnyHint()
+{
+    QReadLocker locker(&lock);
+
+    return !albumHints.isEmpty()                 ||
+           !itemHints.isEmpty()                  ||
+           !modifiedItemHints.isEmpty()          ||
+           !rescanItemHints.isEmpty()            ||
+           !metadataAboutToAdjustHints.isEmpty() ||
+           !metadataAdjustedHints.isEmpty();
+}
+
 bool CollectionScannerHintContainerImplementation::hasAlbumHints()
 {
     QReadLocker locker(&lock);
@@ -210,6 +227,194 @@ void CollectionScannerHintContainerImplementation::clear()
 
 // --------------------------------------------------------------------
 
+ItemScannerPipeline::ItemScannerPipeline()
+    : enabled(false),
+      maxRunningJobs(0),
+      uniqueHashVersion(-1)
+{
+    pool.setMaxThreadCount(qMax(QThread::idealThreadCount(), 1));
+
+    // A few files per thread keep the workers busy while the database is written
+    maxRunningJobs = 4 * pool.maxThreadCount();
+}
+
+ItemScannerPipeline::~ItemScannerPipeline()
+{
+    clear();
+}
+
+void ItemScannerPipeline::setEnabled(bool enabled)
+{
+    if (!enabled)
+    {
+        clear();
+    }
+
+    this->enabled = enabled;
+}
+
+bool ItemScannerPipeline::isEnabled() const
+{
+    return enabled;
+}
+
+void ItemScannerPipeline::setUniqueHashVersion(int version)
+{
+    uniqueHashVersion = version;
+}
+
+void ItemScannerPipeline::addFile(const QFileInfo& info, const ItemScanInfo& scanInfo, DatabaseItem::Category category)
+{
+    Job job;
+    job.info     = info;
+    job.scanInfo = scanInfo;
+    job.category = category;
+
+    waitingJobs << job;
+    startJobs();
+}
+
+void ItemScannerPipeline::startJobs()
+{
+    while (!waitingJobs.isEmpty() && runningJobs.size() < maxRunningJobs)
+    {
+        Job job    = waitingJobs.takeFirst();
+        job.future = QtConcurrent::run(&pool, &ItemScannerPipeline::loadFile,
+                                       job.info, job.scanInfo, job.category, uniqueHashVersion);
+        runningJobs << job;
+    }
+}
+
+ItemScanner* ItemScannerPipeline::takeScanner(const QString& filePath)
+{
+    // Files are scanned in the order in which they were queued, so all jobs
+    // queued before the requested file belong to files which were not scanned.
+
+    ItemScanner* scanner = 0;
+    int index            = indexOf(runningJobs, filePath);
+
+    if (index != -1)
+    {
+        for (int i = 0; i < index; ++i)
+        {
+            delete runningJobs.takeFirst().future.result();
+        }
+
+        scanner = runningJobs.takeFirst().future.result();
+    }
+    else
+    {
+        index = indexOf(waitingJobs, filePath);
+
+        if (index != -1)
+        {
+            // Not started yet, the caller loads the file itself
+            discardScanners(index + 1);
+        }
+    }
+
+    startJobs();
+
+    return scanner;
+}
+
+void ItemScannerPipeline::discardScanners()
+{
+    discardScanners(waitingJobs.size());
+}
+
+void ItemScannerPipeline::discardScanners(int waitingCount)
+{
+    foreach (const Job& job, runningJobs)
+    {
+        delete job.future.result();
+    }
+
+    runningJobs.clear();
+    waitingJobs.erase(waitingJobs.begin(), waitingJobs.begin() + waitingCount);
+}
+
+void ItemScannerPipeline::prefetchDirectory(const QString& path)
+{
+    QString key = QDir::cleanPath(path);
+
+    if (!directories.contains(key))
+    {
+        directories.insert(key, QtConcurrent::run(&pool, &ItemScannerPipeline::listDirectory, key));
+    }
+}
+
+QFileInfoList ItemScannerPipeline::entryInfoList(const QString& path)
+{
+    QString key = QDir::cleanPath(path);
+
+    if (directories.contains(key))
+    {
+        return directories.take(key).result();
+    }
+
+    return listDirectory(key);
+}
+
+void ItemScannerPipeline::discardDirectory(const QString& path)
+{
+    // A listing still running finishes in the pool, its result is dropped with the future
+    directories.remove(QDir::cleanPath(path));
+}
+
+void ItemScannerPipeline::discardDirectories()
+{
+    directories.clear();
+}
+
+void ItemScannerPipeline::clear()
+{
+    discardScanners();
+
+    foreach (QFuture<QFileInfoList> future, directories)
+    {
+        future.waitForFinished();
+    }
+
+    directories.clear();
+}
+
+int ItemScannerPipeline::indexOf(const QList<Job>& jobs, const QString& filePath)
+{
+    for (int i = 0; i < jobs.size(); ++i)
+    {
+        if (jobs.at(i).info.filePath() == filePath)
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+ItemScanner* ItemScannerPipeline::loadFile(const QFileInfo& info, const ItemScanInfo& scanInfo,
+                                           DatabaseItem::Category category, int uniqueHashVersion)
+{
+    // Same construction as in the scanning methods of CollectionScanner.
+    // The hash version is given, the global database lock is not taken in the worker threads.
+    ItemScanner* const scanner = new ItemScanner(info, scanInfo);
+    scanner->setCategory(category);
+    scanner->setUniqueHashVersion(uniqueHashVersion);
+    scanner->loadFromDisk();
+
+    return scanner;
+}
+
+QFileInfoList ItemScannerPipeline::listDirectory(const QString& path)
+{
+    return QDir(path).entryInfoList(QDir::Files   |
+                                    QDir::AllDirs |
+                                    QDir::NoDotAndDotDot,
+                                    QDir::Name | QDir::DirsLast);
+}
+
+// --------------------------------------------------------------------
+
 CollectionScanner::Private::Private()
     : wantSignals(false),
       needTotalFiles(false),
@@ -217,7 +422,10 @@ CollectionScanner::Private::Private()
       updatingHashHint(false),
       recordHistoryIds(false),
       deferredFileScanning(false),
-      observer(0)
+      performFastScan(false),
+      observer(0),
+      batchNewItems(false),
+      filesScanned(0)
 {
 }
 
@@ -252,6 +460,23 @@ bool CollectionScanner::Private::checkDeferred(const QFileInfo& info)
     return false;
 }
 
+bool CollectionScanner::Private::canSkipUnchangedAlbums()
+{
+    // Pending hints refer to files which must be scanned even if their album did not change
+    return (!hints || !hints->hasAnyHint()) && !updatingHashHint;
+}
+
+bool CollectionScanner::Private::mayNeedScan(const QFileInfo& info, const ItemScanInfo& scanInfo)
+{
+    // A cheap check for the pipeline, following scanFileNormal().
+    // Files only modified by a newer sidecar are not detected and loaded when scanned.
+    return (scanInfo.modificationDate.isNull()                                      ||
+            updatingHashHint                                                        ||
+            (hints && hints->hasAnyNormalHint(scanInfo.id))                         ||
+            !s_modificationDateEquals(info.lastModified(), scanInfo.modificationDate) ||
+            info.size() != scanInfo.fileSize);
+}
+
 void CollectionScanner::Private::finishScanner(ItemScanner& scanner)
 {
     // Perform the actual write operation to the database
@@ -266,4 +491,92 @@ void CollectionScanner::Private::finishScanner(ItemScanner& scanner)
     }
 }
 
+bool CollectionScanner::Private::batchScanner(ItemScanner* const scanner)
+{
+    ItemScanRecord record;
+
+    if (!batchNewItems || !scanner->fillScanRecord(record))
+    {
+        return false;
+    }
+
+    batchedScanners << scanner;
+    batchedRecords  << record;
+    batchedHashes   << scanner->itemScanInfo().uniqueHash;
+
+    if (batchedScanners.size() >= 100)
+    {
+        flushBatchedScanners();
+    }
+
+    return true;
+}
+
+void CollectionScanner::Private::flushBatchedScanners()
+{
+    if (batchedScanners.isEmpty())
+    {
+        return;
+    }
+
+    {
+        CoreDbOperationGroup group;
+        CoreDbAccess().db()->addItems(batchedRecords);
+
+        for (int i = 0 ; i < batchedScanners.size() ; ++i)
+        {
+            batchedScanners.at(i)->commitScanRecord(batchedRecords.at(i));
+        }
+    }
+
+    foreach (ItemScanner* const scanner, batchedScanners)
+    {
+        if (recordHistoryIds && scanner->hasHistoryToResolve())
+        {
+            needResolveHistorySet << scanner->id();
+        }
+    }
+
+    qDeleteAll(batchedScanners);
+    batchedScanners.clear();
+    batchedRecords.clear();
+    batchedHashes.clear();
+}
+
+void CollectionScanner::Private::flushBatchForIdentity(ItemScanner* const scanner)
+{
+    if (batchedScanners.isEmpty())
+    {
+        return;
+    }
+
+    // The hash is known once the file is loaded, the scanner will not load it again.
+    scanner->loadFromDisk();
+
+    if (batchedHashes.contains(scanner->itemScanInfo().uniqueHash))
+    {
+        flushBatchedScanners();
+    }
+}
+
+ItemScanner* CollectionScanner::Private::createScanner(const QFileInfo& info, const ItemScanInfo& scanInfo)
+{
+    ItemScanner* const scanner = pipeline.takeScanner(info.filePath());
+
+    if (scanner)
+    {
+        return scanner;
+    }
+
+    return new ItemScanner(info, scanInfo);
+}
+
+void CollectionScanner::Private::reportThroughput()
+{
+    if (observer)
+    {
+        observer->scanThroughput(filesScanned, scanTime.elapsed());
+    }
+}
+
 } // namespace Digikam
@@ -37,11 +37,15 @@
 // Qt includes
 
 #include <QDir>
+#include <QDateTime>
 #include <QFileInfo>
+#include <QFuture>
 #include <QReadWriteLock>
 #include <QReadLocker>
+#include <QScopedPointer>
 #include <QStringList>
 #include <QSet>
+#include <QThreadPool>
 #include <QTime>
 #include <QWriteLocker>
 
@@ -110,6 +114,7 @@ public:
     virtual void clear();
 
     bool hasAnyNormalHint(qlonglong id);
+    bool hasAnyHint();
     bool hasAlbumHints();
     bool hasModificationHint(qlonglong id);
     bool hasRescanHint(qlonglong id);
@@ -130,6 +135,93 @@ public:
 
 // --------------------------------------------------------------------
 
+/** Loads files from disk ahead of the sequential scan. Reading metadata and
+ *  computing the unique hash of a file is done by ItemScanner::loadFromDisk()
+ *  on a pool of worker threads, while all database operations stay on the
+ *  scanning thread, in the same order as without the pipeline.
+ *  Only a limited number of files is loaded in advance to bound memory usage.
+ *  The hash of a file loaded ahead is only used for lookups once the scanning
+ *  thread takes the file. The new files batched before with the same hash are
+ *  written first, see CollectionScanner::Private::flushBatchForIdentity().
+ */
+class Q_DECL_HIDDEN ItemScannerPipeline
+{
+public:
+
+    explicit ItemScannerPipeline();
+    ~ItemScannerPipeline();
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+
+    /** Sets the version of the unique hash computed by the worker threads,
+     *  which do not access the database.
+     */
+    void setUniqueHashVersion(int version);
+
+    /** Queues a file for loading. Files must be queued in the order in which they are scanned.
+     */
+    void addFile(const QFileInfo& info, const ItemScanInfo& scanInfo, DatabaseItem::Category category);
+
+    /** Returns the loaded scanner of the file, or 0 if it was not queued or not yet started.
+     *  The caller takes ownership. Scanners of files queued before are discarded.
+     */
+    ItemScanner* takeScanner(const QString& filePath);
+
+    /** Discards all queued files.
+     */
+    void discardScanners();
+
+    /** Lists the given directory in the background. The result is retrieved with entryInfoList().
+     */
+    void prefetchDirectory(const QString& path);
+    QFileInfoList entryInfoList(const QString& path);
+
+    /** Drops the listing of a directory which is not scanned, or of all directories.
+     */
+    void discardDirectory(const QString& path);
+    void discardDirectories();
+
+    /** Waits for all running jobs and discards all results.
+     */
+    void clear();
+
+private:
+
+    class Q_DECL_HIDDEN Job
+    {
+    public:
+
+        QFileInfo              info;
+        ItemScanInfo           scanInfo;
+        DatabaseItem::Category category;
+        QFuture<ItemScanner*>  future;
+    };
+
+private:
+
+    void startJobs();
+    void discardScanners(int waitingCount);
+
+    static int           indexOf(const QList<Job>& jobs, const QString& filePath);
+
+    static ItemScanner*  loadFile(const QFileInfo& info, const ItemScanInfo& scanInfo,
+                                  DatabaseItem::Category category, int uniqueHashVersion);
+    static QFileInfoList listDirectory(const QString& path);
+
+private:
+
+    bool                                    enabled;
+    int                                     maxRunningJobs;
+    int                                     uniqueHashVersion;
+    QList<Job>                              waitingJobs;
+    QList<Job>                              runningJobs;
+    QHash<QString, QFuture<QFileInfoList> > directories;
+    QThreadPool                             pool;
+};
+
+// --------------------------------------------------------------------
+
 class Q_DECL_HIDDEN CollectionScanner::Private
 {
 
@@ -144,9 +236,28 @@ public:
 
     bool checkObserver();
     bool checkDeferred(const QFileInfo& info);
+    bool canSkipUnchangedAlbums();
+    bool mayNeedScan(const QFileInfo& info, const ItemScanInfo& scanInfo);
 
     void finishScanner(ItemScanner& scanner);
 
+    /** Takes the scanner of a new file to write it with other new files by CoreDB::addItems().
+     *  Returns false if the file must be written with finishScanner().
+     */
+    bool batchScanner(ItemScanner* const scanner);
+    void flushBatchedScanners();
+
+    /** A new file is compared by its unique hash with the files of the database.
+     *  Writes the batched files first if one of them has the same hash as the given file.
+     */
+    void flushBatchForIdentity(ItemScanner* const scanner);
+
+    /** Returns the scanner of the file loaded ahead by the pipeline, or creates a new one.
+     */
+    ItemScanner* createScanner(const QFileInfo& info, const ItemScanInfo& scanInfo = ItemScanInfo());
+
+    void reportThroughput();
+
 public:
 
     QSet<QString>                                 nameFilters;
@@ -172,7 +283,17 @@ public:
     bool                                          deferredFileScanning;
     QSet<QString>                                 deferredAlbumPaths;
 
+    bool                                          performFastScan;
+
     CollectionScannerObserver*                    observer;
+
+    ItemScannerPipeline                           pipeline;
+    bool                                          batchNewItems;
+    QList<ItemScanner*>                           batchedScanners;
+    QList<ItemScanRecord>                         batchedRecords;
+    QSet<QString>                                 batchedHashes;
+    int                                           filesScanned;
+    QTime                                         scanTime;
 };
 
 } // namespace Digikam
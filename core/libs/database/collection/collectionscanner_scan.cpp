@@ -44,7 +44,8 @@ void CollectionScanner::completeScan()
     //TODO: Implement a mechanism to watch for album root changes while we keep this list
     QList<CollectionLocation> allLocations = CollectionManager::instance()->allAvailableLocations();
 
-    if (d->wantSignals && d->needTotalFiles)
+    // Counting would read all directories, which a fast scan avoids
+    if (d->wantSignals && d->needTotalFiles && !d->performFastScan)
     {
         // count for progress info
         int count = 0;
@@ -578,7 +579,59 @@ void CollectionScanner::scanAlbum(const CollectionLocation& location, const QStr
         emit startScanningAlbum(location.albumRootPath(), album);
     }
 
-    int albumID                   = checkAlbum(location, album);
+    int albumID                = checkAlbum(location, album);
+    QDateTime modificationDate = QFileInfo(dir.absolutePath()).lastModified();
+
+    // Not all database backends store milliseconds
+    modificationDate           = modificationDate.addMSecs(-modificationDate.time().msec());
+
+    // Entries are added, removed or renamed since the last scan if the date of the directory differs
+    if (d->performFastScan && d->canSkipUnchangedAlbums() && modificationDate.isValid() &&
+        modificationDate == CoreDbAccess().db()->getAlbumModificationDate(albumID))
+    {
+        // Only the subalbums can have changed
+        const QStringList subDirs = dir.entryList(QDir::AllDirs | QDir::NoDotAndDotDot, QDir::Name);
+
+        foreach (const QString& subDir, subDirs)
+        {
+            if (!d->checkObserver())
+            {
+                return;
+            }
+
+#ifdef Q_OS_WIN
+            //Hide album that starts with a dot, as under Linux.
+            if (subDir.startsWith(QLatin1Char('.')))
+            {
+                continue;
+            }
+#endif
+
+            if (d->ignoreDirectory.contains(subDir))
+            {
+                continue;
+            }
+
+            if (album == QLatin1String("/"))
+            {
+                scanAlbum(location, QLatin1Char('/') + subDir);
+            }
+            else
+            {
+                scanAlbum(location, album + QLatin1Char('/') + subDir);
+            }
+        }
+
+        d->scannedAlbums << albumID;
+
+        if (d->wantSignals)
+        {
+            emit finishedScanningAlbum(location.albumRootPath(), album, 0);
+        }
+
+        return;
+    }
+
     QList<ItemScanInfo> scanInfos = CoreDbAccess().db()->getItemScanInfos(albumID);
 
     // create a hash filename -> index in list
@@ -591,22 +644,76 @@ void CollectionScanner::scanAlbum(const CollectionLocation& location, const QStr
         itemIdSet << scanInfos.at(i).id;
     }
 
-    const QFileInfoList list = dir.entryInfoList(QDir::Files   |
-                                                 QDir::AllDirs |
-                                                 QDir::NoDotAndDotDot,
-                                                 QDir::Name | QDir::DirsLast);
+    // The listing may have been started in the background when scanning the parent album.
+    const QFileInfoList list = d->pipeline.entryInfoList(dir.path());
 
     QFileInfoList::const_iterator fi;
 
+    if (d->pipeline.isEnabled() && !d->deferredFileScanning)
+    {
+        // Load all files which will probably be scanned and list the subalbums
+        // on the worker threads, while the loop below writes the database.
+        for (fi = list.constBegin() ; fi != list.constEnd() ; ++fi)
+        {
+            if (fi->isFile())
+            {
+                if (!d->nameFilters.contains(fi->suffix().toLower()))
+                {
+                    continue;
+                }
+
+                int index = fileNameIndexHash.value(fi->fileName(), -1);
+
+                if (index != -1)
+                {
+                    if (d->mayNeedScan(*fi, scanInfos.at(index)))
+                    {
+                        d->pipeline.addFile(*fi, scanInfos.at(index), category(*fi));
+                    }
+                }
+                else if (!fi->completeSuffix().contains(QLatin1String("digikamtempfile.")))
+                {
+                    d->pipeline.addFile(*fi, ItemScanInfo(), category(*fi));
+                }
+            }
+            else if (fi->isDir() && !d->performFastScan && !d->ignoreDirectory.contains(fi->fileName()))
+            {
+                // With a fast scan, most subalbums are not listed at all
+                d->pipeline.prefetchDirectory(fi->filePath());
+            }
+        }
+    }
+
+    // Write the scanned files in batches, not in one transaction per file
+    QScopedPointer<CoreDbOperationGroup> group;
+
+    if (d->pipeline.isEnabled())
+    {
+        group.reset(new CoreDbOperationGroup);
+        group->setMaximumTime(2000);
+    }
+
+    // New files are written in batches as long as the operation group is active
+    d->batchNewItems = !group.isNull();
+
     int counter = -1;
 
     for (fi = list.constBegin() ; fi != list.constEnd() ; ++fi)
     {
         if (!d->checkObserver())
         {
+            d->flushBatchedScanners();
+            d->batchNewItems = false;
+            d->pipeline.discardScanners();
+            d->pipeline.discardDirectories();
             return; // return directly, do not go to cleanup code after loop!
         }
 
+        if (group)
+        {
+            group->allowLift();
+        }
+
         ++counter;
 
         if (d->wantSignals && counter && (counter % 100 == 0))
@@ -634,6 +741,8 @@ void CollectionScanner::scanAlbum(const CollectionLocation& location, const QStr
                 }
             }
 
+            ++d->filesScanned;
+
             int index = fileNameIndexHash.value(fi->fileName(), -1);
 
             if (index != -1)
@@ -664,11 +773,17 @@ void CollectionScanner::scanAlbum(const CollectionLocation& location, const QStr
         }
         else if (fi->isDir())
         {
+            // All files of this album are done, nothing queued is needed any more
+            d->flushBatchedScanners();
+            d->batchNewItems = false;
+            d->pipeline.discardScanners();
+            group.reset();
 
 #ifdef Q_OS_WIN
             //Hide album that starts with a dot, as under Linux.
             if (fi->fileName().startsWith(QLatin1Char('.')))
             {
+                d->pipeline.discardDirectory(fi->filePath());
                 continue;
             }
 #endif
@@ -690,14 +805,23 @@ void CollectionScanner::scanAlbum(const CollectionLocation& location, const QStr
             }
 
             scanAlbum(location, subalbum);
+
+            // The listing prefetched for the subalbum is left if scanAlbum() skipped it
+            d->pipeline.discardDirectory(fi->filePath());
         }
     }
 
+    d->flushBatchedScanners();
+    d->batchNewItems = false;
+    d->pipeline.discardScanners();
+
     if (d->wantSignals && counter)
     {
         emit scannedFiles(counter);
     }
 
+    d->reportThroughput();
+
     // Mark items in the db which we did not see on disk.
     if (!itemIdSet.isEmpty())
     {
@@ -707,6 +831,14 @@ void CollectionScanner::scanAlbum(const CollectionLocation& location, const QStr
         itemsWereRemoved(ids);
     }
 
+    // Remember the date of the directory for the next fast scan. Skip albums with files
+    // which were not scanned, and directories changed too recently to compare the dates reliably.
+    if (!d->deferredFileScanning && d->canSkipUnchangedAlbums() && modificationDate.isValid() &&
+        modificationDate.secsTo(QDateTime::currentDateTime()) > 2)
+    {
+        CoreDbAccess().db()->setAlbumModificationDate(albumID, modificationDate);
+    }
+
     // mark album as scanned
     d->scannedAlbums << albumID;
 
@@ -810,8 +942,12 @@ qlonglong CollectionScanner::scanNewFile(const QFileInfo& info, int albumId)
         return -1;
     }
 
-    ItemScanner scanner(info);
-    scanner.setCategory(category(info));
+    QScopedPointer<ItemScanner> scanner(d->createScanner(info));
+    scanner->setCategory(category(info));
+
+    // An identical file of the batch must be in the database before the lookup,
+    // as with the sequential scan
+    d->flushBatchForIdentity(scanner.data());
 
     // Check copy/move hints for single items
     qlonglong srcId = 0;
@@ -824,7 +960,7 @@ qlonglong CollectionScanner::scanNewFile(const QFileInfo& info, int albumId)
 
     if (srcId != 0)
     {
-        scanner.copiedFrom(albumId, srcId);
+        scanner->copiedFrom(albumId, srcId);
     }
     else
     {
@@ -839,18 +975,26 @@ qlonglong CollectionScanner::scanNewFile(const QFileInfo& info, int albumId)
 
         if (srcId != 0)
         {
-            scanner.copiedFrom(albumId, srcId);
+            scanner->copiedFrom(albumId, srcId);
         }
         else
         {
             // Establishing identity with the unique hsah
-            scanner.newFile(albumId);
+            scanner->newFile(albumId);
         }
     }
 
-    d->finishScanner(scanner);
+    // The id of a batched file is not known before the batch is written
+
+    if (d->batchScanner(scanner.data()))
+    {
+        scanner.take();
+        return -1;
+    }
+
+    d->finishScanner(*scanner);
 
-    return scanner.id();
+    return scanner->id();
 }
 
 qlonglong CollectionScanner::scanNewFileFullScan(const QFileInfo& info, int albumId)
@@ -860,12 +1004,12 @@ qlonglong CollectionScanner::scanNewFileFullScan(const QFileInfo& info, int albu
         return -1;
     }
 
-    ItemScanner scanner(info);
-    scanner.setCategory(category(info));
-    scanner.newFileFullScan(albumId);
-    d->finishScanner(scanner);
+    QScopedPointer<ItemScanner> scanner(d->createScanner(info));
+    scanner->setCategory(category(info));
+    scanner->newFileFullScan(albumId);
+    d->finishScanner(*scanner);
 
-    return scanner.id();
+    return scanner->id();
 }
 
 void CollectionScanner::scanModifiedFile(const QFileInfo& info, const ItemScanInfo& scanInfo)
@@ -875,10 +1019,10 @@ void CollectionScanner::scanModifiedFile(const QFileInfo& info, const ItemScanIn
         return;
     }
 
-    ItemScanner scanner(info, scanInfo);
-    scanner.setCategory(category(info));
-    scanner.fileModified();
-    d->finishScanner(scanner);
+    QScopedPointer<ItemScanner> scanner(d->createScanner(info, scanInfo));
+    scanner->setCategory(category(info));
+    scanner->fileModified();
+    d->finishScanner(*scanner);
 }
 
 void CollectionScanner::scanFileUpdateHashReuseThumbnail(const QFileInfo& info, const ItemScanInfo& scanInfo,
@@ -888,12 +1032,12 @@ void CollectionScanner::scanFileUpdateHashReuseThumbnail(const QFileInfo& info,
     qlonglong oldSize = scanInfo.fileSize;
 
     // same code as scanModifiedFile
-    ItemScanner scanner(info, scanInfo);
-    scanner.setCategory(category(info));
-    scanner.fileModified();
+    QScopedPointer<ItemScanner> scanner(d->createScanner(info, scanInfo));
+    scanner->setCategory(category(info));
+    scanner->fileModified();
 
-    QString newHash   = scanner.itemScanInfo().uniqueHash;
-    qlonglong newSize = scanner.itemScanInfo().fileSize;
+    QString newHash   = scanner->itemScanInfo().uniqueHash;
+    qlonglong newSize = scanner->itemScanInfo().fileSize;
 
     if (ThumbsDbAccess::isInitialized())
     {
@@ -907,7 +1051,7 @@ void CollectionScanner::scanFileUpdateHashReuseThumbnail(const QFileInfo& info,
             if (thumbDbInfo.id != -1)
             {
                 ThumbsDbAccess().db()->insertUniqueHash(newHash, newSize, thumbDbInfo.id);
-                ThumbsDbAccess().db()->updateModificationDate(thumbDbInfo.id, scanner.itemScanInfo().modificationDate);
+                ThumbsDbAccess().db()->updateModificationDate(thumbDbInfo.id, scanner->itemScanInfo().modificationDate);
                 // TODO: also update details thumbnails (by file path and URL scheme)
             }
         }
@@ -917,7 +1061,7 @@ void CollectionScanner::scanFileUpdateHashReuseThumbnail(const QFileInfo& info,
         }
     }
 
-    d->finishScanner(scanner);
+    d->finishScanner(*scanner);
 }
 
 void CollectionScanner::rescanFile(const QFileInfo& info, const ItemScanInfo& scanInfo)
@@ -927,10 +1071,10 @@ void CollectionScanner::rescanFile(const QFileInfo& info, const ItemScanInfo& sc
         return;
     }
 
-    ItemScanner scanner(info, scanInfo);
-    scanner.setCategory(category(info));
-    scanner.rescan();
-    d->finishScanner(scanner);
+    QScopedPointer<ItemScanner> scanner(d->createScanner(info, scanInfo));
+    scanner->setCategory(category(info));
+    scanner->rescan();
+    d->finishScanner(*scanner);
 }
 
 void CollectionScanner::completeHistoryScanning()
@@ -53,6 +53,14 @@ void CollectionScanner::mainEntryPoint(bool complete)
 {
     loadNameFilters();
     d->recordHistoryIds = !complete;
+    d->filesScanned     = 0;
+    d->scanTime.start();
+
+    if (d->pipeline.isEnabled())
+    {
+        // The worker threads of the pipeline compute the unique hash without querying the database
+        d->pipeline.setUniqueHashVersion(CoreDbAccess().db()->getUniqueHashVersion());
+    }
 }
 
 void CollectionScanner::safelyRemoveAlbums(const QList<int>& albumIds)
@@ -46,6 +46,16 @@ public:
     }
 
     virtual bool continueQuery() = 0;
+
+    /**
+     * Called after each scanned album with the number of files scanned
+     * since the scan was started and the elapsed time in milliseconds.
+     */
+    virtual void scanThroughput(int filesScanned, int msecs)
+    {
+        Q_UNUSED(filesScanned);
+        Q_UNUSED(msecs);
+    }
 };
 
 // ------------------------------------------------------------------------------------------
@@ -45,6 +45,7 @@ extern "C"
 #include <QFileInfo>
 #include <QDir>
 #include <QVariant>
+#include <QSet>
 
 // KDE includes
 
@@ -71,7 +72,9 @@ public:
 
     explicit Private()
       : db(0),
-        uniqueHashVersion(-1)
+        uniqueHashVersion(-1),
+        searchTextIndexVersion(-1),
+        searchTextIndexComplete(-1)
     {
     }
 
@@ -82,16 +85,47 @@ public:
     QList<int>           recentlyAssignedTags;
 
     int                  uniqueHashVersion;
+    int                  searchTextIndexVersion;
+    int                  searchTextIndexComplete;
 
 public:
 
     QString constructRelatedImagesSQL(bool fromOrTo, DatabaseRelation::Type type, bool boolean);
+    void    insertRows(const QString& table, const QStringList& fieldNames, const QList<QVariantList>& rows);
     QList<qlonglong> execRelatedImagesQuery(DbEngineSqlQuery& query, qlonglong id, DatabaseRelation::Type type);
 };
 
 const QString CoreDB::Private::configGroupName(QLatin1String("CoreDB Settings"));
 const QString CoreDB::Private::configRecentlyUsedTags(QLatin1String("Recently Used Tags"));
 
+void CoreDB::Private::insertRows(const QString& table, const QStringList& fieldNames,
+                                 const QList<QVariantList>& rows)
+{
+    // One statement for as many rows as the database can bind values
+
+    const int rowsPerStatement = qMax(1, db->maximumBoundValues() / fieldNames.size());
+
+    for (int i = 0 ; i < rows.size() ; i += rowsPerStatement)
+    {
+        const int count = qMin(rowsPerStatement, rows.size() - i);
+        QString query   = QString::fromUtf8("REPLACE INTO %1 ( %2 ) VALUES ")
+                          .arg(table, fieldNames.join(QLatin1String(", ")));
+        QVariantList boundValues;
+
+        for (int j = 0 ; j < count ; ++j)
+        {
+            query += j ? QLatin1String(", (") : QLatin1String("(");
+            CoreDB::addBoundValuePlaceholders(query, fieldNames.size());
+            query += QLatin1Char(')');
+
+            boundValues << rows.at(i + j);
+        }
+
+        query += QLatin1Char(';');
+        db->execSql(query, boundValues);
+    }
+}
+
 QString CoreDB::Private::constructRelatedImagesSQL(bool fromOrTo, DatabaseRelation::Type type, bool boolean)
 {
     QString sql;
@@ -518,6 +552,29 @@ void CoreDB::setAlbumDate(int albumID, const QDate& date)
     d->db->recordChangeset(AlbumChangeset(albumID, AlbumChangeset::PropertiesChanged));
 }
 
+void CoreDB::setAlbumModificationDate(int albumID, const QDateTime& modificationDate)
+{
+    // Only used by the collection scanner, no changeset is recorded
+    d->db->execSql(QString::fromUtf8("UPDATE Albums SET modificationDate=? WHERE id=?;"),
+                   modificationDate, albumID);
+}
+
+QDateTime CoreDB::getAlbumModificationDate(int albumID)
+{
+    QList<QVariant> values;
+    d->db->execSql(QString::fromUtf8("SELECT modificationDate FROM Albums WHERE id=?;"),
+                   albumID, &values);
+
+    if (!values.isEmpty())
+    {
+        return values.first().toDateTime();
+    }
+    else
+    {
+        return QDateTime();
+    }
+}
+
 void CoreDB::setAlbumIcon(int albumID, qlonglong iconID)
 {
     if (iconID == 0)
@@ -1101,6 +1158,123 @@ void CoreDB::setUniqueHashVersion(int version)
     setSetting(QLatin1String("uniqueHashVersion"), QString::number(d->uniqueHashVersion));
 }
 
+int CoreDB::getSearchTextIndexVersion()
+{
+    if (d->searchTextIndexVersion == -1)
+    {
+        d->searchTextIndexVersion = getSetting(QLatin1String("SearchTextIndexVersion")).toInt();
+    }
+
+    return d->searchTextIndexVersion;
+}
+
+void CoreDB::setSearchTextIndexVersion(int version)
+{
+    d->searchTextIndexVersion = version;
+    setSetting(QLatin1String("SearchTextIndexVersion"), QString::number(d->searchTextIndexVersion));
+}
+
+bool CoreDB::isSearchTextIndexComplete()
+{
+    if (d->searchTextIndexComplete == -1)
+    {
+        d->searchTextIndexComplete = getSetting(QLatin1String("SearchTextIndexComplete")).toInt();
+    }
+
+    return (d->searchTextIndexComplete == 1);
+}
+
+void CoreDB::setSearchTextIndexComplete(bool complete)
+{
+    d->searchTextIndexComplete = complete ? 1 : 0;
+    setSetting(QLatin1String("SearchTextIndexComplete"), QString::number(d->searchTextIndexComplete));
+}
+
+bool CoreDB::hasSearchTextIndex()
+{
+    return (getSearchTextIndexVersion() > 0 && isSearchTextIndexComplete());
+}
+
+void CoreDB::updateSearchTextIndex(const QList<qlonglong>& imageIds,
+                                   const QList<int>& albumIds,
+                                   const QList<int>& tagIds)
+{
+    // The entries are updated while the index is built as well
+
+    if (getSearchTextIndexVersion() <= 0)
+    {
+        return;
+    }
+
+    QSet<qlonglong> ids = imageIds.toSet();
+
+    foreach (int albumId, albumIds)
+    {
+        QString relativePath = getAlbumRelativePath(albumId);
+
+        if (relativePath.isNull())
+        {
+            continue;
+        }
+
+        // The relative path of all subalbums changes with a renamed album
+
+        foreach (int subAlbumId, getAlbumAndSubalbumsForPath(getAlbumRootId(albumId), relativePath))
+        {
+            ids.unite(getItemIDsInAlbum(subAlbumId).toSet());
+        }
+    }
+
+    foreach (int tagId, tagIds)
+    {
+        // The entry of each image lists the ids of its tags and their parents,
+        // which finds the images of deleted tags as well.
+        // The trailing dot keeps "tag1." from matching "tag12.".
+
+        QString tagToken = QString::fromUtf8("tagids : \"tag%1.\"").arg(tagId);
+
+        QList<QVariant> values;
+        QMap<QString, QVariant> bindingMap;
+        bindingMap.insert(QLatin1String(":tagToken"), tagToken);
+
+        d->db->execDBAction(d->db->getDBAction(QLatin1String("GetSearchTextIndexEntriesOfTag")), bindingMap, &values);
+
+        foreach (const QVariant& value, values)
+        {
+            ids << value.toLongLong();
+        }
+    }
+
+    QList<qlonglong> idList = ids.toList();
+    const int chunkSize     = d->db->maximumBoundValues();
+
+    for (int i = 0 ; i < idList.size() ; i += chunkSize)
+    {
+        QList<QVariant> chunk;
+
+        for (int j = i ; j < qMin(i + chunkSize, idList.size()) ; ++j)
+        {
+            chunk << idList.at(j);
+        }
+
+        QMap<QString, QVariant> bindingMap;
+        bindingMap.insert(QLatin1String(":imageIDs"), qVariantFromValue(DbEngineActionType::value(chunk)));
+
+        d->db->beginTransaction();
+        d->db->execDBAction(d->db->getDBAction(QLatin1String("DeleteSearchTextIndexEntries")), bindingMap);
+        d->db->execDBAction(d->db->getDBAction(QLatin1String("InsertSearchTextIndexEntries")), bindingMap);
+        d->db->commitTransaction();
+    }
+}
+
+void CoreDB::cleanupSearchTextIndex()
+{
+    if (getSearchTextIndexVersion() > 0)
+    {
+        d->db->execDBAction(d->db->getDBAction(QLatin1String("CleanupSearchTextIndex")));
+    }
+}
+
 /*
 QString CoreDB::getItemCaption(qlonglong imageID)
 {
@@ -4510,6 +4684,168 @@ QDate CoreDB::getAlbumAverageDate(int albumID)
     return QDate::fromJulianDay(julianDays / dates.size());
 }
 
+void CoreDB::addItems(QList<ItemScanRecord>& records)
+{
+    if (records.isEmpty())
+    {
+        return;
+    }
+
+    QList<qlonglong>             ids;
+    QMap<int, QList<qlonglong> > idsOfAlbums;
+    QList<qlonglong>             taggedIds;
+    QSet<int>                    tagIds;
+    DatabaseFields::Set          fields(DatabaseFields::ImagesAll);
+
+    QMap<int, QList<QVariantList> > informationRows;
+    QList<QVariantList>             metadataRows;
+    QList<QVariantList>             videoMetadataRows;
+    QList<QVariantList>             positionRows;
+    QList<QVariantList>             commentRows;
+    QList<QVariantList>             tagRows;
+
+    d->db->beginTransaction();
+
+    // The rows of Images are written one by one: only then the id of each item is known
+
+    for (int i = 0 ; i < records.size() ; ++i)
+    {
+        ItemScanRecord& record   = records[i];
+        const ItemScanInfo& info = record.scanInfo;
+
+        QVariantList boundValues;
+        boundValues << info.albumID << info.itemName << (int)info.status << (int)info.category
+                    << info.modificationDate << info.fileSize << info.uniqueHash;
+
+        QVariant id;
+        d->db->execSql(QString::fromUtf8("REPLACE INTO Images "
+                                         "( album, name, status, category, modificationDate, fileSize, uniqueHash ) "
+                                         " VALUES (?,?,?,?,?,?,?);"),
+                       boundValues, 0, &id);
+
+        if (id.isNull())
+        {
+            record.scanInfo.id = -1;
+            continue;
+        }
+
+        const qlonglong imageId = id.toLongLong();
+        record.scanInfo.id      = imageId;
+        ids << imageId;
+        idsOfAlbums[info.albumID] << imageId;
+
+        if (record.imageInformationFields != DatabaseFields::ItemInformationNone)
+        {
+            Q_ASSERT(imageInformationFieldList(record.imageInformationFields).size() == record.imageInformationInfos.size());
+
+            informationRows[(int)record.imageInformationFields] << (QVariantList() << imageId << record.imageInformationInfos);
+            fields |= record.imageInformationFields;
+        }
+
+        if (!record.metadataInfos.isEmpty())
+        {
+            if (record.isVideo)
+            {
+                videoMetadataRows << (QVariantList() << imageId << record.metadataInfos);
+            }
+            else
+            {
+                metadataRows << (QVariantList() << imageId << record.metadataInfos);
+            }
+        }
+
+        if (!record.positionInfos.isEmpty())
+        {
+            positionRows << (QVariantList() << imageId << record.positionInfos);
+        }
+
+        foreach (const CommentInfo& comment, record.comments)
+        {
+            commentRows << (QVariantList() << imageId << (int)comment.type << comment.language
+                                           << comment.author << comment.date << comment.comment);
+        }
+
+        if (!record.tagIds.isEmpty())
+        {
+            foreach (int tagId, record.tagIds)
+            {
+                tagRows << (QVariantList() << imageId << tagId);
+                tagIds << tagId;
+            }
+
+            taggedIds << imageId;
+        }
+    }
+
+    const QString imageid = QLatin1String("imageid");
+
+    for (QMap<int, QList<QVariantList> >::const_iterator it = informationRows.constBegin() ;
+         it != informationRows.constEnd() ; ++it)
+    {
+        d->insertRows(QLatin1String("ImageInformation"),
+                      QStringList() << imageid << imageInformationFieldList(DatabaseFields::ItemInformation(QFlag(it.key()))),
+                      it.value());
+    }
+
+    if (!metadataRows.isEmpty())
+    {
+        d->insertRows(QLatin1String("ImageMetadata"),
+                      QStringList() << imageid << imageMetadataFieldList(DatabaseFields::ImageMetadataAll),
+                      metadataRows);
+        fields |= DatabaseFields::ImageMetadataAll;
+    }
+
+    if (!videoMetadataRows.isEmpty())
+    {
+        d->insertRows(QLatin1String("VideoMetadata"),
+                      QStringList() << imageid << videoMetadataFieldList(DatabaseFields::VideoMetadataAll),
+                      videoMetadataRows);
+        fields |= DatabaseFields::VideoMetadataAll;
+    }
+
+    if (!positionRows.isEmpty())
+    {
+        d->insertRows(QLatin1String("ImagePositions"),
+                      QStringList() << imageid << imagePositionsFieldList(DatabaseFields::ItemPositionsAll),
+                      positionRows);
+        fields |= DatabaseFields::ItemPositionsAll;
+    }
+
+    if (!commentRows.isEmpty())
+    {
+        d->insertRows(QLatin1String("ImageComments"),
+                      QStringList() << imageid << QLatin1String("type") << QLatin1String("language")
+                                    << QLatin1String("author") << QLatin1String("date") << QLatin1String("comment"),
+                      commentRows);
+        fields |= DatabaseFields::ItemCommentsAll;
+    }
+
+    if (!tagRows.isEmpty())
+    {
+        d->insertRows(QLatin1String("ImageTags"),
+                      QStringList() << imageid << QLatin1String("tagid"),
+                      tagRows);
+    }
+
+    if (!ids.isEmpty())
+    {
+        d->db->recordChangeset(ImageChangeset(ids, fields));
+
+        for (QMap<int, QList<qlonglong> >::const_iterator it = idsOfAlbums.constBegin() ;
+             it != idsOfAlbums.constEnd() ; ++it)
+        {
+            d->db->recordChangeset(CollectionImageChangeset(it.value(), it.key(), CollectionImageChangeset::Added));
+        }
+    }
+
+    if (!taggedIds.isEmpty())
+    {
+        d->db->recordChangeset(ImageTagChangeset(taggedIds, tagIds.toList(), ImageTagChangeset::Added));
+    }
+
+    d->db->commitTransaction();
+}
+
 void CoreDB::deleteItem(int albumID, const QString& file)
 {
     qlonglong imageId = getImageId(albumID, file);
@@ -124,6 +124,44 @@ public:
 
     bool isUniqueHashV2();
 
+    /**
+     * Returns the version of the full-text search index, or 0 if
+     * the index is not available with this database.
+     * The value is cached.
+     */
+    int  getSearchTextIndexVersion();
+
+    void setSearchTextIndexVersion(int version);
+
+    /**
+     * Returns true if the entries of all images were created after the
+     * index was created. The value is cached.
+     */
+    bool isSearchTextIndexComplete();
+
+    void setSearchTextIndexComplete(bool complete);
+
+    /**
+     * Returns true if the index is available and complete,
+     * so searches can use it.
+     */
+    bool hasSearchTextIndex();
+
+    /**
+     * Updates the entries of the full-text search index for the given images,
+     * the images of the given albums and their subalbums, and the images
+     * tagged with the given tags or one of their subtags.
+     * Does nothing if the index was not created.
+     */
+    void updateSearchTextIndex(const QList<qlonglong>& imageIds,
+                               const QList<int>& albumIds = QList<int>(),
+                               const QList<int>& tagIds   = QList<int>());
+
+    /**
+     * Removes the entries of images which are no longer in the database.
+     */
+    void cleanupSearchTextIndex();
+
     // ----------- AlbumRoot operations -----------
 
     /**
@@ -304,6 +342,20 @@ public:
      */
     void setAlbumDate(int albumID, const QDate& date);
 
+    /**
+     * Set the modification date of the album directory seen by the last scan of the album.
+     * @param albumID  the id of the album
+     * @param modificationDate the modification date of the directory
+     */
+    void setAlbumModificationDate(int albumID, const QDateTime& modificationDate);
+
+    /**
+     * Returns the modification date of the album directory seen by the last scan of the album,
+     * or a null date if the album was never completely scanned.
+     * @param albumID  the id of the album
+     */
+    QDateTime getAlbumModificationDate(int albumID);
+
     /**
      * Set the icon for the album.
      * @param albumID the id of the album
@@ -504,6 +556,15 @@ public:
                       qlonglong fileSize,
                       const QString& uniqueHash);
 
+    /**
+     * Puts the new items of records in the database, with their information,
+     * metadata, position, comments and tags, in one transaction.
+     * The dependent rows are written with one statement for many items, and
+     * one changeset of each type is recorded for all items.
+     * The id of each added item is set in the record.
+     */
+    void addItems(QList<ItemScanRecord>& records);
+
     /**
      * Deletes an item from the database.
      * @param albumID The id of the album.
@@ -28,7 +28,9 @@
 
 #include <QEventLoop>
 #include <QMutex>
+#include <QReadWriteLock>
 #include <QSqlDatabase>
+#include <QThreadStorage>
 #include <QUuid>
 
 // KDE includes
@@ -45,6 +47,7 @@
 #include "coredbschemaupdater.h"
 #include "collectionmanager.h"
 #include "coredbwatch.h"
+#include "coredbsearchtextindexer.h"
 #include "coredbbackend.h"
 #include "dbengineerrorhandler.h"
 #include "tagscache.h"
@@ -62,7 +65,9 @@ public:
         : backend(0),
           db(0),
           databaseWatch(0),
-          initializing(false)
+          initializing(false),
+          searchTextIndexer(0),
+          readerLock(QReadWriteLock::Recursive)
     {
         // Create a unique identifier for this application (as an application accessing a database
         applicationIdentifier = QUuid::createUuid();
@@ -83,6 +88,19 @@ public:
     QUuid               applicationIdentifier;
 
     bool                initializing;
+
+    /// Only created in the main application
+    CoreDbSearchTextIndexer* searchTextIndexer;
+
+    /**
+     * Held for reading by CoreDbReadAccess, for writing while the backend is replaced.
+     * Lock order: a thread takes readerLock before lock.mutex, never the other way round.
+     * A thread which already holds the mutex does not take readerLock at all.
+     */
+    QReadWriteLock      readerLock;
+
+    /// Number of CoreDbAccess objects held by the current thread
+    QThreadStorage<int> accessDepth;
 };
 
 class Q_DECL_HIDDEN CoreDbAccessMutexLocker : public QMutexLocker
@@ -94,10 +112,12 @@ public:
           d(d)
     {
         d->lock.lockCount++;
+        d->accessDepth.localData()++;
     }
 
     ~CoreDbAccessMutexLocker()
     {
+        d->accessDepth.localData()--;
         d->lock.lockCount--;
     }
 
@@ -115,6 +135,7 @@ CoreDbAccess::CoreDbAccess()
 
     d->lock.mutex.lock();
     d->lock.lockCount++;
+    d->accessDepth.localData()++;
 
     if (!d->backend->isOpen() && !d->initializing)
     {
@@ -131,6 +152,7 @@ CoreDbAccess::CoreDbAccess()
 
 CoreDbAccess::~CoreDbAccess()
 {
+    d->accessDepth.localData()--;
     d->lock.lockCount--;
     d->lock.mutex.unlock();
 }
@@ -141,6 +163,7 @@ CoreDbAccess::CoreDbAccess(bool)
     // backend should not be checked
     d->lock.mutex.lock();
     d->lock.lockCount++;
+    d->accessDepth.localData()++;
 }
 
 CoreDB* CoreDbAccess::db() const
@@ -163,6 +186,16 @@ CoreDbWatch* CoreDbAccess::databaseWatch()
     return 0;
 }
 
+CoreDbSearchTextIndexer* CoreDbAccess::searchTextIndexer()
+{
+    if (d)
+    {
+        return d->searchTextIndexer;
+    }
+
+    return 0;
+}
+
 void CoreDbAccess::initDbEngineErrorHandler(DbEngineErrorHandler* const errorhandler)
 {
     if (!d || !d->backend)
@@ -201,6 +234,10 @@ void CoreDbAccess::setParameters(const DbEngineParameters& parameters, Applicati
         d = new CoreDbAccessStaticPriv();
     }
 
+    // Lock order: readerLock, then the mutex (see CoreDbAccessStaticPriv)
+    Q_ASSERT(!d->accessDepth.localData());
+
+    QWriteLocker readersLock(&d->readerLock);
     CoreDbAccessMutexLocker lock(d);
 
     if (d->parameters == parameters)
@@ -229,6 +266,7 @@ void CoreDbAccess::setParameters(const DbEngineParameters& parameters, Applicati
         if (status == MainApplication)
         {
             d->databaseWatch->initializeRemote(CoreDbWatch::DatabaseMaster);
+            d->searchTextIndexer = new CoreDbSearchTextIndexer(d->databaseWatch);
         }
         else
         {
@@ -323,6 +361,12 @@ bool CoreDbAccess::checkReadyForUse(InitializationObserver* const observer)
     // initialize CollectionManager
     CollectionManager::instance()->refresh();
 
+    // build a new full-text search index in the background
+    if (d->searchTextIndexer)
+    {
+        d->searchTextIndexer->scheduleRebuild();
+    }
+
     d->initializing = false;
 
     return d->backend->isReady();
@@ -342,6 +386,12 @@ void CoreDbAccess::cleanUpDatabase()
 {
     if (d)
     {
+        // Applies the pending changes of the index, before the locks are taken
+        delete d->searchTextIndexer;
+        d->searchTextIndexer = 0;
+
+        // Lock order: readerLock, then the mutex (see CoreDbAccessStaticPriv)
+        QWriteLocker readersLock(&d->readerLock);
         CoreDbAccessMutexLocker locker(d);
 
         if (d->backend)
@@ -369,6 +419,7 @@ CoreDbAccessUnlock::CoreDbAccessUnlock()
 
     // set lock count to 0
     CoreDbAccess::d->lock.lockCount = 0;
+    CoreDbAccess::d->accessDepth.localData() -= count;
 
     // unlock
     for (int i = 0 ; i < count ; ++i)
@@ -388,6 +439,7 @@ CoreDbAccessUnlock::CoreDbAccessUnlock(CoreDbAccess* const)
 
     // set lock count to 0
     CoreDbAccess::d->lock.lockCount = 0;
+    CoreDbAccess::d->accessDepth.localData() -= count;
 
     // unlock
     for (int i = 0 ; i < count ; ++i)
@@ -408,6 +460,75 @@ CoreDbAccessUnlock::~CoreDbAccessUnlock()
 
     // update lock count
     CoreDbAccess::d->lock.lockCount += count;
+    CoreDbAccess::d->accessDepth.localData() += count;
+}
+
+// ----------------------------------------------------------------------
+
+CoreDbReadAccess::CoreDbReadAccess()
+    : m_locked(false),
+      m_mutexLocked(false)
+{
+    // You will want to call setParameters before constructing CoreDbReadAccess
+    Q_ASSERT(CoreDbAccess::d);
+
+    CoreDbAccessStaticPriv* const d = CoreDbAccess::d;
+
+    // A CoreDbAccess of this thread already excludes a change of the backend
+
+    if (d->accessDepth.localData())
+    {
+        return;
+    }
+
+    // Lock order: readerLock, then the mutex (see CoreDbAccessStaticPriv)
+    d->readerLock.lockForRead();
+    m_locked = true;
+
+    if (!d->backend->isOpen())
+    {
+        // opens the database
+        CoreDbAccess access;
+    }
+
+    // Without the write-ahead log, a read blocks on the file lock of a concurrent
+    // write (SQLite) or is not isolated from it on the shared connection (MySQL).
+    // Serialize with the writers as a CoreDbAccess does.
+
+    if (!d->backend->usesWriteAheadLog())
+    {
+        d->lock.mutex.lock();
+        d->lock.lockCount++;
+        d->accessDepth.localData()++;
+        m_mutexLocked = true;
+    }
+}
+
+CoreDbReadAccess::~CoreDbReadAccess()
+{
+    CoreDbAccessStaticPriv* const d = CoreDbAccess::d;
+
+    if (m_mutexLocked)
+    {
+        d->accessDepth.localData()--;
+        d->lock.lockCount--;
+        d->lock.mutex.unlock();
+    }
+
+    if (m_locked)
+    {
+        d->readerLock.unlock();
+    }
+}
+
+CoreDB* CoreDbReadAccess::db() const
+{
+    return CoreDbAccess::d->db;
+}
+
+CoreDbBackend* CoreDbReadAccess::backend() const
+{
+    return CoreDbAccess::d->backend;
 }
 
 } // namespace Digikam
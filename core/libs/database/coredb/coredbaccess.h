@@ -37,6 +37,7 @@ namespace Digikam
 class CoreDbBackend;
 class CoreDB;
 class CoreDbWatch;
+class CoreDbSearchTextIndexer;
 class InitializationObserver;
 class CoreDbAccessStaticPriv;
 
@@ -135,6 +136,11 @@ public:
      */
     static CoreDbWatch* databaseWatch();
 
+    /**
+     * Return the updater of the full-text search index, only created in the main application.
+     */
+    static CoreDbSearchTextIndexer* searchTextIndexer();
+
     /**
      * Setup the errors handler instance.
      */
@@ -145,11 +151,52 @@ private:
     explicit CoreDbAccess(bool);
 
     friend class CoreDbAccessUnlock;
+    friend class CoreDbReadAccess;
     static CoreDbAccessStaticPriv* d;
 };
 
 // -----------------------------------------------------------------------------
 
+/** The CoreDbReadAccess provides access to the database for queries which only read:
+ *  Unlike CoreDbAccess, it does not lock the database access for other threads.
+ *  Queries run concurrently on the database connection of the current thread,
+ *  while writers keep exclusive access among themselves with CoreDbAccess.
+ *  Reads are only concurrent with writes if the SQLite database file uses the
+ *  write-ahead log, which is the case on local file systems. Otherwise, and with
+ *  MySQL, CoreDbReadAccess locks the database access like a CoreDbAccess.
+ *
+ *  Use it only for CoreDB methods which execute SELECT queries and do not change
+ *  any state in CoreDB. Create it on the stack like a CoreDbAccess.
+ *  It may be nested in a CoreDbAccess, and a CoreDbAccess may be nested in it.
+ */
+class DIGIKAM_DATABASE_EXPORT CoreDbReadAccess
+{
+public:
+
+    explicit CoreDbReadAccess();
+    ~CoreDbReadAccess();
+
+    /**
+     * Retrieve a pointer to the album database
+     */
+    CoreDB* db() const;
+
+    /**
+     * Retrieve a pointer to the database backend
+     */
+    CoreDbBackend* backend() const;
+
+private:
+
+    /// False if the current thread holds a CoreDbAccess
+    bool m_locked;
+
+    /// True if the database access is locked because reads cannot run concurrently
+    bool m_mutexLocked;
+};
+
+// -----------------------------------------------------------------------------
+
 class CoreDbAccessUnlock
 {
 public:
@@ -31,10 +31,12 @@
 #include <QString>
 #include <QList>
 #include <QDateTime>
+#include <QVariant>
 
 // Local includes
 
 #include "coredbconstants.h"
+#include "coredbfields.h"
 
 namespace Digikam
 {
@@ -333,6 +335,41 @@ public:
 
 // --------------------------------------------------------------------------
 
+/**
+ * The rows of a new item, written with other items by CoreDB::addItems().
+ * Empty lists are not written.
+ */
+class ItemScanRecord
+{
+public:
+
+    explicit ItemScanRecord()
+      : imageInformationFields(DatabaseFields::ItemInformationNone),
+        isVideo(false)
+    {
+    };
+
+public:
+
+    /// The id is set by CoreDB::addItems(), to -1 if the item cannot be added
+    ItemScanInfo                    scanInfo;
+
+    DatabaseFields::ItemInformation imageInformationFields;
+    QVariantList                    imageInformationInfos;
+
+    /// All fields of ImageMetadata, or of VideoMetadata for a video
+    bool                            isVideo;
+    QVariantList                    metadataInfos;
+
+    /// All fields of ImagePositions
+    QVariantList                    positionInfos;
+
+    QList<CommentInfo>              comments;
+    QList<int>                      tagIds;
+};
+
+// --------------------------------------------------------------------------
+
 class CopyrightInfo
 {
 public:
@@ -56,7 +56,7 @@ namespace Digikam
 
 int CoreDbSchemaUpdater::schemaVersion()
 {
-    return 10;
+    return 11;
 }
 
 int CoreDbSchemaUpdater::filterSettingsVersion()
@@ -69,6 +69,11 @@ int CoreDbSchemaUpdater::uniqueHashVersion()
     return 2;
 }
 
+int CoreDbSchemaUpdater::searchTextIndexVersion()
+{
+    return 2;
+}
+
 bool CoreDbSchemaUpdater::isUniqueHashUpToDate()
 {
     return CoreDbAccess().db()->getUniqueHashVersion() >= uniqueHashVersion();
@@ -151,6 +156,7 @@ bool CoreDbSchemaUpdater::update()
     }
 
     updateFilterSettings();
+    updateSearchTextIndex();
 
     if (d->observer)
     {
@@ -540,6 +546,41 @@ bool CoreDbSchemaUpdater::updateFilterSettings()
     return true;
 }
 
+bool CoreDbSchemaUpdater::updateSearchTextIndex()
+{
+    if (d->albumDB->getSearchTextIndexVersion() >= searchTextIndexVersion())
+    {
+        return true;
+    }
+
+    if (d->albumDB->getSearchTextIndexVersion() > 0)
+    {
+        // The index of an older version matched words by their prefix
+
+        d->backend->execDBAction(d->backend->getDBAction(QLatin1String("DropSearchTextIndex")));
+        d->albumDB->setSearchTextIndexVersion(0);
+    }
+
+    // The index is optional: SQLite can be built without the FTS5 trigram tokenizer,
+    // and MySQL cannot find substrings with its FULLTEXT indexes.
+    // The keyword search falls back to LIKE comparisons then.
+
+    if (!d->parameters.isSQLite() ||
+        !d->backend->execDBAction(d->backend->getDBAction(QLatin1String("CreateSearchTextIndex"))))
+    {
+        qCDebug(DIGIKAM_COREDB_LOG) << "Core database: full-text search index is not supported";
+        return false;
+    }
+
+    // The entries are created in the background by CoreDbSearchTextIndexer,
+    // the index is used by searches when it is complete.
+
+    d->albumDB->setSearchTextIndexComplete(false);
+    d->albumDB->setSearchTextIndexVersion(searchTextIndexVersion());
+
+    return true;
+}
+
 bool CoreDbSchemaUpdater::createDatabase()
 {
     if ( createTables() && createIndices() && createTriggers())
@@ -690,6 +731,9 @@ bool CoreDbSchemaUpdater::updateToVersion(int targetVersion)
         case 10:
             // Digikam for database version 9 can work with version 10, remove ImageHaarMatrix table and add manualOrder column.
             return performUpdateToVersion(QLatin1String("UpdateSchemaFromV9ToV10"), 10, 5);
+        case 11:
+            // Digikam for database version 10 can work with version 11, add modificationDate column to albums.
+            return performUpdateToVersion(QLatin1String("UpdateSchemaFromV10ToV11"), 11, 5);
         default:
             qCDebug(DIGIKAM_COREDB_LOG) << "Core database: unsupported update to version" << targetVersion;
             return false;
@@ -50,6 +50,7 @@ public:
     static int  schemaVersion();
     static int  filterSettingsVersion();
     static int  uniqueHashVersion();
+    static int  searchTextIndexVersion();
     static bool isUniqueHashUpToDate();
 
 public:
@@ -77,6 +78,7 @@ private:
     void defaultIgnoreDirectoryFilterSettings(QStringList& defaultIgnoreDirectoryFilter);
     bool createFilterSettings();
     bool updateFilterSettings();
+    bool updateSearchTextIndex();
     bool createDatabase();
     bool createTables();
     bool createIndices();
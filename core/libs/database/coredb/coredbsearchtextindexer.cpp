@@ -0,0 +1,427 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-11-10
+ * Description : Core database full-text search index updater
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "coredbsearchtextindexer.h"
+
+// Qt includes
+
+#include <QAtomicInt>
+#include <QFuture>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSet>
+#include <QTimer>
+#include <QtConcurrent>    // krazy:exclude=includes
+
+// Local includes
+
+#include "digikam_debug.h"
+#include "coredb.h"
+#include "coredbaccess.h"
+#include "coredbwatch.h"
+
+namespace Digikam
+{
+
+/// Changes are collected during this interval before the index is updated
+static const int s_coalescingInterval = 1000;
+
+/// Number of images whose entries are created with one database lock during a rebuild
+static const int s_rebuildChunkSize   = 500;
+
+/// Maximum number of changed images added to a keyword search, with more the index is not used
+static const int s_maximumPendingIds  = 500;
+
+class Q_DECL_HIDDEN CoreDbSearchTextIndexer::Private
+{
+public:
+
+    explicit Private()
+      : timer(0),
+        scheduled(false),
+        cleanup(false),
+        rebuild(false),
+        complete(false),
+        updatingAlbumsOrTags(false)
+    {
+    }
+
+    bool hasChanges() const
+    {
+        return (cleanup || rebuild || complete || !imageIds.isEmpty() || !albumIds.isEmpty() || !tagIds.isEmpty());
+    }
+
+public:
+
+    QTimer*         timer;
+    QFuture<void>   future;
+
+    /// Set when the indexer is destroyed, which stops a running rebuild
+    QAtomicInt      cancel;
+
+    /// Incremented with each change of the database, which stops a running rebuild
+    QAtomicInt      databaseChanges;
+
+    /// Protects all following members, which are written by the changeset slots in any thread
+    QMutex          mutex;
+    bool            scheduled;
+    bool            cleanup;
+    bool            rebuild;
+    bool            complete;
+    QSet<qlonglong> imageIds;
+    QSet<int>       albumIds;
+    QSet<int>       tagIds;
+
+    /// The changes taken by the running update, until their entries are written
+    QSet<qlonglong> updatingImageIds;
+    bool            updatingAlbumsOrTags;
+};
+
+CoreDbSearchTextIndexer::CoreDbSearchTextIndexer(CoreDbWatch* const watch)
+    : QObject(),
+      d(new Private)
+{
+    d->timer = new QTimer(this);
+    d->timer->setSingleShot(true);
+    d->timer->setInterval(s_coalescingInterval);
+
+    connect(d->timer, SIGNAL(timeout()),
+            this, SLOT(slotUpdate()));
+
+    connect(this, SIGNAL(signalScheduleUpdate()),
+            this, SLOT(slotStartTimer()),
+            Qt::QueuedConnection);
+
+    // The changesets are emitted in the thread which changed the database
+
+    connect(watch, SIGNAL(databaseChanged()),
+            this, SLOT(slotDatabaseChanged()),
+            Qt::DirectConnection);
+
+    connect(watch, SIGNAL(imageChange(ImageChangeset)),
+            this, SLOT(slotImageChange(ImageChangeset)),
+            Qt::DirectConnection);
+
+    connect(watch, SIGNAL(imageTagChange(ImageTagChangeset)),
+            this, SLOT(slotImageTagChange(ImageTagChangeset)),
+            Qt::DirectConnection);
+
+    connect(watch, SIGNAL(collectionImageChange(CollectionImageChangeset)),
+            this, SLOT(slotCollectionImageChange(CollectionImageChangeset)),
+            Qt::DirectConnection);
+
+    connect(watch, SIGNAL(albumChange(AlbumChangeset)),
+            this, SLOT(slotAlbumChange(AlbumChangeset)),
+            Qt::DirectConnection);
+
+    connect(watch, SIGNAL(tagChange(TagChangeset)),
+            this, SLOT(slotTagChange(TagChangeset)),
+            Qt::DirectConnection);
+}
+
+CoreDbSearchTextIndexer::~CoreDbSearchTextIndexer()
+{
+    d->timer->stop();
+    d->cancel.storeRelease(1);
+    d->future.waitForFinished();
+    update();
+
+    delete d;
+}
+
+void CoreDbSearchTextIndexer::slotDatabaseChanged()
+{
+    // A new database gets its index from the schema updater
+
+    d->databaseChanges.ref();
+
+    QMutexLocker lock(&d->mutex);
+    d->cleanup  = false;
+    d->rebuild  = false;
+    d->complete = false;
+    d->imageIds.clear();
+    d->albumIds.clear();
+    d->tagIds.clear();
+    d->updatingImageIds.clear();
+    d->updatingAlbumsOrTags = false;
+}
+
+bool CoreDbSearchTextIndexer::pendingImageIds(QList<qlonglong>& imageIds) const
+{
+    QMutexLocker lock(&d->mutex);
+
+    if (!d->albumIds.isEmpty() || !d->tagIds.isEmpty() || d->updatingAlbumsOrTags)
+    {
+        return false;
+    }
+
+    if ((d->imageIds.size() + d->updatingImageIds.size()) > s_maximumPendingIds)
+    {
+        return false;
+    }
+
+    imageIds = (d->imageIds + d->updatingImageIds).toList();
+
+    return true;
+}
+
+void CoreDbSearchTextIndexer::slotImageChange(const ImageChangeset& changeset)
+{
+    DatabaseFields::Set set = changeset.changes();
+
+    if ((set & DatabaseFields::Name)  ||
+        (set & DatabaseFields::Album) ||
+        (set & DatabaseFields::ItemCommentsAll))
+    {
+        QMutexLocker lock(&d->mutex);
+        d->imageIds.unite(changeset.ids().toSet());
+        scheduleUpdate();
+    }
+}
+
+void CoreDbSearchTextIndexer::slotImageTagChange(const ImageTagChangeset& changeset)
+{
+    if (changeset.propertiesWereChanged())
+    {
+        return;
+    }
+
+    QMutexLocker lock(&d->mutex);
+    d->imageIds.unite(changeset.ids().toSet());
+    scheduleUpdate();
+}
+
+void CoreDbSearchTextIndexer::slotCollectionImageChange(const CollectionImageChangeset& changeset)
+{
+    QMutexLocker lock(&d->mutex);
+
+    switch (changeset.operation())
+    {
+        case CollectionImageChangeset::Added:
+        case CollectionImageChangeset::Moved:
+        case CollectionImageChangeset::Copied:
+            d->imageIds.unite(changeset.ids().toSet());
+            break;
+
+        case CollectionImageChangeset::Deleted:
+        case CollectionImageChangeset::RemovedDeleted:
+            d->cleanup = true;
+            break;
+
+        default:
+            // Removed images keep their entries until they are deleted
+            return;
+    }
+
+    scheduleUpdate();
+}
+
+void CoreDbSearchTextIndexer::slotAlbumChange(const AlbumChangeset& changeset)
+{
+    if (changeset.operation() == AlbumChangeset::Renamed ||
+        changeset.operation() == AlbumChangeset::PropertiesChanged)
+    {
+        QMutexLocker lock(&d->mutex);
+        d->albumIds << changeset.albumId();
+        scheduleUpdate();
+    }
+}
+
+void CoreDbSearchTextIndexer::slotTagChange(const TagChangeset& changeset)
+{
+    switch (changeset.operation())
+    {
+        case TagChangeset::Moved:
+        case TagChangeset::Deleted:
+        case TagChangeset::Renamed:
+        case TagChangeset::Reparented:
+        {
+            QMutexLocker lock(&d->mutex);
+            d->tagIds << changeset.tagId();
+            scheduleUpdate();
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+void CoreDbSearchTextIndexer::scheduleRebuild()
+{
+    QMutexLocker lock(&d->mutex);
+    d->rebuild = true;
+    scheduleUpdate();
+}
+
+void CoreDbSearchTextIndexer::scheduleUpdate()
+{
+    // Called with the mutex locked. Signal only the first change of an interval.
+
+    if (!d->scheduled)
+    {
+        d->scheduled = true;
+        emit signalScheduleUpdate();
+    }
+}
+
+void CoreDbSearchTextIndexer::slotStartTimer()
+{
+    if (!d->timer->isActive())
+    {
+        d->timer->start();
+    }
+}
+
+void CoreDbSearchTextIndexer::slotUpdate()
+{
+    if (d->future.isRunning())
+    {
+        d->timer->start();
+        return;
+    }
+
+    d->future = QtConcurrent::run(this, &CoreDbSearchTextIndexer::update);
+}
+
+void CoreDbSearchTextIndexer::update()
+{
+    bool             cleanup;
+    bool             rebuild;
+    bool             complete;
+    QList<qlonglong> imageIds;
+    QList<int>       albumIds;
+    QList<int>       tagIds;
+
+    {
+        QMutexLocker lock(&d->mutex);
+
+        if (!d->hasChanges())
+        {
+            d->scheduled = false;
+            return;
+        }
+
+        cleanup                 = d->cleanup;
+        rebuild                 = d->rebuild;
+        complete                = d->complete;
+        imageIds                = d->imageIds.toList();
+        albumIds                = d->albumIds.toList();
+        tagIds                  = d->tagIds.toList();
+        d->updatingImageIds     = d->imageIds;
+        d->updatingAlbumsOrTags = (!d->albumIds.isEmpty() || !d->tagIds.isEmpty());
+        d->cleanup              = false;
+        d->rebuild              = false;
+        d->complete             = false;
+        d->scheduled            = false;
+        d->imageIds.clear();
+        d->albumIds.clear();
+        d->tagIds.clear();
+    }
+
+    {
+        CoreDbAccess access;
+
+        if (access.db()->getSearchTextIndexVersion() > 0)
+        {
+            qCDebug(DIGIKAM_COREDB_LOG) << "Core database: updating full-text search index of"
+                                        << imageIds.size() << "images," << albumIds.size() << "albums,"
+                                        << tagIds.size() << "tags";
+
+            if (cleanup)
+            {
+                access.db()->cleanupSearchTextIndex();
+            }
+
+            access.db()->updateSearchTextIndex(imageIds, albumIds, tagIds);
+
+            if (complete)
+            {
+                access.db()->setSearchTextIndexComplete(true);
+                qCDebug(DIGIKAM_COREDB_LOG) << "Core database: full-text search index is complete";
+            }
+        }
+
+        {
+            // The entries are written, searches can use the index for these images again
+
+            QMutexLocker lock(&d->mutex);
+            d->updatingImageIds.clear();
+            d->updatingAlbumsOrTags = false;
+        }
+
+        if (!rebuild || (access.db()->getSearchTextIndexVersion() <= 0) || access.db()->isSearchTextIndexComplete())
+        {
+            return;
+        }
+    }
+
+    // The destructor only applies the pending changes
+
+    if (!d->cancel.loadAcquire())
+    {
+        buildIndex();
+    }
+}
+
+void CoreDbSearchTextIndexer::buildIndex()
+{
+    const int        databaseChanges = d->databaseChanges.load();
+    QList<qlonglong> imageIds;
+
+    {
+        CoreDbAccess access;
+        imageIds = access.db()->getAllItems();
+    }
+
+    qCDebug(DIGIKAM_COREDB_LOG) << "Core database: building full-text search index of"
+                                << imageIds.size() << "images";
+
+    for (int i = 0 ; i < imageIds.size() ; i += s_rebuildChunkSize)
+    {
+        if (d->cancel.loadAcquire() || d->databaseChanges.load() != databaseChanges)
+        {
+            // The index is built again with the next start
+
+            qCDebug(DIGIKAM_COREDB_LOG) << "Core database: building full-text search index interrupted";
+            return;
+        }
+
+        CoreDbAccess access;
+        access.db()->updateSearchTextIndex(imageIds.mid(i, s_rebuildChunkSize));
+    }
+
+    // The changesets of images changed meanwhile were collected and are applied
+    // by the next update, which marks the index as complete.
+
+    QMutexLocker lock(&d->mutex);
+
+    if (d->databaseChanges.load() == databaseChanges)
+    {
+        d->cleanup  = true;
+        d->complete = true;
+        scheduleUpdate();
+    }
+}
+
+} // namespace Digikam
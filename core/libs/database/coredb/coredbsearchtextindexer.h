@@ -0,0 +1,108 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-11-10
+ * Description : Core database full-text search index updater
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_CORE_DB_SEARCH_TEXT_INDEXER_H
+#define DIGIKAM_CORE_DB_SEARCH_TEXT_INDEXER_H
+
+// Qt includes
+
+#include <QObject>
+#include <QList>
+
+// Local includes
+
+#include "digikam_export.h"
+#include "coredbchangesets.h"
+
+namespace Digikam
+{
+
+class CoreDbWatch;
+
+/** Keeps the full-text search index of the core database up to date.
+ *
+ *  The changesets of the database watch are collected in the thread which
+ *  wrote the change, including the changes of other processes received
+ *  by the watch. The affected entries are updated in a background thread
+ *  at most once per coalescing interval. Until then, a keyword search adds
+ *  the changed images with pendingImageIds(), or does not use the index.
+ *  The entries of all images are created in the background as well, when the
+ *  schema updater has created the index, in chunks which hold the database lock
+ *  only for a short time.
+ *  Only the main application updates the index.
+ */
+class DIGIKAM_DATABASE_EXPORT CoreDbSearchTextIndexer : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    explicit CoreDbSearchTextIndexer(CoreDbWatch* const watch);
+
+    /** Waits for a running update and applies the pending changes.
+     */
+    ~CoreDbSearchTextIndexer();
+
+    /** Creates the entries of all images in the background, if the index
+     *  of the current database is not complete.
+     */
+    void scheduleRebuild();
+
+    /** Returns the images whose entries are not updated yet, including
+     *  the images of a running update.
+     *  Returns false if more entries may be outdated: after album or tag
+     *  changes, or with too many changed images.
+     */
+    bool pendingImageIds(QList<qlonglong>& imageIds) const;
+
+Q_SIGNALS:
+
+    void signalScheduleUpdate();
+
+private Q_SLOTS:
+
+    void slotDatabaseChanged();
+    void slotImageChange(const ImageChangeset& changeset);
+    void slotImageTagChange(const ImageTagChangeset& changeset);
+    void slotCollectionImageChange(const CollectionImageChangeset& changeset);
+    void slotAlbumChange(const AlbumChangeset& changeset);
+    void slotTagChange(const TagChangeset& changeset);
+
+    void slotStartTimer();
+    void slotUpdate();
+
+private:
+
+    void scheduleUpdate();
+    void update();
+    void buildIndex();
+
+private:
+
+    class Private;
+    Private* const d;
+};
+
+} // namespace Digikam
+
+#endif // DIGIKAM_CORE_DB_SEARCH_TEXT_INDEXER_H
@@ -35,6 +35,9 @@ DBJobsThread::DBJobsThread(QObject* const parent)
     : ActionThreadBase(parent)
 {
     setObjectName(QLatin1String("DBJobsThread"));
+
+    // The views wait for the results
+    setPriorityClass(JobScheduler::InteractiveClass);
 }
 
 DBJobsThread::~DBJobsThread()
@@ -37,6 +37,7 @@
 #include <QSqlDriver>
 #include <QSqlError>
 #include <QSqlRecord>
+#include <QStorageInfo>
 #include <QThread>
 #include <QTime>
 
@@ -72,7 +73,9 @@ BdEngineBackendPrivate::ErrorLocker::ErrorLocker(BdEngineBackendPrivate* const d
 
 DbEngineThreadData::DbEngineThreadData()
     : valid(0),
-      transactionCount(0)
+      transactionCount(0),
+      queryCacheUse(0),
+      schemaGeneration(0)
 {
 }
 
@@ -96,6 +99,9 @@ void DbEngineThreadData::closeDatabase()
         connectionToRemove = database.connectionName();
     }
 
+    // The prepared statements must be destroyed before the connection
+    clearQueryCache();
+
     // Destroy object
     database         = QSqlDatabase();
     valid            = 0;
@@ -109,9 +115,17 @@ void DbEngineThreadData::closeDatabase()
     }
 }
 
+void DbEngineThreadData::clearQueryCache()
+{
+    qDeleteAll(queryCache);
+    queryCache.clear();
+}
+
 BdEngineBackendPrivate::BdEngineBackendPrivate(BdEngineBackend* const backend)
     : currentValidity(0),
       isInTransaction(false),
+      writeAheadLog(false),
+      queryCacheEnabled(true),
       status(BdEngineBackend::Unavailable),
       lock(0),
       operationStatus(BdEngineBackend::ExecuteNormal),
@@ -170,6 +184,11 @@ QSqlDatabase BdEngineBackendPrivate::databaseForThread()
         if (threadData->database.open())
         {
             threadData->valid = currentValidity;
+
+            if (parameters.isSQLite())
+            {
+                setupSQLiteJournal(threadData->database);
+            }
         }
         else
         {
@@ -189,8 +208,15 @@ QSqlDatabase BdEngineBackendPrivate::createDatabaseConnection()
     if (parameters.isSQLite())
     {
         QStringList toAdd;
-        // enable shared cache, especially useful with SQLite >= 3.5.0
-        toAdd << QLatin1String("QSQLITE_ENABLE_SHARED_CACHE");
+
+        // enable shared cache, especially useful with SQLite >= 3.5.0.
+        // Connections sharing the cache lock whole tables against each other,
+        // which would serialize readers and writers again with the write-ahead log.
+        if (!writeAheadLog)
+        {
+            toAdd << QLatin1String("QSQLITE_ENABLE_SHARED_CACHE");
+        }
+
         // We do our own waiting.
         toAdd << QLatin1String("QSQLITE_BUSY_TIMEOUT=0");
 
@@ -212,6 +238,28 @@ QSqlDatabase BdEngineBackendPrivate::createDatabaseConnection()
     return db;
 }
 
+void BdEngineBackendPrivate::setupSQLiteJournal(QSqlDatabase& database)
+{
+    QSqlQuery query(database);
+
+    if (writeAheadLog)
+    {
+        // The journal mode is stored in the database file, synchronous is set per connection
+        query.exec(QLatin1String("PRAGMA journal_mode=WAL;"));
+        query.exec(QLatin1String("PRAGMA synchronous=NORMAL;"));
+        return;
+    }
+
+    // The write-ahead log needs shared memory, which does not work on network file systems.
+    // Revert a database file which was moved from a local file system.
+
+    if (query.exec(QLatin1String("PRAGMA journal_mode;")) && query.next() &&
+        query.value(0).toString().compare(QLatin1String("wal"), Qt::CaseInsensitive) == 0)
+    {
+        query.exec(QLatin1String("PRAGMA journal_mode=DELETE;"));
+    }
+}
+
 void BdEngineBackendPrivate::closeDatabaseForThread()
 {
     if (threadDataStorage.hasLocalData())
@@ -220,6 +268,106 @@ void BdEngineBackendPrivate::closeDatabaseForThread()
     }
 }
 
+DbEngineSqlQuery BdEngineBackendPrivate::takeCachedQuery(const QString& sql)
+{
+    if (queryCacheEnabled)
+    {
+        // Opens the connection, or reopens it after a change of the parameters, which clears the cache
+        databaseForThread();
+
+        DbEngineThreadData* const threadData = threadDataStorage.localData();
+
+        if (threadData->schemaGeneration != schemaGeneration.load())
+        {
+            threadData->clearQueryCache();
+            threadData->schemaGeneration = schemaGeneration.load();
+        }
+
+        // The statement is taken out of the cache while in use, in case the same
+        // statement is executed again before, for example from an error handler
+
+        DbEngineCachedQuery* const cached = threadData->queryCache.take(sql);
+
+        if (cached)
+        {
+            DbEngineSqlQuery query = cached->query;
+            delete cached;
+            queryCacheHits.ref();
+
+            return query;
+        }
+
+        queryCacheMisses.ref();
+    }
+
+    return q->prepareQuery(sql);
+}
+
+void BdEngineBackendPrivate::returnCachedQuery(const QString& sql, DbEngineSqlQuery& query)
+{
+    // Resets the statement, SQLite keeps a read lock while a statement has pending rows
+    query.finish();
+
+    if (!queryCacheEnabled || !threadDataStorage.hasLocalData())
+    {
+        return;
+    }
+
+    DbEngineThreadData* const threadData = threadDataStorage.localData();
+
+    // The statement was prepared for a connection which was closed meanwhile, or it failed
+
+    if (query.lastError().isValid()                                   ||
+        query.driver() != threadData->database.driver()               ||
+        threadData->schemaGeneration != schemaGeneration.load()       ||
+        threadData->queryCache.contains(sql))
+    {
+        return;
+    }
+
+    if (threadData->queryCache.size() >= DbEngineThreadData::QueryCacheSize)
+    {
+        // Evict the least recently used statement
+
+        QHash<QString, DbEngineCachedQuery*>::iterator oldest = threadData->queryCache.begin();
+
+        for (QHash<QString, DbEngineCachedQuery*>::iterator it = threadData->queryCache.begin() ;
+             it != threadData->queryCache.end() ; ++it)
+        {
+            if (it.value()->lastUse < oldest.value()->lastUse)
+            {
+                oldest = it;
+            }
+        }
+
+        delete oldest.value();
+        threadData->queryCache.erase(oldest);
+    }
+
+    DbEngineCachedQuery* const cached = new DbEngineCachedQuery(query);
+    cached->lastUse                   = ++threadData->queryCacheUse;
+    threadData->queryCache.insert(sql, cached);
+}
+
+void BdEngineBackendPrivate::checkSchemaChange(const QString& sql)
+{
+    int pos = 0;
+
+    while (pos < sql.size() && sql.at(pos).isSpace())
+    {
+        ++pos;
+    }
+
+    const QStringRef statement = sql.midRef(pos);
+
+    if (statement.startsWith(QLatin1String("CREATE"), Qt::CaseInsensitive) ||
+        statement.startsWith(QLatin1String("ALTER"),  Qt::CaseInsensitive) ||
+        statement.startsWith(QLatin1String("DROP"),   Qt::CaseInsensitive))
+    {
+        schemaGeneration.ref();
+    }
+}
+
 QSqlError BdEngineBackendPrivate::databaseErrorForThread()
 {
     if (threadDataStorage.hasLocalData())
@@ -623,6 +771,36 @@ BdEngineBackend::DbType BdEngineBackend::databaseType() const
     return d->parameters.isSQLite() ? DbType::SQLite : DbType::MySQL;
 }
 
+void BdEngineBackend::setQueryCacheEnabled(bool enabled)
+{
+    Q_D(BdEngineBackend);
+    d->queryCacheEnabled = enabled;
+}
+
+bool BdEngineBackend::isQueryCacheEnabled() const
+{
+    Q_D(const BdEngineBackend);
+    return d->queryCacheEnabled;
+}
+
+bool BdEngineBackend::usesWriteAheadLog() const
+{
+    Q_D(const BdEngineBackend);
+    return d->writeAheadLog;
+}
+
+int BdEngineBackend::queryCacheHits() const
+{
+    Q_D(const BdEngineBackend);
+    return d->queryCacheHits.load();
+}
+
+int BdEngineBackend::queryCacheMisses() const
+{
+    Q_D(const BdEngineBackend);
+    return d->queryCacheMisses.load();
+}
+
 BdEngineBackend::QueryState BdEngineBackend::execDBAction(const DbEngineAction& action,
                                                           QList<QVariant>* const values,
                                                           QVariant* const lastInsertId)
@@ -772,10 +950,35 @@ bool BdEngineBackend::isCompatible(const DbEngineParameters& parameters)
     return QSqlDatabase::drivers().contains(parameters.databaseType);
 }
 
+static bool isOnNetworkFileSystem(const QString& filePath)
+{
+    const QString dirPath = QFileInfo(filePath).absolutePath();
+
+    if (dirPath.startsWith(QLatin1String("//")))
+    {
+        // UNC path of a Windows share
+        return true;
+    }
+
+    const QByteArray type = QStorageInfo(dirPath).fileSystemType().toLower();
+
+    return (type.startsWith("nfs")  ||
+            type.startsWith("smb")  ||
+            type == "cifs"          ||
+            type == "fuse.sshfs"    ||
+            type == "afs"           ||
+            type == "9p"            ||
+            type == "ncpfs"         ||
+            type == "coda"          ||
+            type == "ceph"          ||
+            type.endsWith("glusterfs"));
+}
+
 bool BdEngineBackend::open(const DbEngineParameters& parameters)
 {
     Q_D(BdEngineBackend);
-    d->parameters = parameters;
+    d->parameters    = parameters;
+    d->writeAheadLog = parameters.isSQLite() && !isOnNetworkFileSystem(parameters.databaseNameCore);
     // This will make possibly opened thread dbs reload at next access
     d->currentValidity++;
 
@@ -894,15 +1097,31 @@ BdEngineBackend::QueryState BdEngineBackend::handleQueryResult(DbEngineSqlQuery&
     return BdEngineBackend::QueryState(BdEngineBackend::NoErrors);
 }
 
+BdEngineBackend::QueryState BdEngineBackend::handleCachedQueryResult(const QString& sql,
+                                                                     DbEngineSqlQuery& query,
+                                                                     QList<QVariant>* const values,
+                                                                     QVariant* const lastInsertId)
+{
+    Q_D(BdEngineBackend);
+
+    BdEngineBackend::QueryState result = handleQueryResult(query, values, lastInsertId);
+    d->returnCachedQuery(sql, query);
+
+    return result;
+}
+
 // -------------------------------------------------------------------------------------
 
 BdEngineBackend::QueryState BdEngineBackend::execSql(const QString& sql,
                                                      QList<QVariant>* const values,
                                                      QVariant* const lastInsertId)
 {
-    DbEngineSqlQuery query = execQuery(sql);
+    Q_D(BdEngineBackend);
 
-    return handleQueryResult(query, values, lastInsertId);
+    DbEngineSqlQuery query = d->takeCachedQuery(sql);
+    exec(query);
+
+    return handleCachedQueryResult(sql, query, values, lastInsertId);
 }
 
 BdEngineBackend::QueryState BdEngineBackend::execSql(const QString& sql,
@@ -910,9 +1129,12 @@ BdEngineBackend::QueryState BdEngineBackend::execSql(const QString& sql,
                                                      QList<QVariant>* const values,
                                                      QVariant* const lastInsertId)
 {
-    DbEngineSqlQuery query = execQuery(sql, boundValue1);
+    Q_D(BdEngineBackend);
+
+    DbEngineSqlQuery query = d->takeCachedQuery(sql);
+    execQuery(query, boundValue1);
 
-    return handleQueryResult(query, values, lastInsertId);
+    return handleCachedQueryResult(sql, query, values, lastInsertId);
 }
 
 BdEngineBackend::QueryState BdEngineBackend::execSql(const QString& sql,
@@ -921,9 +1143,12 @@ BdEngineBackend::QueryState BdEngineBackend::execSql(const QString& sql,
                                                      QList<QVariant>* const values,
                                                      QVariant* const lastInsertId)
 {
-    DbEngineSqlQuery query = execQuery(sql, boundValue1, boundValue2);
+    Q_D(BdEngineBackend);
+
+    DbEngineSqlQuery query = d->takeCachedQuery(sql);
+    execQuery(query, boundValue1, boundValue2);
 
-    return handleQueryResult(query, values, lastInsertId);
+    return handleCachedQueryResult(sql, query, values, lastInsertId);
 }
 
 BdEngineBackend::QueryState BdEngineBackend::execSql(const QString& sql,
@@ -933,8 +1158,12 @@ BdEngineBackend::QueryState BdEngineBackend::execSql(const QString& sql,
                                                      QList<QVariant>* const values,
                                                      QVariant* const lastInsertId)
 {
-    DbEngineSqlQuery query = execQuery(sql, boundValue1, boundValue2, boundValue3);
-    return handleQueryResult(query, values, lastInsertId);
+    Q_D(BdEngineBackend);
+
+    DbEngineSqlQuery query = d->takeCachedQuery(sql);
+    execQuery(query, boundValue1, boundValue2, boundValue3);
+
+    return handleCachedQueryResult(sql, query, values, lastInsertId);
 }
 
 BdEngineBackend::QueryState BdEngineBackend::execSql(const QString& sql,
@@ -945,9 +1174,12 @@ BdEngineBackend::QueryState BdEngineBackend::execSql(const QString& sql,
                                                      QList<QVariant>* const values,
                                                      QVariant* const lastInsertId)
 {
-    DbEngineSqlQuery query = execQuery(sql, boundValue1, boundValue2, boundValue3, boundValue4);
+    Q_D(BdEngineBackend);
 
-    return handleQueryResult(query, values, lastInsertId);
+    DbEngineSqlQuery query = d->takeCachedQuery(sql);
+    execQuery(query, boundValue1, boundValue2, boundValue3, boundValue4);
+
+    return handleCachedQueryResult(sql, query, values, lastInsertId);
 }
 
 BdEngineBackend::QueryState BdEngineBackend::execSql(const QString& sql,
@@ -955,17 +1187,27 @@ BdEngineBackend::QueryState BdEngineBackend::execSql(const QString& sql,
                                                      QList<QVariant>* const values,
                                                      QVariant* const lastInsertId)
 {
-    DbEngineSqlQuery query = execQuery(sql, boundValues);
+    Q_D(BdEngineBackend);
 
-    return handleQueryResult(query, values, lastInsertId);
+    DbEngineSqlQuery query = d->takeCachedQuery(sql);
+    execQuery(query, boundValues);
+
+    return handleCachedQueryResult(sql, query, values, lastInsertId);
 }
 
 BdEngineBackend::QueryState BdEngineBackend::execSql(const QString& sql, const QMap<QString, QVariant>& bindingMap,
                                                      QList<QVariant>* const values, QVariant* const lastInsertId)
 {
-    DbEngineSqlQuery query = execQuery(sql, bindingMap);
+    Q_D(BdEngineBackend);
 
-    return handleQueryResult(query, values, lastInsertId);
+    // The statements of database actions are cached after the expansion of the binding map
+
+    QList<QVariant> valuesToBind;
+    const QString preparedString = BdEngineBackendPrivate::expandBindingMap(sql, bindingMap, &valuesToBind);
+    DbEngineSqlQuery query       = d->takeCachedQuery(preparedString);
+    execQuery(query, valuesToBind);
+
+    return handleCachedQueryResult(preparedString, query, values, lastInsertId);
 }
 
 // -------------------------------------------------------------------------------------
@@ -1154,10 +1396,11 @@ void BdEngineBackend::execQuery(DbEngineSqlQuery& query,
 
 // -------------------------------------------------------------------------------------
 
-DbEngineSqlQuery BdEngineBackend::execQuery(const QString& sql, const QMap<QString, QVariant>& bindingMap)
+QString BdEngineBackendPrivate::expandBindingMap(const QString& sql,
+                                                 const QMap<QString, QVariant>& bindingMap,
+                                                 QList<QVariant>* const valuesToBind)
 {
     QString preparedString = sql;
-    QList<QVariant> valuesToBind;
 
     if (!bindingMap.isEmpty())
     {
@@ -1199,7 +1442,7 @@ DbEngineSqlQuery BdEngineBackend::execQuery(const QString& sql, const QMap<QStri
                         const QVariant& value = iterator.value();
                         replaceStr.append(key);
                         replaceStr.append(QLatin1String("= ?"));
-                        valuesToBind.append(value);
+                        valuesToBind->append(value);
 
                         // Add a semicolon to the statement, if we are not on the last entry
                         if ((iterator+1) != placeHolderMap.constEnd())
@@ -1220,7 +1463,7 @@ DbEngineSqlQuery BdEngineBackend::execQuery(const QString& sql, const QMap<QStri
                         if (isValue)
                         {
                             replaceStr.append(QLatin1String("?"));
-                            valuesToBind.append(entry);
+                            valuesToBind->append(entry);
                         }
                         else
                         {
@@ -1246,7 +1489,7 @@ DbEngineSqlQuery BdEngineBackend::execQuery(const QString& sql, const QMap<QStri
                         if (isValue)
                         {
                             replaceStr.append(QLatin1String("?"));
-                            valuesToBind.append(entry);
+                            valuesToBind->append(entry);
                         }
                         else
                         {
@@ -1265,7 +1508,7 @@ DbEngineSqlQuery BdEngineBackend::execQuery(const QString& sql, const QMap<QStri
                     if (isValue)
                     {
                         replaceStr = QLatin1Char('?');
-                        valuesToBind.append(value);
+                        valuesToBind->append(value);
                     }
                     else
                     {
@@ -1278,7 +1521,7 @@ DbEngineSqlQuery BdEngineBackend::execQuery(const QString& sql, const QMap<QStri
 
 //                qCDebug(DIGIKAM_DBENGINE_LOG) << "Bind key ["<< namedPlaceholder << "] to value [" << bindingMap[namedPlaceholder] << "]";
 
-                valuesToBind.append(placeHolderValue);
+                valuesToBind->append(placeHolderValue);
                 replaceStr = QLatin1Char('?');
             }
 
@@ -1287,9 +1530,16 @@ DbEngineSqlQuery BdEngineBackend::execQuery(const QString& sql, const QMap<QStri
         }
     }
 
-//    qCDebug(DIGIKAM_DBENGINE_LOG) << "Prepared statement [" << preparedString << "] values [" << valuesToBind << "]";
+//    qCDebug(DIGIKAM_DBENGINE_LOG) << "Prepared statement [" << preparedString << "] values [" << *valuesToBind << "]";
+
+    return preparedString;
+}
 
-    DbEngineSqlQuery query = prepareQuery(preparedString);
+DbEngineSqlQuery BdEngineBackend::execQuery(const QString& sql, const QMap<QString, QVariant>& bindingMap)
+{
+    QList<QVariant> valuesToBind;
+    const QString preparedString = BdEngineBackendPrivate::expandBindingMap(sql, bindingMap, &valuesToBind);
+    DbEngineSqlQuery query       = prepareQuery(preparedString);
 
     for (int i = 0 ; i < valuesToBind.size() ; ++i)
     {
@@ -1422,6 +1672,7 @@ bool BdEngineBackend::transactionErrorHandling(const QSqlError& lastError, int r
 BdEngineBackend::QueryState BdEngineBackend::execDirectSql(const QString& sql)
 {
     Q_D(BdEngineBackend);
+    d->checkSchemaChange(sql);
 
     if (!d->checkOperationStatus())
     {
@@ -1458,6 +1709,7 @@ BdEngineBackend::QueryState BdEngineBackend::execDirectSqlWithResult(const QStri
                                                                      QVariant* const lastInsertId)
 {
     Q_D(BdEngineBackend);
+    d->checkSchemaChange(sql);
 
     if (!d->checkOperationStatus())
     {
@@ -1566,6 +1818,9 @@ bool BdEngineBackend::execBatch(DbEngineSqlQuery& query)
 
 DbEngineSqlQuery BdEngineBackend::prepareQuery(const QString& sql)
 {
+    Q_D(BdEngineBackend);
+    d->checkSchemaChange(sql);
+
     int retries = 0;
 
     forever
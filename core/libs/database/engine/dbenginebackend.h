@@ -199,6 +199,13 @@ public:
         return (status() == OpenSchemaChecked);
     }
 
+    /**
+     * Returns true if the SQLite database file uses the write-ahead log,
+     * which lets connections of other threads read while one thread writes.
+     * Always false for MySQL and for SQLite files on network file systems.
+     */
+    bool usesWriteAheadLog() const;
+
     /**
      * Add a DbEngineErrorHandler. This object must be created in the main thread.
      * If a database error occurs, this object can handle problem solving and user interaction.
@@ -216,6 +223,23 @@ public:
      */
     DbType databaseType() const;
 
+    /**
+     * The execSql() methods taking the statement as string keep the prepared
+     * statements of each connection in a cache, by SQL text. Database actions
+     * are cached after their binding map was expanded.
+     * The cache is enabled by default. Call this method before any query.
+     */
+    void setQueryCacheEnabled(bool enabled);
+    bool isQueryCacheEnabled() const;
+
+    /**
+     * Returns the number of statements taken from the cache, and the number
+     * of statements prepared because they were not in the cache, since the
+     * backend was created.
+     */
+    int queryCacheHits()   const;
+    int queryCacheMisses() const;
+
     /**
      * Returns a database action with name, specified in actionName,
      * for the current database.
@@ -314,6 +338,13 @@ public:
      */
     QueryState handleQueryResult(DbEngineSqlQuery& query, QList<QVariant>* const values, QVariant* const lastInsertId);
 
+    /**
+     * Same as handleQueryResult(), for a query taken from the cache of prepared statements.
+     * The query is returned to the cache.
+     */
+    QueryState handleCachedQueryResult(const QString& sql, DbEngineSqlQuery& query,
+                                       QList<QVariant>* const values, QVariant* const lastInsertId);
+
     /**
      * Method which accepts a map for named binding.
      * For special cases it's also possible to add a DbEngineActionType which wraps another
@@ -27,7 +27,9 @@
 
 // Qt includes
 
+#include <QAtomicInt>
 #include <QHash>
+#include <QMap>
 #include <QSqlDatabase>
 #include <QThread>
 #include <QThreadStorage>
@@ -38,23 +40,56 @@
 #include "digikam_export.h"
 #include "dbengineparameters.h"
 #include "dbengineerrorhandler.h"
+#include "dbenginesqlquery.h"
 
 namespace Digikam
 {
 
+class Q_DECL_HIDDEN DbEngineCachedQuery
+{
+public:
+
+    explicit DbEngineCachedQuery(const DbEngineSqlQuery& query)
+        : query(query),
+          lastUse(0)
+    {
+    }
+
+    DbEngineSqlQuery query;
+    quint64          lastUse;
+};
+
+// -----------------------------------------------------------------------------------------
+
 class Q_DECL_HIDDEN DbEngineThreadData
 {
+public:
+
+    enum
+    {
+        /// Maximum number of prepared statements kept per connection
+        QueryCacheSize = 128
+    };
+
 public:
 
     explicit DbEngineThreadData();
     ~DbEngineThreadData();
 
     void closeDatabase();
+    void clearQueryCache();
+
+    QSqlDatabase                          database;
+    int                                   valid;
+    int                                   transactionCount;
+    QSqlError                             lastError;
 
-    QSqlDatabase database;
-    int          valid;
-    int          transactionCount;
-    QSqlError    lastError;
+    /// Prepared statements of this connection by SQL text. A statement in use is not in the cache.
+    QHash<QString, DbEngineCachedQuery*>  queryCache;
+    quint64                               queryCacheUse;
+
+    /// This compares to BdEngineBackendPrivate's schemaGeneration. If it differs, the cache is cleared.
+    int                                   schemaGeneration;
 };
 
 class DIGIKAM_EXPORT BdEngineBackendPrivate : public DbEngineErrorAnswer
@@ -73,7 +108,17 @@ public:
     void         setDatabaseErrorForThread(const QSqlError& lastError);
 
     QSqlDatabase createDatabaseConnection();
+    void setupSQLiteJournal(QSqlDatabase& database);
     void closeDatabaseForThread();
+
+    DbEngineSqlQuery takeCachedQuery(const QString& sql);
+    void             returnCachedQuery(const QString& sql, DbEngineSqlQuery& query);
+    void             checkSchemaChange(const QString& sql);
+
+    static QString expandBindingMap(const QString& sql,
+                                    const QMap<QString, QVariant>& bindingMap,
+                                    QList<QVariant>* const valuesToBind);
+
     bool incrementTransactionCount();
     bool decrementTransactionCount();
 
@@ -109,6 +154,17 @@ public:
 
     bool                                      isInTransaction;
 
+    // SQLite only: the database uses the write-ahead log, readers do not wait for writers
+    bool                                      writeAheadLog;
+
+    // Prepared statements of execSql() are kept by each thread
+    bool                                      queryCacheEnabled;
+    QAtomicInt                                queryCacheHits;
+    QAtomicInt                                queryCacheMisses;
+
+    // Increased when a statement changes the schema. Cached statements of all threads are dropped then.
+    QAtomicInt                                schemaGeneration;
+
     QString                                   backendName;
 
     DbEngineParameters                        parameters;
@@ -157,11 +157,13 @@ WeightBin::WeightBin()
 // --------------------------------------------------------------------
 
 Calculator::Calculator()
+    : m_buffer(new Unit[(NumberOfPixels >> 1) * NumberOfPixels])
 {
 }
 
 Calculator::~Calculator()
 {
+    delete [] m_buffer;
 }
 
 /** Do the Haar tensorial 2d transform itself.
@@ -214,33 +216,40 @@ void Calculator::haar2D(Unit a[])
     */
 
     // Decompose columns:
-    for (i = 0; i < NumberOfPixels; ++i)
+    // All columns are decomposed together, row by row, so that the inner loop runs
+    // over contiguous memory and can be vectorized by the compiler. Each value is
+    // computed with the same operations as in a column by column decomposition.
+    Unit C = 1;
+    int  h, h1;
+
+    for (h = NumberOfPixels; h > 1; h = h1)
     {
-        Unit C = 1;
-        int  h, h1;
+        h1 = h >> 1;
+        C *= 0.7071;       // 1/sqrt(2) = 0.7071
 
-        for (h = NumberOfPixels; h > 1; h = h1)
+        for (int k = 0; k < h1; ++k)
         {
-            int j1, j2, k;
-
-            h1 = h >> 1;
-            C *= 0.7071;       // 1/sqrt(2) = 0.7071
-
-            for (k = 0, j1 = j2 = i; k < h1; ++k, j1 += NumberOfPixels, j2 += 2*NumberOfPixels)
-            {
-                int j21 = j2+NumberOfPixels;
-                t[k]    = (a[j2] - a[j21]) * C;
-                a[j1]   = (a[j2] + a[j21]);
-            }
+            const Unit* const row0 = a + (2 * k) * NumberOfPixels;
+            const Unit* const row1 = row0 + NumberOfPixels;
+            Unit* const       sum  = a + k * NumberOfPixels;
+            Unit* const       diff = m_buffer + k * NumberOfPixels;
 
-            // Write back subtraction results:
-            for (k = 0, j1 = i+h1*NumberOfPixels; k < h1; ++k, j1 += NumberOfPixels)
+            for (int j = 0; j < NumberOfPixels; ++j)
             {
-                a[j1] = t[k];
+                const Unit x0 = row0[j];
+                const Unit x1 = row1[j];
+                diff[j]       = (x0 - x1) * C;
+                sum[j]        = (x0 + x1);
             }
         }
 
-        // Fix first element of each column:
+        // Write back subtraction results:
+        memcpy(a + h1 * NumberOfPixels, m_buffer, h1 * NumberOfPixels * sizeof(a[0]));
+    }
+
+    // Fix first element of each column:
+    for (i = 0; i < NumberOfPixels; ++i)
+    {
         a[i] *= C;
     }
 }
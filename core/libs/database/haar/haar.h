@@ -38,6 +38,10 @@
 
 #include <QtGlobal>
 
+// Local includes
+
+#include "digikam_export.h"
+
 class QImage;
 
 namespace Digikam
@@ -181,7 +185,7 @@ public:
 
 // ---------------------------------------------------------------------------------
 
-class WeightBin
+class DIGIKAM_DATABASE_EXPORT WeightBin
 {
 public:
 
@@ -256,8 +260,17 @@ public:
 
 private:
 
+    // Disable
+    Calculator(const Calculator&);
+    Calculator& operator=(const Calculator&);
+
     void        haar2D(Unit a[]);
     inline void getmLargests(Unit* const cdata, Idx* const sig);
+
+private:
+
+    /// Differences of one level of the column decomposition, NumberOfPixels / 2 rows
+    Unit* const m_buffer;
 };
 
 } // namespace Haar
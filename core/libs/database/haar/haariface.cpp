@@ -37,13 +37,23 @@
 
 #include <QByteArray>
 #include <QDataStream>
+#include <QDir>
 #include <QImage>
 #include <QImageReader>
 #include <QMap>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QAtomicInt>
+#include <QSharedPointer>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent>    // krazy:exclude=includes
 
 // Local includes
 
 #include "digikam_debug.h"
+#include "haarindex.h"
+#include "haarstore.h"
 #include "jpegutils.h"
 #include "dimg.h"
 #include "iteminfo.h"
@@ -52,6 +62,7 @@
 #include "coredb.h"
 #include "coredbbackend.h"
 #include "coredbsearchxml.h"
+#include "coredbwatch.h"
 #include "dbenginesqlquery.h"
 #include "similaritydb.h"
 #include "similaritydbaccess.h"
@@ -63,9 +74,6 @@ using namespace std;
 namespace Digikam
 {
 
-typedef QMap<qlonglong, Haar::SignatureData> SignatureCache;
-typedef QMap<qlonglong, int>                 AlbumCache;
-
 /** This class encapsulates the Haar signature in a QByteArray
  *  that can be stored as a BLOB in the database.
  *
@@ -86,8 +94,9 @@ public:
     DatabaseBlob() = default;
 
     /** Read the QByteArray into the Haar::SignatureData.
+     *  Returns false if the blob has an unsupported version.
      */
-    void read(const QByteArray& array, Haar::SignatureData* const data)
+    bool read(const QByteArray& array, Haar::SignatureData* const data)
     {
         QDataStream stream(array);
 
@@ -98,7 +107,7 @@ public:
         if (version != Version)
         {
             qCDebug(DIGIKAM_DATABASE_LOG) << "Unsupported binary version of Haar Blob in database";
-            return;
+            return false;
         }
 
         stream.setVersion(QDataStream::Qt_4_3);
@@ -117,6 +126,8 @@ public:
                 stream >> data->sig[i][j];
             }
         }
+
+        return true;
     }
 
     QByteArray write(Haar::SignatureData* const data)
@@ -150,6 +161,148 @@ public:
 
 // -----------------------------------------------------------------------------------------------------
 
+/** The album and album root of each signature of a store, read from the core database
+ *  with a single query. Entries of images which are not visible have an album id of -1.
+ *  This replaces an ItemInfo lookup for each signature during a search.
+ */
+class Q_DECL_HIDDEN ItemAlbumSnapshot
+{
+public:
+
+    explicit ItemAlbumSnapshot(const Haar::SignatureStore& store)
+        : m_albumIds(store.count(), -1),
+          m_albumRootIds(store.count(), -1)
+    {
+        CoreDbAccess access;
+
+        // Both the store and the result are sorted by image id, so they are merged in one pass.
+        DbEngineSqlQuery query = access.backend()->prepareQuery(QString::fromUtf8("SELECT Images.id, Images.album, Albums.albumRoot FROM Images "
+                                                                                  "INNER JOIN Albums ON Images.album=Albums.id "
+                                                                                  "WHERE Images.status=? "
+                                                                                  "ORDER BY Images.id;"));
+        query.addBindValue((int)DatabaseItem::Visible);
+
+        if (!access.backend()->exec(query))
+        {
+            return;
+        }
+
+        int pos = 0;
+
+        while (pos < store.count() && query.next())
+        {
+            qlonglong imageid = query.value(0).toLongLong();
+
+            while (pos < store.count() && store.imageId(pos) < imageid)
+            {
+                ++pos;
+            }
+
+            if (pos < store.count() && store.imageId(pos) == imageid)
+            {
+                m_albumIds[pos]     = query.value(1).toInt();
+                m_albumRootIds[pos] = query.value(2).toInt();
+                ++pos;
+            }
+        }
+    }
+
+    bool isVisible(int position) const
+    {
+        return (m_albumIds.at(position) != -1);
+    }
+
+    int albumId(int position) const
+    {
+        return m_albumIds.at(position);
+    }
+
+    int albumRootId(int position) const
+    {
+        return m_albumRootIds.at(position);
+    }
+
+private:
+
+    QVector<int> m_albumIds;
+    QVector<int> m_albumRootIds;
+};
+
+// -----------------------------------------------------------------------------------------------------
+
+/** The signature store and its album snapshot are shared by all HaarIface instances.
+ *  The store is reloaded when the fingerprints in the database change, the snapshot
+ *  when the store is reloaded or when images change their album or status.
+ */
+class Q_DECL_HIDDEN SignatureStoreCache
+{
+public:
+
+    SignatureStoreCache()
+      : saved(true),
+        updates(0),
+        albumsChanges(0),
+        watch(nullptr)
+    {
+    }
+
+public:
+
+    QMutex                                     mutex;
+    QSharedPointer<const Haar::SignatureStore> store;
+
+    /// False if the store was loaded while the cache file writes were deferred
+    bool                                       saved;
+
+    /// Number of running beginSignatureUpdates() calls
+    int                                        updates;
+
+    QSharedPointer<const ItemAlbumSnapshot>    albums;
+    QSharedPointer<const Haar::SignatureStore> albumsStore;
+    int                                        albumsChanges;
+
+    /// Incremented with each change of the core database which outdates the snapshot
+    QAtomicInt                                 coreChanges;
+    CoreDbWatch*                               watch;
+};
+
+Q_GLOBAL_STATIC(SignatureStoreCache, signatureStoreCache)
+
+static void onCoreDatabaseChanged()
+{
+    signatureStoreCache->coreChanges.ref();
+}
+
+static void onImageChange(const ImageChangeset& changeset)
+{
+    DatabaseFields::Set set = changeset.changes();
+
+    if ((set & DatabaseFields::Album) || (set & DatabaseFields::Status))
+    {
+        signatureStoreCache->coreChanges.ref();
+    }
+}
+
+static void onCollectionImageChange(const CollectionImageChangeset&)
+{
+    signatureStoreCache->coreChanges.ref();
+}
+
+static void onAlbumChange(const AlbumChangeset& changeset)
+{
+    if (changeset.operation() != AlbumChangeset::PropertiesChanged)
+    {
+        signatureStoreCache->coreChanges.ref();
+    }
+}
+
+static void onAlbumRootChange(const AlbumRootChangeset&)
+{
+    signatureStoreCache->coreChanges.ref();
+}
+
+// -----------------------------------------------------------------------------------------------------
+
 class Q_DECL_HIDDEN HaarIface::Private
 {
 public:
@@ -158,19 +311,17 @@ public:
     {
         data                       = nullptr;
         bin                        = nullptr;
-        signatureCache             = nullptr;
-        albumCache                 = nullptr;
-        useSignatureCache          = false;
+        signatureIndex             = nullptr;
+        threads                    = 0;
 
-        signatureQuery             = QString::fromUtf8("SELECT M.imageid, M.matrix FROM ImageHaarMatrix AS M;");
+        threadPool.setMaxThreadCount(numberOfThreads());
     }
 
     ~Private()
     {
         delete data;
         delete bin;
-        delete signatureCache;
-        delete albumCache;
+        delete signatureIndex;
     }
 
     void createLoadingBuffer()
@@ -189,94 +340,206 @@ public:
         }
     }
 
-    void setSignatureCacheEnabled(bool cache, const QSet<qlonglong>& imageIds)
+    /** Creates an inverted index of the signatures of the given images for fast lookup.
+     *  An empty set will index all signatures.
+     */
+    void createSignatureIndex(const QSet<qlonglong>& imageIds)
     {
-        setSignatureCacheEnabled(cache);
+        QSharedPointer<const Haar::SignatureStore> store = signatureStore();
+
+        delete signatureIndex;
+        signatureIndex = new Haar::SignatureIndex(store);
 
-        // stop here if we disable cached signatures
-        if (!cache || imageIds.isEmpty())
+        QSharedPointer<const ItemAlbumSnapshot> albums = albumSnapshot(store);
+
+        for (int pos = 0; pos < store->count(); ++pos)
         {
-            return;
+            if (!imageIds.isEmpty() && !imageIds.contains(store->imageId(pos)))
+            {
+                continue;
+            }
+
+            if (albums->isVisible(pos))
+            {
+                signatureIndex->add(pos, albums->albumId(pos));
+            }
+        }
+
+        signatureIndex->build();
+
+        // One set of scratch buffers per worker thread
+        accumulators.resize(numberOfThreads());
+    }
+
+    void removeSignatureIndex()
+    {
+        delete signatureIndex;
+        signatureIndex = nullptr;
+        accumulators.clear();
+    }
+
+    int numberOfThreads() const
+    {
+        return (threads > 0) ? threads : qMax(QThread::idealThreadCount(), 1);
+    }
+
+    /** Returns the store with all signatures from the similarity database.
+     *  If possible, the store is mapped from a cache file next to the database.
+     */
+    static QSharedPointer<const Haar::SignatureStore> signatureStore()
+    {
+        SimilarityDbAccess access;
+        QString revision = access.db()->getFingerprintsRevision();
+
+        // A database without revision may have been recreated.
+        // Set a new one so that no outdated cache file is used.
+        if (revision.isEmpty())
+        {
+            access.db()->updateFingerprintsRevision();
+            revision = access.db()->getFingerprintsRevision();
         }
 
-        // Remove all ids from the fully created signatureCache that are not needed for the duplicates search.
-        // This is usually faster then starting a query for every single id in imageIds.
-        for (SignatureCache::iterator it = signatureCache->begin();
-             it != signatureCache->end(); )
+        QMutexLocker locker(&signatureStoreCache->mutex);
+
+        if (signatureStoreCache->store && signatureStoreCache->store->revision() == revision)
         {
-            if (!imageIds.contains(it.key()))
+            return signatureStoreCache->store;
+        }
+
+        Haar::SignatureStore* const store = new Haar::SignatureStore;
+        QString cacheFile                 = signatureCacheFile();
+
+        signatureStoreCache->saved        = true;
+
+        if (cacheFile.isEmpty() || !store->load(cacheFile) || store->revision() != revision)
+        {
+            store->clear();
+            loadSignatures(store);
+            store->setRevision(revision);
+
+            // While signatures are stored in batches, the file is written once at the end
+
+            if (signatureStoreCache->updates)
             {
-                it = signatureCache->erase(it);
+                signatureStoreCache->saved = false;
             }
-            else
+            else if (!cacheFile.isEmpty())
             {
-                ++it;
+                store->save(cacheFile);
             }
         }
+
+        signatureStoreCache->store = QSharedPointer<const Haar::SignatureStore>(store);
+
+        return signatureStoreCache->store;
     }
 
-    void setSignatureCacheEnabled(bool cache)
+    /** Returns the album snapshot of the store. It is read from the core database
+     *  only if the store was reloaded or the albums or status of images changed.
+     */
+    static QSharedPointer<const ItemAlbumSnapshot> albumSnapshot(const QSharedPointer<const Haar::SignatureStore>& store)
     {
-        delete signatureCache;
-        signatureCache = nullptr;
-        delete albumCache;
-        albumCache     = nullptr;
+        CoreDbWatch* const watch = CoreDbAccess::databaseWatch();
+        int changes              = 0;
 
-        if (cache)
         {
-            signatureCache = new SignatureCache();
-            albumCache     = new AlbumCache();
+            QMutexLocker locker(&signatureStoreCache->mutex);
+
+            if (watch && signatureStoreCache->watch != watch)
+            {
+                // The local signals, called in the thread which changed the database
+
+                QObject::connect(watch, &CoreDbWatch::databaseChanged, &onCoreDatabaseChanged);
+
+                QObject::connect(watch, static_cast<void (CoreDbWatch::*)(const ImageChangeset&)>(&CoreDbWatch::imageChange),
+                                 &onImageChange);
+
+                QObject::connect(watch, static_cast<void (CoreDbWatch::*)(const CollectionImageChangeset&)>(&CoreDbWatch::collectionImageChange),
+                                 &onCollectionImageChange);
+
+                QObject::connect(watch, static_cast<void (CoreDbWatch::*)(const AlbumChangeset&)>(&CoreDbWatch::albumChange),
+                                 &onAlbumChange);
+
+                QObject::connect(watch, static_cast<void (CoreDbWatch::*)(const AlbumRootChangeset&)>(&CoreDbWatch::albumRootChange),
+                                 &onAlbumRootChange);
+
+                signatureStoreCache->watch = watch;
+                signatureStoreCache->coreChanges.ref();
+            }
+
+            changes = signatureStoreCache->coreChanges.load();
+
+            if (watch                                              &&
+                signatureStoreCache->albums                        &&
+                signatureStoreCache->albumsStore   == store        &&
+                signatureStoreCache->albumsChanges == changes)
+            {
+                return signatureStoreCache->albums;
+            }
         }
-        useSignatureCache = cache;
 
-        // stop here if we disable cached signatures
-        if (!cache)
+        // Read without the mutex, the core database is locked meanwhile.
+        // A change during the query outdates the snapshot by its counter.
+
+        QSharedPointer<const ItemAlbumSnapshot> albums(new ItemAlbumSnapshot(*store));
+
+        QMutexLocker locker(&signatureStoreCache->mutex);
+
+        signatureStoreCache->albums        = albums;
+        signatureStoreCache->albumsStore   = store;
+        signatureStoreCache->albumsChanges = changes;
+
+        return albums;
+    }
+
+    /** The cache file is only used with a SQLite similarity database.
+     */
+    static QString signatureCacheFile()
+    {
+        DbEngineParameters params = SimilarityDbAccess::parameters();
+
+        if (!params.isSQLite())
         {
-            return;
+            return QString();
         }
 
-        // Variables for data read from DB
-        SimilarityDbAccess  similarityDbAccess;
+        return QDir(params.getSimilarityDatabaseNameOrDir()).filePath(QLatin1String("similarity-haar.cache"));
+    }
+
+    static void loadSignatures(Haar::SignatureStore* const store)
+    {
+        SimilarityDbAccess  access;
         DatabaseBlob        blob;
-        qlonglong           imageid;
-        int                 albumid;
         Haar::SignatureData targetSig;
 
-        // reference for easier access
-        SignatureCache& signatureCache = *this->signatureCache;
-        AlbumCache&     albumCache     = *this->albumCache;
-
-        DbEngineSqlQuery query = similarityDbAccess.backend()->prepareQuery(signatureQuery);
+        // We don't use SimilarityDb's convenience calls, as the result set is large
+        // and we try to avoid copying in a temporary QList<QVariant>
+        DbEngineSqlQuery query = access.backend()->prepareQuery(QString::fromUtf8("SELECT M.imageid, M.matrix FROM ImageHaarMatrix AS M "
+                                                                                  "ORDER BY M.imageid;"));
 
-        if (!similarityDbAccess.backend()->exec(query))
+        if (!access.backend()->exec(query))
         {
             return;
         }
 
         while (query.next())
         {
-            imageid = query.value(0).toLongLong();
-
-            // Get the album id and status of the item with the ItemInfo.
-            ItemInfo info(imageid);
-            if (!info.isNull() && info.isVisible())
+            if (blob.read(query.value(1).toByteArray(), &targetSig))
             {
-                blob.read(query.value(1).toByteArray(), &targetSig);
-                albumid = info.albumId();
-                signatureCache[imageid] = targetSig;
-                albumCache[imageid]     = albumid;
+                store->append(query.value(0).toLongLong(), targetSig);
             }
         }
     }
 
-    bool             useSignatureCache;
-    Haar::ImageData* data;
-    Haar::WeightBin* bin;
-    SignatureCache*  signatureCache;
-    AlbumCache*      albumCache;
+    Haar::ImageData*                              data;
+    Haar::WeightBin*                              bin;
+    Haar::SignatureIndex*                         signatureIndex;
+    QVector<Haar::SignatureIndex::Accumulator>    accumulators;
 
-    QString          signatureQuery;
-    QSet<int>        albumRootsToSearch;
+    QSet<int>                                     albumRootsToSearch;
+
+    int                                           threads;
+    QThreadPool                                   threadPool;
 };
 
 HaarIface::HaarIface()
@@ -299,11 +562,39 @@ void HaarIface::setAlbumRootsToSearch(QSet<int> albumRootIds)
     d->albumRootsToSearch = albumRootIds;
 }
 
+void HaarIface::setNumberOfThreads(int count)
+{
+    d->threads = qMax(count, 0);
+    d->threadPool.setMaxThreadCount(d->numberOfThreads());
+}
+
+int HaarIface::numberOfThreads() const
+{
+    return d->numberOfThreads();
+}
+
 int HaarIface::preferredSize()
 {
     return Haar::NumberOfPixels;
 }
 
+DImg HaarIface::preferredImage(const DImg& image)
+{
+    // Same rule as the scaling of a fast preview loaded at preferredSize()
+
+    const int size = preferredSize();
+
+    if (image.isNull() || (qMax(image.width(), image.height()) < lround(1.25 * (double)size)))
+    {
+        return image;
+    }
+
+    QSize scaledSize = image.size();
+    scaledSize.scale(size, size, Qt::KeepAspectRatio);
+
+    return image.smoothScale(scaledSize.width(), scaledSize.height());
+}
+
 bool HaarIface::indexImage(const QString& filename)
 {
     QImage image = loadQImage(filename);
@@ -375,26 +666,111 @@ bool HaarIface::indexImage(qlonglong imageid)
     Haar::SignatureData sig;
     haar.calcHaar(d->data, &sig);
 
-    SimilarityDbAccess access;
+    // prepare blob
+    DatabaseBlob blob;
+    QMap<qlonglong, QByteArray> signatures;
+    signatures.insert(imageid, blob.write(&sig));
 
     // Store main entry
+    storeSignatures(signatures);
+
+    return true;
+}
+
+QByteArray HaarIface::signatureData(const DImg& image)
+{
+    if (image.isNull())
+    {
+        return QByteArray();
+    }
+
+    d->createLoadingBuffer();
+    d->data->fillPixelData(image);
+
+    Haar::Calculator haar;
+    haar.transform(d->data);
+
+    Haar::SignatureData sig;
+    haar.calcHaar(d->data, &sig);
+
+    DatabaseBlob blob;
+
+    return blob.write(&sig);
+}
+
+int HaarIface::storeSignatures(const QMap<qlonglong, QByteArray>& signatures)
+{
+    if (signatures.isEmpty())
     {
-        // prepare blob
-        DatabaseBlob blob;
-        QByteArray array = blob.write(&sig);
+        return 0;
+    }
 
-        ItemInfo info(imageid);
+    int count = 0;
+    SimilarityDbAccess access;
+    access.backend()->beginTransaction();
 
-        if (!info.isNull() && info.isVisible()) {
+    for (QMap<qlonglong, QByteArray>::const_iterator it = signatures.constBegin() ;
+         it != signatures.constEnd() ; ++it)
+    {
+        ItemInfo info(it.key());
 
-            access.backend()->execSql(QString::fromUtf8("REPLACE INTO ImageHaarMatrix "
-                                                                " (imageid, modificationDate, uniqueHash, matrix) "
-                                                                " VALUES(?, ?, ?, ?);"),
-                                      imageid, info.modDateTime(), info.uniqueHash(), array);
+        if (info.isNull() || !info.isVisible() || it.value().isEmpty())
+        {
+            continue;
         }
+
+        access.backend()->execSql(QString::fromUtf8("REPLACE INTO ImageHaarMatrix "
+                                                    " (imageid, modificationDate, uniqueHash, matrix) "
+                                                    " VALUES(?, ?, ?, ?);"),
+                                  it.key(), info.modDateTime(), info.uniqueHash(), it.value());
+        ++count;
     }
 
-    return true;
+    // One new revision for the whole batch, so that the signature store is reloaded once
+
+    if (count)
+    {
+        access.db()->updateFingerprintsRevision();
+    }
+
+    access.backend()->commitTransaction();
+
+    return count;
+}
+
+void HaarIface::beginSignatureUpdates()
+{
+    QMutexLocker locker(&signatureStoreCache->mutex);
+    ++signatureStoreCache->updates;
+}
+
+void HaarIface::endSignatureUpdates()
+{
+    QString revision;
+
+    {
+        SimilarityDbAccess access;
+        revision = access.db()->getFingerprintsRevision();
+    }
+
+    QMutexLocker locker(&signatureStoreCache->mutex);
+
+    if (--signatureStoreCache->updates > 0 || signatureStoreCache->saved)
+    {
+        return;
+    }
+
+    // A store loaded during the updates is written if it is still current,
+    // otherwise the next load writes the file.
+
+    const QString cacheFile = Private::signatureCacheFile();
+
+    if (!cacheFile.isEmpty() && signatureStoreCache->store &&
+        signatureStoreCache->store->revision() == revision)
+    {
+        signatureStoreCache->store->save(cacheFile);
+        signatureStoreCache->saved = true;
+    }
 }
 
 QString HaarIface::signatureAsText(const QImage& image)
@@ -468,24 +844,25 @@ QPair<double,QMap<qlonglong,double>> HaarIface::bestMatchesForImageWithThreshold
                                                              double maximumPercentage, QList<int>& targetAlbums,
                                                              DuplicatesSearchRestrictions searchResultRestriction, SketchType type)
 {
-    if ( !d->useSignatureCache || (d->signatureCache->isEmpty() && d->useSignatureCache) )
+    Haar::SignatureData sig;
+
+    if (d->signatureIndex)
     {
-        Haar::SignatureData sig;
+        int position = d->signatureIndex->position(imageid);
 
-        if (!retrieveSignatureFromDB(imageid, &sig))
+        if (position == -1)
         {
             return QPair<double,QMap<qlonglong,double>>();
         }
 
-        return bestMatchesWithThreshold(imageid, &sig, requiredPercentage, maximumPercentage, targetAlbums, searchResultRestriction, type);
+        d->signatureIndex->signature(position, &sig);
     }
-    else
+    else if (!retrieveSignatureFromDB(imageid, &sig))
     {
-        // reference for easier access
-        SignatureCache& signatureCache = *d->signatureCache;
-        Haar::SignatureData& sig       = signatureCache[imageid];
-        return bestMatchesWithThreshold(imageid, &sig, requiredPercentage, maximumPercentage, targetAlbums, searchResultRestriction, type);
+        return QPair<double,QMap<qlonglong,double>>();
     }
+
+    return bestMatchesWithThreshold(imageid, &sig, requiredPercentage, maximumPercentage, targetAlbums, searchResultRestriction, type);
 }
 
 QList<qlonglong> HaarIface::bestMatchesForFile(const QString& filename, QList<int>& targetAlbums, int numberOfResults, SketchType type)
@@ -506,7 +883,11 @@ QMap<qlonglong,double> HaarIface::bestMatchesForSignature(const QString& signatu
 
     DatabaseBlob blobReader;
     Haar::SignatureData sig;
-    blobReader.read(bytes, &sig);
+
+    if (!blobReader.read(bytes, &sig))
+    {
+        return QMap<qlonglong, double>();
+    }
 
     // Get all matching images with their score and save their similarity to the signature, i.e. id -2
     QMultiMap<double,qlonglong> matches = bestMatches(&sig, numberOfResults, targetAlbums, type);
@@ -582,7 +963,19 @@ QPair<double,QMap<qlonglong,double>> HaarIface::bestMatchesWithThreshold(qlonglo
                                                                          SketchType type)
 {
     int albumId = CoreDbAccess().db()->getItemAlbum(imageid);
-    QMap<qlonglong, double> scores = searchDatabase(querySig, type, targetAlbums, searchResultRestriction, imageid, albumId);
+
+    QMap<qlonglong, double> bestMatches = matchesWithThreshold(imageid, albumId, querySig, requiredPercentage, maximumPercentage,
+                                                               targetAlbums, searchResultRestriction, type,
+                                                               d->accumulators.isEmpty() ? nullptr : &d->accumulators[0]);
+
+    return storeMatches(imageid, bestMatches);
+}
+
+QMap<qlonglong, double> HaarIface::matchesWithThreshold(qlonglong imageid, int albumId, Haar::SignatureData* const querySig,
+                                                        double requiredPercentage, double maximumPercentage,
+                                                        QList<int>& targetAlbums, DuplicatesSearchRestrictions searchResultRestriction,
+                                                        SketchType type, Haar::SignatureIndex::Accumulator* const accumulator)
+{
     double lowest, highest;
     getBestAndWorstPossibleScore(querySig, type, &lowest, &highest);
     // The range between the highest (worst) and lowest (best) score
@@ -600,11 +993,15 @@ QPair<double,QMap<qlonglong,double>> HaarIface::bestMatchesWithThreshold(qlonglo
     // with similarity 50,x.
     double supremum = (floor(maximumPercentage*100 + 1.0))/100;
 
+    // With an inverted index, only the images which can reach the required score are scored at all.
+    QMap<qlonglong, double> scores = (d->signatureIndex && accumulator) ? searchIndex(querySig, type, targetAlbums, requiredScore, *accumulator,
+                                                                                      searchResultRestriction, imageid, albumId)
+                                                                        : searchDatabase(querySig, type, targetAlbums,
+                                                                                         searchResultRestriction, imageid, albumId);
+
     QMap<qlonglong, double> bestMatches;
-    double score, percentage, avgPercentage = 0.0;
-    QPair<double,QMap<qlonglong,double>> result;
-    qlonglong           id;
-    SimilarityDbAccess  access;
+    double score, percentage;
+    qlonglong id;
 
     for (QMap<qlonglong, double>::const_iterator it = scores.constBegin(); it != scores.constEnd(); ++it)
     {
@@ -619,21 +1016,34 @@ QPair<double,QMap<qlonglong,double>> HaarIface::bestMatchesWithThreshold(qlonglo
             if ((id == imageid) || (percentage < supremum))
             {
                 bestMatches.insert(id, percentage);
-                // If the current image is not the original, use the images similarity for the average percentage
-                // Also, save the similarity of the found image to the original image.
-                if (id != imageid)
-                {
-                    // Store the similarity if the reference image has a valid image id
-                    if (imageid > 0)
-                    {
-                        access.db()->setImageSimilarity(id,imageid,percentage);
-                    }
-                    avgPercentage += percentage;
-                }
             }
         }
     }
 
+    return bestMatches;
+}
+
+QPair<double,QMap<qlonglong,double>> HaarIface::storeMatches(qlonglong imageid, const QMap<qlonglong, double>& bestMatches)
+{
+    double avgPercentage = 0.0;
+    QPair<double,QMap<qlonglong,double>> result;
+    SimilarityDbAccess  access;
+
+    for (QMap<qlonglong, double>::const_iterator it = bestMatches.constBegin(); it != bestMatches.constEnd(); ++it)
+    {
+        // If the current image is not the original, use the images similarity for the average percentage
+        // Also, save the similarity of the found image to the original image.
+        if (it.key() != imageid)
+        {
+            // Store the similarity if the reference image has a valid image id
+            if (imageid > 0)
+            {
+                access.db()->setImageSimilarity(it.key(), imageid, it.value());
+            }
+            avgPercentage += it.value();
+        }
+    }
+
     // Debug output
     if (bestMatches.count() > 1)
     {
@@ -683,112 +1093,198 @@ QMap<qlonglong, double> HaarIface::searchDatabase(Haar::SignatureData* const que
     // The table of constant weight factors applied to each channel and bin
     Haar::Weights weights((Haar::Weights::SketchType)type);
 
-    // layout the query signature for fast lookup
-    Haar::SignatureMap queryMapY, queryMapI, queryMapQ;
-    queryMapY.fill(querySig->sig[0]);
-    queryMapI.fill(querySig->sig[1]);
-    queryMapQ.fill(querySig->sig[2]);
-    Haar::SignatureMap* queryMaps[3] = { &queryMapY, &queryMapI, &queryMapQ };
-
     // Map imageid -> score. Lowest score is best.
-    // any newly inserted value will be initialized with a score of 0, as required
     QMap<qlonglong, double> scores;
 
-    // Variables for data read from DB
-    SimilarityDbAccess  access;
-    DatabaseBlob        blob;
-    qlonglong           imageid;
-    int                 albumid;
-    Haar::SignatureData targetSig;
-
-    // reference for easier access
-    SignatureCache& signatureCache = *d->signatureCache;
-    AlbumCache&     albumCache     = *d->albumCache;
+    QSharedPointer<const Haar::SignatureStore> store = d->signatureStore();
+    QVector<int>                               positions;
+    qlonglong                                  imageid;
 
     bool filterByAlbumRoots = !d->albumRootsToSearch.isEmpty();
 
-    // if no cache is used or the cache signature map is empty, query the database
-    if (!d->useSignatureCache || (signatureCache.isEmpty() && d->useSignatureCache))
+    // The album id, album root id and status of all items, read at once.
+    QSharedPointer<const ItemAlbumSnapshot> albums = d->albumSnapshot(store);
+
+    positions.reserve(store->count());
+
+    for (int pos = 0; pos < store->count(); ++pos)
     {
-        DbEngineSqlQuery query = access.backend()->prepareQuery(d->signatureQuery);
+        if (!albums->isVisible(pos))
+        {
+            continue;
+        }
 
-        if (!access.backend()->exec(query))
+        if (filterByAlbumRoots && !d->albumRootsToSearch.contains(albums->albumRootId(pos)))
         {
-            return scores;
+            continue;
         }
 
-        // We don't use SimilarityDb's convenience calls, as the result set is large
-        // and we try to avoid copying in a temporary QList<QVariant>
-        int albumRootId = 0;
+        imageid = store->imageId(pos);
 
-        while (query.next())
+        // If the image is the original one or
+        // No restrictions apply or
+        // SameAlbum restriction applies and the albums are equal or
+        // DifferentAlbum restriction applies and the albums differ
+        // then calculate the score.
+        // Also, restrict to target album
+        if ( fulfillsRestrictions(imageid, albums->albumId(pos), originalImageId, originalAlbumId, targetAlbums, searchResultRestriction) )
         {
-            imageid = query.value(0).toLongLong();
+            positions << pos;
+        }
+    }
 
-            // Get the album id, album root id and status of the item with the ItemInfo.
-            ItemInfo info(imageid);
-            if (!info.isNull() && info.isVisible())
-            {
-                if (filterByAlbumRoots)
-                {
-                    albumRootId = info.albumRootId();
+    // Score all selected signatures in one pass over the store.
+    // Large sets are split in ranges scored in parallel, each writing its own part of the results.
+    QVector<double>  results(positions.size());
+    Haar::ScoreTable query(*querySig, weights, *d->bin);
+    const int        count   = positions.size();
+    const int        threads = qMin(d->numberOfThreads(), count / 1000 + 1);
 
-                    if (!d->albumRootsToSearch.contains(albumRootId))
-                    {
-                        continue;
-                    }
-                }
+    if (threads <= 1)
+    {
+        store->calculateScores(query, positions.constData(), count, results.data());
+    }
+    else
+    {
+        const int chunk = (count + threads - 1) / threads;
+        QList<QFuture<void> > tasks;
 
-                blob.read(query.value(1).toByteArray(), &targetSig);
-                albumid = info.albumId();
+        for (int start = 0; start < count; start += chunk)
+        {
+            tasks.append(QtConcurrent::run(&d->threadPool,
+                                           store.data(),
+                                           &Haar::SignatureStore::calculateScores,
+                                           query,
+                                           positions.constData() + start,
+                                           qMin(chunk, count - start),
+                                           results.data() + start
+                                          ));
+        }
 
-                if (d->useSignatureCache)
-                {
-                    signatureCache[imageid] = targetSig;
-                    albumCache[imageid]     = albumid;
-                }
+        foreach (QFuture<void> t, tasks)
+        {
+            t.waitForFinished();
+        }
+    }
 
-                // If the image is the original one or
-                // No restrictions apply or
-                // SameAlbum restriction applies and the albums are equal or
-                // DifferentAlbum restriction applies and the albums differ
-                // then calculate the score.
-                // Also, restrict to target album
-                if ( fulfillsRestrictions(imageid, albumid, originalImageId, originalAlbumId, targetAlbums, searchResultRestriction) )
-                {
-                    double&              score = scores[imageid];
-                    Haar::SignatureData& qSig  = *querySig;
-                    Haar::SignatureData& tSig  = targetSig;
+    for (int i = 0; i < positions.size(); ++i)
+    {
+        scores.insert(store->imageId(positions.at(i)), results.at(i));
+    }
 
-                    score = calculateScore(qSig, tSig, weights, queryMaps);
-                }
-            }
+    return scores;
+}
+
+QMap<qlonglong, double> HaarIface::searchIndex(Haar::SignatureData* const querySig, SketchType type, QList<int>& targetAlbums,
+                                               double maximumScore, Haar::SignatureIndex::Accumulator& accumulator,
+                                               DuplicatesSearchRestrictions searchResultRestriction,
+                                               qlonglong originalImageId, int originalAlbumId)
+{
+    // Called from the worker threads, the bin is created by findDuplicates() before.
+    Q_ASSERT(d->bin);
+
+    Haar::Weights weights((Haar::Weights::SketchType)type);
+
+    QMap<qlonglong, double> scores;
+    QVector<int>            storePositions;
+    qlonglong               imageid;
+    int                     albumid;
+
+    // The index only returns the images which can reach the maximum score.
+    foreach (int position, d->signatureIndex->candidates(*querySig, weights, *d->bin, maximumScore, accumulator))
+    {
+        imageid = d->signatureIndex->imageId(position);
+        albumid = d->signatureIndex->albumId(position);
+
+        if ( fulfillsRestrictions(imageid, albumid, originalImageId, originalAlbumId, targetAlbums, searchResultRestriction) )
+        {
+            storePositions << d->signatureIndex->storePosition(position);
         }
     }
-    // read cached signature map if possible
-    else
+
+    // Their exact score is calculated the same way as in searchDatabase(),
+    // with the score table of the worker thread.
+    const Haar::SignatureStore* const store = d->signatureIndex->store();
+    QVector<double> results(storePositions.size());
+    accumulator.scores.setQuery(*querySig, weights, *d->bin);
+    store->calculateScores(accumulator.scores,
+                           storePositions.constData(), storePositions.size(), results.data());
+
+    for (int i = 0; i < storePositions.size(); ++i)
     {
-        foreach (const qlonglong& imageid, signatureCache.keys())
-        {
-            albumid = albumCache[imageid];
-
-            // If the image is the original one or
-            // No restrictions apply or
-            // SameAlbum restriction applies and the albums are equal or
-            // DifferentAlbum restriction applies and the albums differ
-            // then calculate the score.
-            if ( fulfillsRestrictions(imageid, albumid, originalImageId, originalAlbumId, targetAlbums, searchResultRestriction) )
-            {
-                double& score              = scores[imageid];
-                Haar::SignatureData& qSig  = *querySig;
-                Haar::SignatureData& tSig  = signatureCache[imageid];
+        scores.insert(store->imageId(storePositions.at(i)), results.at(i));
+    }
 
-                score = calculateScore(qSig, tSig, weights, queryMaps);
-            }
+    return scores;
+}
+
+QList<QMap<qlonglong, double> > HaarIface::searchIndexBatch(const QList<qlonglong>& imageIds,
+                                                            double requiredPercentage, double maximumPercentage,
+                                                            DuplicatesSearchRestrictions searchResultRestriction,
+                                                            Haar::SignatureIndex::Accumulator* const accumulator)
+{
+    QList<QMap<qlonglong, double> > results;
+    QList<int>                      targetAlbums;
+    Haar::SignatureData             sig;
+
+    foreach (const qlonglong& imageid, imageIds)
+    {
+        int position = d->signatureIndex->position(imageid);
+
+        if (position == -1)
+        {
+            results << QMap<qlonglong, double>();
+            continue;
         }
+
+        d->signatureIndex->signature(position, &sig);
+        results << matchesWithThreshold(imageid, d->signatureIndex->albumId(position), &sig,
+                                        requiredPercentage, maximumPercentage, targetAlbums,
+                                        searchResultRestriction, ScannedSketch, accumulator);
     }
 
-    return scores;
+    return results;
+}
+
+QList<QMap<qlonglong, double> > HaarIface::searchIndexParallel(const QList<qlonglong>& imageIds,
+                                                               double requiredPercentage, double maximumPercentage,
+                                                               DuplicatesSearchRestrictions searchResultRestriction)
+{
+    Q_ASSERT(d->bin);
+
+    const int threads = qMin(d->accumulators.size(), imageIds.count());
+
+    if (threads <= 1)
+    {
+        return searchIndexBatch(imageIds, requiredPercentage, maximumPercentage,
+                                searchResultRestriction, &d->accumulators[0]);
+    }
+
+    // Split the images in one contiguous part per thread and merge the results in the same order
+    const int chunk = (imageIds.count() + threads - 1) / threads;
+    QList<QFuture<QList<QMap<qlonglong, double> > > > tasks;
+
+    for (int i = 0; i < threads; ++i)
+    {
+        tasks.append(QtConcurrent::run(&d->threadPool,
+                                       this,
+                                       &HaarIface::searchIndexBatch,
+                                       imageIds.mid(i * chunk, chunk),
+                                       requiredPercentage,
+                                       maximumPercentage,
+                                       searchResultRestriction,
+                                       &d->accumulators[i]
+                                      ));
+    }
+
+    QList<QMap<qlonglong, double> > results;
+
+    foreach (QFuture<QList<QMap<qlonglong, double> > > t, tasks)
+    {
+        results << t.result();
+    }
+
+    return results;
 }
 
 QImage HaarIface::loadQImage(const QString& filename)
@@ -834,8 +1330,7 @@ bool HaarIface::retrieveSignatureFromDB(qlonglong imageid, Haar::SignatureData*
 
     DatabaseBlob blob;
 
-    blob.read(values.first().toByteArray(), sig);
-    return true;
+    return blob.read(values.first().toByteArray(), sig);
 }
 
 void HaarIface::getBestAndWorstPossibleScore(Haar::SignatureData* const sig, SketchType type,
@@ -1055,7 +1550,6 @@ QMap< double,QMap< qlonglong,QList<qlonglong> > > HaarIface::findDuplicates(cons
 {
     QMap<double,QMap<qlonglong,QList<qlonglong>>> resultsMap;
     QMap<double,QMap<qlonglong,QList<qlonglong>>>::iterator similarity_it;
-    QSet<qlonglong>::const_iterator     it;
     QPair<double,QMap<qlonglong,double>>      bestMatches;
     QList<qlonglong>                    imageIdList;
     QSet<qlonglong>                     resultsCandidates;
@@ -1071,59 +1565,105 @@ QMap< double,QMap< qlonglong,QList<qlonglong> > > HaarIface::findDuplicates(cons
         observer->totalNumberToScan(total);
     }
 
-    // create signature cache map for fast lookup
-    d->setSignatureCacheEnabled(true, images2Scan);
+    // The bin is shared read-only by all workers, create it before any of them starts.
+    d->createWeightBin();
+
+    // create an inverted index of the signatures, so that every image is only
+    // compared with the images sharing significant coefficients
+    d->createSignatureIndex(images2Scan);
 
-    for (it = images2Scan.constBegin(); it != images2Scan.constEnd(); ++it)
+    // The images are searched in batches, one part of a batch per thread. The results are
+    // then processed in the same order as a sequential search would do, so they are identical.
+    const QList<qlonglong> imageIds  = images2Scan.toList();
+    const int              batchSize = (d->accumulators.size() == 1) ? 1 : d->accumulators.size() * 8;
+    bool                   canceled  = false;
+
+    for (int batchStart = 0; !canceled && (batchStart < imageIds.count()); batchStart += batchSize)
     {
-        if (observer && observer->isCanceled())
+        QList<qlonglong> batch = imageIds.mid(batchStart, batchSize);
+        QList<qlonglong> imagesToSearch;
+
+        foreach (const qlonglong& imageid, batch)
         {
-            break;
+            if (!resultsCandidates.contains(imageid))
+            {
+                imagesToSearch << imageid;
+            }
         }
 
-        if (!resultsCandidates.contains(*it))
+        QList<QMap<qlonglong, double> > batchMatches = searchIndexParallel(imagesToSearch, requiredPercentage,
+                                                                           maximumPercentage, searchResultRestriction);
+        // Images removed from the index while processing this batch must not appear
+        // in the matches of the following images of the batch.
+        QSet<qlonglong> removedImages;
+        int             matchIndex    = 0;
+
+        foreach (const qlonglong& imageid, batch)
         {
-            QList<int> targetAlbums;
-            // find images with required similarity
-            bestMatches = bestMatchesForImageWithThreshold(*it, requiredPercentage, maximumPercentage, targetAlbums, searchResultRestriction, ScannedSketch);
-            // We need only the image ids from the best matches map.
-            imageIdList = bestMatches.second.keys();
-            if (!imageIdList.isEmpty())
+            if (observer && observer->isCanceled())
+            {
+                canceled = true;
+                break;
+            }
+
+            if (!resultsCandidates.contains(imageid))
             {
-                // the list will usually contain one image: the original. Filter out.
-                if (!(imageIdList.count() == 1 && imageIdList.first() == *it))
+                // Candidates only grow, so the image was searched in this batch.
+                while (imagesToSearch.at(matchIndex) != imageid)
                 {
-                    // make a lookup for the average similarity
-                    similarity_it = resultsMap.find(bestMatches.first);
-                    // If there is an entry for this similarity, add the result set. Else, create a new similarity entry.
-                    if (similarity_it != resultsMap.end())
-                    {
-                        similarity_it->insert(*it,imageIdList);
-                    }
-                    else
+                    ++matchIndex;
+                }
+
+                QMap<qlonglong, double> matches = batchMatches.at(matchIndex);
+
+                foreach (const qlonglong& removedId, removedImages)
+                {
+                    matches.remove(removedId);
+                }
+
+                // find images with required similarity
+                bestMatches = storeMatches(imageid, matches);
+                // We need only the image ids from the best matches map.
+                imageIdList = bestMatches.second.keys();
+
+                if (!imageIdList.isEmpty())
+                {
+                    // the list will usually contain one image: the original. Filter out.
+                    if (!(imageIdList.count() == 1 && imageIdList.first() == imageid))
                     {
-                        QMap<qlonglong,QList<qlonglong>> result;
-                        result.insert(*it, imageIdList);
-                        resultsMap.insert(bestMatches.first,result);
+                        // make a lookup for the average similarity
+                        similarity_it = resultsMap.find(bestMatches.first);
+                        // If there is an entry for this similarity, add the result set. Else, create a new similarity entry.
+                        if (similarity_it != resultsMap.end())
+                        {
+                            similarity_it->insert(imageid, imageIdList);
+                        }
+                        else
+                        {
+                            QMap<qlonglong,QList<qlonglong>> result;
+                            result.insert(imageid, imageIdList);
+                            resultsMap.insert(bestMatches.first,result);
+                        }
+                        resultsCandidates << imageid;
+                        resultsCandidates.unite(imageIdList.toSet());
                     }
-                    resultsCandidates << *it;
-                    resultsCandidates.unite(imageIdList.toSet());
                 }
             }
-        }
 
-        // if an imageid is not a results candidate, remove it from the cached signature map as well,
-        // to greatly improve speed
-        if (!resultsCandidates.contains(*it))
-        {
-            d->signatureCache->remove(*it);
-        }
+            // if an imageid is not a results candidate, remove it from the signature index as well,
+            // to greatly improve speed
+            if (!resultsCandidates.contains(imageid))
+            {
+                d->signatureIndex->remove(imageid);
+                removedImages << imageid;
+            }
 
-        ++progress;
+            ++progress;
 
-        if (observer && (progress == total || progress % progressStep == 0))
-        {
-            observer->processedNumber(progress);
+            if (observer && (progress == total || progress % progressStep == 0))
+            {
+                observer->processedNumber(progress);
+            }
         }
     }
 
@@ -1133,8 +1673,8 @@ QMap< double,QMap< qlonglong,QList<qlonglong> > > HaarIface::findDuplicates(cons
         observer->processedNumber(total);
     }
 
-    // disable cache
-    d->setSignatureCacheEnabled(false);
+    // release the index
+    d->removeSignatureIndex();
 
     return resultsMap;
 }
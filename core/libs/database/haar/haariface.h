@@ -37,6 +37,7 @@
 // Local includes
 
 #include "haar.h"
+#include "haarindex.h"
 #include "digikam_export.h"
 
 class QImage;
@@ -97,6 +98,17 @@ public:
 
     static int preferredSize();
 
+    /** Returns the image scaled down like a fast preview loaded at preferredSize().
+     *  An image decoded at a larger size gives then the same input to signatureData().
+     */
+    static DImg preferredImage(const DImg& image);
+
+    /** Sets the number of threads used to score signatures and to search duplicates.
+     *  The results do not depend on it. 0 (default) uses one thread per core.
+     */
+    void setNumberOfThreads(int count);
+    int  numberOfThreads() const;
+
     /** Adds an image to the index in the database.
      */
     bool indexImage(const QString& filename);
@@ -105,6 +117,25 @@ public:
     bool indexImage(qlonglong imageid, const QImage& image);
     bool indexImage(qlonglong imageid, const DImg& image);
 
+    /** Calculates the Haar signature of the image in the form as stored in the database,
+     *  without writing it. Returns an empty array for a null image.
+     *  Use storeSignatures() to write the signatures of many images at once.
+     */
+    QByteArray signatureData(const DImg& image);
+
+    /** Writes signatures calculated with signatureData(), mapped by image id, to the
+     *  database in one transaction. Signatures of images which are not visible are skipped.
+     *  Returns the number of signatures written.
+     */
+    static int storeSignatures(const QMap<qlonglong, QByteArray>& signatures);
+
+    /** Defers writing the signature cache file while signatures are stored in many batches,
+     *  i.e. during a fingerprints job. The file is written once, when endSignatureUpdates()
+     *  was called as often as beginSignatureUpdates(), or with the next load of the signatures.
+     */
+    static void beginSignatureUpdates();
+    static void endSignatureUpdates();
+
     /** Searches the database for the best matches for the specified query image.
      *  The numberOfResults best matches are returned.
      */
@@ -234,6 +265,42 @@ private:
     QMap<qlonglong, double> searchDatabase(Haar::SignatureData* const data, SketchType type, QList<int>& targetAlbums,
                                            DuplicatesSearchRestrictions searchResultRestriction = None,
                                            qlonglong originalImageId = -1, int albumId = -1);
+
+    /** This function generates the scores for the images of the signature index.
+     *  Only images which can reach a score of at most maximumScore are considered,
+     *  all others are omitted from the map. Scores are identical to searchDatabase().
+     */
+    QMap<qlonglong, double> searchIndex(Haar::SignatureData* const data, SketchType type, QList<int>& targetAlbums,
+                                        double maximumScore, Haar::SignatureIndex::Accumulator& accumulator,
+                                        DuplicatesSearchRestrictions searchResultRestriction = None,
+                                        qlonglong originalImageId = -1, int albumId = -1);
+
+    /** Returns the matches of the query image as a map of image ids and similarities,
+     *  using the signature index if available. Nothing is written to the database,
+     *  so this method can run in several threads with different accumulators.
+     */
+    QMap<qlonglong, double> matchesWithThreshold(qlonglong imageid, int albumId, Haar::SignatureData* const querySig,
+                                                 double requiredPercentage, double maximumPercentage,
+                                                 QList<int>& targetAlbums, DuplicatesSearchRestrictions searchResultRestriction,
+                                                 SketchType type, Haar::SignatureIndex::Accumulator* const accumulator);
+
+    /** Stores the similarities of the matches in the database and computes their average similarity.
+     */
+    QPair<double,QMap<qlonglong,double>> storeMatches(qlonglong imageid, const QMap<qlonglong, double>& bestMatches);
+
+    /** Worker of findDuplicates(): returns the matches of each image, in the order of imageIds.
+     */
+    QList<QMap<qlonglong, double> > searchIndexBatch(const QList<qlonglong>& imageIds,
+                                                     double requiredPercentage, double maximumPercentage,
+                                                     DuplicatesSearchRestrictions searchResultRestriction,
+                                                     Haar::SignatureIndex::Accumulator* const accumulator);
+
+    /** Splits the images over the worker threads and merges the results of searchIndexBatch() in order.
+     */
+    QList<QMap<qlonglong, double> > searchIndexParallel(const QList<qlonglong>& imageIds,
+                                                        double requiredPercentage, double maximumPercentage,
+                                                        DuplicatesSearchRestrictions searchResultRestriction);
+
     double calculateScore(Haar::SignatureData& querySig, Haar::SignatureData& targetSig,
                           Haar::Weights& weights, Haar::SignatureMap** const queryMaps);
 
@@ -0,0 +1,266 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-11-10
+ * Description : Inverted index of Haar signature coefficients
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "haarindex.h"
+
+// C++ includes
+
+#include <cmath>
+#include <algorithm>
+
+using namespace std;
+
+namespace Digikam
+{
+
+namespace Haar
+{
+
+SignatureIndex::SignatureIndex(const QSharedPointer<const SignatureStore>& store)
+    : m_store(store),
+      m_built(false),
+      m_count(0)
+{
+}
+
+SignatureIndex::~SignatureIndex()
+{
+}
+
+void SignatureIndex::add(int storePosition, int albumid)
+{
+    Q_ASSERT(!m_built);
+
+    qlonglong imageid = m_store->imageId(storePosition);
+
+    if (m_positions.contains(imageid))
+    {
+        return;
+    }
+
+    m_positions.insert(imageid, m_storePositions.size());
+    m_storePositions << storePosition;
+    m_albumIds       << albumid;
+    m_alive          << true;
+    ++m_count;
+}
+
+void SignatureIndex::build()
+{
+    const int size = m_storePositions.size();
+
+    // First pass: count the entries of each posting list
+
+    m_offsets.fill(0, NumberOfPostingLists + 1);
+
+    for (int pos = 0; pos < size; ++pos)
+    {
+        const Idx* coefs = m_store->coefficients(m_storePositions.at(pos));
+
+        for (int channel = 0; channel < 3; ++channel)
+        {
+            for (int coef = 0; coef < NumberOfCoefficients; ++coef)
+            {
+                ++m_offsets[postingKey(channel, *coefs++) + 1];
+            }
+        }
+    }
+
+    for (int key = 0; key < NumberOfPostingLists; ++key)
+    {
+        m_offsets[key + 1] += m_offsets[key];
+    }
+
+    // Second pass: fill the posting lists. Positions are appended in ascending order.
+
+    m_postings.resize(m_offsets.last());
+    QVector<int> fill = m_offsets;
+
+    for (int pos = 0; pos < size; ++pos)
+    {
+        const Idx* coefs = m_store->coefficients(m_storePositions.at(pos));
+
+        for (int channel = 0; channel < 3; ++channel)
+        {
+            for (int coef = 0; coef < NumberOfCoefficients; ++coef)
+            {
+                m_postings[fill[postingKey(channel, *coefs++)]++] = pos;
+            }
+        }
+    }
+
+    m_built = true;
+}
+
+void SignatureIndex::remove(qlonglong imageid)
+{
+    int pos = position(imageid);
+
+    if (pos != -1)
+    {
+        m_alive[pos] = false;
+        m_positions.remove(imageid);
+        --m_count;
+    }
+}
+
+bool SignatureIndex::contains(qlonglong imageid) const
+{
+    return m_positions.contains(imageid);
+}
+
+int SignatureIndex::count() const
+{
+    return m_count;
+}
+
+int SignatureIndex::position(qlonglong imageid) const
+{
+    return m_positions.value(imageid, -1);
+}
+
+const SignatureStore* SignatureIndex::store() const
+{
+    return m_store.data();
+}
+
+int SignatureIndex::storePosition(int position) const
+{
+    return m_storePositions.at(position);
+}
+
+qlonglong SignatureIndex::imageId(int position) const
+{
+    return m_store->imageId(m_storePositions.at(position));
+}
+
+int SignatureIndex::albumId(int position) const
+{
+    return m_albumIds.at(position);
+}
+
+void SignatureIndex::signature(int position, SignatureData* const sig) const
+{
+    m_store->signature(m_storePositions.at(position), sig);
+}
+
+bool SignatureIndex::mayReachScore(int pos, const SignatureData& querySig, const Weights& weights,
+                                   double maximumScore, const Accumulator& accumulator) const
+{
+    const double* const avg = m_store->averages(m_storePositions.at(pos));
+    double avgScore         = 0.0;
+
+    for (int channel = 0; channel < 3; ++channel)
+    {
+        avgScore += weights.weightForAverage(channel) * fabs(querySig.avg[channel] - avg[channel]);
+    }
+
+    const double tolerance = 1.0E-9 * (1.0 + fabs(maximumScore) + avgScore);
+
+    return ((avgScore - accumulator.weights.at(pos)) <= (maximumScore + tolerance));
+}
+
+QVector<int> SignatureIndex::candidates(const SignatureData& querySig, const Weights& weights,
+                                        const WeightBin& bin, double maximumScore,
+                                        Accumulator& accumulator) const
+{
+    Q_ASSERT(m_built);
+
+    if (accumulator.weights.size() != m_storePositions.size())
+    {
+        accumulator.weights.fill(0.0, m_storePositions.size());
+        accumulator.touched.clear();
+    }
+
+    // Step 1: sum up the weights of all coefficients each entry has in common with the query.
+    // All weights are strictly positive, so a zero accumulator means "not touched yet".
+
+    for (int channel = 0; channel < 3; ++channel)
+    {
+        for (int coef = 0; coef < NumberOfCoefficients; ++coef)
+        {
+            const Idx    x      = querySig.sig[channel][coef];
+            const double weight = weights.weight(bin.binAbs(x), channel);
+            const int    key    = postingKey(channel, x);
+            const int    end    = m_offsets.at(key + 1);
+
+            for (int i = m_offsets.at(key); i < end; ++i)
+            {
+                const int pos = m_postings.at(i);
+
+                if (accumulator.weights.at(pos) == 0.0)
+                {
+                    accumulator.touched << pos;
+                }
+
+                accumulator.weights[pos] += weight;
+            }
+        }
+    }
+
+    // Step 2: the score of an entry is its weighted average difference (never negative)
+    // minus the accumulated weights. Keep every entry which may reach the maximum score.
+    // The tolerance covers the different summation order compared to the exact score.
+
+    QVector<int> result;
+
+    if (maximumScore + 1.0E-9 * (1.0 + fabs(maximumScore)) >= 0.0)
+    {
+        // Entries without any common coefficient can qualify by their averages alone
+
+        for (int pos = 0; pos < m_storePositions.size(); ++pos)
+        {
+            if (m_alive.at(pos) && mayReachScore(pos, querySig, weights, maximumScore, accumulator))
+            {
+                result << pos;
+            }
+        }
+    }
+    else
+    {
+        foreach (int pos, accumulator.touched)
+        {
+            if (m_alive.at(pos) && mayReachScore(pos, querySig, weights, maximumScore, accumulator))
+            {
+                result << pos;
+            }
+        }
+
+        std::sort(result.begin(), result.end());
+    }
+
+    // Reset the scratch buffers for the next query
+
+    foreach (int pos, accumulator.touched)
+    {
+        accumulator.weights[pos] = 0.0;
+    }
+
+    accumulator.touched.clear();
+
+    return result;
+}
+
+} // namespace Haar
+
+} // namespace Digikam
@@ -0,0 +1,153 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-11-10
+ * Description : Inverted index of Haar signature coefficients
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_HAAR_INDEX_H
+#define DIGIKAM_HAAR_INDEX_H
+
+// Qt includes
+
+#include <QHash>
+#include <QSharedPointer>
+#include <QVector>
+
+// Local includes
+
+#include "haar.h"
+#include "haarstore.h"
+#include "digikam_export.h"
+
+namespace Digikam
+{
+
+namespace Haar
+{
+
+/** This class holds a subset of the signatures of a SignatureStore together with
+ *  an inverted index mapping every signed coefficient position of each Y/I/Q channel
+ *  to the list of entries which have this coefficient in their signature.
+ *
+ *  A query only visits the entries sharing at least one coefficient with
+ *  the query signature, and prunes all entries which cannot reach a given
+ *  maximum score. The exact score of the remaining candidates must still be
+ *  computed by the caller, so results are identical to a full scan.
+ *
+ *  Usage: call add() for all signatures, then build() once. After build(),
+ *  entries can only be removed, not added. Queries can run concurrently
+ *  with one Accumulator per thread, but not concurrently with remove().
+ */
+class DIGIKAM_DATABASE_EXPORT SignatureIndex
+{
+public:
+
+    /** Scratch buffers of one query thread, reused between queries.
+     */
+    class Accumulator
+    {
+    public:
+
+        QVector<double> weights;
+        QVector<int>    touched;
+
+        /// The table used to score the candidates, reset for each query
+        ScoreTable      scores;
+    };
+
+public:
+
+    explicit SignatureIndex(const QSharedPointer<const SignatureStore>& store);
+    ~SignatureIndex();
+
+    /** Adds the signature at the given store position to the index. Must be called before build().
+     */
+    void add(int storePosition, int albumid);
+
+    /** Creates the posting lists from all added signatures.
+     */
+    void build();
+
+    /** Removes the entry of the given image id from all further queries.
+     */
+    void remove(qlonglong imageid);
+
+    bool contains(qlonglong imageid) const;
+    int  count()                     const;
+
+    /** Returns the position of the given image id, or -1 if not indexed or removed.
+     */
+    int  position(qlonglong imageid) const;
+
+    const SignatureStore* store()                                const;
+    int       storePosition(int position)                        const;
+    qlonglong imageId(int position)                              const;
+    int       albumId(int position)                              const;
+    void      signature(int position, SignatureData* const sig) const;
+
+    /** Returns the positions of all entries which can score at most maximumScore
+     *  against the query signature (lower is better, see HaarIface::calculateScore()).
+     *  The positions are returned in ascending order.
+     */
+    QVector<int> candidates(const SignatureData& querySig, const Weights& weights,
+                            const WeightBin& bin, double maximumScore,
+                            Accumulator& accumulator) const;
+
+private:
+
+    /// Maps a channel and a signed coefficient to its posting list
+    static int postingKey(int channel, Idx coef)
+    {
+        return (channel * 2 * NumberOfPixelsSquared) + coef + NumberOfPixelsSquared;
+    }
+
+    bool mayReachScore(int pos, const SignatureData& querySig, const Weights& weights,
+                       double maximumScore, const Accumulator& accumulator) const;
+
+    enum { NumberOfPostingLists = 3 * 2 * NumberOfPixelsSquared };
+
+private:
+
+    // Disable
+    SignatureIndex(const SignatureIndex&);
+    SignatureIndex& operator=(const SignatureIndex&);
+
+private:
+
+    QSharedPointer<const SignatureStore> m_store;
+
+    bool                                 m_built;
+    int                                  m_count;
+
+    QVector<int>                         m_storePositions;
+    QVector<int>                         m_albumIds;
+    QVector<bool>                        m_alive;
+    QHash<qlonglong, int>                m_positions;
+
+    /// Posting lists in compressed row storage: list k is m_postings[m_offsets[k]..m_offsets[k+1]]
+    QVector<int>                         m_offsets;
+    QVector<int>                         m_postings;
+};
+
+} // namespace Haar
+
+} // namespace Digikam
+
+#endif // DIGIKAM_HAAR_INDEX_H
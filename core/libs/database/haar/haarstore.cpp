@@ -0,0 +1,343 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-11-10
+ * Description : Flat in-memory store of Haar signatures
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "haarstore.h"
+
+// C++ includes
+
+#include <cmath>
+#include <algorithm>
+
+// Qt includes
+
+#include <QSaveFile>
+
+// Local includes
+
+#include "digikam_debug.h"
+
+using namespace std;
+
+namespace Digikam
+{
+
+namespace Haar
+{
+
+/** Header of the cache file. The data is written in native byte order,
+ *  a file written on a different platform is rejected by the magic number.
+ */
+struct Q_DECL_HIDDEN SignatureStoreHeader
+{
+    enum
+    {
+        Magic          = 0x444B4853, // "DKHS"
+        Version        = 1,
+        RevisionLength = 64
+    };
+
+    quint32 magic;
+    quint32 version;
+    qint64  count;
+    char    revision[RevisionLength];
+};
+
+// --------------------------------------------------------------------
+
+ScoreTable::ScoreTable()
+    : m_table(3 * 2 * NumberOfPixelsSquared, 0.0F),
+      m_hasQuery(false)
+{
+    for (int channel = 0; channel < 3; ++channel)
+    {
+        averages[channel]       = 0.0;
+        averageWeights[channel] = 0.0F;
+    }
+}
+
+ScoreTable::ScoreTable(const SignatureData& querySig, const Weights& weights, const WeightBin& bin)
+    : m_table(3 * 2 * NumberOfPixelsSquared, 0.0F),
+      m_hasQuery(false)
+{
+    setQuery(querySig, weights, bin);
+}
+
+ScoreTable::~ScoreTable()
+{
+}
+
+void ScoreTable::setQuery(const SignatureData& querySig, const Weights& weights, const WeightBin& bin)
+{
+    // Subtracting a zero weight does not change the score, so no branch is needed
+    // when scoring and the result is the same as in HaarIface::calculateScore().
+
+    for (int channel = 0; channel < 3; ++channel)
+    {
+        float* const table = m_table.data() + (channel * 2 + 1) * NumberOfPixelsSquared;
+
+        if (m_hasQuery)
+        {
+            for (int coef = 0; coef < NumberOfCoefficients; ++coef)
+            {
+                table[m_coefficients[channel][coef]] = 0.0F;
+            }
+        }
+
+        for (int coef = 0; coef < NumberOfCoefficients; ++coef)
+        {
+            const Idx x                   = querySig.sig[channel][coef];
+            table[x]                      = weights.weight(bin.binAbs(x), channel);
+            m_coefficients[channel][coef] = x;
+        }
+
+        averages[channel]       = querySig.avg[channel];
+        averageWeights[channel] = weights.weightForAverage(channel);
+    }
+
+    m_hasQuery = true;
+}
+
+// --------------------------------------------------------------------
+
+SignatureStore::SignatureStore()
+    : m_count(0),
+      m_ids(nullptr),
+      m_averages(nullptr),
+      m_coefficients(nullptr)
+{
+}
+
+SignatureStore::~SignatureStore()
+{
+}
+
+void SignatureStore::clear()
+{
+    m_file.close();
+
+    m_idData.clear();
+    m_averageData.clear();
+    m_coefficientData.clear();
+    m_revision.clear();
+
+    updateColumns();
+}
+
+void SignatureStore::reserve(int size)
+{
+    m_idData.reserve(size);
+    m_averageData.reserve(3 * size);
+    m_coefficientData.reserve(CoefficientsPerEntry * size);
+}
+
+void SignatureStore::append(qlonglong imageid, const SignatureData& sig)
+{
+    Q_ASSERT(!m_file.isOpen());
+    Q_ASSERT(m_idData.isEmpty() || m_idData.last() < imageid);
+
+    m_idData << imageid;
+
+    for (int channel = 0; channel < 3; ++channel)
+    {
+        m_averageData << sig.avg[channel];
+    }
+
+    for (int channel = 0; channel < 3; ++channel)
+    {
+        for (int coef = 0; coef < NumberOfCoefficients; ++coef)
+        {
+            m_coefficientData << sig.sig[channel][coef];
+        }
+    }
+
+    updateColumns();
+}
+
+void SignatureStore::updateColumns()
+{
+    m_count        = m_idData.size();
+    m_ids          = m_idData.constData();
+    m_averages     = m_averageData.constData();
+    m_coefficients = m_coefficientData.constData();
+}
+
+int SignatureStore::count() const
+{
+    return m_count;
+}
+
+int SignatureStore::position(qlonglong imageid) const
+{
+    const qlonglong* const end = m_ids + m_count;
+    const qlonglong* const it  = std::lower_bound(m_ids, end, imageid);
+
+    if (it == end || *it != imageid)
+    {
+        return -1;
+    }
+
+    return (it - m_ids);
+}
+
+qlonglong SignatureStore::imageId(int position) const
+{
+    return m_ids[position];
+}
+
+const double* SignatureStore::averages(int position) const
+{
+    return m_averages + 3 * position;
+}
+
+const Idx* SignatureStore::coefficients(int position) const
+{
+    return m_coefficients + CoefficientsPerEntry * position;
+}
+
+void SignatureStore::signature(int position, SignatureData* const sig) const
+{
+    memcpy(sig->avg, averages(position),     3 * sizeof(double));
+    memcpy(sig->sig, coefficients(position), CoefficientsPerEntry * sizeof(Idx));
+}
+
+QString SignatureStore::revision() const
+{
+    return m_revision;
+}
+
+void SignatureStore::setRevision(const QString& revision)
+{
+    m_revision = revision;
+}
+
+bool SignatureStore::save(const QString& filePath) const
+{
+    QSaveFile file(filePath);
+
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        qCDebug(DIGIKAM_DATABASE_LOG) << "Cannot write Haar signature cache" << filePath;
+        return false;
+    }
+
+    SignatureStoreHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic   = SignatureStoreHeader::Magic;
+    header.version = SignatureStoreHeader::Version;
+    header.count   = m_count;
+
+    QByteArray revision = m_revision.toUtf8().left(SignatureStoreHeader::RevisionLength - 1);
+    memcpy(header.revision, revision.constData(), revision.size());
+
+    file.write(reinterpret_cast<const char*>(&header),         sizeof(header));
+    file.write(reinterpret_cast<const char*>(m_ids),           m_count * sizeof(qlonglong));
+    file.write(reinterpret_cast<const char*>(m_averages),      m_count * 3 * sizeof(double));
+    file.write(reinterpret_cast<const char*>(m_coefficients),  m_count * CoefficientsPerEntry * sizeof(Idx));
+
+    return file.commit();
+}
+
+bool SignatureStore::load(const QString& filePath)
+{
+    clear();
+
+    m_file.setFileName(filePath);
+
+    if (!m_file.open(QIODevice::ReadOnly) || m_file.size() < (qint64)sizeof(SignatureStoreHeader))
+    {
+        m_file.close();
+        return false;
+    }
+
+    const uchar* const data = m_file.map(0, m_file.size());
+
+    if (!data)
+    {
+        m_file.close();
+        return false;
+    }
+
+    const SignatureStoreHeader* const header = reinterpret_cast<const SignatureStoreHeader*>(data);
+    const qint64 entrySize                   = sizeof(qlonglong) + 3 * sizeof(double) + CoefficientsPerEntry * sizeof(Idx);
+
+    if (header->magic   != SignatureStoreHeader::Magic   ||
+        header->version != SignatureStoreHeader::Version ||
+        header->count   <  0                             ||
+        m_file.size()   != (qint64)sizeof(SignatureStoreHeader) + header->count * entrySize)
+    {
+        qCDebug(DIGIKAM_DATABASE_LOG) << "Invalid Haar signature cache" << filePath;
+        m_file.close();
+        return false;
+    }
+
+    m_count        = header->count;
+    m_revision     = QString::fromUtf8(header->revision,
+                                       qstrnlen(header->revision, SignatureStoreHeader::RevisionLength));
+    m_ids          = reinterpret_cast<const qlonglong*>(data + sizeof(SignatureStoreHeader));
+    m_averages     = reinterpret_cast<const double*>(m_ids + m_count);
+    m_coefficients = reinterpret_cast<const Idx*>(m_averages + 3 * m_count);
+
+    return true;
+}
+
+void SignatureStore::calculateScores(const ScoreTable& query, const int* const positions,
+                                     int count, double* const scores) const
+{
+    const float* const channelTables[3] = { query.channelTable(0),
+                                            query.channelTable(1),
+                                            query.channelTable(2) };
+
+    for (int i = 0; i < count; ++i)
+    {
+        const double* const avg   = averages(positions[i]);
+        const Idx*          coefs = coefficients(positions[i]);
+        double              score = 0.0;
+
+        // Step 1: average intensity values of all three channels
+
+        for (int channel = 0; channel < 3; ++channel)
+        {
+            score += query.averageWeights[channel] * fabs(query.averages[channel] - avg[channel]);
+        }
+
+        // Step 2: significant coefficients in common
+
+        for (int channel = 0; channel < 3; ++channel)
+        {
+            const float* const table = channelTables[channel];
+
+            for (int coef = 0; coef < NumberOfCoefficients; ++coef)
+            {
+                score -= table[coefs[coef]];
+            }
+
+            coefs += NumberOfCoefficients;
+        }
+
+        scores[i] = score;
+    }
+}
+
+} // namespace Haar
+
+} // namespace Digikam
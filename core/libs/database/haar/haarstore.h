@@ -0,0 +1,183 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-11-10
+ * Description : Flat in-memory store of Haar signatures
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_HAAR_STORE_H
+#define DIGIKAM_HAAR_STORE_H
+
+// Qt includes
+
+#include <QFile>
+#include <QString>
+#include <QVector>
+
+// Local includes
+
+#include "haar.h"
+#include "digikam_export.h"
+
+namespace Digikam
+{
+
+namespace Haar
+{
+
+/** The weights of the coefficients of a query signature, laid out for fast lookup
+ *  of signed coefficients. All other coefficients have a weight of zero.
+ *  Copies are cheap, the table is implicitly shared.
+ *  A table can be reused for several queries with setQuery(), which only
+ *  resets the coefficients of the previous query instead of allocating the table again.
+ */
+class DIGIKAM_DATABASE_EXPORT ScoreTable
+{
+public:
+
+    /** Creates a table without query, all weights are zero.
+     */
+    ScoreTable();
+    explicit ScoreTable(const SignatureData& querySig, const Weights& weights, const WeightBin& bin);
+    ~ScoreTable();
+
+    /** Replaces the query of the table.
+     */
+    void setQuery(const SignatureData& querySig, const Weights& weights, const WeightBin& bin);
+
+    /** Weight of the signed coefficient in the given channel, 0 if not part of the query.
+     */
+    float weight(int channel, Idx coef) const
+    {
+        return m_table.at((channel * 2 + 1) * NumberOfPixelsSquared + coef);
+    }
+
+    const float* channelTable(int channel) const
+    {
+        return m_table.constData() + (channel * 2 + 1) * NumberOfPixelsSquared;
+    }
+
+public:
+
+    double         averages[3];
+    float          averageWeights[3];
+
+private:
+
+    QVector<float> m_table;
+
+    /// The coefficients of the current query, which have a non-zero weight
+    bool           m_hasQuery;
+    Idx            m_coefficients[3][NumberOfCoefficients];
+};
+
+// ---------------------------------------------------------------------------------
+
+/** This class holds all Haar signatures of the similarity database in a
+ *  structure of arrays: a sorted column of image ids, a column with the three
+ *  averages of each signature and a packed matrix with the 3 x 40 coefficients
+ *  of each signature. Entries are addressed by their position.
+ *
+ *  The store can be written to a cache file and mapped back into memory,
+ *  which avoids decoding all database blobs for each search.
+ *  A loaded store is never changed, so it can be shared between threads.
+ */
+class DIGIKAM_DATABASE_EXPORT SignatureStore
+{
+public:
+
+    enum
+    {
+        CoefficientsPerEntry = 3 * NumberOfCoefficients
+    };
+
+public:
+
+    explicit SignatureStore();
+    ~SignatureStore();
+
+    void clear();
+    void reserve(int size);
+
+    /** Appends a signature. Image ids must be appended in ascending order.
+     */
+    void append(qlonglong imageid, const SignatureData& sig);
+
+    int count() const;
+
+    /** Returns the position of the image id, or -1 if it is not in the store.
+     */
+    int position(qlonglong imageid) const;
+
+    qlonglong     imageId(int position)      const;
+    const double* averages(int position)     const;
+    const Idx*    coefficients(int position) const;
+    void          signature(int position, SignatureData* const sig) const;
+
+    /** An arbitrary string identifying the state of the data source.
+     *  It is saved with the cache file.
+     */
+    QString revision() const;
+    void    setRevision(const QString& revision);
+
+    /** Writes the store to a cache file, or maps a previously written cache file.
+     */
+    bool save(const QString& filePath) const;
+    bool load(const QString& filePath);
+
+    /** Batch version of HaarIface::calculateScore(): computes the score of the query
+     *  against each of the count given positions and writes it to scores.
+     *  The results are bit-identical to the single image calculation.
+     *  This method can be called from several threads for different ranges.
+     */
+    void calculateScores(const ScoreTable& query, const int* const positions,
+                         int count, double* const scores) const;
+
+private:
+
+    void updateColumns();
+
+private:
+
+    // Disable
+    SignatureStore(const SignatureStore&);
+    SignatureStore& operator=(const SignatureStore&);
+
+private:
+
+    int                m_count;
+    QString            m_revision;
+
+    /// Columns, pointing either to the owned vectors or to the mapped file
+    const qlonglong*   m_ids;
+    const double*      m_averages;
+    const Idx*         m_coefficients;
+
+    QVector<qlonglong> m_idData;
+    QVector<double>    m_averageData;
+    QVector<Idx>       m_coefficientData;
+
+    QFile              m_file;
+};
+
+} // namespace Haar
+
+} // namespace Digikam
+
+#endif // DIGIKAM_HAAR_STORE_H
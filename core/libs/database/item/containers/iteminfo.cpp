@@ -182,6 +182,14 @@ ItemInfoCache* ItemInfoStatic::cache()
     return &m_instance->m_cache;
 }
 
+QReadWriteLock* ItemInfoStatic::lockForData(const ItemInfoData* const data)
+{
+    // Heap blocks are at least 16 bytes aligned
+    const quintptr key = reinterpret_cast<quintptr>(data) >> 4;
+
+    return &m_instance->m_dataLocks[key % NumberOfDataLocks].lock;
+}
+
 // ---------------------------------------------------------------
 
 ItemInfoData::ItemInfoData()
@@ -248,7 +256,7 @@ ItemInfo::ItemInfo(const ItemListerRecord& record)
 {
     m_data                         = ItemInfoStatic::cache()->infoForId(record.imageID);
 
-    ItemInfoWriteLocker lock;
+    ItemInfoWriteLocker lock(m_data);
     bool newlyCreated              = m_data->albumId == -1;
 
     m_data->albumId                = record.albumID;
@@ -279,6 +287,8 @@ ItemInfo::ItemInfo(const ItemListerRecord& record)
     m_data->hasImageMetadata       = true;
     m_data->databaseFieldsHashRaw.clear();
 
+    lock.unlock();
+
     if (newlyCreated)
     {
         ItemInfoStatic::cache()->cacheByName(m_data);
@@ -293,14 +303,17 @@ ItemInfo::ItemInfo(qlonglong ID)
     if (m_data->albumId == -1)
     {
         // retrieve immutable values now, the rest on demand
-        ItemShortInfo info  = CoreDbAccess().db()->getItemShortInfo(ID);
+        ItemShortInfo info  = CoreDbReadAccess().db()->getItemShortInfo(ID);
 
         if (info.id)
         {
-            ItemInfoWriteLocker lock;
-            m_data->albumId     = info.albumID;
-            m_data->albumRootId = info.albumRootID;
-            m_data->name        = info.itemName;
+            {
+                ItemInfoWriteLocker lock(m_data);
+                m_data->albumId     = info.albumID;
+                m_data->albumRootId = info.albumRootID;
+                m_data->name        = info.itemName;
+            }
+
             ItemInfoStatic::cache()->cacheByName(m_data);
         }
         else
@@ -355,7 +368,7 @@ ItemInfo ItemInfo::fromLocationAlbumAndName(int locationId, const QString& album
     if (!info.m_data)
     {
 
-        ItemShortInfo shortInfo  = CoreDbAccess().db()->getItemShortInfo(locationId, album, name);
+        ItemShortInfo shortInfo  = CoreDbReadAccess().db()->getItemShortInfo(locationId, album, name);
 
         if (!shortInfo.id)
         {
@@ -366,10 +379,12 @@ ItemInfo ItemInfo::fromLocationAlbumAndName(int locationId, const QString& album
 
         info.m_data              = ItemInfoStatic::cache()->infoForId(shortInfo.id);
 
-        ItemInfoWriteLocker lock;
-        info.m_data->albumId     = shortInfo.albumID;
-        info.m_data->albumRootId = shortInfo.albumRootID;
-        info.m_data->name        = shortInfo.itemName;
+        {
+            ItemInfoWriteLocker lock(info.m_data);
+            info.m_data->albumId     = shortInfo.albumID;
+            info.m_data->albumRootId = shortInfo.albumRootID;
+            info.m_data->name        = shortInfo.itemName;
+        }
 
         ItemInfoStatic::cache()->cacheByName(info.m_data);
     }
@@ -490,14 +505,14 @@ QString ItemInfo::name() const
         return QString();
     }
 
-    ItemInfoReadLocker lock;
+    ItemInfoReadLocker lock(m_data);
     return m_data->name;
 }
 
 #define RETURN_IF_CACHED(x)       \
     if (m_data->x##Cached)        \
     {                             \
-        ItemInfoReadLocker lock; \
+        ItemInfoReadLocker lock(m_data); \
         if (m_data->x##Cached)    \
         {                         \
             return m_data->x;     \
@@ -507,7 +522,7 @@ QString ItemInfo::name() const
 #define RETURN_ASPECTRATIO_IF_IMAGESIZE_CACHED()       \
     if (m_data->imageSizeCached)  \
     {                             \
-        ItemInfoReadLocker lock; \
+        ItemInfoReadLocker lock(m_data); \
         if (m_data->imageSizeCached)    \
         {                         \
     return (double)m_data->imageSize.width()/m_data->imageSize.height();     \
@@ -515,7 +530,7 @@ QString ItemInfo::name() const
     }
 
 #define STORE_IN_CACHE_AND_RETURN(x, retrieveMethod) \
-    ItemInfoWriteLocker lock;                       \
+    ItemInfoWriteLocker lock(m_data);               \
     m_data.constCastData()->x##Cached = true;        \
     if (!values.isEmpty())                           \
     {                                                \
@@ -532,7 +547,7 @@ qlonglong ItemInfo::fileSize() const
 
     RETURN_IF_CACHED(fileSize)
 
-    QVariantList values = CoreDbAccess().db()->getImagesFields(m_data->id, DatabaseFields::FileSize);
+    QVariantList values = CoreDbReadAccess().db()->getImagesFields(m_data->id, DatabaseFields::FileSize);
 
     STORE_IN_CACHE_AND_RETURN(fileSize, values.first().toLongLong())
 }
@@ -546,7 +561,7 @@ QString ItemInfo::uniqueHash() const
 
     RETURN_IF_CACHED(uniqueHash)
 
-    QVariantList values = CoreDbAccess().db()->getImagesFields(m_data->id, DatabaseFields::UniqueHash);
+    QVariantList values = CoreDbReadAccess().db()->getImagesFields(m_data->id, DatabaseFields::UniqueHash);
 
     STORE_IN_CACHE_AND_RETURN(uniqueHash, values.first().toString())
 }
@@ -567,7 +582,7 @@ QString ItemInfo::title() const
         title = comments.defaultComment(DatabaseComment::Title);
     }
 
-    ItemInfoWriteLocker lock;
+    ItemInfoWriteLocker lock(m_data);
     m_data.constCastData()->defaultTitle       = title;
     m_data.constCastData()->defaultTitleCached = true;
     return m_data->defaultTitle;
@@ -589,7 +604,7 @@ QString ItemInfo::comment() const
         comment = comments.defaultComment();
     }
 
-    ItemInfoWriteLocker lock;
+    ItemInfoWriteLocker lock(m_data);
     m_data.constCastData()->defaultComment       = comment;
     m_data.constCastData()->defaultCommentCached = true;
     return m_data->defaultComment;
@@ -618,7 +633,7 @@ int ItemInfo::pickLabel() const
 
     int pickLabel = TagsCache::instance()->pickLabelFromTags(tagIds());
 
-    ItemInfoWriteLocker lock;
+    ItemInfoWriteLocker lock(m_data);
     m_data.constCastData()->pickLabel       = (pickLabel == -1) ? NoPickLabel : pickLabel;
     m_data.constCastData()->pickLabelCached = true;
     return m_data->pickLabel;
@@ -635,7 +650,7 @@ int ItemInfo::colorLabel() const
 
     int colorLabel = TagsCache::instance()->colorLabelFromTags(tagIds());
 
-    ItemInfoWriteLocker lock;
+    ItemInfoWriteLocker lock(m_data);
     m_data.constCastData()->colorLabel       = (colorLabel == -1) ? NoColorLabel : colorLabel;
     m_data.constCastData()->colorLabelCached = true;
     return m_data->colorLabel;
@@ -650,7 +665,7 @@ int ItemInfo::rating() const
 
     RETURN_IF_CACHED(rating)
 
-    QVariantList values = CoreDbAccess().db()->getItemInformation(m_data->id, DatabaseFields::Rating);
+    QVariantList values = CoreDbReadAccess().db()->getItemInformation(m_data->id, DatabaseFields::Rating);
 
     STORE_IN_CACHE_AND_RETURN(rating, values.first().toLongLong())
 }
@@ -664,7 +679,7 @@ qlonglong ItemInfo::manualOrder() const
 
     RETURN_IF_CACHED(manualOrder)
 
-    QVariantList values = CoreDbAccess().db()->getImagesFields(m_data->id, DatabaseFields::ManualOrder);
+    QVariantList values = CoreDbReadAccess().db()->getImagesFields(m_data->id, DatabaseFields::ManualOrder);
 
     STORE_IN_CACHE_AND_RETURN(manualOrder, values.first().toLongLong())
 }
@@ -678,7 +693,7 @@ QString ItemInfo::format() const
 
     RETURN_IF_CACHED(format)
 
-    QVariantList values = CoreDbAccess().db()->getItemInformation(m_data->id, DatabaseFields::Format);
+    QVariantList values = CoreDbReadAccess().db()->getItemInformation(m_data->id, DatabaseFields::Format);
 
     STORE_IN_CACHE_AND_RETURN(format, values.first().toString())
 }
@@ -692,7 +707,7 @@ DatabaseItem::Category ItemInfo::category() const
 
     RETURN_IF_CACHED(category)
 
-    QVariantList values = CoreDbAccess().db()->getImagesFields(m_data->id, DatabaseFields::Category);
+    QVariantList values = CoreDbReadAccess().db()->getImagesFields(m_data->id, DatabaseFields::Category);
 
     STORE_IN_CACHE_AND_RETURN(category, (DatabaseItem::Category)values.first().toInt())
 }
@@ -706,7 +721,7 @@ QDateTime ItemInfo::dateTime() const
 
     RETURN_IF_CACHED(creationDate)
 
-    QVariantList values = CoreDbAccess().db()->getItemInformation(m_data->id, DatabaseFields::CreationDate);
+    QVariantList values = CoreDbReadAccess().db()->getItemInformation(m_data->id, DatabaseFields::CreationDate);
 
     STORE_IN_CACHE_AND_RETURN(creationDate, values.first().toDateTime())
 }
@@ -720,7 +735,7 @@ QDateTime ItemInfo::modDateTime() const
 
     RETURN_IF_CACHED(modificationDate)
 
-    QVariantList values = CoreDbAccess().db()->getImagesFields(m_data->id, DatabaseFields::ModificationDate);
+    QVariantList values = CoreDbReadAccess().db()->getImagesFields(m_data->id, DatabaseFields::ModificationDate);
 
     STORE_IN_CACHE_AND_RETURN(modificationDate, values.first().toDateTime())
 }
@@ -734,9 +749,9 @@ QSize ItemInfo::dimensions() const
 
     RETURN_IF_CACHED(imageSize)
 
-    QVariantList values = CoreDbAccess().db()->getItemInformation(m_data->id, DatabaseFields::Width | DatabaseFields::Height);
+    QVariantList values = CoreDbReadAccess().db()->getItemInformation(m_data->id, DatabaseFields::Width | DatabaseFields::Height);
 
-    ItemInfoWriteLocker lock;
+    ItemInfoWriteLocker lock(m_data);
     m_data.constCastData()->imageSizeCached = true;
 
     if (values.size() == 2)
@@ -756,9 +771,9 @@ QList<int> ItemInfo::tagIds() const
 
     RETURN_IF_CACHED(tagIds)
 
-    QList<int> ids = CoreDbAccess().db()->getItemTagIDs(m_data->id);
+    QList<int> ids = CoreDbReadAccess().db()->getItemTagIDs(m_data->id);
 
-    ItemInfoWriteLocker lock;
+    ItemInfoWriteLocker lock(m_data);
     m_data.constCastData()->tagIds       = ids;
     m_data.constCastData()->tagIdsCached = true;
     return ids;
@@ -781,9 +796,7 @@ void ItemInfoList::loadTagIds() const
         return;
     }
 
-    QVector<QList<int> > allTagIds = CoreDbAccess().db()->getItemsTagIDs(infoList.toImageIdList());
-
-    ItemInfoWriteLocker lock;
+    QVector<QList<int> > allTagIds = CoreDbReadAccess().db()->getItemsTagIDs(infoList.toImageIdList());
 
     for (int i = 0 ; i < infoList.size() ; ++i)
     {
@@ -795,6 +808,7 @@ void ItemInfoList::loadTagIds() const
             continue;
         }
 
+        ItemInfoWriteLocker lock(info.m_data);
         info.m_data.constCastData()->tagIds       = ids;
         info.m_data.constCastData()->tagIdsCached = true;
     }
@@ -807,7 +821,7 @@ int ItemInfo::orientation() const
         return 0; // ORIENTATION_UNSPECIFIED
     }
 
-    QVariantList values = CoreDbAccess().db()->getItemInformation(m_data->id, DatabaseFields::Orientation);
+    QVariantList values = CoreDbReadAccess().db()->getItemInformation(m_data->id, DatabaseFields::Orientation);
 
     if (values.isEmpty())
     {
@@ -837,7 +851,7 @@ QString ItemInfo::filePath() const
     }
 
     QString album = ItemInfoStatic::cache()->albumRelativePath(m_data->albumId);
-    ItemInfoReadLocker lock;
+    ItemInfoReadLocker lock(m_data);
 
     if (album == QLatin1String("/"))
     {
@@ -856,7 +870,7 @@ bool ItemInfo::isVisible() const
         return false;
     }
 
-    QVariantList value = CoreDbAccess().db()->getImagesFields(m_data->id, DatabaseFields::Status);
+    QVariantList value = CoreDbReadAccess().db()->getImagesFields(m_data->id, DatabaseFields::Status);
 
     if (!value.isEmpty())
     {
@@ -873,7 +887,7 @@ bool ItemInfo::isRemoved() const
         return true;
     }
 
-    QVariantList value = CoreDbAccess().db()->getImagesFields(m_data->id, DatabaseFields::Status);
+    QVariantList value = CoreDbReadAccess().db()->getImagesFields(m_data->id, DatabaseFields::Status);
 
     if (!value.isEmpty())
     {
@@ -906,7 +920,7 @@ bool ItemInfo::hasDerivedImages() const
         return false;
     }
 
-    return CoreDbAccess().db()->hasImagesRelatingTo(m_data->id, DatabaseRelation::DerivedFrom);
+    return CoreDbReadAccess().db()->hasImagesRelatingTo(m_data->id, DatabaseRelation::DerivedFrom);
 }
 
 bool ItemInfo::hasAncestorImages() const
@@ -916,7 +930,7 @@ bool ItemInfo::hasAncestorImages() const
         return false;
     }
 
-    return CoreDbAccess().db()->hasImagesRelatedFrom(m_data->id, DatabaseRelation::DerivedFrom);
+    return CoreDbReadAccess().db()->hasImagesRelatedFrom(m_data->id, DatabaseRelation::DerivedFrom);
 }
 
 QList<ItemInfo> ItemInfo::derivedImages() const
@@ -926,7 +940,7 @@ QList<ItemInfo> ItemInfo::derivedImages() const
         return QList<ItemInfo>();
     }
 
-    return ItemInfoList(CoreDbAccess().db()->getImagesRelatingTo(m_data->id, DatabaseRelation::DerivedFrom));
+    return ItemInfoList(CoreDbReadAccess().db()->getImagesRelatingTo(m_data->id, DatabaseRelation::DerivedFrom));
 }
 
 QList<ItemInfo> ItemInfo::ancestorImages() const
@@ -936,7 +950,7 @@ QList<ItemInfo> ItemInfo::ancestorImages() const
         return QList<ItemInfo>();
     }
 
-    return ItemInfoList(CoreDbAccess().db()->getImagesRelatedFrom(m_data->id, DatabaseRelation::DerivedFrom));
+    return ItemInfoList(CoreDbReadAccess().db()->getImagesRelatedFrom(m_data->id, DatabaseRelation::DerivedFrom));
 }
 
 QList<QPair<qlonglong, qlonglong> > ItemInfo::relationCloud() const
@@ -946,7 +960,7 @@ QList<QPair<qlonglong, qlonglong> > ItemInfo::relationCloud() const
         return QList<QPair<qlonglong, qlonglong> >();
     }
 
-    return CoreDbAccess().db()->getRelationCloud(m_data->id, DatabaseRelation::DerivedFrom);
+    return CoreDbReadAccess().db()->getRelationCloud(m_data->id, DatabaseRelation::DerivedFrom);
 }
 
 void ItemInfo::markDerivedFrom(const ItemInfo& ancestor)
@@ -983,11 +997,11 @@ qlonglong ItemInfo::groupImageId() const
 
     RETURN_IF_CACHED(groupImage)
 
-    QList<qlonglong> ids = CoreDbAccess().db()->getImagesRelatedFrom(m_data->id, DatabaseRelation::Grouped);
+    QList<qlonglong> ids = CoreDbReadAccess().db()->getImagesRelatedFrom(m_data->id, DatabaseRelation::Grouped);
     // list size should be 0 or 1
     int groupImage       = ids.isEmpty() ? -1 : ids.first();
 
-    ItemInfoWriteLocker lock;
+    ItemInfoWriteLocker lock(m_data);
     m_data.constCastData()->groupImage       = groupImage;
     m_data.constCastData()->groupImageCached = true;
     return m_data->groupImage;
@@ -1010,11 +1024,9 @@ void ItemInfoList::loadGroupImageIds() const
         return;
     }
 
-    QVector<QList<qlonglong> > allGroupIds = CoreDbAccess().db()->getImagesRelatedFrom(infoList.toImageIdList(),
+    QVector<QList<qlonglong> > allGroupIds = CoreDbReadAccess().db()->getImagesRelatedFrom(infoList.toImageIdList(),
                                                                                        DatabaseRelation::Grouped);
 
-    ItemInfoWriteLocker lock;
-
     for (int i = 0 ; i < infoList.size() ; ++i)
     {
         const ItemInfo& info            = infoList.at(i);
@@ -1025,6 +1037,7 @@ void ItemInfoList::loadGroupImageIds() const
             continue;
         }
 
+        ItemInfoWriteLocker lock(info.m_data);
         info.m_data.constCastData()->groupImage       = groupIds.isEmpty() ? -1 : groupIds.first();
         info.m_data.constCastData()->groupImageCached = true;
     }
@@ -1054,7 +1067,7 @@ QList<ItemInfo> ItemInfo::groupedImages() const
         return QList<ItemInfo>();
     }
 
-    return ItemInfoList(CoreDbAccess().db()->getImagesRelatingTo(m_data->id, DatabaseRelation::Grouped));
+    return ItemInfoList(CoreDbReadAccess().db()->getImagesRelatingTo(m_data->id, DatabaseRelation::Grouped));
 }
 
 void ItemInfo::addToGroup(const ItemInfo& givenLeader)
@@ -1180,7 +1193,7 @@ ItemPosition ItemInfo::imagePosition() const
 
     if (!m_data->positionsCached)
     {
-        ItemInfoWriteLocker lock;
+        ItemInfoWriteLocker lock(m_data);
         m_data.constCastData()->longitude       = pos.longitudeNumber();
         m_data.constCastData()->latitude        = pos.latitudeNumber();
         m_data.constCastData()->altitude        = pos.altitude();
@@ -1294,7 +1307,7 @@ DImageHistory ItemInfo::imageHistory() const
         return DImageHistory();
     }
 
-    ImageHistoryEntry entry = CoreDbAccess().db()->getItemHistory(m_data->id);
+    ImageHistoryEntry entry = CoreDbReadAccess().db()->getItemHistory(m_data->id);
     return DImageHistory::fromXml(entry.history);
 }
 
@@ -1315,7 +1328,7 @@ bool ItemInfo::hasImageHistory() const
         return false;
     }
 
-    return CoreDbAccess().db()->hasImageHistory(m_data->id);
+    return CoreDbReadAccess().db()->hasImageHistory(m_data->id);
 }
 
 QString ItemInfo::uuid() const
@@ -1325,7 +1338,7 @@ QString ItemInfo::uuid() const
         return QString();
     }
 
-    return CoreDbAccess().db()->getImageUuid(m_data->id);
+    return CoreDbReadAccess().db()->getImageUuid(m_data->id);
 }
 
 void ItemInfo::setUuid(const QString& uuid)
@@ -1650,7 +1663,7 @@ void ItemInfo::setPickLabel(int pickId)
         setTag(pickLabelTags[pickId]);
     }
 
-    ItemInfoWriteLocker lock;
+    ItemInfoWriteLocker lock(m_data);
     m_data->pickLabel       = pickId;
     m_data->pickLabelCached = true;
 }
@@ -1681,7 +1694,7 @@ void ItemInfo::setColorLabel(int colorId)
         setTag(colorLabelTags[colorId]);
     }
 
-    ItemInfoWriteLocker lock;
+    ItemInfoWriteLocker lock(m_data);
     m_data->colorLabel       = colorId;
     m_data->colorLabelCached = true;
 }
@@ -1695,7 +1708,7 @@ void ItemInfo::setRating(int value)
 
     CoreDbAccess().db()->changeItemInformation(m_data->id, QVariantList() << value, DatabaseFields::Rating);
 
-    ItemInfoWriteLocker lock;
+    ItemInfoWriteLocker lock(m_data);
     m_data->rating       = value;
     m_data->ratingCached = true;
 }
@@ -1709,7 +1722,7 @@ void ItemInfo::setManualOrder(qlonglong value)
 
     CoreDbAccess().db()->setItemManualOrder(m_data->id, value);
 
-    ItemInfoWriteLocker lock;
+    ItemInfoWriteLocker lock(m_data);
     m_data->manualOrder       = value;
     m_data->manualOrderCached = true;
 }
@@ -1733,8 +1746,11 @@ void ItemInfo::setName(const QString& newName)
 
     CoreDbAccess().db()->renameItem(m_data->id, newName);
 
-    ItemInfoWriteLocker lock;
-    m_data->name = newName;
+    {
+        ItemInfoWriteLocker lock(m_data);
+        m_data->name = newName;
+    }
+
     ItemInfoStatic::cache()->cacheByName(m_data);
 }
 
@@ -1747,7 +1763,7 @@ void ItemInfo::setDateTime(const QDateTime& dateTime)
 
     CoreDbAccess().db()->changeItemInformation(m_data->id, QVariantList() << dateTime, DatabaseFields::CreationDate);
 
-    ItemInfoWriteLocker lock;
+    ItemInfoWriteLocker lock(m_data);
     m_data->creationDate       = dateTime;
     m_data->creationDateCached = true;
 }
@@ -1761,7 +1777,7 @@ void ItemInfo::setModDateTime(const QDateTime& dateTime)
 
     CoreDbAccess().db()->setItemModificationDate(m_data->id, dateTime);
 
-    ItemInfoWriteLocker lock;
+    ItemInfoWriteLocker lock(m_data);
     m_data->modificationDate       = dateTime;
     m_data->modificationDateCached = true;
 }
@@ -1817,7 +1833,7 @@ ItemInfo ItemInfo::copyItem(int dstAlbumID, const QString& dstFileName)
     }
 
     {
-        ItemInfoReadLocker lock;
+        ItemInfoReadLocker lock(m_data);
 
         if (dstAlbumID == m_data->albumId && dstFileName == m_data->name)
         {
@@ -1872,7 +1888,7 @@ qlonglong ItemInfo::currentReferenceImage() const
 
 QList<ItemInfo> ItemInfo::fromUniqueHash(const QString& uniqueHash, qlonglong fileSize)
 {
-    QList<ItemScanInfo> scanInfos = CoreDbAccess().db()->getIdenticalFiles(uniqueHash, fileSize);
+    QList<ItemScanInfo> scanInfos = CoreDbReadAccess().db()->getIdenticalFiles(uniqueHash, fileSize);
     QList<ItemInfo> infos;
 
     foreach (const ItemScanInfo& scanInfo, scanInfos)
@@ -1941,7 +1957,7 @@ ItemInfo::DatabaseFieldsHashRaw ItemInfo::getDatabaseFieldsRaw(const DatabaseFie
     ItemInfo::DatabaseFieldsHashRaw cachedHash;
     // consolidate to one ReadLocker. In particular, the shallow copy of the QHash must be done under protection
     {
-        ItemInfoReadLocker lock;
+        ItemInfoReadLocker lock(m_data);
         cachedVideoMetadata = m_data->videoMetadataCached;
         cachedImageMetadata = m_data->imageMetadataCached;
         cachedHash = m_data->databaseFieldsHashRaw;
@@ -1954,9 +1970,9 @@ ItemInfo::DatabaseFieldsHashRaw ItemInfo::getDatabaseFieldsRaw(const DatabaseFie
 
         if (missingVideoMetadata)
         {
-            const QVariantList fieldValues = CoreDbAccess().db()->getVideoMetadata(m_data->id, missingVideoMetadata);
+            const QVariantList fieldValues = CoreDbReadAccess().db()->getVideoMetadata(m_data->id, missingVideoMetadata);
 
-            ItemInfoWriteLocker lock;
+            ItemInfoWriteLocker lock(m_data);
 
             if (fieldValues.isEmpty())
             {
@@ -1990,9 +2006,9 @@ ItemInfo::DatabaseFieldsHashRaw ItemInfo::getDatabaseFieldsRaw(const DatabaseFie
 
         if (missingImageMetadata)
         {
-            const QVariantList fieldValues = CoreDbAccess().db()->getImageMetadata(m_data->id, missingImageMetadata);
+            const QVariantList fieldValues = CoreDbReadAccess().db()->getImageMetadata(m_data->id, missingImageMetadata);
 
-            ItemInfoWriteLocker lock;
+            ItemInfoWriteLocker lock(m_data);
 
             if (fieldValues.isEmpty())
             {
@@ -67,7 +67,7 @@ ItemInfoCache::~ItemInfoCache()
 template <class T>
 DSharedDataPointer<T> toStrongRef(T* weakRef)
 {
-    // Called under read lock
+    // Called under the lock of the hash containing weakRef
     if (!weakRef)
     {
         return DSharedDataPointer<T>();
@@ -104,6 +104,12 @@ static bool lessThanForAlbumShortInfo(const AlbumShortInfo& first, const AlbumSh
     return first.id < second.id;
 }
 
+ItemInfoCache::Shard& ItemInfoCache::shard(qlonglong id)
+{
+    // Image ids are sequential, consecutive images are in different shards
+    return m_shards[(quint64)id % NumberOfShards];
+}
+
 void ItemInfoCache::checkAlbums()
 {
     if (m_needUpdateAlbums)
@@ -111,7 +117,7 @@ void ItemInfoCache::checkAlbums()
         // list comes sorted from db
         QList<AlbumShortInfo> infos = CoreDbAccess().db()->getAlbumShortInfos();
 
-        ItemInfoWriteLocker lock;
+        QWriteLocker lock(&m_albumLock);
         m_albums                    = infos;
         m_needUpdateAlbums          = false;
     }
@@ -123,20 +129,22 @@ int ItemInfoCache::getImageGroupedCount(qlonglong id)
     {
         QList<qlonglong> ids = CoreDbAccess().db()->getRelatedImagesToByType(DatabaseRelation::Grouped);
 
-        ItemInfoWriteLocker lock;
+        QWriteLocker lock(&m_albumLock);
         m_grouped            = ids;
         m_needUpdateGrouped  = false;
     }
 
-    ItemInfoReadLocker lock;
+    QReadLocker lock(&m_albumLock);
     return m_grouped.count(id);
 }
 
 DSharedDataPointer<ItemInfoData> ItemInfoCache::infoForId(qlonglong id)
 {
+    Shard& idShard = shard(id);
+
     {
-        ItemInfoReadLocker lock;
-        DSharedDataPointer<ItemInfoData> ptr = toStrongRef(m_infos.value(id));
+        QReadLocker lock(&idShard.lock);
+        DSharedDataPointer<ItemInfoData> ptr = toStrongRef(idShard.infos.value(id));
 
         if (ptr)
         {
@@ -144,49 +152,83 @@ DSharedDataPointer<ItemInfoData> ItemInfoCache::infoForId(qlonglong id)
         }
     }
 
-    ItemInfoWriteLocker lock;
+    QWriteLocker lock(&idShard.lock);
+
+    // Another thread may have created the data in the meantime
+    DSharedDataPointer<ItemInfoData> ptr = toStrongRef(idShard.infos.value(id));
+
+    if (ptr)
+    {
+        return ptr;
+    }
+
     ItemInfoData* const data = new ItemInfoData();
-    data->id                  = id;
-    m_infos[id]               = data;
+    data->id                 = id;
+    idShard.infos[id]        = data;
 
     return DSharedDataPointer<ItemInfoData>(data);
 }
 
 void ItemInfoCache::cacheByName(ItemInfoData* const data)
 {
-    // Called with Write lock
+    if (!data)
+    {
+        return;
+    }
 
-    if (!data || data->id == -1 || data->name.isEmpty())
+    QWriteLocker nameLock(&m_nameLock);
+    qlonglong    id;
+    QString      name;
+
+    {
+        ItemInfoReadLocker lock(data);
+        id   = data->id;
+        name = data->name;
+    }
+
+    if (id == -1 || name.isEmpty())
     {
         return;
     }
 
     // Called in a context where we can assume that the entry is not yet cached by name (newly created data)
     m_nameHash.remove(m_dataHash.value(data), data);
-    m_nameHash.insert(data->name, data);
-    m_dataHash.insert(data, data->name);
+    m_nameHash.insert(name, data);
+    m_dataHash.insert(data, name);
 }
 
 DSharedDataPointer<ItemInfoData> ItemInfoCache::infoForPath(int albumRootId, const QString& relativePath, const QString& name)
 {
-    ItemInfoReadLocker lock;
+    QReadLocker nameLock(&m_nameLock);
     // We check all entries in the multi hash with matching file name
     QMultiHash<QString, ItemInfoData*>::const_iterator it;
 
     for (it = m_nameHash.constFind(name) ; it != m_nameHash.constEnd() && it.key() == name ; ++it)
     {
+        int dataAlbumRootId;
+        int dataAlbumId;
+
+        {
+            ItemInfoReadLocker lock(it.value());
+            dataAlbumRootId = it.value()->albumRootId;
+            dataAlbumId     = it.value()->albumId;
+        }
+
         // first check that album root matches
-        if (it.value()->albumRootId != albumRootId)
+        if (dataAlbumRootId != albumRootId)
         {
             continue;
         }
 
         // check that relativePath matches. We get relativePath from entry's id and compare to given name.
-        QList<AlbumShortInfo>::const_iterator albumIt = findAlbum(it.value()->albumId);
-
-        if (albumIt == m_albums.constEnd() || albumIt->relativePath != relativePath)
         {
-            continue;
+            QReadLocker albumLock(&m_albumLock);
+            QList<AlbumShortInfo>::const_iterator albumIt = findAlbum(dataAlbumId);
+
+            if (albumIt == m_albums.constEnd() || albumIt->relativePath != relativePath)
+            {
+                continue;
+            }
         }
 
         // we have now a match by name, albumRootId and relativePath
@@ -203,9 +245,18 @@ void ItemInfoCache::dropInfo(ItemInfoData* const infodata)
         return;
     }
 
-    ItemInfoWriteLocker lock;
+    // Lock all hashes which can return a weak reference to the data before deleting it
+    Shard& idShard = shard(infodata->id);
+    QWriteLocker lock(&idShard.lock);
+    QWriteLocker nameLock(&m_nameLock);
+
+    QHash<qlonglong, ItemInfoData*>::iterator it = idShard.infos.find(infodata->id);
 
-    m_infos.remove(infodata->id);
+    // The id may already refer to newer data
+    if (it != idShard.infos.end() && *it == infodata)
+    {
+        idShard.infos.erase(it);
+    }
 
     m_nameHash.remove(m_dataHash.value(infodata), infodata);
     m_nameHash.remove(infodata->name, infodata);
@@ -215,7 +266,7 @@ void ItemInfoCache::dropInfo(ItemInfoData* const infodata)
 
 QList<AlbumShortInfo>::const_iterator ItemInfoCache::findAlbum(int id)
 {
-    // Called with read lock
+    // Called with album lock
     AlbumShortInfo info;
     info.id = id;
     // we use the fact that d->infos is sorted by id
@@ -225,7 +276,7 @@ QList<AlbumShortInfo>::const_iterator ItemInfoCache::findAlbum(int id)
 QString ItemInfoCache::albumRelativePath(int albumId)
 {
     checkAlbums();
-    ItemInfoReadLocker lock;
+    QReadLocker lock(&m_albumLock);
     QList<AlbumShortInfo>::const_iterator it = findAlbum(albumId);
 
     if (it != m_albums.constEnd())
@@ -238,41 +289,63 @@ QString ItemInfoCache::albumRelativePath(int albumId)
 
 void ItemInfoCache::invalidate()
 {
-    ItemInfoWriteLocker lock;
-    QHash<qlonglong, ItemInfoData*>::iterator it;
+    for (int i = 0 ; i < NumberOfShards ; ++i)
+    {
+        m_shards[i].lock.lockForWrite();
+    }
 
-    for (it = m_infos.begin() ; it != m_infos.end() ; ++it)
     {
-        if ((*it)->isReferenced())
-        {
-            (*it)->invalid = true;
-            (*it)->id      = -1;
-        }
-        else
+        QWriteLocker nameLock(&m_nameLock);
+
+        for (int i = 0 ; i < NumberOfShards ; ++i)
         {
-            delete *it;
+            QHash<qlonglong, ItemInfoData*>::iterator it;
+
+            for (it = m_shards[i].infos.begin() ; it != m_shards[i].infos.end() ; ++it)
+            {
+                if ((*it)->isReferenced())
+                {
+                    ItemInfoWriteLocker lock(*it);
+                    (*it)->invalid = true;
+                    (*it)->id      = -1;
+                }
+                else
+                {
+                    delete *it;
+                }
+            }
+
+            m_shards[i].infos.clear();
         }
+
+        m_nameHash.clear();
+        m_dataHash.clear();
     }
 
-    m_infos.clear();
+    for (int i = NumberOfShards - 1 ; i >= 0 ; --i)
+    {
+        m_shards[i].lock.unlock();
+    }
+
+    QWriteLocker albumLock(&m_albumLock);
     m_albums.clear();
     m_grouped.clear();
-    m_nameHash.clear();
-    m_dataHash.clear();
     m_needUpdateAlbums  = true;
     m_needUpdateGrouped = true;
 }
 
 void ItemInfoCache::slotImageChanged(const ImageChangeset& changeset)
 {
-    ItemInfoWriteLocker lock;
-
     foreach (const qlonglong& imageId, changeset.ids())
     {
-        QHash<qlonglong, ItemInfoData*>::iterator it = m_infos.find(imageId);
+        Shard& idShard = shard(imageId);
+        QReadLocker shardLock(&idShard.lock);
+        QHash<qlonglong, ItemInfoData*>::const_iterator it = idShard.infos.constFind(imageId);
 
-        if (it != m_infos.end())
+        if (it != idShard.infos.constEnd())
         {
+            ItemInfoWriteLocker lock(*it);
+
             // invalidate the relevant field. It will be lazy-loaded at first access.
             DatabaseFields::Set changes = changeset.changes();
 
@@ -371,14 +444,16 @@ void ItemInfoCache::slotImageTagChanged(const ImageTagChangeset& changeset)
         return;
     }
 
-    ItemInfoWriteLocker lock;
-
     foreach (const qlonglong& imageId, changeset.ids())
     {
-        QHash<qlonglong, ItemInfoData*>::iterator it = m_infos.find(imageId);
+        Shard& idShard = shard(imageId);
+        QReadLocker shardLock(&idShard.lock);
+        QHash<qlonglong, ItemInfoData*>::const_iterator it = idShard.infos.constFind(imageId);
 
-        if (it != m_infos.end())
+        if (it != idShard.infos.constEnd())
         {
+            ItemInfoWriteLocker lock(*it);
+
             (*it)->tagIdsCached     = false;
             (*it)->colorLabelCached = false;
             (*it)->pickLabelCached  = false;
@@ -30,6 +30,7 @@
 #include <QMultiHash>
 #include <QHash>
 #include <QObject>
+#include <QReadWriteLock>
 
 // Local includes
 
@@ -42,6 +43,12 @@ namespace Digikam
 class AlbumShortInfo;
 class ItemInfoData;
 
+/**
+ * The cache is split in independently locked parts: the data by id in shards selected by the id,
+ * the data by name, and the album and group information. The fields of each data object are
+ * protected by the locks of ItemInfoStatic. Locks are acquired in this order: shard, name,
+ * album or data lock.
+ */
 // No EXPORT class
 class ItemInfoCache : public QObject
 {
@@ -68,7 +75,7 @@ public:
     /**
      * Call this to put data in the hash by file name if you have newly created data
      * and the name is filled.
-     * Call under write lock.
+     * Do not call while holding the lock of the data.
      */
     void cacheByName(ItemInfoData* const data);
 
@@ -102,14 +109,32 @@ private Q_SLOTS:
 
 private:
 
+    class Shard
+    {
+    public:
+
+        QReadWriteLock                  lock;
+        QHash<qlonglong, ItemInfoData*> infos;
+    };
+
+    enum
+    {
+        NumberOfShards = 16
+    };
+
+    Shard&                                shard(qlonglong id);
     QList<AlbumShortInfo>::const_iterator findAlbum(int id);
     void                                  checkAlbums();
 
 private:
 
-    QHash<qlonglong, ItemInfoData*>    m_infos;
-    QHash<ItemInfoData*, QString>      m_dataHash;
-    QMultiHash<QString, ItemInfoData*> m_nameHash;
+    Shard                               m_shards[NumberOfShards];
+
+    QReadWriteLock                      m_nameLock;
+    QHash<ItemInfoData*, QString>       m_dataHash;
+    QMultiHash<QString, ItemInfoData*>  m_nameHash;
+
+    QReadWriteLock                      m_albumLock;
     volatile bool                       m_needUpdateAlbums;
     volatile bool                       m_needUpdateGrouped;
     QList<qlonglong>                    m_grouped;
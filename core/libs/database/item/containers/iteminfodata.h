@@ -45,6 +45,8 @@
 namespace Digikam
 {
 
+class ItemInfoData;
+
 class ItemInfoStatic
 {
 public:
@@ -54,22 +56,48 @@ public:
 
     static ItemInfoCache* cache();
 
+    /**
+     * Returns the lock protecting the fields of the given data.
+     * The data objects share a fixed number of locks, so that threads
+     * accessing different items rarely wait for each other.
+     */
+    static QReadWriteLock* lockForData(const ItemInfoData* const data);
+
 public:
 
+    /// A prime number, heap addresses are not evenly distributed modulo powers of two
+    enum
+    {
+        NumberOfDataLocks = 61
+    };
+
+    /// Each lock on its own cache line, readers of different locks do not slow down each other
+    class DataLock
+    {
+    public:
+
+        QReadWriteLock lock;
+        char           padding[64 - sizeof(QReadWriteLock)];
+    };
+
     ItemInfoCache          m_cache;
-    QReadWriteLock          m_lock;
+    DataLock               m_dataLocks[NumberOfDataLocks];
 
     static ItemInfoStatic* m_instance;
 };
 
 // -----------------------------------------------------------------------------------
 
+/**
+ * Locks the fields of one ItemInfoData. Do not lock the data of a second item
+ * or call into ItemInfoCache while the lock is held.
+ */
 class ItemInfoReadLocker : public QReadLocker
 {
 public:
 
-    explicit ItemInfoReadLocker()
-        : QReadLocker(&ItemInfoStatic::m_instance->m_lock)
+    explicit ItemInfoReadLocker(const ItemInfoData* const data)
+        : QReadLocker(ItemInfoStatic::lockForData(data))
     {
     }
 };
@@ -80,8 +108,8 @@ class ItemInfoWriteLocker : public QWriteLocker
 {
 public:
 
-    explicit ItemInfoWriteLocker()
-        : QWriteLocker(&ItemInfoStatic::m_instance->m_lock)
+    explicit ItemInfoWriteLocker(const ItemInfoData* const data)
+        : QWriteLocker(ItemInfoStatic::lockForData(data))
     {
     }
 };
@@ -43,9 +43,11 @@ void ItemLister::listPAlbum(ItemListerReceiver* const receiver,
 
     QList<QVariant> albumIds;
 
+    // The listing only reads, it does not need to wait for writers of other threads
+
     if (d->recursive)
     {
-        QList<int> intAlbumIds = CoreDbAccess().db()->getAlbumAndSubalbumsForPath(albumRootId, album);
+        QList<int> intAlbumIds = CoreDbReadAccess().db()->getAlbumAndSubalbumsForPath(albumRootId, album);
 
         if (intAlbumIds.isEmpty())
         {
@@ -59,7 +61,7 @@ void ItemLister::listPAlbum(ItemListerReceiver* const receiver,
     }
     else
     {
-        int albumId = CoreDbAccess().db()->getAlbumForPath(albumRootId, album, false);
+        int albumId = CoreDbReadAccess().db()->getAlbumForPath(albumRootId, album, false);
 
         if (albumId == -1)
         {
@@ -83,7 +85,7 @@ void ItemLister::listPAlbum(ItemListerReceiver* const receiver,
     if (d->recursive)
     {
         // SQLite allows no more than 999 parameters
-        const int maxParams = CoreDbAccess().backend()->maximumBoundValues();
+        const int maxParams = CoreDbReadAccess().backend()->maximumBoundValues();
 
         for (int i = 0 ; i < albumIds.size() ; i++)
         {
@@ -92,7 +94,7 @@ void ItemLister::listPAlbum(ItemListerReceiver* const receiver,
             i                  += ids.count();
 
             QList<QVariant> v;
-            CoreDbAccess  access;
+            CoreDbReadAccess access;
             q += QString::fromUtf8("Images.album IN (");
             access.db()->addBoundValuePlaceholders(q, ids.size());
             q += QString::fromUtf8(");");
@@ -103,7 +105,7 @@ void ItemLister::listPAlbum(ItemListerReceiver* const receiver,
     }
     else
     {
-        CoreDbAccess access;
+        CoreDbReadAccess access;
         query += QString::fromUtf8("Images.album = ?;");
         access.backend()->execSql(query, albumIds, &values);
     }
@@ -902,6 +902,16 @@ bool ItemQueryBuilder::buildField(QString& sql, SearchXmlCachingReader& reader,
 
         sql += QLatin1String(" ( ");
 
+        // The full-text index narrows down the candidates,
+        // the comparisons below decide on the result.
+
+        if (relation == SearchXml::Like && buildSearchTextField(sql, reader.value(), boundValues))
+        {
+            sql += QLatin1String(" AND ");
+        }
+
+        sql += QLatin1String(" ( ");
+
         addSqlOperator(sql, SearchXml::Or, true);
         buildField(sql, reader, QLatin1String("albumname"), boundValues, hooks);
 
@@ -923,7 +933,7 @@ bool ItemQueryBuilder::buildField(QString& sql, SearchXmlCachingReader& reader,
         addSqlOperator(sql, SearchXml::Or, false);
         buildField(sql, reader, QLatin1String("title"), boundValues, hooks);
 
-        sql += QLatin1String(" ) ");
+        sql += QLatin1String(" ) ) ");
     }
     else if (name == QLatin1String("similarity"))
     {
@@ -1355,6 +1365,63 @@ QString ItemQueryBuilder::buildQueryFromUrl(const QUrl& url, QList<QVariant>* bo
     return sqlQuery;
 }
 
+bool ItemQueryBuilder::buildSearchTextField(QString& sql, const QString& text,
+                                            QList<QVariant>* boundValues) const
+{
+    // The trigram index finds every entry which contains the text as a substring,
+    // so it returns at least the matches of the LIKE comparisons.
+    // Shorter texts have no trigram, and the LIKE wildcards have no equivalent.
+
+    if (text.toUcs4().size() < 3 || text.contains(QLatin1Char('%')) || text.contains(QLatin1Char('_')))
+    {
+        return false;
+    }
+
+    // The index is updated in the background. The images changed since then are
+    // added to the candidates. Without the indexer of the main application, or
+    // after changes of albums and tags, the entries may be outdated.
+
+    CoreDbSearchTextIndexer* const indexer = CoreDbAccess::searchTextIndexer();
+    QList<qlonglong>               pendingIds;
+
+    if (!indexer)
+    {
+        return false;
+    }
+
+    {
+        CoreDbAccess access;
+
+        if (!access.db()->hasSearchTextIndex() || !indexer->pendingImageIds(pendingIds))
+        {
+            return false;
+        }
+    }
+
+    QString phrase = text;
+    phrase.replace(QLatin1Char('"'), QLatin1String("\"\""));
+
+    sql += QString::fromUtf8(" (Images.id IN "
+           " (SELECT rowid FROM ImageSearchText WHERE ImageSearchText MATCH ?) ");
+    *boundValues << QString::fromUtf8("{name album tags comments} : \"%1\"").arg(phrase);
+
+    if (!pendingIds.isEmpty())
+    {
+        QStringList ids;
+
+        foreach (const qlonglong& id, pendingIds)
+        {
+            ids << QString::number(id);
+        }
+
+        sql += QString::fromUtf8(" OR Images.id IN (%1) ").arg(ids.join(QLatin1Char(',')));
+    }
+
+    sql += QLatin1String(") ");
+
+    return true;
+}
+
 QString ItemQueryBuilder::possibleDate(const QString& str, bool& exact) const
 {
     QDate date = QDate::fromString(str, Qt::ISODate);
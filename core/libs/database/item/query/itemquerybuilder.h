@@ -72,6 +72,9 @@ protected:
     bool buildField(QString& sql, SearchXmlCachingReader& reader, const QString& name,
                     QList<QVariant>* boundValues, ItemQueryPostHooks* const hooks) const;
 
+    bool buildSearchTextField(QString& sql, const QString& text,
+                              QList<QVariant>* boundValues) const;
+
     QString possibleDate(const QString& str, bool& exact) const;
 
 protected:
@@ -67,6 +67,11 @@ void ItemScanner::setCategory(DatabaseItem::Category category)
     d->scanInfo.category = category;
 }
 
+void ItemScanner::setUniqueHashVersion(int version)
+{
+    d->uniqueHashVersion = version;
+}
+
 const ItemScanInfo& ItemScanner::itemScanInfo() const
 {
     return d->scanInfo;
@@ -88,6 +88,13 @@ public:
      */
     const ItemScanInfo& itemScanInfo() const;
 
+    /**
+     * Inform the scanner about the version of the unique hash, as returned by
+     * CoreDB::getUniqueHashVersion(). Otherwise loadFromDisk() reads the version
+     * from the database. Set it to load a file without accessing the database.
+     */
+    void setUniqueHashVersion(int version);
+
     /**
      * Loads data from disk (metadata, image file properties).
      * This method is called from any of the main entry points above.
@@ -145,6 +152,19 @@ public:
      */
     void commit();
 
+    /**
+     * Alternative to commit() for a new file, to write it with other new files.
+     * Returns false if the file cannot be written by CoreDB::addItems(), then call
+     * commit(). Otherwise, record is filled with the rows of the file: call
+     * commitScanRecord() with the record after it was passed to CoreDB::addItems().
+     */
+    bool fillScanRecord(ItemScanRecord& record);
+
+    /**
+     * Commits the scanned information which is not part of the record.
+     */
+    void commitScanRecord(const ItemScanRecord& record);
+
     /**
      * Returns the image id of the scanned file, if (yet) available.
      */
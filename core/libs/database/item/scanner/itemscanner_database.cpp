@@ -101,6 +101,111 @@ void ItemScanner::commit()
     commitImageHistory();
 }
 
+bool ItemScanner::fillScanRecord(ItemScanRecord& record)
+{
+    if (d->commit.operation != ItemScannerCommit::AddItem ||
+        d->commit.copyImageAttributesId != -1)
+    {
+        return false;
+    }
+
+    // An identical removed image is reused by commitAddImage()
+
+    if (CoreDbAccess().db()->getImageId(-1, d->scanInfo.itemName, DatabaseItem::Status::Trashed,
+                                        d->scanInfo.category, d->scanInfo.modificationDate,
+                                        d->scanInfo.fileSize, d->scanInfo.uniqueHash) != -1)
+    {
+        return false;
+    }
+
+    qCDebug(DIGIKAM_DATABASE_LOG) << "Scanning took" << d->time.restart() << "ms";
+
+    record.scanInfo = d->scanInfo;
+
+    if (d->commit.commitItemInformation)
+    {
+        record.imageInformationFields = d->commit.imageInformationFields;
+        record.imageInformationInfos  = d->commit.imageInformationInfos;
+    }
+
+    if (d->commit.commitImageMetadata || d->commit.commitVideoMetadata)
+    {
+        record.isVideo       = d->commit.commitVideoMetadata && !d->commit.commitImageMetadata;
+        record.metadataInfos = d->commit.imageMetadataInfos;
+    }
+
+    if (d->commit.commitItemPosition)
+    {
+        record.positionInfos = d->commit.imagePositionInfos;
+    }
+
+    if (d->commit.commitItemComments)
+    {
+        // The same rows as written by ItemComments for an item without comments
+
+        for (CaptionsMap::const_iterator it = d->commit.captions.constBegin() ;
+             it != d->commit.captions.constEnd() ; ++it)
+        {
+            CommentInfo comment;
+            comment.type     = DatabaseComment::Comment;
+            comment.language = it.key().isEmpty() ? QLatin1String("x-default") : it.key();
+            comment.author   = it.value().author;
+            comment.date     = it.value().date;
+            comment.comment  = it.value().caption;
+            record.comments << comment;
+        }
+
+        if (!d->commit.headline.isNull())
+        {
+            CommentInfo comment;
+            comment.type     = DatabaseComment::Headline;
+            comment.language = QLatin1String("x-default");
+            comment.comment  = d->commit.headline;
+            record.comments << comment;
+        }
+
+        if (!d->commit.title.isNull())
+        {
+            CommentInfo comment;
+            comment.type     = DatabaseComment::Title;
+            comment.language = QLatin1String("x-default");
+            comment.comment  = d->commit.title;
+            record.comments << comment;
+        }
+    }
+
+    record.tagIds = d->commit.tagIds;
+
+    return true;
+}
+
+void ItemScanner::commitScanRecord(const ItemScanRecord& record)
+{
+    d->scanInfo.id = record.scanInfo.id;
+
+    if (d->scanInfo.id == -1)
+    {
+        return;
+    }
+
+    if (d->commit.commitItemCopyright)
+    {
+        commitItemCopyright();
+    }
+
+    if (d->commit.commitIPTCCore)
+    {
+        commitIPTCCore();
+    }
+
+    if (d->commit.commitFaces)
+    {
+        commitFaces();
+    }
+
+    commitImageHistory();
+}
+
 void ItemScanner::newFile(int albumId)
 {
     loadFromDisk();
@@ -414,17 +414,20 @@ bool ItemScanner::hasHistoryToResolve() const
 
 QString ItemScanner::uniqueHash() const
 {
+    const bool hashV2 = (d->uniqueHashVersion == -1) ? CoreDbAccess().db()->isUniqueHashV2()
+                                                     : (d->uniqueHashVersion == 2);
+
     // the QByteArray is an ASCII hex string
     if (d->scanInfo.category == DatabaseItem::Image)
     {
-        if (CoreDbAccess().db()->isUniqueHashV2())
+        if (hashV2)
             return QString::fromUtf8(d->img.getUniqueHashV2());
         else
             return QString::fromUtf8(d->img.getUniqueHash());
     }
     else
     {
-        if (CoreDbAccess().db()->isUniqueHashV2())
+        if (hashV2)
             return QString::fromUtf8(DImg::getUniqueHashV2(d->fileInfo.filePath()));
         else
             return QString::fromUtf8(DImg::getUniqueHash(d->fileInfo.filePath()));
@@ -120,6 +120,7 @@ ItemScanner::Private::Private()
     : hasImage(false),
       hasMetadata(false),
       loadedFromDisk(false),
+      uniqueHashVersion(-1),
       scanMode(ModifiedScan),
       hasHistoryToResolve(false)
 {
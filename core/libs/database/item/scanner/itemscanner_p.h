@@ -142,6 +142,7 @@ public:
     bool                   hasImage;
     bool                   hasMetadata;
     bool                   loadedFromDisk;
+    int                    uniqueHashVersion;
 
     QFileInfo              fileInfo;
 
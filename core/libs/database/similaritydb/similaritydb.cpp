@@ -31,6 +31,7 @@
 #include <QFile>
 #include <QFileInfo>
 #include <QDir>
+#include <QUuid>
 
 // Local includes
 
@@ -266,6 +267,18 @@ void SimilarityDb::copySimilarityAttributes(qlonglong srcId, qlonglong dstId)
                                      "SELECT ?, modificationDate, uniqueHash, matrix "
                                      " FROM ImageHaarMatrix WHERE imageid=?;"),
                    dstId, srcId);
+
+    updateFingerprintsRevision();
+}
+
+QString SimilarityDb::getFingerprintsRevision()
+{
+    return getSetting(QLatin1String("FingerprintsRevision"));
+}
+
+void SimilarityDb::updateFingerprintsRevision()
+{
+    setSetting(QLatin1String("FingerprintsRevision"), QUuid::createUuid().toString());
 }
 
 
@@ -276,6 +289,8 @@ void SimilarityDb::removeImageFingerprint(qlonglong imageID,
     {
         d->db->execSql(QString::fromUtf8("DELETE FROM ImageHaarMatrix WHERE imageid=?;"),
                        imageID);
+
+        updateFingerprintsRevision();
     }
     else if (algorithm == FuzzyAlgorithm::TfIdf)
     {
@@ -142,6 +142,19 @@ public:
     void copySimilarityAttributes(qlonglong srcId,
                                   qlonglong destId);
 
+    /**
+     * Returns a token which changes each time fingerprints are added, changed or removed.
+     * It is used to check if a cached copy of the fingerprints is still valid.
+     * @return The revision token, or an empty string if none was set yet.
+     */
+    QString getFingerprintsRevision();
+
+    /**
+     * Sets a new fingerprints revision token. This must be called after each change
+     * of the ImageHaarMatrix table.
+     */
+    void updateFingerprintsRevision();
+
     // ----------- Methods for image similarity table access ----------
 
     /**
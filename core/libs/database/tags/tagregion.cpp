@@ -31,6 +31,7 @@
 // Local includes
 
 #include "dimg.h"
+#include "metaengine.h"
 
 namespace Digikam
 {
@@ -290,6 +291,41 @@ QRect TagRegion::ajustToFlippedImg(const QRect& region, const QSize& fullSize, i
     return QRect(newx, newy, neww, newh);
 }
 
+QRect TagRegion::mapToStoredOrientation(const QRect& region, const QSize& storedSize, int orientation)
+{
+    int x, y, w, h;
+    region.getRect(&x, &y, &w, &h);
+    const int sw = storedSize.width();
+    const int sh = storedSize.height();
+
+    switch (orientation)
+    {
+        case MetaEngine::ORIENTATION_HFLIP:
+            return QRect(sw - x - w, y, w, h);
+
+        case MetaEngine::ORIENTATION_ROT_180:
+            return QRect(sw - x - w, sh - y - h, w, h);
+
+        case MetaEngine::ORIENTATION_VFLIP:
+            return QRect(x, sh - y - h, w, h);
+
+        case MetaEngine::ORIENTATION_ROT_90_HFLIP:
+            return QRect(y, x, h, w);
+
+        case MetaEngine::ORIENTATION_ROT_90:
+            return QRect(y, sh - x - w, h, w);
+
+        case MetaEngine::ORIENTATION_ROT_90_VFLIP:
+            return QRect(sw - y - h, sh - x - w, h, w);
+
+        case MetaEngine::ORIENTATION_ROT_270:
+            return QRect(sw - y - h, x, h, w);
+
+        default:
+            return region;
+    }
+}
+
 QDebug operator<<(QDebug dbg, const TagRegion& r)
 {
     QVariant var = r.toVariant();
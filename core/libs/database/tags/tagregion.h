@@ -135,6 +135,12 @@ public:
      */
     static QRect ajustToFlippedImg(const QRect& region, const QSize& fullSize, int flip);
 
+    /**
+     * Maps a rectangle of an image displayed with the Exif orientation to the image
+     * as stored in the file, which has storedSize.
+     */
+    static QRect mapToStoredOrientation(const QRect& region, const QSize& storedSize, int orientation);
+
 protected:
 
     QVariant m_value;
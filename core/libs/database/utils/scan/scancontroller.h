@@ -152,8 +152,10 @@ public:
     /**
      * Scan Whole collection without to display a progress dialog
      * or to manage splashscreen, as for NewItemsFinder tool.
+     * With fastScan, the files of albums whose directory was not modified
+     * since the last scan are skipped, see CollectionScanner::setPerformFastScan().
      */
-    void completeCollectionScanInBackground(bool defer);
+    void completeCollectionScanInBackground(bool defer, bool fastScan = false);
 
     /**
      * Schedules a scan of the specified part of the collection.
@@ -216,7 +218,7 @@ private:
      */
     void scanFileDirectly(const QString& filePath);
     void scanFileDirectlyNormal(const ItemInfo& info);
-    void completeCollectionScanCore(bool needTotalFiles, bool defer);
+    void completeCollectionScanCore(bool needTotalFiles, bool defer, bool fastScan = false);
 
     //@}
 
@@ -39,6 +39,15 @@ bool SimpleCollectionScannerObserver::continueQuery()
     return *m_continue;
 }
 
+void SimpleCollectionScannerObserver::scanThroughput(int filesScanned, int msecs)
+{
+    if (msecs > 0)
+    {
+        qCDebug(DIGIKAM_DATABASE_LOG) << "Scanned" << filesScanned << "files in" << msecs << "msecs,"
+                                      << (filesScanned * 1000LL / msecs) << "files/s";
+    }
+}
+
 // ------------------------------------------------------------------------------
 
 ScanController::Private::Private()
@@ -49,6 +58,7 @@ ScanController::Private::Private()
       idle(false),
       scanSuspended(0),
       deferFileScanning(false),
+      fastScan(false),
       finishScanAllowed(true),
       continueInitialization(false),
       continueScan(false),
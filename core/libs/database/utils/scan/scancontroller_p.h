@@ -94,6 +94,7 @@ public:
     explicit SimpleCollectionScannerObserver(bool* const var);
 
     bool continueQuery();
+    void scanThroughput(int filesScanned, int msecs);
 
 public:
 
@@ -131,6 +132,7 @@ public:
 
     QStringList                     completeScanDeferredAlbums;
     bool                            deferFileScanning;
+    bool                            fastScan;
     bool                            finishScanAllowed;
 
     QMutex                          mutex;
@@ -75,12 +75,12 @@ void ScanController::completeCollectionScan(bool defer)
     d->progressDialog = 0;
 }
 
-void ScanController::completeCollectionScanInBackground(bool defer)
+void ScanController::completeCollectionScanInBackground(bool defer, bool fastScan)
 {
-    completeCollectionScanCore(true, defer);
+    completeCollectionScanCore(true, defer, fastScan);
 }
 
-void ScanController::completeCollectionScanCore(bool needTotalFiles, bool defer)
+void ScanController::completeCollectionScanCore(bool needTotalFiles, bool defer, bool fastScan)
 {
     d->needTotalFiles = needTotalFiles;
 
@@ -88,6 +88,7 @@ void ScanController::completeCollectionScanCore(bool needTotalFiles, bool defer)
         QMutexLocker lock(&d->mutex);
         d->needsCompleteScan = true;
         d->deferFileScanning = defer;
+        d->fastScan          = fastScan;
         d->condVar.wakeAll();
     }
 
@@ -401,6 +401,70 @@ bool DImg::load(const QString& filePath, bool loadMetadata, bool loadICCData, bo
     return load(filePath, loadFlags, observer, rawDecodingSettings);
 }
 
+bool DImg::loadRegion(const QString& filePath, const QRect& region, int scaledLoadingSize,
+                      bool loadMetadata, bool loadICCData,
+                      DImgLoaderObserver* const observer, const DRawDecoding& rawDecodingSettings)
+{
+    setAttribute(QLatin1String("loadingRegion"), region);
+
+    if (scaledLoadingSize > 0)
+    {
+        setAttribute(QLatin1String("scaledLoadingSize"), scaledLoadingSize);
+    }
+
+    bool ok = load(filePath, loadMetadata, loadICCData, false, false, observer, rawDecodingSettings);
+    removeAttribute(QLatin1String("loadingRegion"));
+
+    if (!ok || isNull())
+    {
+        return false;
+    }
+
+    // The loader tells which part of the full image was decoded, the whole image if it cannot decode regions.
+    // The image may be smaller than the decoded part with scaled loading.
+
+    QSize originalSize = attribute(QLatin1String("originalSize")).toSize();
+
+    if (!originalSize.isValid())
+    {
+        originalSize = size();
+    }
+
+    QRect loaded = attribute(QLatin1String("loadedRegion")).toRect();
+
+    if (!loaded.isValid())
+    {
+        loaded = QRect(QPoint(0, 0), originalSize);
+    }
+
+    QRect target = region.intersected(loaded);
+
+    if (target.isEmpty())
+    {
+        reset();
+        return false;
+    }
+
+    const double xFactor = (double)width()  / loaded.width();
+    const double yFactor = (double)height() / loaded.height();
+
+    QRect clip(qRound((target.x() - loaded.x()) * xFactor),
+               qRound((target.y() - loaded.y()) * yFactor),
+               qMax(qRound(target.width()  * xFactor), 1),
+               qMax(qRound(target.height() * yFactor), 1));
+
+    clip = clip.intersected(QRect(0, 0, width(), height()));
+
+    if (clip.size() != size())
+    {
+        crop(clip);
+    }
+
+    setAttribute(QLatin1String("loadedRegion"), target);
+
+    return true;
+}
+
 bool DImg::load(const QString& filePath, int loadFlagsInt, DImgLoaderObserver* const observer,
                 const DRawDecoding& rawDecodingSettings)
 {
@@ -208,6 +208,20 @@ public:
                      DImgLoaderObserver* const observer = 0,
                      const DRawDecoding& rawDecodingSettings=DRawDecoding());
 
+    /** Loads only the part region, given in the coordinates of the full size image, of filePath.
+     *  The JPEG and TIFF loaders decode only the blocks intersecting the region, the PNG loader
+     *  stops after the last row of the region, except for interlaced images. The JPEG 2000 loader
+     *  decodes the whole image with JasPer and converts only the rows of the region.
+     *  The other loaders decode the whole image which is cropped afterwards.
+     *  If scaledLoadingSize is greater than 0, the region may be loaded at a reduced size,
+     *  see the "scaledLoadingSize" attribute.
+     *  The "originalSize" attribute is the size of the full image.
+     */
+    bool        loadRegion(const QString& filePath, const QRect& region, int scaledLoadingSize = 0,
+                           bool loadMetadata = false, bool loadICCData = true,
+                           DImgLoaderObserver* const observer = 0,
+                           const DRawDecoding& rawDecodingSettings=DRawDecoding());
+
     bool        save(const QString& filePath, FORMAT frm, DImgLoaderObserver* const observer = 0);
     bool        save(const QString& filePath, const QString& format, DImgLoaderObserver* const observer = 0);
 
@@ -555,6 +569,13 @@ public:
     DImg       smoothScaleSection(int sx, int sy, int sw, int sh, int dw, int dh) const;
     DImg       smoothScaleSection(const QRect& sourceRect, const QSize& destSize) const;
 
+    /** The smooth scaling uses the SSE4.1 code on the CPUs supporting it, and scales large images
+     *  in bands on the global thread pool. Both give the same pixels as the scalar code in one
+     *  thread, which is used when they are disabled. Only meant for the tests and benchmarks.
+     */
+    static void setSmoothScaleSimd(bool enable);
+    static void setSmoothScaleThreads(bool enable);
+
     void       rotate(ANGLE angle);
     void       flip(FLIP direction);
 
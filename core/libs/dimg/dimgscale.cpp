@@ -47,6 +47,19 @@ extern "C"
 #include <cstdlib>
 #include <cstdio>
 
+// Qt includes
+
+#include <QFuture>
+#include <QThreadPool>
+#include <QtConcurrent>    // krazy:exclude=includes
+
+// The SSE4.1 kernels are compiled for x86 with GCC and Clang, and selected at run-time
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#   define DIMGSCALE_SSE41
+#   include <smmintrin.h>
+#endif
+
 // Local includes
 
 #include "digikam_debug.h"
@@ -93,6 +106,60 @@ public:
     int      xup_yup;
 };
 
+/** The arguments of a call to one of the smoothed scale functions below,
+ *  which can be run on a part of the rows of the clip.
+ */
+class Q_DECL_HIDDEN DImgScaleJob
+{
+public:
+
+    DImgScaleJob(DImgScaleInfo* const isi, uchar* const dest, bool sixteenBit, bool hasAlpha,
+                 int dxx, int dyy, int dw, int dh, int dow, int sow,
+                 int clip_dx, int clip_dy, int clip_dw, int clip_dh)
+        : isi(isi),
+          dest(dest),
+          sixteenBit(sixteenBit),
+          hasAlpha(hasAlpha),
+          dxx(dxx),
+          dyy(dyy),
+          dw(dw),
+          dh(dh),
+          dow(dow),
+          sow(sow),
+          clip_dx(clip_dx),
+          clip_dy(clip_dy),
+          clip_dw(clip_dw),
+          clip_dh(clip_dh)
+    {
+    }
+
+    /** Scales the rows y_begin to y_end - 1 of the clip.
+     */
+    void run(int y_begin, int y_end) const;
+
+public:
+
+    DImgScaleInfo* const isi;
+    uchar* const         dest;
+    const bool           sixteenBit;
+    const bool           hasAlpha;
+    const int            dxx;
+    const int            dyy;
+    const int            dw;
+    const int            dh;
+    const int            dow;
+    const int            sow;
+    const int            clip_dx;
+    const int            clip_dy;
+    const int            clip_dw;
+    const int            clip_dh;
+};
+
+/** Runs job, split in bands of rows on the global thread pool for large images.
+ *  sourcePixels is the number of pixels of the scaled section of the source image.
+ */
+void dimgScaleParallel(const DImgScaleJob& job, qint64 sourcePixels);
+
 uint**   dimgCalcYPoints(uint* const src, int sw, int sh, int dh);
 ullong** dimgCalcYPoints16(ullong* const src, int sw, int sh, int dh);
 int*     dimgCalcXPoints(int sw, int dw);
@@ -229,36 +296,11 @@ DImg DImg::smoothScaleClipped(int dw, int dh, int clipx, int clipy, int clipw, i
 
     DImg buffer(*this, clipw, cliph);
 
-    if (sixteenBit())
-    {
-        if (hasAlpha())
-        {
-            dimgScaleAARGBA16(scaleinfo, reinterpret_cast<ullong*>(buffer.bits()),
-                              0, 0, dw, dh, clipw, w,
-                              clipx, clipy, clipw, cliph);
-        }
-        else
-        {
-            dimgScaleAARGB16(scaleinfo, reinterpret_cast<ullong*>(buffer.bits()),
-                             0, 0, dw, dh, clipw, w,
-                             clipx, clipy, clipw, cliph);
-        }
-    }
-    else
-    {
-        if (hasAlpha())
-        {
-            dimgScaleAARGBA(scaleinfo, reinterpret_cast<uint*>(buffer.bits()),
-                            0, 0, dw, dh, clipw, w,
-                            clipx, clipy, clipw, cliph);
-        }
-        else
-        {
-            dimgScaleAARGB(scaleinfo, reinterpret_cast<uint*>(buffer.bits()),
-                           0, 0, dw, dh, clipw, w,
-                           clipx, clipy, clipw, cliph);
-        }
-    }
+    DImgScaleJob job(scaleinfo, buffer.bits(), sixteenBit(), hasAlpha(),
+                     0, 0, dw, dh, clipw, w,
+                     clipx, clipy, clipw, cliph);
+
+    dimgScaleParallel(job, (qint64)w * h);
 
     delete scaleinfo;
 
@@ -336,46 +378,14 @@ DImg DImg::smoothScaleSection(int sx, int sy,
 
     DImg buffer(*this, dw, dh);
 
-    if (sixteenBit())
-    {
-        if (hasAlpha())
-        {
-            dimgScaleAARGBA16(scaleinfo, reinterpret_cast<ullong*>(buffer.bits()),
-                              ((sx * dw) / sw),
-                              ((sy * dh) / sh),
-                              dw, dh,
-                              dw, w);
-        }
-        else
-        {
-            dimgScaleAARGB16(scaleinfo, reinterpret_cast<ullong*>(buffer.bits()),
-                             ((sx * dw) / sw),
-                             ((sy * dh) / sh),
-                             dw, dh,
-                             dw, w);
-        }
-    }
-    else
-    {
-        if (hasAlpha())
-        {
-            dimgScaleAARGBA(scaleinfo,
-                            reinterpret_cast<uint*>(buffer.bits()),
-                            ((sx * dw) / sw),
-                            ((sy * dh) / sh),
-                            dw, dh,
-                            dw, w);
-        }
-        else
-        {
-            dimgScaleAARGB(scaleinfo,
-                           reinterpret_cast<uint*>(buffer.bits()),
-                           ((sx * dw) / sw),
-                           ((sy * dh) / sh),
-                           dw, dh,
-                           dw, w);
-        }
-    }
+    DImgScaleJob job(scaleinfo, buffer.bits(), sixteenBit(), hasAlpha(),
+                     ((sx * dw) / sw),
+                     ((sy * dh) / sh),
+                     dw, dh,
+                     dw, w,
+                     0, 0, dw, dh);
+
+    dimgScaleParallel(job, (qint64)sw * sh);
 
     delete scaleinfo;
 
@@ -398,6 +408,246 @@ DImg DImg::smoothScaleSection(int sx, int sy,
 #define INV_YAP  (256 - yapoints[dyy + y])
 #define YAP      (yapoints[dyy + y])
 
+#define A_VAL16(p) ((ushort*)(p))[3]
+#define R_VAL16(p) ((ushort*)(p))[2]
+#define G_VAL16(p) ((ushort*)(p))[1]
+#define B_VAL16(p) ((ushort*)(p))[0]
+
+/// Images with less pixels than this are scaled in one thread
+static const qint64 s_parallelMinimumPixels = 1024 * 1024;
+
+/// Minimum number of destination rows of a band
+static const int    s_minimumBandRows       = 8;
+
+/// Disabled by the tests to compare the SSE4.1 code and the bands with the scalar code in one thread
+static bool         s_simdEnabled           = true;
+static bool         s_threadsEnabled        = true;
+
+void DImg::setSmoothScaleSimd(bool enable)
+{
+    s_simdEnabled = enable;
+}
+
+void DImg::setSmoothScaleThreads(bool enable)
+{
+    s_threadsEnabled = enable;
+}
+
+void DImgScale::DImgScaleJob::run(int y_begin, int y_end) const
+{
+    if (sixteenBit)
+    {
+        ullong* const bandDest = reinterpret_cast<ullong*>(dest) + (y_begin - clip_dy) * dow;
+
+        if (hasAlpha)
+        {
+            dimgScaleAARGBA16(isi, bandDest, dxx, dyy, dw, dh, dow, sow,
+                              clip_dx, y_begin, clip_dw, y_end - y_begin);
+        }
+        else
+        {
+            dimgScaleAARGB16(isi, bandDest, dxx, dyy, dw, dh, dow, sow,
+                             clip_dx, y_begin, clip_dw, y_end - y_begin);
+        }
+    }
+    else
+    {
+        uint* const bandDest = reinterpret_cast<uint*>(dest) + (y_begin - clip_dy) * dow;
+
+        if (hasAlpha)
+        {
+            dimgScaleAARGBA(isi, bandDest, dxx, dyy, dw, dh, dow, sow,
+                            clip_dx, y_begin, clip_dw, y_end - y_begin);
+        }
+        else
+        {
+            dimgScaleAARGB(isi, bandDest, dxx, dyy, dw, dh, dow, sow,
+                           clip_dx, y_begin, clip_dw, y_end - y_begin);
+        }
+    }
+}
+
+void DImgScale::dimgScaleParallel(const DImgScaleJob& job, qint64 sourcePixels)
+{
+    // The rows of the destination are independent: each band gives the same pixels
+    // as a scaling of the whole clip.
+
+    int bands = 1;
+
+    if (s_threadsEnabled && ((sourcePixels + (qint64)job.clip_dw * job.clip_dh) >= s_parallelMinimumPixels))
+    {
+        bands = qBound(1, job.clip_dh / s_minimumBandRows, QThreadPool::globalInstance()->maxThreadCount());
+    }
+
+    if (bands == 1)
+    {
+        job.run(job.clip_dy, job.clip_dy + job.clip_dh);
+        return;
+    }
+
+    QList<QFuture<void> > tasks;
+
+    for (int i = 1 ; i < bands ; ++i)
+    {
+        tasks.append(QtConcurrent::run(&job,
+                                       &DImgScaleJob::run,
+                                       job.clip_dy + (job.clip_dh * i)       / bands,
+                                       job.clip_dy + (job.clip_dh * (i + 1)) / bands
+                                      ));
+    }
+
+    job.run(job.clip_dy, job.clip_dy + job.clip_dh / bands);
+
+    foreach (QFuture<void> t, tasks)
+    {
+        t.waitForFinished();
+    }
+}
+
+#ifdef DIMGSCALE_SSE41
+
+/*
+ * SSE4.1 versions of the scaling down horizontally & vertically, the usual case for
+ * thumbnails and previews. The four channels of a pixel are processed in the four
+ * 32 bits lanes of a register, with the same integer operations as the scalar code,
+ * so the results are identical.
+ */
+
+static bool dimgHasSse41()
+{
+    static const bool hasSse41 = __builtin_cpu_supports("sse4.1");
+
+    return (hasSse41 && s_simdEnabled);
+}
+
+__attribute__((target("sse4.1")))
+static inline __m128i dimgLoadPixel(const uint* const pix)
+{
+    return _mm_cvtepu8_epi32(_mm_cvtsi32_si128(*reinterpret_cast<const int*>(pix)));
+}
+
+__attribute__((target("sse4.1")))
+static inline __m128i dimgLoadPixel(const ullong* const pix)
+{
+    return _mm_cvtepu16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pix)));
+}
+
+/** Returns (v * w) >> 14 for 8 bits data, where the products fit in 32 bits.
+ */
+__attribute__((target("sse4.1")))
+static inline __m128i dimgWeightRow(__m128i v, int w, const uint*)
+{
+    return _mm_srai_epi32(_mm_mullo_epi32(v, _mm_set1_epi32(w)), 14);
+}
+
+/** Returns (v * w) >> 14 for 16 bits data, with 64 bits products as the llong of the scalar code.
+ */
+__attribute__((target("sse4.1")))
+static inline __m128i dimgWeightRow(__m128i v, int w, const ullong*)
+{
+    const __m128i weight = _mm_set1_epi32(w);
+    __m128i even         = _mm_srli_epi64(_mm_mul_epi32(v, weight), 14);
+    __m128i odd          = _mm_srli_epi64(_mm_mul_epi32(_mm_srli_epi64(v, 32), weight), 14);
+
+    return _mm_blend_epi16(even, _mm_slli_epi64(odd, 32), 0xCC);
+}
+
+/** Returns the weighted sum of the source pixels of a destination pixel on one row.
+ */
+template <typename T>
+__attribute__((target("sse4.1")))
+static inline __m128i dimgSumRow(const T* pix, int xap, int Cx)
+{
+    __m128i sum = _mm_srai_epi32(_mm_mullo_epi32(dimgLoadPixel(pix), _mm_set1_epi32(xap)), 9);
+    ++pix;
+    int i;
+
+    for (i = (1 << 14) - xap; i > Cx; i -= Cx)
+    {
+        sum = _mm_add_epi32(sum, _mm_srai_epi32(_mm_mullo_epi32(dimgLoadPixel(pix), _mm_set1_epi32(Cx)), 9));
+        ++pix;
+    }
+
+    if (i > 0)
+    {
+        sum = _mm_add_epi32(sum, _mm_srai_epi32(_mm_mullo_epi32(dimgLoadPixel(pix), _mm_set1_epi32(i)), 9));
+    }
+
+    return sum;
+}
+
+__attribute__((target("sse4.1")))
+static inline void dimgStorePixel(uint* const dptr, __m128i v, bool hasAlpha)
+{
+    // The scalar code stores the low bits of each channel
+
+    v       = _mm_and_si128(_mm_srai_epi32(v, 5), _mm_set1_epi32(0xFF));
+    v       = _mm_packus_epi16(_mm_packus_epi32(v, v), v);
+    *dptr   = _mm_cvtsi128_si32(v);
+
+    if (!hasAlpha)
+    {
+        *dptr |= 0xFF000000;
+    }
+}
+
+__attribute__((target("sse4.1")))
+static inline void dimgStorePixel(ullong* const dptr, __m128i v, bool hasAlpha)
+{
+    v = _mm_and_si128(_mm_srai_epi32(v, 5), _mm_set1_epi32(0xFFFF));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dptr), _mm_packus_epi32(v, v));
+
+    if (!hasAlpha)
+    {
+        A_VAL16(dptr) = 0xFFFF;
+    }
+}
+
+template <typename T>
+__attribute__((target("sse4.1")))
+static void dimgScaleDownAASse41(DImgScaleInfo* const isi, T* const dest, T** const ypoints,
+                                 int dyy, int dow, int sow,
+                                 int x_begin, int x_end, int y_begin, int y_end,
+                                 bool hasAlpha)
+{
+    int* const xpoints  = isi->xpoints;
+    int* const xapoints = isi->xapoints;
+    int* const yapoints = isi->yapoints;
+
+    for (int y = y_begin; y < y_end; ++y)
+    {
+        const int Cy  = YAP >> 16;
+        const int yap = YAP & 0xffff;
+        T* dptr       = dest + (y - y_begin) * dow;
+
+        for (int x = x_begin; x < x_end; ++x)
+        {
+            const int Cx  = XAP >> 16;
+            const int xap = XAP & 0xffff;
+            const T* sptr = ypoints[dyy + y] + xpoints[x];
+            __m128i sum   = dimgWeightRow(dimgSumRow(sptr, xap, Cx), yap, sptr);
+            int j;
+
+            for (j = (1 << 14) - yap; j > Cy; j -= Cy)
+            {
+                sptr += sow;
+                sum   = _mm_add_epi32(sum, dimgWeightRow(dimgSumRow(sptr, xap, Cx), Cy, sptr));
+            }
+
+            if (j > 0)
+            {
+                sptr += sow;
+                sum   = _mm_add_epi32(sum, dimgWeightRow(dimgSumRow(sptr, xap, Cx), j, sptr));
+            }
+
+            dimgStorePixel(dptr, sum, hasAlpha);
+            ++dptr;
+        }
+    }
+}
+
+#endif // DIMGSCALE_SSE41
+
 uint** DImgScale::dimgCalcYPoints(uint* const src, int sw, int sh, int dh)
 {
     uint** p = 0;
@@ -992,6 +1242,15 @@ void DImgScale::dimgScaleAARGBA(DImgScaleInfo* const isi, uint* const dest,
     /* if we're scaling down horizontally & vertically */
     else
     {
+#ifdef DIMGSCALE_SSE41
+        if (dimgHasSse41())
+        {
+            dimgScaleDownAASse41(isi, dest, ypoints, dyy, dow, sow,
+                                 x_begin, x_end, y_begin, y_end, true);
+            return;
+        }
+#endif
+
         /*\ 'Correct' version, with math units prepared for MMXification:
         |*|  The operation 'b = (b * c) >> 16' translates to pmulhw,
         |*|  so the operation 'b = (b * c) >> d' would translate to
@@ -1437,6 +1696,15 @@ void DImgScale::dimgScaleAARGB(DImgScaleInfo* const isi, uint* const dest,
     /* if we're scaling down horizontally & vertically */
     else
     {
+#ifdef DIMGSCALE_SSE41
+        if (dimgHasSse41())
+        {
+            dimgScaleDownAASse41(isi, dest, ypoints, dyy, dow, sow,
+                                 x_begin, x_end, y_begin, y_end, false);
+            return;
+        }
+#endif
+
         /*\ 'Correct' version, with math units prepared for MMXification \*/
         int Cx, Cy, i, j;
         uint* pix=0;
@@ -1550,11 +1818,6 @@ void DImgScale::dimgScaleAARGB(DImgScaleInfo* const isi, uint* const dest,
     }
 }
 
-#define A_VAL16(p) ((ushort*)(p))[3]
-#define R_VAL16(p) ((ushort*)(p))[2]
-#define G_VAL16(p) ((ushort*)(p))[1]
-#define B_VAL16(p) ((ushort*)(p))[0]
-
 void DImgScale::dimgScaleAARGB16(DImgScaleInfo* const isi, ullong* const dest,
                                  int dxx, int dyy,
                                  int dw, int dh,
@@ -1866,6 +2129,15 @@ void DImgScale::dimgScaleAARGB16(DImgScaleInfo* const isi, ullong* const dest,
     // if we're scaling down horizontally & vertically
     else
     {
+#ifdef DIMGSCALE_SSE41
+        if (dimgHasSse41())
+        {
+            dimgScaleDownAASse41(isi, dest, ypoints, dyy, dow, sow,
+                                 x_begin, x_end, y_begin, y_end, false);
+            return;
+        }
+#endif
+
         // 'Correct' version, with math units prepared for MMXification
         int Cx, Cy, i, j;
         ullong* pix=0;
@@ -2320,6 +2592,15 @@ void DImgScale::dimgScaleAARGBA16(DImgScaleInfo* const isi, ullong* const dest,
     /* if we're scaling down horizontally & vertically */
     else
     {
+#ifdef DIMGSCALE_SSE41
+        if (dimgHasSse41())
+        {
+            dimgScaleDownAASse41(isi, dest, ypoints, dyy, dow, sow,
+                                 x_begin, x_end, y_begin, y_end, true);
+            return;
+        }
+#endif
+
         /*\ 'Correct' version, with math units prepared for MMXification:
         |*|  The operation 'b = (b * c) >> 16' translates to pmulhw,
         |*|  so the operation 'b = (b * c) >> d' would translate to
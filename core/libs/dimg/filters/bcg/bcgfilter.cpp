@@ -215,7 +215,12 @@ void BCGFilter::applyBCG(DImg& image)
         return;
     }
 
-    applyBCG(image.bits(), image.width(), image.height(), image.sixteenBit());
+    runMultithreaded(this, &BCGFilter::bcgMultithreaded, &image, image.height());
+}
+
+void BCGFilter::bcgMultithreaded(DImg* image, uint start, uint stop)
+{
+    applyBCG(image->scanLine(start), image->width(), stop - start, image->sixteenBit());
 }
 
 void BCGFilter::applyBCG(uchar* const bits, uint width, uint height, bool sixteenBits)
@@ -226,7 +231,6 @@ void BCGFilter::applyBCG(uchar* const bits, uint width, uint height, bool sixtee
     }
 
     uint size = width * height;
-    int  progress;
 
     if (!sixteenBits)                    // 8 bits image.
     {
@@ -256,13 +260,6 @@ void BCGFilter::applyBCG(uchar* const bits, uint width, uint height, bool sixtee
             }
 
             data += 4;
-
-            progress = (int)(((double)i * 100.0) / size);
-
-            if (progress % 5 == 0)
-            {
-                postProgress(progress);
-            }
         }
     }
     else                                        // 16 bits image.
@@ -293,13 +290,6 @@ void BCGFilter::applyBCG(uchar* const bits, uint width, uint height, bool sixtee
             }
 
             data += 4;
-
-            progress = (int)(((double)i * 100.0) / size);
-
-            if (progress % 5 == 0)
-            {
-                postProgress(progress);
-            }
         }
     }
 
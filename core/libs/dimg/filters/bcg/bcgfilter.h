@@ -87,6 +87,7 @@ private:
     void setBrightness(double val);
     void setContrast(double val);
     void applyBCG(DImg& image);
+    void bcgMultithreaded(DImg* image, uint start, uint stop);
     void applyBCG(uchar* const bits, uint width, uint height, bool sixteenBits);
 
 private:
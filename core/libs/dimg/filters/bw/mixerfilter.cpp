@@ -59,13 +59,16 @@ void MixerFilter::filterImage()
 {
     m_destImage.putImageData(m_orgImage.bits());
 
-    uchar* bits     = m_destImage.bits();
+    runMultithreaded(this, &MixerFilter::mixerMultithreaded, m_destImage.height());
+}
+
+void MixerFilter::mixerMultithreaded(uint start, uint stop)
+{
+    uchar* bits     = m_destImage.scanLine(start);
     uint width      = m_destImage.width();
-    uint height     = m_destImage.height();
     bool sixteenBit = m_destImage.sixteenBit();
 
-    uint size       = width * height;
-    int  progress;
+    uint size       = width * (stop - start);
 
     uint i;
     double   rnorm  = 1;    // red channel normalizer use in RGB mode.
@@ -92,7 +95,7 @@ void MixerFilter::filterImage()
         uchar  nGray, red, green, blue;
         uchar* ptr = bits;
 
-        for (i = 0 ; i < size ; ++i)
+        for (i = 0 ; runningFlag() && (i < size) ; ++i)
         {
             blue  = ptr[0];
             green = ptr[1];
@@ -119,13 +122,6 @@ void MixerFilter::filterImage()
             }
 
             ptr     += 4;
-
-            progress = (int)(((double)i * 100.0) / size);
-
-            if (progress % 5 == 0)
-            {
-                postProgress(progress);
-            }
         }
     }
     else               // 16 bits image.
@@ -133,7 +129,7 @@ void MixerFilter::filterImage()
         unsigned short  nGray, red, green, blue;
         unsigned short* ptr = reinterpret_cast<unsigned short*>(bits);
 
-        for (i = 0 ; i < size ; ++i)
+        for (i = 0 ; runningFlag() && (i < size) ; ++i)
         {
             blue  = ptr[0];
             green = ptr[1];
@@ -156,13 +152,6 @@ void MixerFilter::filterImage()
             }
 
             ptr     += 4;
-
-            progress = (int)(((double)i * 100.0) / size);
-
-            if (progress % 5 == 0)
-            {
-                postProgress(progress);
-            }
         }
     }
 }
@@ -129,6 +129,7 @@ public:
 private:
 
     void filterImage();
+    void mixerMultithreaded(uint start, uint stop);
 
     inline double CalculateNorm(double RedGain, double GreenGain, double BlueGain, bool bPreserveLum);
 
@@ -250,14 +250,18 @@ void CBFilter::applyCBFilter(DImg& image, double r, double g, double b, double a
         return;
     }
 
-    uint size = image.width() * image.height();
-    int  progress;
-
     adjustRGB(r, g, b, a, image.sixteenBit());
 
-    if (!image.sixteenBit())                    // 8 bits image.
+    runMultithreaded(this, &CBFilter::cbMultithreaded, &image, image.height());
+}
+
+void CBFilter::cbMultithreaded(DImg* image, uint start, uint stop)
+{
+    uint size = image->width() * (stop - start);
+
+    if (!image->sixteenBit())                    // 8 bits image.
     {
-        uchar* data = (uchar*) image.bits();
+        uchar* data = image->scanLine(start);
 
         for (uint i = 0 ; runningFlag() && (i < size) ; ++i)
         {
@@ -267,18 +271,11 @@ void CBFilter::applyCBFilter(DImg& image, double r, double g, double b, double a
             data[3]  = d->alphaMap[data[3]];
 
             data    += 4;
-
-            progress = (int)(((double)i * 100.0) / size);
-
-            if (progress % 5 == 0)
-            {
-                postProgress(progress);
-            }
         }
     }
     else                                        // 16 bits image.
     {
-        ushort* data = reinterpret_cast<ushort*>(image.bits());
+        ushort* data = reinterpret_cast<ushort*>(image->scanLine(start));
 
         for (uint i = 0 ; runningFlag() && (i < size) ; ++i)
         {
@@ -288,13 +285,6 @@ void CBFilter::applyCBFilter(DImg& image, double r, double g, double b, double a
             data[3]  = d->alphaMap16[data[3]];
 
             data    += 4;
-
-            progress = (int)(((double)i * 100.0) / size);
-
-            if (progress % 5 == 0)
-            {
-                postProgress(progress);
-            }
         }
     }
 }
@@ -121,6 +121,7 @@ private:
     void getTables(int* const redMap, int* const greenMap, int* const blueMap, int* const alphaMap, bool sixteenBit);
     void adjustRGB(double r, double g, double b, double a, bool sixteenBit);
     void applyCBFilter(DImg& image, double r, double g, double b, double a);
+    void cbMultithreaded(DImg* image, uint start, uint stop);
 
 private:
 
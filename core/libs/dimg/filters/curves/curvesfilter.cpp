@@ -95,8 +95,13 @@ void CurvesFilter::filterImage()
     curves.curvesLutSetup(AlphaChannel);
     postProgress(75);
 
-    curves.curvesLutProcess(m_orgImage.bits(), m_destImage.bits(), m_orgImage.width(), m_orgImage.height());
-    postProgress(100);
+    runMultithreaded(this, &CurvesFilter::curvesMultithreaded, &curves, m_orgImage.height(), 75, 100);
+}
+
+void CurvesFilter::curvesMultithreaded(ImageCurves* curves, uint start, uint stop)
+{
+    curves->curvesLutProcess(m_orgImage.scanLine(start), m_destImage.scanLine(start),
+                             m_orgImage.width(), stop - start);
 }
 
 FilterAction CurvesFilter::filterAction()
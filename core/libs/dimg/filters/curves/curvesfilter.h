@@ -89,6 +89,7 @@ public:
 private:
 
     void filterImage();
+    void curvesMultithreaded(ImageCurves* curves, uint start, uint stop);
 
 private:
 
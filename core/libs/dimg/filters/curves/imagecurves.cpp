@@ -43,6 +43,7 @@
 #include "curvescontainer.h"
 #include "filteraction.h"
 #include "digikam_globals.h"
+#include "imagelut.h"
 
 namespace Digikam
 {
@@ -653,7 +654,6 @@ void ImageCurves::curvesLutSetup(int nchannels)
 void ImageCurves::curvesLutProcess(uchar* const srcPR, uchar* const destPR, int w, int h)
 {
     unsigned short* lut0 = NULL, *lut1 = NULL, *lut2 = NULL, *lut3 = NULL;
-    int i;
 
     if (d->lut->nchannels > 0)
     {
@@ -677,87 +677,13 @@ void ImageCurves::curvesLutProcess(uchar* const srcPR, uchar* const destPR, int
 
     if (!isSixteenBits())        // 8 bits image.
     {
-        uchar red, green, blue, alpha;
-        uchar* ptr = srcPR;
-        uchar* dst = destPR;
-
-        for (i = 0 ; i < w * h ; ++i)
-        {
-            blue  = ptr[0];
-            green = ptr[1];
-            red   = ptr[2];
-            alpha = ptr[3];
-
-            if ((d->lut->nchannels > 0) && lut0)
-            {
-                red = lut0[red];
-            }
-
-            if ((d->lut->nchannels > 1) && lut1)
-            {
-                green = lut1[green];
-            }
-
-            if ((d->lut->nchannels > 2) && lut2)
-            {
-                blue = lut2[blue];
-            }
-
-            if ((d->lut->nchannels > 3) && lut3)
-            {
-                alpha = lut3[alpha];
-            }
-
-            dst[0] = blue;
-            dst[1] = green;
-            dst[2] = red;
-            dst[3] = alpha;
-
-            ptr += 4;
-            dst += 4;
-        }
+        ImageLut::process8(srcPR, destPR, (uint)(w * h), lut0, lut1, lut2, lut3);
     }
     else               // 16 bits image.
     {
-        unsigned short red, green, blue, alpha;
-        unsigned short* ptr = reinterpret_cast<unsigned short*>(srcPR);
-        unsigned short* dst = reinterpret_cast<unsigned short*>(destPR);
-
-        for (i = 0 ; i < w * h ; ++i)
-        {
-            blue  = ptr[0];
-            green = ptr[1];
-            red   = ptr[2];
-            alpha = ptr[3];
-
-            if ((d->lut->nchannels > 0) && lut0)
-            {
-                red = lut0[red];
-            }
-
-            if ((d->lut->nchannels > 1) && lut1)
-            {
-                green = lut1[green];
-            }
-
-            if ((d->lut->nchannels > 2) && lut2)
-            {
-                blue = lut2[blue];
-            }
-
-            if ((d->lut->nchannels > 3) && lut3)
-            {
-                alpha = lut3[alpha];
-            }
-
-            dst[0] = blue;
-            dst[1] = green;
-            dst[2] = red;
-            dst[3] = alpha;
-
-            ptr += 4;
-            dst += 4;
-        }
+        ImageLut::process16(reinterpret_cast<unsigned short*>(srcPR),
+                            reinterpret_cast<unsigned short*>(destPR),
+                            (uint)(w * h), lut0, lut1, lut2, lut3);
     }
 }
 
@@ -25,6 +25,12 @@
 #ifndef DIGIKAM_DIMG_THREADED_FILTER_H
 #define DIGIKAM_DIMG_THREADED_FILTER_H
 
+// Qt includes
+
+#include <QFuture>
+#include <QList>
+#include <QtConcurrent>    // krazy:exclude=includes
+
 // KDE includes
 
 #include <klocalizedstring.h>
@@ -225,6 +231,69 @@ protected:
     void initMaster();
     virtual void prepareDestImage();
 
+    /** Runs method(start, stop) of filter on the bands of rows [start, stop[ given by
+     *  multithreadedSteps(height), in parallel using QtConcurrent API, and waits until all
+     *  bands are processed. Progress is posted from progressBegin to progressEnd as bands
+     *  complete. The rows of a band must not depend on the rows of other bands.
+     *  With only one thread in the pool, the whole image is processed in the current thread.
+     *  This is the common execution path of the pixel-wise filters.
+     */
+    template <class Filter>
+    void runMultithreaded(Filter* const filter, void (Filter::*method)(uint, uint), uint height,
+                          int progressBegin = 0, int progressEnd = 100)
+    {
+        QList<int> vals = multithreadedSteps(height);
+
+        if (vals.count() <= 2)
+        {
+            (filter->*method)(0, height);
+            postProgress(progressEnd);
+            return;
+        }
+
+        QList<QFuture<void> > tasks;
+
+        for (int j = 0 ; runningFlag() && (j < vals.count()-1) ; ++j)
+        {
+            tasks.append(QtConcurrent::run(filter, method, (uint)vals[j], (uint)vals[j+1]));
+        }
+
+        for (int j = 0 ; j < tasks.count() ; ++j)
+        {
+            tasks[j].waitForFinished();
+            postProgress(progressBegin + (progressEnd - progressBegin) * (j + 1) / tasks.count());
+        }
+    }
+
+    /** Same as above, for a method taking arg as first argument: method(arg, start, stop).
+     */
+    template <class Filter, class Arg>
+    void runMultithreaded(Filter* const filter, void (Filter::*method)(Arg*, uint, uint), Arg* const arg,
+                          uint height, int progressBegin = 0, int progressEnd = 100)
+    {
+        QList<int> vals = multithreadedSteps(height);
+
+        if (vals.count() <= 2)
+        {
+            (filter->*method)(arg, 0, height);
+            postProgress(progressEnd);
+            return;
+        }
+
+        QList<QFuture<void> > tasks;
+
+        for (int j = 0 ; runningFlag() && (j < vals.count()-1) ; ++j)
+        {
+            tasks.append(QtConcurrent::run(filter, method, arg, (uint)vals[j], (uint)vals[j+1]));
+        }
+
+        for (int j = 0 ; j < tasks.count() ; ++j)
+        {
+            tasks[j].waitForFinished();
+            postProgress(progressBegin + (progressEnd - progressBegin) * (j + 1) / tasks.count());
+        }
+    }
+
     /**
      * Convenience class to spare the few repeating lines of code
      */
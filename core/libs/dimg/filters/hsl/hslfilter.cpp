@@ -237,16 +237,20 @@ void HSLFilter::applyHSL(DImg& image)
         return;
     }
 
-    bool   sixteenBit     = image.sixteenBit();
-    uint   numberOfPixels = image.numPixels();
-    int    progress;
+    runMultithreaded(this, &HSLFilter::hslMultithreaded, &image, image.height());
+}
+
+void HSLFilter::hslMultithreaded(DImg* image, uint start, uint stop)
+{
+    bool   sixteenBit     = image->sixteenBit();
+    uint   numberOfPixels = image->width() * (stop - start);
     int    hue, sat, lig;
     double vib = d->settings.vibrance;
     DColor color;
 
     if (sixteenBit)                   // 16 bits image.
     {
-        unsigned short* data = reinterpret_cast<unsigned short*>(image.bits());
+        unsigned short* data = reinterpret_cast<unsigned short*>(image->scanLine(start));
 
         for (uint i = 0; runningFlag() && (i < numberOfPixels); ++i)
         {
@@ -263,18 +267,11 @@ void HSLFilter::applyHSL(DImg& image)
             data[0] = color.blue();
 
             data += 4;
-
-            progress = (int)(((double)i * 100.0) / numberOfPixels);
-
-            if (progress % 5 == 0)
-            {
-                postProgress(progress);
-            }
         }
     }
     else                                      // 8 bits image.
     {
-        uchar* data = image.bits();
+        uchar* data = image->scanLine(start);
 
         for (uint i = 0; runningFlag() && (i < numberOfPixels); ++i)
         {
@@ -291,13 +288,6 @@ void HSLFilter::applyHSL(DImg& image)
             data[0] = color.blue();
 
             data += 4;
-
-            progress = (int)(((double)i * 100.0) / numberOfPixels);
-
-            if (progress % 5 == 0)
-            {
-                postProgress(progress);
-            }
         }
     }
 }
@@ -109,6 +109,7 @@ private:
     void setSaturation(double val);
     void setLightness(double val);
     void applyHSL(DImg& image);
+    void hslMultithreaded(DImg* image, uint start, uint stop);
     int  vibranceBias(double sat, double hue, double vib, bool sixteenbit);
 
 private:
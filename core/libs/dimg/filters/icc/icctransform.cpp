@@ -30,8 +30,12 @@
 
 #include <QDataStream>
 #include <QFile>
+#include <QFuture>
 #include <QImage>
+#include <QThreadPool>
 #include <QVarLengthArray>
+#include <QVector>
+#include <QtConcurrent>    // krazy:exclude=includes
 
 // KDE includes
 
@@ -83,6 +87,91 @@ public:
     int        proofIntent;
 };
 
+// -----------------------------------------------------------------------------------------------
+
+/** A band of rows of an image to transform. The bands of one image are transformed
+ *  in parallel: a Little CMS transform can be shared between threads, once created.
+ */
+class Q_DECL_HIDDEN IccTransformBand
+{
+public:
+
+    IccTransformBand()
+      : handle(0),
+        data(0),
+        width(0),
+        rows(0),
+        bytesDepth(0),
+        inPlace(true)
+    {
+    }
+
+    void run() const
+    {
+        const int pixels        = width * rows;
+        // convert ten scanlines in a batch
+        const int pixelsPerStep = width * 10;
+        uchar* ptr              = data;
+
+        // it is safe to use the same input and output buffer if the format is the same
+        if (inPlace)
+        {
+            for (int p = pixels; p > 0; p -= pixelsPerStep)
+            {
+                int pixelsThisStep =  qMin(p, pixelsPerStep);
+                dkCmsDoTransform(handle, ptr, ptr, pixelsThisStep);
+                ptr               += pixelsThisStep * bytesDepth;
+            }
+        }
+        else
+        {
+            QVarLengthArray<uchar> buffer(pixelsPerStep * bytesDepth);
+
+            for (int p = pixels; p > 0; p -= pixelsPerStep)
+            {
+                int pixelsThisStep  = qMin(p, pixelsPerStep);
+                int size            = pixelsThisStep * bytesDepth;
+                memcpy(buffer.data(), ptr, size);
+                dkCmsDoTransform(handle, buffer.data(), ptr, pixelsThisStep);
+                ptr                += size;
+            }
+        }
+    }
+
+    /** Splits the rows of an image in one band per thread of the global pool.
+     */
+    static QVector<IccTransformBand> split(cmsHTRANSFORM handle, uchar* const data, int width, int height,
+                                           int bytesDepth, bool inPlace)
+    {
+        const int count = qBound(1, QThreadPool::globalInstance()->maxThreadCount(), qMax(1, height / 10));
+        QVector<IccTransformBand> bands(count);
+        int row         = 0;
+
+        for (int i = 0 ; i < count ; ++i)
+        {
+            IccTransformBand& band = bands[i];
+            band.handle            = handle;
+            band.data              = data + (qint64)row * width * bytesDepth;
+            band.width             = width;
+            band.rows              = (height - row) / (count - i);
+            band.bytesDepth        = bytesDepth;
+            band.inPlace           = inPlace;
+            row                   += band.rows;
+        }
+
+        return bands;
+    }
+
+public:
+
+    cmsHTRANSFORM handle;
+    uchar*        data;
+    int           width;
+    int           rows;
+    int           bytesDepth;
+    bool          inPlace;
+};
+
 class Q_DECL_HIDDEN IccTransform::Private : public QSharedData
 {
 public:
@@ -696,77 +785,55 @@ bool IccTransform::apply(QImage& qimage)
 
 void IccTransform::transform(DImg& image, const TransformDescription& description, DImgLoaderObserver* const observer)
 {
-    const int bytesDepth    = image.bytesDepth();
-    const int pixels        = image.width() * image.height();
-    // convert ten scanlines in a batch
-    const int pixelsPerStep = image.width() * 10;
-    uchar* data             = image.bits();
+    QVector<IccTransformBand> bands = IccTransformBand::split(d->handle, image.bits(), image.width(), image.height(),
+                                                              image.bytesDepth(),
+                                                              description.inputFormat == description.outputFormat);
 
-    // see dimgloader.cpp, granularity().
-    int granularity         = 1;
-
-    if (observer)
+    if (bands.count() == 1)
     {
-        granularity = (int)((pixels / (20 * 0.9)) / observer->granularity());
+        bands.first().run();
+        return;
     }
 
-    int checkPoint = pixels;
+    QList<QFuture<void> > tasks;
 
-    // it is safe to use the same input and output buffer if the format is the same
-    if (description.inputFormat == description.outputFormat)
+    for (int i = 0 ; i < bands.count() ; ++i)
     {
-        for (int p = pixels; p > 0; p -= pixelsPerStep)
-        {
-            int pixelsThisStep =  qMin(p, pixelsPerStep);
-            int size           =  pixelsThisStep * bytesDepth;
-            LcmsLock lock;
-            dkCmsDoTransform(d->handle, data, data, pixelsThisStep);
-            data               += size;
-
-            if (observer && p <= checkPoint)
-            {
-                checkPoint -= granularity;
-                observer->progressInfo(&image, 0.1 + 0.9 * (1.0 - float(p) / float(pixels)));
-            }
-        }
+        tasks.append(QtConcurrent::run(&bands.at(i), &IccTransformBand::run));
     }
-    else
+
+    for (int i = 0 ; i < tasks.count() ; ++i)
     {
-        QVarLengthArray<uchar> buffer(pixelsPerStep * bytesDepth);
+        tasks[i].waitForFinished();
 
-        for (int p = pixels; p > 0; p -= pixelsPerStep)
+        if (observer)
         {
-            int pixelsThisStep  = qMin(p, pixelsPerStep);
-            int size            = pixelsThisStep * bytesDepth;
-            LcmsLock lock;
-            memcpy(buffer.data(), data, size);
-            dkCmsDoTransform(d->handle, buffer.data(), data, pixelsThisStep);
-            data               += size;
-
-            if (observer && p <= checkPoint)
-            {
-                checkPoint -= granularity;
-                observer->progressInfo(&image, 0.1 + 0.9 * (1.0 - float(p) / float(pixels)));
-            }
+            observer->progressInfo(&image, 0.1 + 0.9 * float(i + 1) / float(tasks.count()));
         }
     }
 }
 
 void IccTransform::transform(QImage& image, const TransformDescription&)
 {
-    const int bytesDepth    = 4;
-    const int pixels        = image.width() * image.height();
-    // convert ten scanlines in a batch
-    const int pixelsPerStep = image.width() * 10;
-    uchar* data             = image.bits();
+    QVector<IccTransformBand> bands = IccTransformBand::split(d->handle, image.bits(), image.width(), image.height(),
+                                                              4, true);
+
+    if (bands.count() == 1)
+    {
+        bands.first().run();
+        return;
+    }
+
+    QList<QFuture<void> > tasks;
+
+    for (int i = 0 ; i < bands.count() ; ++i)
+    {
+        tasks.append(QtConcurrent::run(&bands.at(i), &IccTransformBand::run));
+    }
 
-    for (int p = pixels; p > 0; p -= pixelsPerStep)
+    for (int i = 0 ; i < tasks.count() ; ++i)
     {
-        int pixelsThisStep =  qMin(p, pixelsPerStep);
-        int size           =  pixelsThisStep * bytesDepth;
-        LcmsLock lock;
-        dkCmsDoTransform(d->handle, data, data, pixelsThisStep);
-        data               += size;
+        tasks[i].waitForFinished();
     }
 }
 
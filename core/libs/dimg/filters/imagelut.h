@@ -0,0 +1,125 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-11-10
+ * Description : look-up tables processing of image data
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_IMAGE_LUT_H
+#define DIGIKAM_IMAGE_LUT_H
+
+// Qt includes
+
+#include <QtGlobal>
+
+namespace Digikam
+{
+
+/** Applies one look-up table per channel to a run of BGRA pixels, as used by
+ *  the curves and levels tools. A null table leaves its channel unchanged.
+ *  The channel tests are done once per run, not once per pixel, so that the
+ *  compiler can unroll the pixel loop.
+ */
+class ImageLut
+{
+public:
+
+    /** 8 bits pixels. The tables have 256 entries, narrowed to bytes here
+     *  so that all four fit in the L1 cache.
+     */
+    static inline void process8(const uchar* src, uchar* dst, uint pixels,
+                                const unsigned short* const red,  const unsigned short* const green,
+                                const unsigned short* const blue, const unsigned short* const alpha)
+    {
+        const unsigned short* const luts[4] = { blue, green, red, alpha };
+        uchar tables[4][256];
+
+        for (int c = 0 ; c < 4 ; ++c)
+        {
+            for (int i = 0 ; i < 256 ; ++i)
+            {
+                tables[c][i] = luts[c] ? (uchar)luts[c][i] : (uchar)i;
+            }
+        }
+
+        for (uint i = 0 ; i < pixels ; ++i)
+        {
+            const uchar b = tables[0][src[0]];
+            const uchar g = tables[1][src[1]];
+            const uchar r = tables[2][src[2]];
+            const uchar a = tables[3][src[3]];
+
+            dst[0] = b;
+            dst[1] = g;
+            dst[2] = r;
+            dst[3] = a;
+
+            src   += 4;
+            dst   += 4;
+        }
+    }
+
+    /** 16 bits pixels. The tables have 65536 entries.
+     */
+    static inline void process16(const unsigned short* src, unsigned short* dst, uint pixels,
+                                 const unsigned short* const red,  const unsigned short* const green,
+                                 const unsigned short* const blue, const unsigned short* const alpha)
+    {
+        if (red && green && blue && alpha)
+        {
+            for (uint i = 0 ; i < pixels ; ++i)
+            {
+                const unsigned short b = blue[src[0]];
+                const unsigned short g = green[src[1]];
+                const unsigned short r = red[src[2]];
+                const unsigned short a = alpha[src[3]];
+
+                dst[0] = b;
+                dst[1] = g;
+                dst[2] = r;
+                dst[3] = a;
+
+                src   += 4;
+                dst   += 4;
+            }
+        }
+        else
+        {
+            for (uint i = 0 ; i < pixels ; ++i)
+            {
+                const unsigned short b = blue  ? blue[src[0]]  : src[0];
+                const unsigned short g = green ? green[src[1]] : src[1];
+                const unsigned short r = red   ? red[src[2]]   : src[2];
+                const unsigned short a = alpha ? alpha[src[3]] : src[3];
+
+                dst[0] = b;
+                dst[1] = g;
+                dst[2] = r;
+                dst[3] = a;
+
+                src   += 4;
+                dst   += 4;
+            }
+        }
+    }
+};
+
+} // namespace Digikam
+
+#endif // DIGIKAM_IMAGE_LUT_H
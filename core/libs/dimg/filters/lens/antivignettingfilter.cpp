@@ -65,9 +65,18 @@ AntiVignettingFilter::~AntiVignettingFilter()
 
 void AntiVignettingFilter::filterImage()
 {
-    int    progress;
+    // Determine the shift in pixels from the shift in percentage.
+    m_settings.yshift = m_settings.yshift * m_orgImage.height() / 200.0;
+    m_settings.xshift = m_settings.xshift * m_orgImage.width()  / 200.0;
+
+    runMultithreaded(this, &AntiVignettingFilter::filterMultithreaded, m_orgImage.height());
+}
+
+void AntiVignettingFilter::filterMultithreaded(uint start, uint stop)
+{
     int    col, row, xd, td, yd, p;
     int    xsize, ysize, /*diagonal,*/ erad, irad, xctr, yctr;
+    double att;
 
     uchar* NewBits            = m_destImage.bits();
     uchar* data               = m_orgImage.bits();
@@ -78,10 +87,6 @@ void AntiVignettingFilter::filterImage()
     int Width                 = m_orgImage.width();
     int Height                = m_orgImage.height();
 
-    // Determine the shift in pixels from the shift in percentage.
-    m_settings.yshift         = m_settings.yshift * Height / 200.0;
-    m_settings.xshift         = m_settings.xshift * Width  / 200.0;
-
     // Determine the outer radius of the filter.  This is the half diagonal
     // measure of the image multiplied by the radius factor.
 
@@ -98,40 +103,34 @@ void AntiVignettingFilter::filterImage()
     xctr     = qRound(Width  / 2.0 + m_settings.xshift);
     yctr     = qRound(Height / 2.0 + m_settings.yshift);
 
+    // Process the scan lines of the band, pixels are read and written in memory order.
 
-    for (row = 0 ; runningFlag() && (row < Width) ; ++row)
+    for (col = start ; runningFlag() && (col < (int)stop) ; ++col)
     {
-        yd = abs(xctr - row);
+        xd = abs(yctr - col);
 
-        for (col = 0 ; runningFlag() && (col < Height) ; ++col)
+        for (row = 0 ; row < Width ; ++row)
         {
-            p  = (col * Width + row) * 4;
-            xd = abs(yctr - col);
-            td = qRound(hypothenuse(xd, yd));
+            p   = (col * Width + row) * 4;
+            yd  = abs(xctr - row);
+            td  = qRound(hypothenuse(xd, yd));
+            att = real_attenuation(irad, erad, td);
 
             if (!m_orgImage.sixteenBit())       // 8 bits image
             {
-                NewBits[ p ] = clamp8bits(data[ p ] * real_attenuation(irad, erad, td));
-                NewBits[p + 1] = clamp8bits(data[p + 1] * real_attenuation(irad, erad, td));
-                NewBits[p + 2] = clamp8bits(data[p + 2] * real_attenuation(irad, erad, td));
+                NewBits[ p ] = clamp8bits(data[ p ] * att);
+                NewBits[p + 1] = clamp8bits(data[p + 1] * att);
+                NewBits[p + 2] = clamp8bits(data[p + 2] * att);
                 NewBits[p + 3] = data[p + 3];
             }
             else                                // 16 bits image.
             {
-                NewBits16[ p ] = clamp16bits(data16[ p ] * real_attenuation(irad, erad, td));
-                NewBits16[p + 1] = clamp16bits(data16[p + 1] * real_attenuation(irad, erad, td));
-                NewBits16[p + 2] = clamp16bits(data16[p + 2] * real_attenuation(irad, erad, td));
+                NewBits16[ p ] = clamp16bits(data16[ p ] * att);
+                NewBits16[p + 1] = clamp16bits(data16[p + 1] * att);
+                NewBits16[p + 2] = clamp16bits(data16[p + 2] * att);
                 NewBits16[p + 3] = data16[p + 3];
             }
         }
-
-        // Update the progress bar in dialog.
-        progress = (int)(((double)row * 100.0) / Width);
-
-        if (progress % 5 == 0)
-        {
-            postProgress(progress);
-        }
     }
 }
 
@@ -111,6 +111,7 @@ public:
 private:
 
     void           filterImage();
+    void           filterMultithreaded(uint start, uint stop);
 
     double         hypothenuse(double x, double y);
     uchar          clamp8bits(double x);
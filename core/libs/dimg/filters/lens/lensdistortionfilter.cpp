@@ -73,15 +73,20 @@ LensDistortionFilter::~LensDistortionFilter()
 
 void LensDistortionFilter::filterImage()
 {
-    int    Width      = m_orgImage.width();
-    int    Height     = m_orgImage.height();
-    int    bytesDepth = m_orgImage.bytesDepth();
-    uchar* data       = m_destImage.bits();
-
     // initial copy
 
     m_destImage.bitBltImage(&m_orgImage, 0, 0);
 
+    runMultithreaded(this, &LensDistortionFilter::filterMultithreaded, m_orgImage.height());
+}
+
+void LensDistortionFilter::filterMultithreaded(uint start, uint stop)
+{
+    int    Width      = m_orgImage.width();
+    int    Height     = m_orgImage.height();
+    int    bytesDepth = m_orgImage.bytesDepth();
+    uchar* data       = m_destImage.scanLine(start);
+
     // initialize coefficients
 
     double normallise_radius_sq = 4.0 / (Width * Width + Height * Height);
@@ -91,6 +96,8 @@ void LensDistortionFilter::filterImage()
     double mult_qd              = m_edge / 200.0;
     double rescale              = pow(2.0, - m_rescale / 100.0);
     double brighten             = - m_brighten / 10.0;
+
+    // The pixel cache of PixelAccess is not shared between threads.
     PixelAccess* pa             = new PixelAccess(&m_orgImage);
 
     /*
@@ -99,19 +106,17 @@ void LensDistortionFilter::filterImage()
      * NB: d <= image.bpp
      */
 
-    // We are working on the full image.
+    // We are working on the band of rows [start, stop[ of the image.
     int    dstWidth  = Width;
-    int    dstHeight = Height;
     uchar* dst       = (uchar*)data;
-    int    step      = 1, progress;
+    int    step      = 1;
 
-    int    iLimit, jLimit;
-    double srcX, srcY, mag;
+    int    iLimit;
+    double srcX, srcY, mag, brightness;
 
     iLimit = dstWidth  * step;
-    jLimit = dstHeight * step;
 
-    for (int dstJ = 0 ; runningFlag() && (dstJ < jLimit) ; dstJ += step)
+    for (int dstJ = start ; runningFlag() && (dstJ < (int)stop) ; dstJ += step)
     {
         for (int dstI = 0 ; runningFlag() && (dstI < iLimit) ; dstI += step)
         {
@@ -134,19 +139,11 @@ void LensDistortionFilter::filterImage()
             srcX        = center_x + radius_mult * off_x;
             srcY        = center_y + radius_mult * off_y;
 
-            brighten = 1.0 + mag * brighten;
-            pa->pixelAccessGetCubic(srcX, srcY, brighten, dst);
+            // The brightness only depends on the distance to the center, as in the Gimp plugin.
+            brightness  = 1.0 + mag * brighten;
+            pa->pixelAccessGetCubic(srcX, srcY, brightness, dst);
             dst += bytesDepth;
         }
-
-        // Update progress bar in dialog.
-
-        progress = (int)(((double)dstJ * 100.0) / jLimit);
-
-        if (progress % 5 == 0)
-        {
-            postProgress(progress);
-        }
     }
 
     delete pa;
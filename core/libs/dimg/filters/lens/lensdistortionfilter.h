@@ -77,6 +77,7 @@ public:
 private:
 
     void filterImage();
+    void filterMultithreaded(uint start, uint stop);
 
 private:
 
@@ -49,6 +49,7 @@
 #include "digikam_debug.h"
 #include "imagehistogram.h"
 #include "digikam_globals.h"
+#include "imagelut.h"
 
 namespace Digikam
 {
@@ -493,8 +494,6 @@ void ImageLevels::levelsLutProcess(uchar* const srcPR, uchar* const destPR, int
 {
     unsigned short* lut0 = NULL, *lut1 = NULL, *lut2 = NULL, *lut3 = NULL;
 
-    int   i;
-
     if (d->lut->nchannels > 0)
     {
         lut0 = d->lut->luts[0];
@@ -517,87 +516,13 @@ void ImageLevels::levelsLutProcess(uchar* const srcPR, uchar* const destPR, int
 
     if (!d->sixteenBit)        // 8 bits image.
     {
-        uchar red, green, blue, alpha;
-        uchar* ptr = srcPR;
-        uchar* dst = destPR;
-
-        for (i = 0 ; i < w * h ; ++i)
-        {
-            blue  = ptr[0];
-            green = ptr[1];
-            red   = ptr[2];
-            alpha = ptr[3];
-
-            if (d->lut->nchannels > 0)
-            {
-                red = lut0[red];
-            }
-
-            if (d->lut->nchannels > 1)
-            {
-                green = lut1[green];
-            }
-
-            if (d->lut->nchannels > 2)
-            {
-                blue = lut2[blue];
-            }
-
-            if (d->lut->nchannels > 3)
-            {
-                alpha = lut3[alpha];
-            }
-
-            dst[0] = blue;
-            dst[1] = green;
-            dst[2] = red;
-            dst[3] = alpha;
-
-            ptr += 4;
-            dst += 4;
-        }
+        ImageLut::process8(srcPR, destPR, (uint)(w * h), lut0, lut1, lut2, lut3);
     }
     else               // 16 bits image.
     {
-        unsigned short red, green, blue, alpha;
-        unsigned short* ptr = reinterpret_cast<unsigned short*>(srcPR);
-        unsigned short* dst = reinterpret_cast<unsigned short*>(destPR);
-
-        for (i = 0 ; i < w * h ; ++i)
-        {
-            blue  = ptr[0];
-            green = ptr[1];
-            red   = ptr[2];
-            alpha = ptr[3];
-
-            if (d->lut->nchannels > 0)
-            {
-                red = lut0[red];
-            }
-
-            if (d->lut->nchannels > 1)
-            {
-                green = lut1[green];
-            }
-
-            if (d->lut->nchannels > 2)
-            {
-                blue = lut2[blue];
-            }
-
-            if (d->lut->nchannels > 3)
-            {
-                alpha = lut3[alpha];
-            }
-
-            dst[0] = blue;
-            dst[1] = green;
-            dst[2] = red;
-            dst[3] = alpha;
-
-            ptr += 4;
-            dst += 4;
-        }
+        ImageLut::process16(reinterpret_cast<unsigned short*>(srcPR),
+                            reinterpret_cast<unsigned short*>(destPR),
+                            (uint)(w * h), lut0, lut1, lut2, lut3);
     }
 }
 
@@ -95,9 +95,13 @@ void LevelsFilter::filterImage()
     levels.levelsLutSetup(AlphaChannel);
     postProgress(80);
 
-    levels.levelsLutProcess(m_orgImage.bits(), m_destImage.bits(),
-                            m_orgImage.width(), m_orgImage.height());
-    postProgress(90);
+    runMultithreaded(this, &LevelsFilter::levelsMultithreaded, &levels, m_orgImage.height(), 80, 90);
+}
+
+void LevelsFilter::levelsMultithreaded(ImageLevels* levels, uint start, uint stop)
+{
+    levels->levelsLutProcess(m_orgImage.scanLine(start), m_destImage.scanLine(start),
+                             m_orgImage.width(), stop - start);
 }
 
 FilterAction LevelsFilter::filterAction()
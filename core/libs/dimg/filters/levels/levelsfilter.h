@@ -35,6 +35,7 @@ namespace Digikam
 {
 
 class DImg;
+class ImageLevels;
 
 class DIGIKAM_EXPORT LevelsContainer
 {
@@ -117,6 +118,7 @@ public:
 private:
 
     void filterImage();
+    void levelsMultithreaded(ImageLevels* levels, uint start, uint stop);
 
 private:
 
@@ -44,10 +44,25 @@ class Q_DECL_HIDDEN FreeRotationFilter::Private
 public:
 
     explicit Private()
+      : lfSin(0.0),
+        lfCos(0.0),
+        nhdx(0),
+        nhdy(0),
+        nhsx(0),
+        nhsy(0)
     {
     }
 
     FreeRotationContainer settings;
+
+    // Rotation parameters shared by all threads.
+
+    double                lfSin;
+    double                lfCos;
+    int                   nhdx;
+    int                   nhdy;
+    int                   nhsx;
+    int                   nhsy;
 };
 
 FreeRotationFilter::FreeRotationFilter(QObject* const parent)
@@ -130,18 +145,12 @@ double FreeRotationFilter::calculateAngle(const QPoint& p1, const QPoint& p2)
 
 void FreeRotationFilter::filterImage()
 {
-    int          progress;
-   int w, h, nw, nh, j, i = 0;
     int          nNewHeight, nNewWidth;
-    int          nhdx, nhdy, nhsx, nhsy;
-    double       lfSin, lfCos, lfx, lfy;
+    double       lfSin, lfCos;
 
     int nWidth  = m_orgImage.width();
     int nHeight = m_orgImage.height();
 
-    uchar* pBits            = m_orgImage.bits();
-    unsigned short* pBits16 = reinterpret_cast<unsigned short*>(m_orgImage.bits());
-
     // first of all, we need to calculate the sin and cos of the given angle
 
     lfSin = sin(d->settings.angle * -DEG2RAD);
@@ -160,15 +169,18 @@ void FreeRotationFilter::filterImage()
         nNewHeight = lround(fabs(nWidth * lfSin + nHeight * lfCos));
     }
 
+    d->lfSin = lfSin;
+    d->lfCos = lfCos;
+
     // getting the destination's center position
 
-    nhdx = nNewWidth  / 2;
-    nhdy = nNewHeight / 2;
+    d->nhdx  = nNewWidth  / 2;
+    d->nhdy  = nNewHeight / 2;
 
     // getting the source's center position
 
-    nhsx = nWidth  / 2;
-    nhsy = nHeight / 2;
+    d->nhsx  = nWidth  / 2;
+    d->nhsy  = nHeight / 2;
 
     // now, we have to alloc a new image
 
@@ -182,69 +194,9 @@ void FreeRotationFilter::filterImage()
 
     m_destImage.fill(DColor(d->settings.backgroundColor.rgb(), sixteenBit));
 
-    uchar* pResBits            = m_destImage.bits();
-    unsigned short* pResBits16 = reinterpret_cast<unsigned short*>(m_destImage.bits());
-
-    PixelsAliasFilter alias;
-
-    // main loop
-
-    for (h = 0; runningFlag() && (h < nNewHeight); ++h)
-    {
-        nh = h - nhdy;
-
-        for (w = 0; runningFlag() && (w < nNewWidth); ++w)
-        {
-            nw = w - nhdx;
-
-            i = setPosition(nNewWidth, w, h);
+    // main loop, each thread processes a band of rows of the destination image
 
-            lfx = (double)nw * lfCos - (double)nh * lfSin + nhsx;
-            lfy = (double)nw * lfSin + (double)nh * lfCos + nhsy;
-
-            if (isInside(nWidth, nHeight, (int)lfx, (int)lfy))
-            {
-                if (d->settings.antiAlias)
-                {
-                    if (!sixteenBit)
-                        alias.pixelAntiAliasing(pBits, nWidth, nHeight, lfx, lfy,
-                                                &pResBits[i + 3], &pResBits[i + 2],
-                                                &pResBits[i + 1], &pResBits[i]);
-                    else
-                        alias.pixelAntiAliasing16(pBits16, nWidth, nHeight, lfx, lfy,
-                                                  &pResBits16[i + 3], &pResBits16[i + 2],
-                                                  &pResBits16[i + 1], &pResBits16[i]);
-                }
-                else
-                {
-                    j = setPosition(nWidth, (int)lfx, (int)lfy);
-
-                    for (int p = 0 ; p < 4 ; ++p)
-                    {
-                        if (!sixteenBit)
-                        {
-                            pResBits[i] = pBits[j];
-                        }
-                        else
-                        {
-                            pResBits16[i] = pBits16[j];
-                        }
-
-                        ++i;
-                        ++j;
-                    }
-                }
-            }
-        }
-
-        // Update the progress bar in dialog.
-        progress = (int)(((double) h * 100.0) / nNewHeight);
-
-        if (progress % 5 == 0)
-        {
-            postProgress(progress);
-        }
-    }
+    runMultithreaded(this, &FreeRotationFilter::rotateMultithreaded, nNewHeight);
 
     // Compute the rotated destination image size using original image dimensions.
     int    W, H;
@@ -377,6 +329,73 @@ void FreeRotationFilter::filterImage()
     }
 }
 
+void FreeRotationFilter::rotateMultithreaded(uint start, uint stop)
+{
+    int w, h, nw, nh, j, i = 0;
+    double lfx, lfy;
+
+    int nWidth                 = m_orgImage.width();
+    int nHeight                = m_orgImage.height();
+    int nNewWidth              = m_destImage.width();
+    bool sixteenBit            = m_orgImage.sixteenBit();
+
+    uchar* pBits               = m_orgImage.bits();
+    unsigned short* pBits16    = reinterpret_cast<unsigned short*>(m_orgImage.bits());
+    uchar* pResBits            = m_destImage.bits();
+    unsigned short* pResBits16 = reinterpret_cast<unsigned short*>(m_destImage.bits());
+
+    PixelsAliasFilter alias;
+
+    for (h = start; runningFlag() && (h < (int)stop); ++h)
+    {
+        nh = h - d->nhdy;
+
+        for (w = 0; runningFlag() && (w < nNewWidth); ++w)
+        {
+            nw = w - d->nhdx;
+
+            i = setPosition(nNewWidth, w, h);
+
+            lfx = (double)nw * d->lfCos - (double)nh * d->lfSin + d->nhsx;
+            lfy = (double)nw * d->lfSin + (double)nh * d->lfCos + d->nhsy;
+
+            if (isInside(nWidth, nHeight, (int)lfx, (int)lfy))
+            {
+                if (d->settings.antiAlias)
+                {
+                    if (!sixteenBit)
+                        alias.pixelAntiAliasing(pBits, nWidth, nHeight, lfx, lfy,
+                                                &pResBits[i + 3], &pResBits[i + 2],
+                                                &pResBits[i + 1], &pResBits[i]);
+                    else
+                        alias.pixelAntiAliasing16(pBits16, nWidth, nHeight, lfx, lfy,
+                                                  &pResBits16[i + 3], &pResBits16[i + 2],
+                                                  &pResBits16[i + 1], &pResBits16[i]);
+                }
+                else
+                {
+                    j = setPosition(nWidth, (int)lfx, (int)lfy);
+
+                    for (int p = 0 ; p < 4 ; ++p)
+                    {
+                        if (!sixteenBit)
+                        {
+                            pResBits[i] = pBits[j];
+                        }
+                        else
+                        {
+                            pResBits16[i] = pBits16[j];
+                        }
+
+                        ++i;
+                        ++j;
+                    }
+                }
+            }
+        }
+    }
+}
+
 int FreeRotationFilter::setPosition(int Width, int X, int Y)
 {
     return (Y * Width * 4 + 4 * X);
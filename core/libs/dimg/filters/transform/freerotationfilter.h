@@ -128,6 +128,7 @@ public:
 private:
 
     void        filterImage();
+    void        rotateMultithreaded(uint start, uint stop);
     inline int  setPosition (int Width, int X, int Y);
     inline bool isInside (int Width, int Height, int X, int Y);
 
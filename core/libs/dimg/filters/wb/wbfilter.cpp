@@ -139,10 +139,15 @@ void WBFilter::filterImage()
     preventAutoExposure(m_settings.maxr, m_settings.maxg, m_settings.maxb);
 
     // Apply White balance adjustments.
-    adjustWhiteBalance(m_orgImage.bits(), m_orgImage.width(), m_orgImage.height(), m_orgImage.sixteenBit());
+    runMultithreaded(this, &WBFilter::wbMultithreaded, m_orgImage.height());
     m_destImage = m_orgImage;
 }
 
+void WBFilter::wbMultithreaded(uint start, uint stop)
+{
+    adjustWhiteBalance(m_orgImage.scanLine(start), m_orgImage.width(), stop - start, m_orgImage.sixteenBit());
+}
+
 void WBFilter::autoWBAdjustementFromColor(const QColor& tc, double& temperature, double& green)
 {
     // Calculate Temperature and Green component from color picked.
@@ -424,7 +429,6 @@ void WBFilter::adjustWhiteBalance(uchar* const data, int width, int height, bool
 {
     uint size = (uint)(width * height);
     uint i, j;
-    int  progress;
 
     if (!sixteenBit)        // 8 bits image.
     {
@@ -456,13 +460,6 @@ void WBFilter::adjustWhiteBalance(uchar* const data, int width, int height, bool
             ptr[1] = (uchar)pixelColor(rv[1], i, v);
             ptr[2] = (uchar)pixelColor(rv[2], i, v);
             ptr   += 4;
-
-            progress = (int)(((double)j * 100.0) / size);
-
-            if (progress % 5 == 0)
-            {
-                postProgress(progress);
-            }
         }
     }
     else               // 16 bits image.
@@ -495,13 +492,6 @@ void WBFilter::adjustWhiteBalance(uchar* const data, int width, int height, bool
             ptr[1] = pixelColor(rv[1], i, v);
             ptr[2] = pixelColor(rv[2], i, v);
             ptr   += 4;
-
-            progress = (int)(((double)j * 100.0) / size);
-
-            if (progress % 5 == 0)
-            {
-                postProgress(progress);
-            }
         }
     }
 }
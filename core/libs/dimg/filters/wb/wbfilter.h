@@ -98,6 +98,7 @@ private:
 
     void setRGBmult();
     void setLUTv();
+    void wbMultithreaded(uint start, uint stop);
     void adjustWhiteBalance(uchar* const data, int width, int height, bool sixteenBit);
     inline unsigned short pixelColor(int colorMult, int index, int value);
 
@@ -139,6 +139,31 @@ void DImgLoader::imageSetAttribute(const QString& key, const QVariant& value)
     m_image->setAttribute(key, value);
 }
 
+QRect DImgLoader::loadingRegion(const QSize& originalSize) const
+{
+    QVariant attribute = imageGetAttribute(QLatin1String("loadingRegion"));
+
+    if (!attribute.isValid())
+    {
+        return QRect();
+    }
+
+    QRect full(QPoint(0, 0), originalSize);
+    QRect region = attribute.toRect().intersected(full);
+
+    if (region.isEmpty() || region == full)
+    {
+        return QRect();
+    }
+
+    return region;
+}
+
+void DImgLoader::setLoadedRegion(const QRect& region)
+{
+    imageSetAttribute(QLatin1String("loadedRegion"), region);
+}
+
 QMap<QString, QString>& DImgLoader::imageEmbeddedText() const
 {
     return m_image->m_priv->embeddedText;
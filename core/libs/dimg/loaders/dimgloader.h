@@ -32,6 +32,7 @@
 // Qt includes
 
 #include <QMap>
+#include <QRect>
 #include <QString>
 #include <QByteArray>
 #include <QVariant>
@@ -114,6 +115,17 @@ protected:
     QVariant                imageGetAttribute(const QString& key) const;
     void                    imageSetAttribute(const QString& key, const QVariant& value);
 
+    /** Returns the part of the image to decode, as requested with the "loadingRegion" attribute,
+     *  in the coordinates of an image of originalSize and clipped to it.
+     *  A null rectangle means that the whole image must be decoded.
+     */
+    QRect                   loadingRegion(const QSize& originalSize) const;
+
+    /** Records in the "loadedRegion" attribute the part of the original image which was decoded.
+     *  The decoded part can be larger than the requested region, i.e. aligned to the blocks of the file.
+     */
+    void                    setLoadedRegion(const QRect& region);
+
     QMap<QString, QString>& imageEmbeddedText()                      const;
     QString                 imageGetEmbbededText(const QString& key) const;
     void                    imageSetEmbbededText(const QString& key, const QString& text);
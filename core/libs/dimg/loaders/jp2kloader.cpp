@@ -333,6 +333,20 @@ bool JP2KLoader::load(const QString& filePath, DImgLoaderObserver* const observe
         }
     }
 
+    // -------------------------------------------------------------------
+    // Find out the part of the image to convert. JasPer always decodes the whole image,
+    // only the rows of the region are stored.
+
+    QSize originalSize(imageWidth(), imageHeight());
+    QRect decoded(QPoint(0, 0), originalSize);
+    QRect region = loadingRegion(originalSize);
+
+    if (region.isValid() && (m_loadFlags & LoadImageData))
+    {
+        decoded = QRect(0, region.top(), imageWidth(), region.height());
+        setLoadedRegion(decoded);
+    }
+
     // -------------------------------------------------------------------
     // Get image data.
 
@@ -342,11 +356,11 @@ bool JP2KLoader::load(const QString& filePath, DImgLoaderObserver* const observe
     {
         if (m_sixteenBit)          // 16 bits image.
         {
-            data.reset(new_failureTolerant(imageWidth(), imageHeight(), 8));
+            data.reset(new_failureTolerant(imageWidth(), decoded.height(), 8));
         }
         else
         {
-            data.reset(new_failureTolerant(imageWidth(), imageHeight(), 4));
+            data.reset(new_failureTolerant(imageWidth(), decoded.height(), 4));
         }
 
         if (!data)
@@ -368,7 +382,7 @@ bool JP2KLoader::load(const QString& filePath, DImgLoaderObserver* const observe
         uchar* dst            = data.data();
         unsigned short* dst16 = reinterpret_cast<unsigned short*>(data.data());
 
-        for (y = 0 ; y < (long)imageHeight() ; ++y)
+        for (y = decoded.top() ; y <= (long)decoded.bottom() ; ++y)
         {
             for (i = 0 ; i < (long)number_components; ++i)
             {
@@ -575,11 +589,12 @@ bool JP2KLoader::load(const QString& filePath, DImgLoaderObserver* const observe
         observer->progressInfo(m_image, 1.0);
     }
 
-    imageData() = data.take();
+    imageHeight() = decoded.height();
+    imageData()   = data.take();
     imageSetAttribute(QLatin1String("format"),             QLatin1String("JP2"));
     imageSetAttribute(QLatin1String("originalColorModel"), colorModel);
     imageSetAttribute(QLatin1String("originalBitDepth"),   maximum_component_depth);
-    imageSetAttribute(QLatin1String("originalSize"),       QSize(imageWidth(), imageHeight()));
+    imageSetAttribute(QLatin1String("originalSize"),       originalSize);
 
     jas_image_destroy(jp2_image);
 
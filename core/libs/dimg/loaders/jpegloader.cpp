@@ -49,6 +49,12 @@ extern "C"
 #include "jpegwin.h"
 #endif
 
+// libjpeg-turbo >= 1.5 can skip rows and crop columns while decoding
+
+#if defined(LIBJPEG_TURBO_VERSION_NUMBER) && (LIBJPEG_TURBO_VERSION_NUMBER >= 1005000)
+#   define JPEG_PARTIAL_DECODING
+#endif
+
 namespace Digikam
 {
 
@@ -287,6 +293,7 @@ bool JPEGLoader::load(const QString& filePath, DImgLoaderObserver* const observe
     int w = cinfo.image_width;
     int h = cinfo.image_height;
     QSize originalSize(w, h);
+    QRect region = loadingRegion(originalSize);
 
     // Libjpeg handles the following conversions:
     // YCbCr => GRAYSCALE, YCbCr => RGB, GRAYSCALE => RGB, YCCK => CMYK
@@ -338,13 +345,22 @@ bool JPEGLoader::load(const QString& filePath, DImgLoaderObserver* const observe
         cinfo.do_fancy_upsampling = boolean(true);
         cinfo.do_block_smoothing  = boolean(false);
 
+        // libjpeg supports 1/1, 1/2, 1/4, 1/8
+        int scale = 1;
+
         // handle scaled loading
         if (scaledLoadingSize)
         {
             int imgSize = qMax(cinfo.image_width, cinfo.image_height);
 
-            // libjpeg supports 1/1, 1/2, 1/4, 1/8
-            int scale = 1;
+#ifdef JPEG_PARTIAL_DECODING
+            // The requested size applies to the decoded region
+
+            if (region.isValid())
+            {
+                imgSize = qMax(region.width(), region.height());
+            }
+#endif
 
             while (scaledLoadingSize* scale * 2 <= imgSize)
             {
@@ -378,6 +394,35 @@ bool JPEGLoader::load(const QString& filePath, DImgLoaderObserver* const observe
         w = cinfo.output_width;
         h = cinfo.output_height;
 
+#ifdef JPEG_PARTIAL_DECODING
+        // Decode only the rows and the columns of the region. A margin of two pixels
+        // keeps the upsampled chroma identical to a full decoding at the region borders.
+        // libjpeg moves the first column to an iMCU boundary.
+
+        if (region.isValid())
+        {
+            const int margin   = 2;
+            const int left     = qMax(region.left() / scale - margin, 0);
+            const int top      = qMax(region.top()  / scale - margin, 0);
+            const int right    = qMin((region.right()  + scale) / scale + margin, w);
+            const int bottom   = qMin((region.bottom() + scale) / scale + margin, h);
+
+            JDIMENSION xoffset = left;
+            JDIMENSION width   = right - left;
+            JDIMENSION yoffset = top;
+            JDIMENSION height  = bottom - top;
+
+            jpeg_crop_scanline(&cinfo, &xoffset, &width);
+            jpeg_skip_scanlines(&cinfo, yoffset);
+
+            w = cinfo.output_width;
+            h = height;
+
+            setLoadedRegion(QRect(xoffset * scale, yoffset * scale, w * scale, h * scale)
+                            .intersected(QRect(QPoint(0, 0), originalSize)));
+        }
+#endif
+
         // -------------------------------------------------------------------
         // Get scanlines
 
@@ -603,6 +648,15 @@ bool JPEGLoader::load(const QString& filePath, DImgLoaderObserver* const observe
             }
         }
 
+#ifdef JPEG_PARTIAL_DECODING
+        // jpeg_finish_decompress() expects all rows to be read
+
+        if (region.isValid() && cinfo.output_scanline < cinfo.output_height)
+        {
+            jpeg_skip_scanlines(&cinfo, cinfo.output_height - cinfo.output_scanline);
+        }
+#endif
+
         // clean up
         cleanupData->deleteData();
     }
@@ -41,6 +41,7 @@ extern "C"
 
 #include <QFile>
 #include <QByteArray>
+#include <QRect>
 #include <QSysInfo>
 
 // Local includes
@@ -278,6 +279,7 @@ bool PNGLoader::load(const QString& filePath, DImgLoaderObserver* const observer
     }
 
     uchar* data  = 0;
+    QRect  decoded(0, 0, width, height);
 
     if (m_loadFlags & LoadImageData)
     {
@@ -413,13 +415,25 @@ bool PNGLoader::load(const QString& filePath, DImgLoaderObserver* const observer
 
         png_read_update_info(png_ptr, info_ptr);
 
+        // The rows are compressed as one stream: with a region, the rows above it are decoded
+        // into the spare last row of the data and the reading stops after its last row.
+        // An interlaced image is decoded completely.
+
+        QRect region = loadingRegion(QSize(width, height));
+
+        if (region.isValid() && (number_passes == 1))
+        {
+            decoded = QRect(0, region.top(), width, region.height());
+            setLoadedRegion(decoded);
+        }
+
         if (m_sixteenBit)
         {
-            data = new_failureTolerant(width, height, 8); // 16 bits/color/pixel
+            data = new_failureTolerant(width, decoded.height() + 1, 8); // 16 bits/color/pixel
         }
         else
         {
-            data = new_failureTolerant(width, height, 4); // 8 bits/color/pixel
+            data = new_failureTolerant(width, decoded.height() + 1, 4); // 8 bits/color/pixel
         }
 
         cleanupData->setData(data);
@@ -438,15 +452,17 @@ bool PNGLoader::load(const QString& filePath, DImgLoaderObserver* const observer
             return false;
         }
 
+        const int rowBytes = m_sixteenBit ? (width * 8) : (width * 4);
+
         for (int i = 0; i < height; ++i)
         {
-            if (m_sixteenBit)
+            if (decoded.contains(0, i))
             {
-                lines[i] = data + (i * width * 8);
+                lines[i] = data + ((i - decoded.top()) * rowBytes);
             }
             else
             {
-                lines[i] = data + (i * width * 4);
+                lines[i] = data + (decoded.height() * rowBytes);
             }
         }
 
@@ -460,7 +476,7 @@ bool PNGLoader::load(const QString& filePath, DImgLoaderObserver* const observer
             int y;
             int checkPoint = 0;
 
-            for (y = 0; y < height; ++y)
+            for (y = 0; y <= decoded.bottom(); ++y)
             {
                 if (observer && y == checkPoint)
                 {
@@ -492,7 +508,7 @@ bool PNGLoader::load(const QString& filePath, DImgLoaderObserver* const observer
             {
                 uchar ptr[8];   // One pixel to swap
 
-                for (int p = 0; p < width * height * 8; p += 8)
+                for (int p = 0; p < width * decoded.height() * 8; p += 8)
                 {
                     memcpy(&ptr[0], &data[p], 8);   // Current pixel
 
@@ -584,7 +600,9 @@ bool PNGLoader::load(const QString& filePath, DImgLoaderObserver* const observer
 
     // -------------------------------------------------------------------
 
-    if (m_loadFlags & LoadImageData)
+    // The end of the file is not read when only the rows of a region were decoded
+
+    if ((m_loadFlags & LoadImageData) && (decoded.height() == height))
     {
         png_read_end(png_ptr, info_ptr);
     }
@@ -599,7 +617,7 @@ bool PNGLoader::load(const QString& filePath, DImgLoaderObserver* const observer
     }
 
     imageWidth()  = width;
-    imageHeight() = height;
+    imageHeight() = decoded.height();
     imageData()   = data;
     imageSetAttribute(QLatin1String("format"),             QLatin1String("PNG"));
     imageSetAttribute(QLatin1String("originalColorModel"), colorModel);
@@ -66,6 +66,55 @@ extern "C"
 namespace Digikam
 {
 
+tsize_t TIFFLoader::readTIFFStrip(TIFF* const tif, tstrip_t st, uchar* const buffer, tsize_t size,
+                                  uint32 w, uint32 h, uint32 rows_per_strip,
+                                  tstrip_t stripsPerPlane, uint32 pixelBytes)
+{
+    if (!TIFFIsTiled(tif))
+    {
+        return TIFFReadEncodedStrip(tif, st, buffer, size);
+    }
+
+    uint32 tile_width  = 0;
+    uint32 tile_length = 0;
+
+    if (!TIFFGetField(tif, TIFFTAG_TILEWIDTH,  &tile_width)  || tile_width  == 0 ||
+        !TIFFGetField(tif, TIFFTAG_TILELENGTH, &tile_length) || tile_length == 0)
+    {
+        return -1;
+    }
+
+    QScopedArrayPointer<uchar> tile(new_failureTolerant(TIFFTileSize(tif)));
+
+    if (tile.isNull())
+    {
+        return -1;
+    }
+
+    const tsample_t plane = st / stripsPerPlane;
+    const uint32    y     = (st % stripsPerPlane) * rows_per_strip;
+    const uint32    rows  = qMin(qMin(rows_per_strip, tile_length), h - y);
+
+    for (uint32 x = 0 ; x < w ; x += tile_width)
+    {
+        if (TIFFReadTile(tif, tile.data(), x, y, 0, plane) == -1)
+        {
+            return -1;
+        }
+
+        const uint32 columns = qMin(tile_width, w - x);
+
+        for (uint32 row = 0 ; row < rows ; ++row)
+        {
+            memcpy(buffer + ((quint64)row * w + x) * pixelBytes,
+                   tile.data() + (quint64)row * tile_width * pixelBytes,
+                   columns * pixelBytes);
+        }
+    }
+
+    return ((tsize_t)rows * w * pixelBytes);
+}
+
 // To manage Errors/Warnings handling provide by libtiff
 
 void TIFFLoader::dimg_tiff_warning(const char* module, const char* format, va_list warnings)
@@ -281,6 +330,138 @@ bool TIFFLoader::load(const QString& filePath, DImgLoaderObserver* const observe
         }
     }
 
+    // -------------------------------------------------------------------
+    // Find out if we do the fast-track loading with reduced size. TIFF specific:
+    // use the smallest reduced-resolution image of the file which is still large enough.
+
+    QSize originalSize(w, h);
+    QRect region = loadingRegion(originalSize);
+
+    if (m_loadFlags & LoadImageData)
+    {
+        QVariant attribute = imageGetAttribute(QLatin1String("scaledLoadingSize"));
+
+        if (attribute.isValid() && TIFFNumberOfDirectories(tif) > 1)
+        {
+            uint32 scaledLoadingSize = attribute.toInt();
+            tdir_t level             = 0;
+            uint32 levelSize         = qMin(w, h);
+
+            for (tdir_t dir = 1 ; TIFFSetDirectory(tif, dir) ; ++dir)
+            {
+                uint32 subfile_type = 0;
+                uint32 dir_w        = 0;
+                uint32 dir_h        = 0;
+                uint16 dir_bits     = 0;
+                uint16 dir_samples  = 0;
+                uint16 dir_photo    = 0;
+                uint16 dir_planar   = 0;
+
+                TIFFGetFieldDefaulted(tif, TIFFTAG_SUBFILETYPE,     &subfile_type);
+                TIFFGetFieldDefaulted(tif, TIFFTAG_IMAGEWIDTH,      &dir_w);
+                TIFFGetFieldDefaulted(tif, TIFFTAG_IMAGELENGTH,     &dir_h);
+                TIFFGetFieldDefaulted(tif, TIFFTAG_BITSPERSAMPLE,   &dir_bits);
+                TIFFGetFieldDefaulted(tif, TIFFTAG_SAMPLESPERPIXEL, &dir_samples);
+                TIFFGetFieldDefaulted(tif, TIFFTAG_PHOTOMETRIC,     &dir_photo);
+                TIFFGetFieldDefaulted(tif, TIFFTAG_PLANARCONFIG,    &dir_planar);
+
+                // Only a stripped reduced version of the main image with the same pixel layout will do
+
+                if (!(subfile_type & FILETYPE_REDUCEDIMAGE) ||
+                    TIFFIsTiled(tif)                        ||
+                    dir_bits    != bits_per_sample          ||
+                    dir_samples != samples_per_pixel        ||
+                    dir_photo   != photometric              ||
+                    dir_planar  != planar_config)
+                {
+                    continue;
+                }
+
+                // The requested size applies to the decoded region
+
+                uint32 dirSize = qMin(dir_w, dir_h);
+
+                if (region.isValid())
+                {
+                    dirSize = qMin((quint64)region.width()  * dir_w / w,
+                                   (quint64)region.height() * dir_h / h);
+                }
+
+                if (dirSize >= scaledLoadingSize && qMin(dir_w, dir_h) < levelSize)
+                {
+                    level     = dir;
+                    levelSize = qMin(dir_w, dir_h);
+                }
+            }
+
+            TIFFSetDirectory(tif, level);
+
+            if (level > 0)
+            {
+                TIFFGetFieldDefaulted(tif, TIFFTAG_IMAGEWIDTH,  &w);
+                TIFFGetFieldDefaulted(tif, TIFFTAG_IMAGELENGTH, &h);
+
+                if (TIFFGetFieldDefaulted(tif, TIFFTAG_ROWSPERSTRIP, &rows_per_strip) == 0 ||
+                    rows_per_strip == 0 || rows_per_strip > h)
+                {
+                    rows_per_strip = h;
+                }
+
+                qCDebug(DIGIKAM_DIMG_LOG_TIFF) << "Loading TIFF scaled version at directory " << level
+                                               << " (" << w << " x " << h << ") for size "
+                                               << scaledLoadingSize;
+            }
+        }
+    }
+
+    // -------------------------------------------------------------------
+    // Find out the part of the image to decode. All rows of the strips, or of the tiles,
+    // intersecting the region are decoded. Only the RGBA reader can skip columns.
+
+    QRect decoded(0, 0, w, h);
+
+    if (TIFFIsTiled(tif))
+    {
+        uint32 tile_length = 0;
+
+        if (TIFFGetField(tif, TIFFTAG_TILELENGTH, &tile_length) && tile_length > 0 && tile_length < h)
+        {
+            rows_per_strip = tile_length;
+        }
+    }
+
+    if (region.isValid() && (m_loadFlags & LoadImageData))
+    {
+        // The region is given in the coordinates of the main image, not of a reduced version
+
+        const quint64 ow     = originalSize.width();
+        const quint64 oh     = originalSize.height();
+        const uint32  top    = ((quint64)region.top() * h / oh) / rows_per_strip * rows_per_strip;
+        const uint32  bottom = qMin((((quint64)region.bottom() + 1) * h + oh - 1) / oh, (quint64)h);
+        uint32        left   = 0;
+        uint32        right  = w;
+
+        if (bits_per_sample != 16 && bits_per_sample != 32)
+        {
+            left  = (quint64)region.left() * w / ow;
+            right = qMin((((quint64)region.right() + 1) * w + ow - 1) / ow, (quint64)w);
+        }
+
+        const uint32  end    = qMin((bottom + rows_per_strip - 1) / rows_per_strip * rows_per_strip, h);
+
+        decoded = QRect(left, top, right - left, end - top);
+
+        QRect loaded;
+        loaded.setCoords(decoded.left() * ow / w, decoded.top() * oh / h,
+                         ((decoded.right()  + 1) * ow + w - 1) / w - 1,
+                         ((decoded.bottom() + 1) * oh + h - 1) / h - 1);
+
+        setLoadedRegion(loaded.intersected(QRect(QPoint(0, 0), originalSize)));
+    }
+
+    const tstrip_t firstStrip = decoded.top()    / rows_per_strip;
+    const tstrip_t lastStrip  = decoded.bottom() / rows_per_strip;
+
     // -------------------------------------------------------------------
     // Get image data.
 
@@ -296,9 +477,26 @@ bool TIFFLoader::load(const QString& filePath, DImgLoaderObserver* const observe
         strip_size    = TIFFStripSize(tif);
         num_of_strips = TIFFNumberOfStrips(tif);
 
+        const uint32 pixelBytes = (planar_config == PLANARCONFIG_SEPARATE) ? (bits_per_sample / 8)
+                                                                           : (samples_per_pixel * bits_per_sample / 8);
+
+        if (TIFFIsTiled(tif))
+        {
+            // The rows of tiles are read as strips, see readTIFFStrip()
+
+            num_of_strips = (h + rows_per_strip - 1) / rows_per_strip;
+            num_of_strips = (planar_config == PLANARCONFIG_SEPARATE) ? (num_of_strips * samples_per_pixel) : num_of_strips;
+            strip_size    = (tsize_t)w * rows_per_strip * pixelBytes;
+        }
+
+        // Planes of separated samples are stored one after the other
+
+        const tstrip_t stripsPerPlane = (planar_config == PLANARCONFIG_SEPARATE) ? num_of_strips / samples_per_pixel
+                                                                                  : num_of_strips;
+
         if (bits_per_sample == 16)          // 16 bits image.
         {
-            data.reset(new_failureTolerant(w, h, 8));
+            data.reset(new_failureTolerant(w, decoded.height(), 8));
             QScopedArrayPointer<uchar> strip(new_failureTolerant(strip_size));
 
             if (!data || strip.isNull())
@@ -329,7 +527,13 @@ bool TIFFLoader::load(const QString& filePath, DImgLoaderObserver* const observe
                     observer->progressInfo(m_image, 0.1 + (0.8 * (((float)st) / ((float)num_of_strips))));
                 }
 
-                bytesRead = TIFFReadEncodedStrip(tif, st, strip.data(), strip_size);
+                if ((st % stripsPerPlane) < firstStrip || (st % stripsPerPlane) > lastStrip)
+                {
+                    continue;
+                }
+
+                bytesRead = readTIFFStrip(tif, st, strip.data(), strip_size,
+                                          w, h, rows_per_strip, stripsPerPlane, pixelBytes);
 
                 if (bytesRead == -1)
                 {
@@ -340,7 +544,7 @@ bool TIFFLoader::load(const QString& filePath, DImgLoaderObserver* const observe
                 }
 
                 if ((planar_config == PLANARCONFIG_SEPARATE) &&
-                    (st % (num_of_strips / samples_per_pixel)) == 0)
+                    (st % stripsPerPlane) == firstStrip)
                 {
                     offset = 0;
                 }
@@ -461,7 +665,7 @@ bool TIFFLoader::load(const QString& filePath, DImgLoaderObserver* const observe
         }
         else if (bits_per_sample == 32)          // 32 bits image.
         {
-            data.reset(new_failureTolerant(w, h, 8));
+            data.reset(new_failureTolerant(w, decoded.height(), 8));
             QScopedArrayPointer<uchar> strip(new_failureTolerant(strip_size));
 
             if (!data || strip.isNull())
@@ -477,6 +681,8 @@ bool TIFFLoader::load(const QString& filePath, DImgLoaderObserver* const observe
             uint  checkpoint = 0;
             float maxValue   = 0.0;
 
+            // The maximum is searched in the whole image, a region is converted as in the full image
+
             for (tstrip_t st = 0 ; st < num_of_strips ; ++st)
             {
                 if (observer && !observer->continueQuery(m_image))
@@ -486,7 +692,8 @@ bool TIFFLoader::load(const QString& filePath, DImgLoaderObserver* const observe
                     return false;
                 }
 
-                bytesRead = TIFFReadEncodedStrip(tif, st, strip.data(), strip_size);
+                bytesRead = readTIFFStrip(tif, st, strip.data(), strip_size,
+                                          w, h, rows_per_strip, stripsPerPlane, pixelBytes);
 
                 if (bytesRead == -1)
                 {
@@ -528,7 +735,13 @@ bool TIFFLoader::load(const QString& filePath, DImgLoaderObserver* const observe
                     observer->progressInfo(m_image, 0.1 + (0.8 * (((float)st) / ((float)num_of_strips))));
                 }
 
-                bytesRead = TIFFReadEncodedStrip(tif, st, strip.data(), strip_size);
+                if ((st % stripsPerPlane) < firstStrip || (st % stripsPerPlane) > lastStrip)
+                {
+                    continue;
+                }
+
+                bytesRead = readTIFFStrip(tif, st, strip.data(), strip_size,
+                                          w, h, rows_per_strip, stripsPerPlane, pixelBytes);
 
                 if (bytesRead == -1)
                 {
@@ -539,7 +752,7 @@ bool TIFFLoader::load(const QString& filePath, DImgLoaderObserver* const observe
                 }
 
                 if ((planar_config == PLANARCONFIG_SEPARATE) &&
-                    (st % (num_of_strips / samples_per_pixel)) == 0)
+                    (st % stripsPerPlane) == firstStrip)
                 {
                     offset = 0;
                 }
@@ -641,8 +854,8 @@ bool TIFFLoader::load(const QString& filePath, DImgLoaderObserver* const observe
         }
         else       // Non 16 or 32 bits images ==> get it on BGRA 8 bits.
         {
-            data.reset(new_failureTolerant(w, h, 4));
-            QScopedArrayPointer<uchar> strip(new_failureTolerant(w, rows_per_strip, 4));
+            data.reset(new_failureTolerant(decoded.width(), decoded.height(), 4));
+            QScopedArrayPointer<uchar> strip(new_failureTolerant(decoded.width(), rows_per_strip, 4));
 
             if (!data || strip.isNull())
             {
@@ -678,11 +891,11 @@ bool TIFFLoader::load(const QString& filePath, DImgLoaderObserver* const observe
             img.req_orientation = img.orientation;
 
             // read strips from image: read rows_per_strip, so always start at beginning of a strip
-            for (uint row = 0 ; row < h ; row += rows_per_strip)
+            for (uint row = decoded.top() ; row <= (uint)decoded.bottom() ; row += rows_per_strip)
             {
-                if (observer && row >= checkpoint)
+                if (observer && row - decoded.top() >= checkpoint)
                 {
-                    checkpoint += granularity(observer, h, 0.8F);
+                    checkpoint += granularity(observer, decoded.height(), 0.8F);
 
                     if (!observer->continueQuery(m_image))
                     {
@@ -691,11 +904,11 @@ bool TIFFLoader::load(const QString& filePath, DImgLoaderObserver* const observe
                         return false;
                     }
 
-                    observer->progressInfo(m_image, 0.1 + (0.8 * (((float)row) / ((float)h))));
+                    observer->progressInfo(m_image, 0.1 + (0.8 * (((float)(row - decoded.top())) / ((float)decoded.height()))));
                 }
 
                 img.row_offset  = row;
-                img.col_offset  = 0;
+                img.col_offset  = decoded.left();
 
                 if (row + rows_per_strip > img.height)
                 {
@@ -708,7 +921,7 @@ bool TIFFLoader::load(const QString& filePath, DImgLoaderObserver* const observe
 
                 // Read data
 
-                if (TIFFRGBAImageGet(&img, reinterpret_cast<uint32*>(strip.data()), img.width, rows_to_read) == -1)
+                if (TIFFRGBAImageGet(&img, reinterpret_cast<uint32*>(strip.data()), decoded.width(), rows_to_read) == -1)
                 {
                     qCWarning(DIGIKAM_DIMG_LOG_TIFF) << "Failed to read image data";
                     TIFFClose(tif);
@@ -716,7 +929,7 @@ bool TIFFLoader::load(const QString& filePath, DImgLoaderObserver* const observe
                     return false;
                 }
 
-                pixelsRead = rows_to_read * img.width;
+                pixelsRead = rows_to_read * decoded.width();
 
                 uchar* stripPtr = (uchar*)(strip.data());
                 uchar* dataPtr  = (uchar*)(data.data() + offset);
@@ -752,13 +965,13 @@ bool TIFFLoader::load(const QString& filePath, DImgLoaderObserver* const observe
         observer->progressInfo(m_image, 1.0);
     }
 
-    imageWidth()  = w;
-    imageHeight() = h;
+    imageWidth()  = decoded.width();
+    imageHeight() = decoded.height();
     imageData()   = data.take();
     imageSetAttribute(QLatin1String("format"),             QLatin1String("TIFF"));
     imageSetAttribute(QLatin1String("originalColorModel"), colorModel);
     imageSetAttribute(QLatin1String("originalBitDepth"),   bits_per_sample);
-    imageSetAttribute(QLatin1String("originalSize"),       QSize(w, h));
+    imageSetAttribute(QLatin1String("originalSize"),       originalSize);
 
     return true;
 }
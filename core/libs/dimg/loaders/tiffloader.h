@@ -64,6 +64,14 @@ private:
     // cppcheck-suppress unusedPrivateFunction
     void tiffSetExifDataTag(TIFF* const tif, ttag_t tiffTag, const DMetadata& metaData, const char* const exifTagName);
 
+    /** Reads the strip st. The 16 and 32 bits samples of a tiled image are read by rows of tiles,
+     *  the row st is assembled as a strip of rows_per_strip rows of the whole width w.
+     *  Returns the number of bytes read, or -1 on error.
+     */
+    static tsize_t readTIFFStrip(TIFF* const tif, tstrip_t st, uchar* const buffer, tsize_t size,
+                                 uint32 w, uint32 h, uint32 rows_per_strip,
+                                 tstrip_t stripsPerPlane, uint32 pixelBytes);
+
     static void dimg_tiff_warning(const char* module, const char* format, va_list warnings);
     static void dimg_tiff_error(const char* module, const char* format, va_list errors);
 
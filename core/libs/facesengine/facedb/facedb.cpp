@@ -44,6 +44,11 @@
 #include "interpolation.h"
 #include "frontal_face_detector.h"
 
+// Qt includes
+
+#include <QFileInfo>
+#include <QDateTime>
+
 // Local includes
 
 #include "eigenfacemodel.h"
@@ -62,13 +67,94 @@ class Q_DECL_HIDDEN FaceDb::Private
 
 public:
     explicit Private()
-        : db(0)
+        : db(0),
+          embeddingsChecked(false)
     {
     }
 
+    void storeDNNFaceIndex(DNNFaceModel& model);
+    void checkFaceEmbeddings();
+
+    static QByteArray         compressVector(const std::vector<float>& vecdata);
+    static std::vector<float> uncompressVector(const QByteArray& cData);
+
+public:
+
     FaceDbBackend* db;
+    bool           embeddingsChecked;
 };
 
+void FaceDb::Private::storeDNNFaceIndex(DNNFaceModel& model)
+{
+    QList<int> databaseIds;
+
+    foreach (const DNNFaceVecMetadata& metadata, model.vecMetadata())
+    {
+        databaseIds << metadata.databaseId;
+    }
+
+    QByteArray data = model.ptr()->index().toByteArray(databaseIds);
+
+    if (data.isEmpty())
+    {
+        db->execSql(QLatin1String("DELETE FROM FaceMatricesIndex;"));
+        return;
+    }
+
+    db->execSql(QLatin1String("REPLACE INTO FaceMatricesIndex (id, `data`) VALUES (1, ?);"),
+                qCompress(data));
+}
+
+void FaceDb::Private::checkFaceEmbeddings()
+{
+    if (embeddingsChecked)
+    {
+        return;
+    }
+
+    embeddingsChecked = true;
+
+    // The cached vectors are only valid for the network which computed them
+
+    QFileInfo info(QStandardPaths::locate(QStandardPaths::GenericDataLocation,
+                                          QLatin1String("digikam/facesengine/dlib_face_recognition_resnet_model_v1.dat")));
+    QString model = QString::fromLatin1("%1-%2").arg(info.size())
+                                                .arg(info.lastModified().toMSecsSinceEpoch());
+
+    QMap<QString, QVariant> parameters;
+    parameters.insert(QLatin1String(":keyword"), QLatin1String("FaceEmbeddingsModel"));
+    QList<QVariant> values;
+
+    db->execDBAction(db->getDBAction(QLatin1String("SelectFaceSetting")), parameters, &values);
+
+    if (!values.isEmpty() && (values.first().toString() == model))
+    {
+        return;
+    }
+
+    qCDebug(DIGIKAM_FACEDB_LOG) << "Face recognition model changed, clearing the face vectors cache";
+
+    db->execSql(QLatin1String("DELETE FROM FaceEmbeddings;"));
+
+    parameters.insert(QLatin1String(":value"), model);
+    db->execDBAction(db->getDBAction(QLatin1String("ReplaceFaceSetting")), parameters);
+}
+
+QByteArray FaceDb::Private::compressVector(const std::vector<float>& vecdata)
+{
+    QByteArray vec_byte((const char*)vecdata.data(), (int)(vecdata.size() * sizeof(float)));
+
+    return qCompress(vec_byte);
+}
+
+std::vector<float> FaceDb::Private::uncompressVector(const QByteArray& cData)
+{
+    QByteArray new_vec = qUncompress(cData);
+    const float* const it = (const float*)new_vec.constData();
+
+    return std::vector<float>(it, it + new_vec.size() / sizeof(float));
+}
+
 /*
  * NOTE: This constructor is only used in facerec_dnnborrowed.cpp.
  * Create an object of FaceDb to invoke the method getFaceVector
@@ -405,6 +491,103 @@ void FaceDb::getFaceVector(cv::Mat data, std::vector<float>& vecdata)
     dnnFaceKernel.getFaceVector(data, vecdata);
 }
 
+void FaceDb::getFaceVectors(const std::vector<cv::Mat>& data, std::vector<std::vector<float> >& vecdata)
+{
+    DNNFaceKernel dnnFaceKernel;
+    dnnFaceKernel.getFaceVectors(data, vecdata);
+}
+
+QMap<QString, std::vector<float> > FaceDb::faceEmbeddings(const QStringList& keys) const
+{
+    QMap<QString, std::vector<float> > embeddings;
+
+    if (keys.isEmpty())
+    {
+        return embeddings;
+    }
+
+    d->checkFaceEmbeddings();
+
+    // One query for all faces, in chunks below the bound values limit of SQLite
+
+    const int chunkSize = 500;
+
+    for (int i = 0 ; i < keys.size() ; i += chunkSize)
+    {
+        QStringList  chunk = keys.mid(i, chunkSize);
+        QVariantList boundValues;
+        QString      sql   = QLatin1String("SELECT faceKey, vecdata FROM FaceEmbeddings WHERE faceKey IN (");
+
+        for (int j = 0 ; j < chunk.size() ; ++j)
+        {
+            sql         += (j == 0) ? QLatin1String("?") : QLatin1String(",?");
+            boundValues << chunk.at(j);
+        }
+
+        sql += QLatin1String(");");
+
+        QList<QVariant> values;
+        d->db->execSql(sql, boundValues, &values);
+
+        for (QList<QVariant>::const_iterator it = values.constBegin() ; it != values.constEnd() ;)
+        {
+            QString key                = (*it).toString();
+            ++it;
+            std::vector<float> vecdata = Private::uncompressVector((*it).toByteArray());
+            ++it;
+
+            if (!vecdata.empty())
+            {
+                embeddings.insert(key, vecdata);
+            }
+        }
+    }
+
+    return embeddings;
+}
+
+QStringList FaceDb::faceEmbeddingKeys() const
+{
+    QList<QVariant> values;
+    d->db->execSql(QLatin1String("SELECT faceKey FROM FaceEmbeddings;"), &values);
+
+    QStringList keys;
+
+    foreach (const QVariant& value, values)
+    {
+        keys << value.toString();
+    }
+
+    return keys;
+}
+
+void FaceDb::storeFaceEmbeddings(const QMap<QString, std::vector<float> >& embeddings)
+{
+    d->checkFaceEmbeddings();
+
+    for (QMap<QString, std::vector<float> >::const_iterator it = embeddings.constBegin() ;
+         it != embeddings.constEnd() ; ++it)
+    {
+        if (it.key().isEmpty() || it.value().empty())
+        {
+            continue;
+        }
+
+        d->db->execSql(QLatin1String("REPLACE INTO FaceEmbeddings (faceKey, vecdata) VALUES (?,?);"),
+                       it.key(), Private::compressVector(it.value()));
+    }
+}
+
+void FaceDb::removeFaceEmbedding(const QString& key)
+{
+    d->db->execSql(QLatin1String("DELETE FROM FaceEmbeddings WHERE faceKey=?;"), key);
+}
+
+void FaceDb::clearFaceEmbeddings()
+{
+    d->db->execSql(QLatin1String("DELETE FROM FaceEmbeddings;"));
+}
+
 void FaceDb::updateEIGENFaceModel(EigenFaceModel& model, const std::vector<cv::Mat>& images_rgb)
 {
     QList<EigenFaceMatMetadata> metadataList = model.matMetadata();
@@ -602,6 +785,7 @@ FisherFaceModel FaceDb::fisherFaceModel() const
 void FaceDb::updateDNNFaceModel(DNNFaceModel& model)
 {
     QList<DNNFaceVecMetadata> metadataList = model.vecMetadata();
+    bool written                           = false;
 
     for (size_t i = 0 ; i < (size_t)metadataList.size() ; ++i)
     {
@@ -642,12 +826,20 @@ void FaceDb::updateDNNFaceModel(DNNFaceModel& model)
                                histogramValues, 0, &insertedId);
 
                 model.setWrittenToDatabase(i, insertedId.toInt());
+                written = true;
 
                 qCDebug(DIGIKAM_FACEDB_LOG) << "Commit compressed vecData " << insertedId << " for identity "
                                             << metadata.identity << " with size " << compressed_vecdata.size();
             }
         }
     }
+
+    // The stored index must know the database ids of the new vectors
+
+    if (written && model.ptr()->index().isValid())
+    {
+        d->storeDNNFaceIndex(model);
+    }
 }
 
 DNNFaceModel FaceDb::dnnFaceModel() const
@@ -703,6 +895,33 @@ DNNFaceModel FaceDb::dnnFaceModel() const
 
     model.setMats(mats, matMetadata);
 
+    if (matMetadata.size() < DNNFaceIndex::MinimumCount)
+    {
+        return model;
+    }
+
+    // Restore the nearest neighbour index, or build it again if the stored one is missing or outdated
+
+    QList<int> databaseIds;
+
+    foreach (const DNNFaceVecMetadata& metadata, matMetadata)
+    {
+        databaseIds << metadata.databaseId;
+    }
+
+    DNNFaceIndex& index = model.ptr()->index();
+    QList<QVariant> values;
+    d->db->execSql(QLatin1String("SELECT `data` FROM FaceMatricesIndex WHERE id=1;"), &values);
+
+    if (values.isEmpty() ||
+        !index.fromByteArray(qUncompress(values.first().toByteArray()), databaseIds, model.ptr()->getSrc()))
+    {
+        qCDebug(DIGIKAM_FACEDB_LOG) << "Building DNN face index for" << matMetadata.size() << "face vectors";
+
+        index.build(model.ptr()->getSrc());
+        d->storeDNNFaceIndex(model);
+    }
+
     return model;
 }
 
@@ -711,6 +930,7 @@ void FaceDb::clearEIGENTraining(const QString& context)
     if (context.isNull())
     {
         d->db->execSql(QLatin1String("DELETE FROM FaceMatrices;"));
+        d->db->execSql(QLatin1String("DELETE FROM FaceMatricesIndex;"));
     }
     else
     {
@@ -31,6 +31,8 @@
 // Qt includes
 
 #include <QString>
+#include <QStringList>
+#include <QMap>
 #include <QFile>
 #include <QDataStream>
 #include <QStandardPaths>
@@ -89,6 +91,39 @@ public:
     void getFaceVector(cv::Mat data, std::vector<float>& vecdata);
     DNNFaceModel dnnFaceModel() const;
 
+    /**
+     * Computes the face vectors of all images in one batch, see DNNFaceKernel.
+     * An image for which no vector can be computed gets an empty vector.
+     */
+    void getFaceVectors(const std::vector<cv::Mat>& data, std::vector<std::vector<float> >& vecdata);
+
+    /**
+     * Returns the cached face vectors of the faces identified by keys.
+     * Faces without a cached vector are not in the returned map.
+     */
+    QMap<QString, std::vector<float> > faceEmbeddings(const QStringList& keys) const;
+
+    /**
+     * Returns the keys of all cached face vectors.
+     */
+    QStringList faceEmbeddingKeys() const;
+
+    /**
+     * Stores the face vectors in the cache, replacing the previous vector of the same key.
+     * The cache is cleared first if the face recognition network changed.
+     */
+    void storeFaceEmbeddings(const QMap<QString, std::vector<float> >& embeddings);
+
+    /**
+     * Removes the cached face vector of the face identified by key.
+     */
+    void removeFaceEmbedding(const QString& key);
+
+    /**
+     * Removes all cached face vectors.
+     */
+    void clearFaceEmbeddings();
+
     // ----------- Database shrinking methods ----------
 
     /**
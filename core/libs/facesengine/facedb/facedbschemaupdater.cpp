@@ -40,7 +40,7 @@ namespace Digikam
 
 int FaceDbSchemaUpdater::schemaVersion()
 {
-    return 3;
+    return 5;
 }
 
 // -------------------------------------------------------------------------------------
@@ -215,11 +215,37 @@ bool FaceDbSchemaUpdater::makeUpdates()
         {
             updateV2ToV3();
         }
+
+        if ((d->currentVersion == 3) && !updateV3ToV4())
+        {
+            setUpdateError();
+            return false;
+        }
+
+        if ((d->currentVersion == 4) && !updateV4ToV5())
+        {
+            setUpdateError();
+            return false;
+        }
     }
 
     return true;
 }
 
+void FaceDbSchemaUpdater::setUpdateError()
+{
+    QString errorMsg = i18n("Failed to update the database schema from version %1 to version %2.\n%3",
+                            d->currentVersion, d->currentVersion + 1,
+                            d->dbAccess->backend()->lastError());
+    d->dbAccess->setLastError(errorMsg);
+
+    if (d->observer)
+    {
+        d->observer->error(errorMsg);
+        d->observer->finishedSchemaUpdate(InitializationObserver::UpdateErrorMustAbort);
+    }
+}
+
 
 bool FaceDbSchemaUpdater::createDatabase()
 {
@@ -239,7 +265,9 @@ bool FaceDbSchemaUpdater::createTables()
 {
     return d->dbAccess->backend()->execDBAction(d->dbAccess->backend()->getDBAction(QLatin1String("CreateFaceDB"))) &&
            d->dbAccess->backend()->execDBAction(d->dbAccess->backend()->getDBAction(QLatin1String("CreateFaceDBOpenCVLBPH"))) &&
-           d->dbAccess->backend()->execDBAction(d->dbAccess->backend()->getDBAction(QLatin1String("CreateFaceDBFaceMatrices")));
+           d->dbAccess->backend()->execDBAction(d->dbAccess->backend()->getDBAction(QLatin1String("CreateFaceDBFaceMatrices"))) &&
+           d->dbAccess->backend()->execDBAction(d->dbAccess->backend()->getDBAction(QLatin1String("CreateFaceDBFaceMatricesIndex"))) &&
+           d->dbAccess->backend()->execDBAction(d->dbAccess->backend()->getDBAction(QLatin1String("CreateFaceDBFaceEmbeddings")));
 }
 
 bool FaceDbSchemaUpdater::createIndices()
@@ -276,4 +304,38 @@ bool FaceDbSchemaUpdater::updateV2ToV3()
     return true;
 }
 
+bool FaceDbSchemaUpdater::updateV3ToV4()
+{
+    // Version 3 can still read a version 4 database, which only adds the index table.
+    // A failure to create it aborts the update, the schema is left at version 3.
+
+    if (!d->dbAccess->backend()->execDBAction(d->dbAccess->backend()->getDBAction(QLatin1String("CreateFaceDBFaceMatricesIndex"))))
+    {
+        qCWarning(DIGIKAM_FACEDB_LOG) << "Face database: cannot create the FaceMatricesIndex table";
+        return false;
+    }
+
+    d->currentVersion         = 4;
+    d->currentRequiredVersion = 3;
+
+    return true;
+}
+
+bool FaceDbSchemaUpdater::updateV4ToV5()
+{
+    // Older versions ignore the embeddings cache table.
+    // A failure to create it aborts the update, the schema is left at version 4.
+
+    if (!d->dbAccess->backend()->execDBAction(d->dbAccess->backend()->getDBAction(QLatin1String("CreateFaceDBFaceEmbeddings"))))
+    {
+        qCWarning(DIGIKAM_FACEDB_LOG) << "Face database: cannot create the FaceEmbeddings table";
+        return false;
+    }
+
+    d->currentVersion         = 5;
+    d->currentRequiredVersion = 3;
+
+    return true;
+}
+
 } // namespace Digikam
@@ -58,6 +58,10 @@ private:
     bool createTriggers();
     bool updateV1ToV2();
     bool updateV2ToV3();
+    bool updateV3ToV4();
+    bool updateV4ToV5();
+
+    void setUpdateError();
 
 private:
 
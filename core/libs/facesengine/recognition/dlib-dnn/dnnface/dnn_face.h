@@ -35,6 +35,12 @@
 #include <QFile>
 #include <QDataStream>
 #include <QStandardPaths>
+#include <QList>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThreadPool>
+#include <QFuture>
+#include <QtConcurrent>    // krazy:exclude=includes
 
 // Local includes
 
@@ -95,64 +101,243 @@ using anet_type = loss_metric<fc_no_bias<128,avg_pool_everything<
 using namespace Digikam;
 using namespace Digikam::redeye;
 
-class DNNFaceKernel
+/** The models are loaded once and shared by all kernels. The shape predictor
+ *  is only read and is shared as is. The detector and the network keep
+ *  internal buffers while they run, so each thread uses its own copy.
+ *  The network copies are recycled, as copying one costs as much as a few
+ *  forward passes.
+ */
+class DNNFaceModels
 {
 public:
 
-    explicit DNNFaceKernel()
+    static DNNFaceModels* instance()
     {
-    };
+        static DNNFaceModels models;
+        return &models;
+    }
 
-    void getFaceVector(cv::Mat tmp_mat, std::vector<float>& vecdata)
+    /** Returns true if the models are available. Loads them on first call.
+     */
+    bool load()
     {
-        anet_type net;
-        frontal_face_detector detector = get_frontal_face_detector();
+        QMutexLocker lock(&mutex);
+
+        if (loaded)
+        {
+            return valid;
+        }
+
+        loaded = true;
 
         QString path1 = QStandardPaths::locate(QStandardPaths::GenericDataLocation,
-                                               QLatin1String("digikam/facesengine/dlib_face_recognition_resnet_model_v1.dat")); 
+                                               QLatin1String("digikam/facesengine/dlib_face_recognition_resnet_model_v1.dat"));
         deserialize(path1.toStdString()) >> net;
 
-        redeye::ShapePredictor sp;
         QString path2 = QStandardPaths::locate(QStandardPaths::GenericDataLocation,
                                                QLatin1String("digikam/facesengine/shapepredictor.dat"));
         QFile model(path2);
-        redeye::ShapePredictor* const temp = new redeye::ShapePredictor();
 
         qCDebug(DIGIKAM_FACEDB_LOG) << "Start reading shape predictor file";
 
-        if (model.open(QIODevice::ReadOnly))
+        if (!model.open(QIODevice::ReadOnly))
         {
-            QDataStream dataStream(&model);
-            dataStream.setFloatingPointPrecision(QDataStream::SinglePrecision);
-            dataStream >> *temp;
-            sp = *temp;
-            model.close();
+            qCDebug(DIGIKAM_FACEDB_LOG) << "Error open file shapepredictor.dat\n";
+            return false;
         }
-        else
+
+        QDataStream dataStream(&model);
+        dataStream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+        dataStream >> sp;
+        model.close();
+
+        detector = get_frontal_face_detector();
+        valid    = true;
+
+        return valid;
+    }
+
+    anet_type* acquireNet()
+    {
+        QMutexLocker lock(&mutex);
+
+        if (freeNets.empty())
+        {
+            return new anet_type(net);
+        }
+
+        anet_type* const copy = freeNets.back();
+        freeNets.pop_back();
+
+        return copy;
+    }
+
+    void releaseNet(anet_type* const copy)
+    {
+        QMutexLocker lock(&mutex);
+        freeNets.push_back(copy);
+    }
+
+    frontal_face_detector detectorCopy()
+    {
+        QMutexLocker lock(&mutex);
+        return detector;
+    }
+
+public:
+
+    redeye::ShapePredictor   sp;
+
+private:
+
+    DNNFaceModels()
+      : loaded(false),
+        valid(false)
+    {
+    }
+
+    ~DNNFaceModels()
+    {
+        for (size_t i = 0 ; i < freeNets.size() ; ++i)
+        {
+            delete freeNets[i];
+        }
+    }
+
+private:
+
+    QMutex                   mutex;
+    bool                     loaded;
+    bool                     valid;
+    anet_type                net;
+    frontal_face_detector    detector;
+    std::vector<anet_type*>  freeNets;
+};
+
+// -------------------------------------------------------------------------------------------
+
+class DNNFaceKernel
+{
+public:
+
+    /// Number of face chips passed to the network at once
+    static const size_t BatchSize        = 32;
+
+    /// A thread is started for at least this number of faces
+    static const size_t MinimumBandSize  = 4;
+
+public:
+
+    explicit DNNFaceKernel()
+    {
+    };
+
+    void getFaceVector(cv::Mat tmp_mat, std::vector<float>& vecdata)
+    {
+        std::vector<cv::Mat> images(1, tmp_mat);
+        std::vector<std::vector<float> > vectors;
+
+        getFaceVectors(images, vectors);
+
+        if (!vectors.empty() && !vectors[0].empty())
+        {
+            vecdata = vectors[0];
+        }
+    };
+
+    /** Computes the face vectors of all images at once. The images are split in
+     *  bands processed by the threads of the global pool, and the face chips of
+     *  each band go through the network in batches of BatchSize.
+     *  An image for which no vector can be computed gets an empty vector.
+     */
+    void getFaceVectors(const std::vector<cv::Mat>& images, std::vector<std::vector<float> >& vectors)
+    {
+        vectors.clear();
+        vectors.resize(images.size());
+
+        if (images.empty() || !DNNFaceModels::instance()->load())
         {
-            qCDebug(DIGIKAM_FACEDB_LOG) << "Error open file shapepredictor.dat\n";
             return;
         }
 
-        delete temp;
+        const size_t threads = (size_t)qMax(1, QThreadPool::globalInstance()->maxThreadCount());
+        const size_t bands   = qBound((size_t)1, images.size() / MinimumBandSize, threads);
 
-        matrix<rgb_pixel> img;
+        if (bands == 1)
+        {
+            processBand(&images, &vectors, 0, images.size());
+            return;
+        }
+
+        QList<QFuture<void> > tasks;
+        const size_t step = images.size() / bands;
+
+        for (size_t b = 0 ; b < bands ; ++b)
+        {
+            const size_t begin = b * step;
+            const size_t end   = (b == bands - 1) ? images.size() : begin + step;
+
+            tasks.append(QtConcurrent::run(this, &DNNFaceKernel::processBand,
+                                           &images, &vectors, begin, end));
+        }
+
+        foreach (QFuture<void> t, tasks)
+        {
+            t.waitForFinished();
+        }
+    };
+
+private:
+
+    void processBand(const std::vector<cv::Mat>* images, std::vector<std::vector<float> >* vectors,
+                     size_t begin, size_t end)
+    {
+        DNNFaceModels* const models    = DNNFaceModels::instance();
+        frontal_face_detector detector = models->detectorCopy();
         std::vector<matrix<rgb_pixel> > faces;
 
-        std::cout << "tmp_mat channels: " << tmp_mat.channels() << std::endl;
+        faces.reserve(end - begin);
 
-        assign_image(img, cv_image<rgb_pixel>(tmp_mat));
-        bool face_flag = false;
+        for (size_t i = begin ; i < end ; ++i)
+        {
+            faces.push_back(faceChip(detector, models->sp, (*images)[i]));
+        }
 
-        for (auto face : detector(img))
+        anet_type* const net = models->acquireNet();
+        std::vector<matrix<float, 0, 1> > face_descriptors = (*net)(faces, BatchSize);
+        models->releaseNet(net);
+
+        for (size_t i = 0 ; i < face_descriptors.size() ; ++i)
         {
-            qCDebug(DIGIKAM_FACEDB_LOG) << "Detected face";
+            std::vector<float>& vecdata = (*vectors)[begin + i];
+
+            for (int r = 0 ; r < face_descriptors[i].nr() ; ++r)
+            {
+                for (int c = 0 ; c < face_descriptors[i].nc() ; ++c)
+                {
+                    vecdata.push_back(face_descriptors[i](r, c));
+                }
+            }
+        }
+    };
+
+    /** Returns the aligned 150x150 chip of the face in tmp_mat, or the whole
+     *  image resized to 150x150 if no face is detected.
+     */
+    static matrix<rgb_pixel> faceChip(frontal_face_detector& detector, const redeye::ShapePredictor& sp,
+                                      cv::Mat tmp_mat)
+    {
+        matrix<rgb_pixel> img;
+        assign_image(img, cv_image<rgb_pixel>(tmp_mat));
+
+        std::vector<rectangle> detected = detector(img);
 
-            face_flag = true;
+        if (!detected.empty())
+        {
+            const rectangle& face = detected.front();
             cv::Mat gray;
 
             int type = tmp_mat.type();
-            qCDebug(DIGIKAM_FACEDB_LOG) << "type: " << type;
 
             if (type == CV_8UC3 || type == CV_16UC3)
             {
@@ -170,41 +355,17 @@ public:
 
             cv::Rect new_rect(face.left(), face.top(), face.right()-face.left(), face.bottom()-face.top());
             FullObjectDetection object = sp(gray, new_rect);
-            qCDebug(DIGIKAM_FACEDB_LOG) << "Full object detection finished";
             matrix<rgb_pixel> face_chip;
             extract_image_chip(img, get_face_chip_details(object, 150, 0.25), face_chip);
-            qCDebug(DIGIKAM_FACEDB_LOG) << "Extract image chip finished";
-            faces.push_back(move(face_chip));
-            break;
-        }
 
-        if (!face_flag)
-        {
-            cv::resize(tmp_mat, tmp_mat, cv::Size(150, 150));
-            assign_image(img, cv_image<rgb_pixel>(tmp_mat));
-            faces.push_back(img);
+            return face_chip;
         }
 
-        qCDebug(DIGIKAM_FACEDB_LOG) << "Start neural network";
-        std::vector<matrix<float, 0, 1> > face_descriptors = net(faces);
-        qCDebug(DIGIKAM_FACEDB_LOG) << "Face descriptors size:" << face_descriptors.size();
-
-        if (face_descriptors.size() != 0)
-        {
-            vecdata.clear();
+        cv::Mat resized;
+        cv::resize(tmp_mat, resized, cv::Size(150, 150));
+        assign_image(img, cv_image<rgb_pixel>(resized));
 
-            for(int i = 0 ; i < face_descriptors[0].nr() ; ++i)
-            {
-                for(int j = 0 ; j < face_descriptors[0].nc() ; ++j)
-                {
-                    vecdata.push_back(face_descriptors[0](i, j));
-                }
-            }
-        }
-        /*else
-        {
-            qCDebug(DIGIKAM_FACEDB_LOG) << "Error calculate face vector";
-        }*/
+        return img;
     };
 };
 
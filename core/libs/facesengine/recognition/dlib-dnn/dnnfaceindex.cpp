@@ -0,0 +1,432 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam
+ *
+ * Date        : 2018-11-10
+ * Description : Inverted file index of DNN face vectors
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "dnnfaceindex.h"
+
+// C++ includes
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+// Qt includes
+
+#include <QDataStream>
+#include <QHash>
+#include <QtGlobal>
+
+namespace Digikam
+{
+
+/// Increase when the format of toByteArray() changes
+static const quint32 s_formatVersion = 1;
+
+/// Number of k-means iterations. The lists only need to be compact, not optimal.
+static const int     s_iterations    = 8;
+
+/// Number of vectors per list used to compute the centroids
+static const int     s_samplesPerList = 64;
+
+DNNFaceIndex::DNNFaceIndex()
+    : m_dimension(0),
+      m_builtCount(0)
+{
+}
+
+DNNFaceIndex::~DNNFaceIndex()
+{
+}
+
+void DNNFaceIndex::clear()
+{
+    m_dimension  = 0;
+    m_builtCount = 0;
+    m_centroids.clear();
+    m_radii.clear();
+    m_lists.clear();
+    m_listOfVector.clear();
+}
+
+bool DNNFaceIndex::isValid() const
+{
+    return !m_lists.empty();
+}
+
+int DNNFaceIndex::count() const
+{
+    return (int)m_listOfVector.size();
+}
+
+float DNNFaceIndex::distance(const float* const a, const float* const b, int dimension)
+{
+    // Independent sums let the compiler use vector instructions
+
+    float sum[8] = { 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F };
+    int i        = 0;
+
+    for ( ; i + 8 <= dimension ; i += 8)
+    {
+        for (int j = 0 ; j < 8 ; ++j)
+        {
+            const float diff = a[i + j] - b[i + j];
+            sum[j]          += diff * diff;
+        }
+    }
+
+    for ( ; i < dimension ; ++i)
+    {
+        const float diff = a[i] - b[i];
+        sum[0]          += diff * diff;
+    }
+
+    return std::sqrt(((sum[0] + sum[4]) + (sum[1] + sum[5])) + ((sum[2] + sum[6]) + (sum[3] + sum[7])));
+}
+
+void DNNFaceIndex::setupLists(int numberOfLists)
+{
+    m_radii.assign(numberOfLists, 0.0F);
+    m_lists.assign(numberOfLists, std::vector<int>());
+    m_listOfVector.clear();
+}
+
+void DNNFaceIndex::addToList(int list, const std::vector<float>& vector)
+{
+    const int position = (int)m_listOfVector.size();
+    const float dist   = distance(&m_centroids[list * m_dimension], vector.data(), m_dimension);
+
+    m_listOfVector.push_back(list);
+    m_lists[list].push_back(position);
+    m_radii[list]      = qMax(m_radii[list], dist);
+}
+
+int DNNFaceIndex::nearestList(const float* const vector) const
+{
+    const int numberOfLists = (int)m_lists.size();
+    int   nearest           = 0;
+    float minDist           = distance(&m_centroids[0], vector, m_dimension);
+
+    for (int list = 1 ; list < numberOfLists ; ++list)
+    {
+        const float dist = distance(&m_centroids[list * m_dimension], vector, m_dimension);
+
+        if (dist < minDist)
+        {
+            minDist = dist;
+            nearest = list;
+        }
+    }
+
+    return nearest;
+}
+
+void DNNFaceIndex::build(const std::vector<std::vector<float> >& vectors)
+{
+    clear();
+
+    const int count = (int)vectors.size();
+
+    if (count < MinimumCount)
+    {
+        return;
+    }
+
+    m_dimension             = (int)vectors[0].size();
+    const int numberOfLists = qBound(16, (int)std::sqrt((double)count), 1024);
+
+    // The centroids are computed from an evenly distributed sample
+
+    std::vector<int> sample;
+    const int step          = qMax(1, count / (numberOfLists * s_samplesPerList));
+
+    for (int i = 0 ; i < count ; i += step)
+    {
+        sample.push_back(i);
+    }
+
+    m_centroids.resize(numberOfLists * m_dimension);
+    m_lists.resize(numberOfLists);
+
+    for (int list = 0 ; list < numberOfLists ; ++list)
+    {
+        const std::vector<float>& v = vectors[sample[(size_t)list * sample.size() / numberOfLists]];
+        std::copy(v.begin(), v.end(), m_centroids.begin() + list * m_dimension);
+    }
+
+    std::vector<double> sums(numberOfLists * m_dimension);
+    std::vector<int>    members(numberOfLists);
+
+    for (int iteration = 0 ; iteration < s_iterations ; ++iteration)
+    {
+        std::fill(sums.begin(), sums.end(), 0.0);
+        std::fill(members.begin(), members.end(), 0);
+
+        for (size_t i = 0 ; i < sample.size() ; ++i)
+        {
+            const std::vector<float>& v = vectors[sample[i]];
+            const int list              = nearestList(v.data());
+            double* const sum           = &sums[list * m_dimension];
+
+            for (int j = 0 ; j < m_dimension ; ++j)
+            {
+                sum[j] += v[j];
+            }
+
+            ++members[list];
+        }
+
+        for (int list = 0 ; list < numberOfLists ; ++list)
+        {
+            // An empty list keeps its centroid
+
+            if (!members[list])
+            {
+                continue;
+            }
+
+            for (int j = 0 ; j < m_dimension ; ++j)
+            {
+                m_centroids[list * m_dimension + j] = (float)(sums[list * m_dimension + j] / members[list]);
+            }
+        }
+    }
+
+    setupLists(numberOfLists);
+
+    for (int i = 0 ; i < count ; ++i)
+    {
+        addToList(nearestList(vectors[i].data()), vectors[i]);
+    }
+
+    m_builtCount = count;
+}
+
+void DNNFaceIndex::add(const std::vector<float>& vector)
+{
+    if (!isValid())
+    {
+        return;
+    }
+
+    addToList(nearestList(vector.data()), vector);
+}
+
+int DNNFaceIndex::nearest(const std::vector<std::vector<float> >& vectors,
+                          const std::vector<float>& query,
+                          double maxDistance,
+                          double* const distance,
+                          int maxProbes) const
+{
+    const int numberOfLists = (int)m_lists.size();
+    std::vector<std::pair<float, int> > order(numberOfLists);
+
+    for (int list = 0 ; list < numberOfLists ; ++list)
+    {
+        order[list] = std::make_pair(DNNFaceIndex::distance(&m_centroids[list * m_dimension],
+                                                            query.data(), m_dimension),
+                                     list);
+    }
+
+    std::sort(order.begin(), order.end());
+
+    const int probes = (maxProbes > 0) ? qMin(maxProbes, numberOfLists) : numberOfLists;
+    double minDist   = maxDistance;
+    int    nearest   = -1;
+
+    for (int i = 0 ; i < probes ; ++i)
+    {
+        const int list = order[i].second;
+
+        // No vector of this list is nearer than centroid distance minus radius
+
+        if (order[i].first - m_radii[list] >= minDist)
+        {
+            continue;
+        }
+
+        const std::vector<int>& positions = m_lists[list];
+
+        for (size_t j = 0 ; j < positions.size() ; ++j)
+        {
+            const int position = positions[j];
+            const double dist  = DNNFaceIndex::distance(vectors[position].data(), query.data(), m_dimension);
+
+            if (dist < minDist)
+            {
+                minDist = dist;
+                nearest = position;
+            }
+        }
+    }
+
+    if (distance)
+    {
+        *distance = (nearest == -1) ? maxDistance : minDist;
+    }
+
+    return nearest;
+}
+
+QByteArray DNNFaceIndex::toByteArray(const QList<int>& databaseIds) const
+{
+    QByteArray data;
+
+    if (!isValid() || databaseIds.size() != count())
+    {
+        return data;
+    }
+
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    stream << s_formatVersion;
+    stream << (qint32)m_dimension;
+    stream << (qint32)m_lists.size();
+    stream << (qint32)m_builtCount;
+
+    for (size_t i = 0 ; i < m_centroids.size() ; ++i)
+    {
+        stream << m_centroids[i];
+    }
+
+    stream << (qint32)databaseIds.size();
+
+    for (int i = 0 ; i < databaseIds.size() ; ++i)
+    {
+        stream << (qint32)databaseIds.at(i);
+        stream << (qint32)m_listOfVector[i];
+    }
+
+    return data;
+}
+
+bool DNNFaceIndex::fromByteArray(const QByteArray& data,
+                                 const QList<int>& databaseIds,
+                                 const std::vector<std::vector<float> >& vectors)
+{
+    clear();
+
+    if (data.isEmpty() || vectors.empty() || databaseIds.size() != (int)vectors.size())
+    {
+        return false;
+    }
+
+    QDataStream stream(data);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    quint32 version;
+    qint32  dimension, numberOfLists, builtCount, storedCount;
+
+    stream >> version;
+    stream >> dimension;
+    stream >> numberOfLists;
+    stream >> builtCount;
+
+    if (stream.status() != QDataStream::Ok    ||
+        version         != s_formatVersion    ||
+        dimension       != (int)vectors[0].size() ||
+        numberOfLists   <= 0                  ||
+        numberOfLists   >  1024               ||
+        builtCount      <= 0)
+    {
+        return false;
+    }
+
+    // Too many vectors were added since the centroids were computed
+
+    if ((int)vectors.size() > 4 * builtCount)
+    {
+        return false;
+    }
+
+    m_dimension = dimension;
+    m_centroids.resize(numberOfLists * m_dimension);
+
+    for (size_t i = 0 ; i < m_centroids.size() ; ++i)
+    {
+        stream >> m_centroids[i];
+    }
+
+    stream >> storedCount;
+
+    if (stream.status() != QDataStream::Ok || storedCount < 0)
+    {
+        clear();
+        return false;
+    }
+
+    QHash<int, int> listOfId;
+    listOfId.reserve(storedCount);
+
+    for (int i = 0 ; i < storedCount ; ++i)
+    {
+        qint32 id, list;
+        stream >> id;
+        stream >> list;
+
+        if (list < 0 || list >= numberOfLists)
+        {
+            clear();
+            return false;
+        }
+
+        listOfId.insert(id, list);
+    }
+
+    if (stream.status() != QDataStream::Ok)
+    {
+        clear();
+        return false;
+    }
+
+    setupLists(numberOfLists);
+
+    int restored = 0;
+
+    for (size_t i = 0 ; i < vectors.size() ; ++i)
+    {
+        QHash<int, int>::const_iterator it = listOfId.constFind(databaseIds.at((int)i));
+
+        if (it != listOfId.constEnd())
+        {
+            addToList(it.value(), vectors[i]);
+            ++restored;
+        }
+        else
+        {
+            addToList(nearestList(vectors[i].data()), vectors[i]);
+        }
+    }
+
+    // Most vectors were removed, the centroids do not fit the data any more
+
+    if (2 * restored < (int)vectors.size())
+    {
+        clear();
+        return false;
+    }
+
+    m_builtCount = builtCount;
+
+    return true;
+}
+
+} // namespace Digikam
@@ -0,0 +1,148 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam
+ *
+ * Date        : 2018-11-10
+ * Description : Inverted file index of DNN face vectors
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_DNN_FACE_INDEX_H
+#define DIGIKAM_DNN_FACE_INDEX_H
+
+// C++ includes
+
+#include <vector>
+
+// Qt includes
+
+#include <QByteArray>
+#include <QList>
+
+namespace Digikam
+{
+
+/**
+ * This class partitions the face vectors of a DNNFaceRecognizer in lists around
+ * centroids computed with k-means. A query visits the lists by increasing
+ * distance of their centroid, and skips every list whose radius proves by the
+ * triangle inequality that it cannot contain a vector closer than the best one
+ * found so far. Without a limit on the number of visited lists, the result is
+ * the same as a linear scan. In 128 dimensions, the radii rarely exclude a list:
+ * queries are only fast when the number of visited lists is limited, which
+ * gives an approximate result.
+ *
+ * The index refers to the vectors by their position in the recognizer and does
+ * not keep a copy of them. Vectors can only be appended.
+ */
+class DNNFaceIndex
+{
+public:
+
+    enum
+    {
+        /// Below this number of vectors, a linear scan is as fast as the index
+        MinimumCount  = 2000,
+
+        /// Number of lists visited by DNNFaceRecognizer::predict()
+        DefaultProbes = 16
+    };
+
+public:
+
+    explicit DNNFaceIndex();
+    ~DNNFaceIndex();
+
+    void clear();
+
+    /**
+     * Returns true if the lists are built. The index must contain all vectors
+     * of the recognizer to be used for queries.
+     */
+    bool isValid() const;
+
+    /**
+     * Returns the number of indexed vectors.
+     */
+    int  count()   const;
+
+    /**
+     * Computes the centroids from the given vectors and adds all vectors.
+     * Does nothing if there are less than MinimumCount vectors.
+     */
+    void build(const std::vector<std::vector<float> >& vectors);
+
+    /**
+     * Adds the vector at the next position to the nearest list.
+     */
+    void add(const std::vector<float>& vector);
+
+    /**
+     * Returns the position of the vector nearest to query with a distance
+     * below maxDistance, or -1. The distance is returned in distance.
+     * If maxProbes is positive, at most this number of lists is visited.
+     */
+    int  nearest(const std::vector<std::vector<float> >& vectors,
+                 const std::vector<float>& query,
+                 double maxDistance,
+                 double* const distance,
+                 int maxProbes = 0) const;
+
+    /**
+     * Serializes the centroids and the list of each vector, identified
+     * by the database ids given in the order of the vector positions.
+     */
+    QByteArray toByteArray(const QList<int>& databaseIds) const;
+
+    /**
+     * Restores the centroids from data and adds all vectors. Vectors which
+     * were not stored are added to their nearest list. Returns false if the
+     * data is invalid or the index should be built again, because a large
+     * part of the vectors is new.
+     */
+    bool fromByteArray(const QByteArray& data,
+                       const QList<int>& databaseIds,
+                       const std::vector<std::vector<float> >& vectors);
+
+    /**
+     * Returns the euclidean distance of the two vectors.
+     */
+    static float distance(const float* const a, const float* const b, int dimension);
+
+private:
+
+    void setupLists(int numberOfLists);
+    void addToList(int list, const std::vector<float>& vector);
+    int  nearestList(const float* const vector) const;
+
+private:
+
+    int                            m_dimension;
+    int                            m_builtCount;
+
+    /// Centroids of all lists, m_dimension values each
+    std::vector<float>             m_centroids;
+
+    /// The largest distance of a vector of each list to its centroid
+    std::vector<float>             m_radii;
+
+    std::vector<std::vector<int> > m_lists;
+    std::vector<int>               m_listOfVector;
+};
+
+} // namespace Digikam
+
+#endif // DIGIKAM_DNN_FACE_INDEX_H
@@ -160,14 +160,10 @@ void DNNFaceModel::update(const std::vector<cv::Mat>& images, const std::vector<
 {
     std::vector<std::vector<float> > src;
 
-    foreach (const cv::Mat& mat, images)
-    {
-        std::vector<float> vecdata;
-        FaceDbAccess().db()->getFaceVector(mat, vecdata);
-        qCDebug(DIGIKAM_FACEDB_LOG) << "vecdata: " << vecdata[vecdata.size()-2]
-                                                   << vecdata[vecdata.size()-1];
-        src.push_back(vecdata);
-    }
+    // All training faces go through the network in batches
+
+    FaceDb().getFaceVectors(images, src);
+    qCDebug(DIGIKAM_FACEDB_LOG) << "Computed" << src.size() << "face vectors";
 
     ptr()->update(src, labels);
 
@@ -83,6 +83,7 @@ void DNNFaceRecognizer::train(std::vector<std::vector<float> > _in_src, InputArr
     {
         m_labels.release();
         m_src.clear();
+        m_index.clear();
     }
 
     // append labels to m_labels matrix
@@ -90,6 +91,9 @@ void DNNFaceRecognizer::train(std::vector<std::vector<float> > _in_src, InputArr
     {
         m_labels.push_back(labels.at<int>((int)labelIdx));
         m_src.push_back(src[(int)labelIdx]);
+
+        // the index refers to the vectors by position, new ones are appended
+        m_index.add(m_src.back());
     }
 
     return ;
@@ -189,29 +193,42 @@ void DNNFaceRecognizer::getFaceVector(cv::Mat data, std::vector<float>& vecdata)
 */
 void DNNFaceRecognizer::predict(cv::InputArray _src, int& minClass, double& minDist) const
 {
-    qCWarning(DIGIKAM_FACESENGINE_LOG) << "Predicting face image";
-
-    cv::Mat src              = _src.getMat();//254*254
+    cv::Mat src = _src.getMat();
     std::vector<float> vecdata;
-    FaceDb* const tmp_facedb = new FaceDb();
-    tmp_facedb->getFaceVector(src, vecdata);
-    qCWarning(DIGIKAM_FACESENGINE_LOG) << "vecdata: " << vecdata[vecdata.size()-2] << " " << vecdata[vecdata.size()-1];
+    FaceDb().getFaceVector(src, vecdata);
+
+    predictVector(vecdata, minClass, minDist);
+}
 
+void DNNFaceRecognizer::predictVector(const std::vector<float>& vecdata, int& minClass, double& minDist) const
+{
     minDist  = DBL_MAX;
     minClass = -1;
 
+    if (vecdata.empty())
+    {
+        return;
+    }
+
     // find nearest neighbor
 
-    for (size_t sampleIdx = 0 ; sampleIdx < m_src.size() ; ++sampleIdx)
+    if (m_index.isValid() && m_index.count() == (int)m_src.size())
     {
-        double dist = 0;
+        double dist;
+        int sampleIdx = m_index.nearest(m_src, vecdata, m_threshold, &dist, DNNFaceIndex::DefaultProbes);
 
-        for (size_t i = 0 ; i < m_src[sampleIdx].size() ; ++i)
+        if (sampleIdx != -1)
         {
-            dist += (vecdata[i]-m_src[sampleIdx][i])*(vecdata[i]-m_src[sampleIdx][i]);
+            minDist  = dist;
+            minClass = m_labels.at<int>(sampleIdx);
         }
 
-        dist = std::sqrt(dist);
+        return;
+    }
+
+    for (size_t sampleIdx = 0 ; sampleIdx < m_src.size() ; ++sampleIdx)
+    {
+        double dist = DNNFaceIndex::distance(vecdata.data(), m_src[sampleIdx].data(), (int)m_src[sampleIdx].size());
 
         if ((dist < minDist) && (dist < m_threshold))
         {
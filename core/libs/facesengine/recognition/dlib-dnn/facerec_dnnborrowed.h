@@ -29,6 +29,7 @@
 #include "digikam_opencv.h"
 #include "facedb.h"
 #include "face.hpp"
+#include "dnnfaceindex.h"
 
 // C++ includes
 
@@ -86,18 +87,30 @@ public:
      */
     void predict(cv::InputArray _src, int& label, double& dist) const;
 
+    /**
+     * Predicts the label and confidence for a face vector computed before,
+     * see FaceDb::getFaceVectors(). This is a search in the vectors only.
+     */
+    void predictVector(const std::vector<float>& vecdata, int& label, double& dist) const;
+
     /**
      * Getter and setter functions.
      */
     double getThreshold() const                             { return m_threshold;                  }
     void   setThreshold(double _threshold)                  { m_threshold = _threshold;            }
 
-    std::vector<std::vector<float> > getSrc() const         { return m_src;                        }
-    void setSrc(std::vector<std::vector<float> > _src)      { m_src = _src;                        }
+    const std::vector<std::vector<float> >& getSrc() const  { return m_src;                        }
+    void setSrc(std::vector<std::vector<float> > _src)      { m_src = _src; m_index.clear();       }
 
     cv::Mat getLabels() const                               { return m_labels;                     }
     void setLabels(cv::Mat _labels)                         { m_labels = _labels;                  }
 
+    /**
+     * The index used by predict() when it contains all face vectors.
+     * It is built or restored by the owner of the face vectors.
+     */
+    DNNFaceIndex& index()                                   { return m_index;                      }
+
 private:
 
     /**
@@ -114,6 +127,7 @@ private:
 
     std::vector<std::vector<float> > m_src;
     cv::Mat                          m_labels;
+    DNNFaceIndex                     m_index;
 };
 
 } // namespace Digikam
@@ -23,6 +23,11 @@
 
 #include "opencvdnnfacerecognizer.h"
 
+// Qt includes
+
+#include <QMutex>
+#include <QMutexLocker>
+
 // Local includes
 
 #include "digikam_opencv.h"
@@ -48,6 +53,9 @@ public:
 
     DNNFaceModel& dnn()
     {
+        // The model is loaded once, recognition can run in several threads
+        QMutexLocker lock(&mutex);
+
         if (!loaded)
         {
             m_dnn  = FaceDbAccess().db()->dnnFaceModel();
@@ -65,6 +73,7 @@ private:
 
     DNNFaceModel m_dnn;
     bool         loaded;
+    QMutex       mutex;
 };
 
 OpenCVDNNFaceRecognizer::OpenCVDNNFaceRecognizer()
@@ -114,7 +123,8 @@ cv::Mat OpenCVDNNFaceRecognizer::prepareForRecognition(const QImage& inputImage)
             break;
         default:
             image          = image.convertToFormat(QImage::Format_RGB888);
-            cvImage        = cv::Mat(image.height(), image.width(), CV_8UC3, image.scanLine(0), image.bytesPerLine());
+            // Deep copy, the returned matrix must not share the data of the local image
+            cvImage        = cv::Mat(image.height(), image.width(), CV_8UC3, image.scanLine(0), image.bytesPerLine()).clone();
             //cvtColor(cvImageWrapper, cvImage, CV_RGB2GRAY);
             break;
     }
@@ -139,6 +149,80 @@ int OpenCVDNNFaceRecognizer::recognize(const cv::Mat& inputImage)
     return predictedLabel;
 }
 
+QList<int> OpenCVDNNFaceRecognizer::recognize(const std::vector<cv::Mat>& inputImages, const QStringList& keys)
+{
+    QList<int> results;
+
+    if (inputImages.empty())
+    {
+        return results;
+    }
+
+    const bool useCache = (keys.size() == (int)inputImages.size());
+    QMap<QString, std::vector<float> > cached;
+
+    if (useCache)
+    {
+        cached = FaceDbAccess().db()->faceEmbeddings(keys);
+    }
+
+    // Only the faces which are not in the cache go through the network
+
+    std::vector<cv::Mat>             missingImages;
+    std::vector<size_t>              missingIndexes;
+    std::vector<std::vector<float> > vectors(inputImages.size());
+
+    for (size_t i = 0 ; i < inputImages.size() ; ++i)
+    {
+        if (useCache && cached.contains(keys[i]))
+        {
+            vectors[i] = cached.value(keys[i]);
+        }
+        else
+        {
+            missingImages.push_back(inputImages[i]);
+            missingIndexes.push_back(i);
+        }
+    }
+
+    qCDebug(DIGIKAM_FACESENGINE_LOG) << "DNN recognition of" << inputImages.size() << "faces,"
+                                     << missingImages.size() << "face vectors to compute";
+
+    if (!missingImages.empty())
+    {
+        std::vector<std::vector<float> > computed;
+        FaceDb().getFaceVectors(missingImages, computed);
+
+        QMap<QString, std::vector<float> > newEmbeddings;
+
+        for (size_t i = 0 ; i < computed.size() ; ++i)
+        {
+            vectors[missingIndexes[i]] = computed[i];
+
+            if (useCache)
+            {
+                newEmbeddings.insert(keys[(int)missingIndexes[i]], computed[i]);
+            }
+        }
+
+        if (!newEmbeddings.isEmpty())
+        {
+            FaceDbAccess().db()->storeFaceEmbeddings(newEmbeddings);
+        }
+    }
+
+    for (size_t i = 0 ; i < vectors.size() ; ++i)
+    {
+        int predictedLabel = -1;
+        double confidence  = 0;
+        d->dnn()->predictVector(vectors[i], predictedLabel, confidence);
+
+        results << ((confidence > d->threshold) ? -1 : predictedLabel);
+    }
+
+    return results;
+}
+
 void OpenCVDNNFaceRecognizer::train(const std::vector<cv::Mat>& images,
                                     const std::vector<int>& labels,
                                     const QString& context,
@@ -31,6 +31,8 @@
 // Qt include
 
 #include <QImage>
+#include <QList>
+#include <QStringList>
 
 namespace Digikam
 {
@@ -60,6 +62,15 @@ public:
      */
     int recognize(const cv::Mat& inputImage);
 
+    /**
+     *  Try to recognize the given images at once, see recognize().
+     *  The face vectors are computed in batches. If keys is not empty, it gives
+     *  a unique key per image, and the face vectors are cached in the database
+     *  under these keys, so that recognizing the same faces again only
+     *  searches the known vectors. Returns one identity id per image.
+     */
+    QList<int> recognize(const std::vector<cv::Mat>& inputImages, const QStringList& keys = QStringList());
+
     /**
      *  Trains the given images, representing faces of the given matched identities.
      */
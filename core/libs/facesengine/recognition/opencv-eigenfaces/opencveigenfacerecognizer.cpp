@@ -27,7 +27,12 @@
 
 #include "opencveigenfacerecognizer.h"
 
-// local includes
+// Qt includes
+
+#include <QMutex>
+#include <QMutexLocker>
+
+// Local includes
 
 #include "digikam_opencv.h"
 #include "facedbaccess.h"
@@ -52,6 +57,9 @@ public:
 
     EigenFaceModel& eigen()
     {
+        // The model is loaded once, recognition can run in several threads
+        QMutexLocker lock(&mutex);
+
         if (!loaded)
         {
             m_eigen = FaceDbAccess().db()->eigenFaceModel();
@@ -69,6 +77,7 @@ private:
 
     EigenFaceModel    m_eigen;
     bool              loaded;
+    QMutex            mutex;
 };
 
 OpenCVEIGENFaceRecognizer::OpenCVEIGENFaceRecognizer()
@@ -27,7 +27,12 @@
 
 #include "opencvfisherfacerecognizer.h"
 
-// local includes
+// Qt includes
+
+#include <QMutex>
+#include <QMutexLocker>
+
+// Local includes
 
 #include "digikam_opencv.h"
 #include "facedbaccess.h"
@@ -52,6 +57,9 @@ public:
 
     FisherFaceModel& fisher()
     {
+        // The model is loaded once, recognition can run in several threads
+        QMutexLocker lock(&mutex);
+
         if (!loaded)
         {
             m_fisher = FaceDbAccess().db()->fisherFaceModel();
@@ -69,6 +77,7 @@ private:
 
     FisherFaceModel   m_fisher;
     bool              loaded;
+    QMutex            mutex;
 };
 
 OpenCVFISHERFaceRecognizer::OpenCVFISHERFaceRecognizer()
@@ -23,7 +23,12 @@
 
 #include "opencvlbphfacerecognizer.h"
 
-// local includes
+// Qt includes
+
+#include <QMutex>
+#include <QMutexLocker>
+
+// Local includes
 
 #include "digikam_opencv.h"
 #include "facedbaccess.h"
@@ -48,6 +53,9 @@ public:
 
     LBPHFaceModel& lbph()
     {
+        // The model is loaded once, recognition can run in several threads
+        QMutexLocker lock(&mutex);
+
         if (!loaded)
         {
             m_lbph = FaceDbAccess().db()->lbphFaceModel();
@@ -65,6 +73,7 @@ private:
 
     LBPHFaceModel     m_lbph;
     bool              loaded;
+    QMutex            mutex;
 };
 
 OpenCVLBPHFaceRecognizer::OpenCVLBPHFaceRecognizer()
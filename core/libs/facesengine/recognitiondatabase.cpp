@@ -33,6 +33,10 @@
 
 #include <QMutex>
 #include <QMutexLocker>
+#include <QReadLocker>
+#include <QReadWriteLock>
+#include <QWriteLocker>
+#include <QSharedPointer>
 #include <QUuid>
 #include <QDir>
 #include <QStandardPaths>
@@ -53,12 +57,26 @@
 namespace Digikam
 {
 
-class Q_DECL_HIDDEN RecognitionDatabase::Private
+/**
+ * The recognizers used for recognition are read-only snapshots of the models
+ * stored in the database. recognizeFaces() only takes the mutex to get the
+ * current snapshot, then runs without any lock, so that it can be called from
+ * several threads at the same time.
+ * Training works on separate instances, serialized by trainingMutex. Once the
+ * new training data are written, the snapshot is dropped and the next
+ * recognition loads the new models.
+ */
+class Q_DECL_HIDDEN RecognitionDatabase::Private : public QSharedData
 {
 public:
 
     bool                                    dbAvailable;
+
+    /// Protects the snapshots, the parameters and the algorithm
     QMutex                                  mutex;
+    QMutex                                  trainingMutex;
+    mutable QReadWriteLock                  identityLock;
+
     QVariantMap                             parameters;
     QHash<int, Identity>                    identityCache;
     RecognitionDatabase::RecognizeAlgorithm recognizeAlgorithm;
@@ -70,39 +88,76 @@ public:
 
 public:
 
+    /**
+     * Returns the current snapshot of a recognizer, created if needed.
+     */
     template <class T>
-    T* getObjectOrCreate(T* &ptr) const
+    QSharedPointer<T> snapshot(QSharedPointer<T>& ptr)
     {
+        QMutexLocker lock(&mutex);
+
         if (!ptr)
         {
             qCDebug(DIGIKAM_FACESENGINE_LOG) << "create recognizer";
-            ptr = new T();
+            ptr = QSharedPointer<T>(new T());
+            applyParameters(ptr.data());
         }
 
         return ptr;
     }
 
-public:
-
-    OpenCVLBPHFaceRecognizer*   lbph()               { return getObjectOrCreate(opencvlbph);   }
-    OpenCVLBPHFaceRecognizer*   lbphConst() const    { return opencvlbph;                      }
+    /**
+     * Returns the recognizer used for training, created if needed.
+     * Called with trainingMutex locked.
+     */
+    template <class T>
+    T* trainer(T* &ptr)
+    {
+        if (!ptr)
+        {
+            qCDebug(DIGIKAM_FACESENGINE_LOG) << "create recognizer for training";
+            ptr = new T();
 
-    OpenCVEIGENFaceRecognizer*  eigen()              { return getObjectOrCreate(opencveigen);  }
-    OpenCVEIGENFaceRecognizer*  eigenConst() const   { return opencveigen;                     }
+            QMutexLocker lock(&mutex);
+            applyParameters(ptr);
+        }
 
-    OpenCVFISHERFaceRecognizer* fisher()             { return getObjectOrCreate(opencvfisher); }
-    OpenCVFISHERFaceRecognizer* fisherConst() const  { return opencvfisher;                    }
+        return ptr;
+    }
 
-    OpenCVDNNFaceRecognizer*    dnn()                { return getObjectOrCreate(opencvdnn);    }
-    OpenCVDNNFaceRecognizer*    dnnConst() const     { return opencvdnn;                       }
+    /**
+     * Drops the snapshot after training. Readers still using it keep a valid object.
+     */
+    template <class T>
+    void dropSnapshot(QSharedPointer<T>& ptr)
+    {
+        QMutexLocker lock(&mutex);
+        ptr.clear();
+    }
 
-    FunnelReal*                 aligner()            { return getObjectOrCreate(funnel);       }
-    FunnelReal*                 alignerConst() const { return funnel;                          }
+    RecognitionDatabase::RecognizeAlgorithm algorithm()
+    {
+        QMutexLocker lock(&mutex);
+        return recognizeAlgorithm;
+    }
 
 public:
 
+    /// Called with mutex locked
     void applyParameters();
 
+    template <class T>
+    void applyParameters(T* const r)
+    {
+        for (QVariantMap::const_iterator it = parameters.constBegin() ; it != parameters.constEnd() ; ++it)
+        {
+            if (it.key() == QLatin1String("threshold") || it.key() == QLatin1String("accuracy"))
+            {
+                r->setThreshold(it.value().toFloat());
+            }
+        }
+    }
+
     void train(OpenCVLBPHFaceRecognizer* const r, const QList<Identity>& identitiesToBeTrained,
                TrainingDataProvider* const data, const QString& trainingContext);
     void train(OpenCVEIGENFaceRecognizer* const r, const QList<Identity>& identitiesToBeTrained,
@@ -110,13 +165,36 @@ public:
     void train(OpenCVDNNFaceRecognizer* const r, const QList<Identity>& identitiesToBeTrained,
                TrainingDataProvider* const data, const QString& trainingContext);
 
-    void clear(OpenCVLBPHFaceRecognizer* const, const QList<int>& idsToClear, const QString& trainingContext);
-    void clear(OpenCVEIGENFaceRecognizer* const, const QList<int>& idsToClear, const QString& trainingContext);
-    void clear(OpenCVFISHERFaceRecognizer* const, const QList<int>& idsToClear, const QString& trainingContext);
-    void clear(OpenCVDNNFaceRecognizer* const, const QList<int>& idsToClear, const QString& trainingContext);
+    /// Called with trainingMutex locked
+    void clearLBPH(const QList<int>& idsToClear, const QString& trainingContext);
+    void clearEIGEN(const QList<int>& idsToClear, const QString& trainingContext);
+    void clearFISHER();
+    void clearDNN();
 
-    cv::Mat preprocessingChain(const QImage& image);
-    cv::Mat preprocessingChainRGB(const QImage& image);
+    template <class T>
+    cv::Mat preprocessingChain(T* const r, const QImage& image)
+    {
+        try
+        {
+            cv::Mat cvImage = r->prepareForRecognition(image);
+/*
+            cvImage         = aligner()->align(cvImage);
+            TanTriggsPreprocessor preprocessor;
+            cvImage         = preprocessor.preprocess(cvImage);
+*/
+            return cvImage;
+        }
+        catch (cv::Exception& e)
+        {
+            qCCritical(DIGIKAM_FACESENGINE_LOG) << "cv::Exception:" << e.what();
+            return cv::Mat();
+        }
+        catch (...)
+        {
+            qCCritical(DIGIKAM_FACESENGINE_LOG) << "Default exception from OpenCV";
+            return cv::Mat();
+        }
+    }
 
 public:
 
@@ -124,14 +202,18 @@ public:
     Identity findByAttribute(const QString& attribute, const QString& value) const;
     Identity findByAttributes(const QString& attribute, const QMap<QString, QString>& valueMap) const;
 
-private:
+public:
 
-    OpenCVFISHERFaceRecognizer* opencvfisher;
-    OpenCVEIGENFaceRecognizer*  opencveigen;
-    OpenCVLBPHFaceRecognizer*   opencvlbph;
-    OpenCVDNNFaceRecognizer*    opencvdnn;
+    /// Snapshots used for recognition
+    QSharedPointer<OpenCVFISHERFaceRecognizer> opencvfisher;
+    QSharedPointer<OpenCVEIGENFaceRecognizer>  opencveigen;
+    QSharedPointer<OpenCVLBPHFaceRecognizer>   opencvlbph;
+    QSharedPointer<OpenCVDNNFaceRecognizer>    opencvdnn;
 
-    FunnelReal*                 funnel;
+    /// Instances used for training
+    OpenCVEIGENFaceRecognizer*                 eigenTrainer;
+    OpenCVLBPHFaceRecognizer*                  lbphTrainer;
+    OpenCVDNNFaceRecognizer*                   dnnTrainer;
 };
 
 // ----------------------------------------------------------------------------------------------
@@ -150,7 +232,7 @@ static void trainSingle(Recognizer* const r, const Identity& identity, TrainingD
     {
         try
         {
-            r->train(identity.id(), d->preprocessingChain(images->image()), trainingContext);
+            r->train(identity.id(), d->preprocessingChain(r, images->image()), trainingContext);
         }
         catch (cv::Exception& e)
         {
@@ -185,8 +267,7 @@ static void trainIdentityBatchLBPH(OpenCVLBPHFaceRecognizer* const r,
         {
             try
             {
-                cv::Mat cvImage     = d->preprocessingChain(imageList->image());
-                cv::Mat cvImage_rgb = d->preprocessingChainRGB(imageList->image());
+                cv::Mat cvImage = d->preprocessingChain(r, imageList->image());
 
                 labels.push_back(identity.id());
                 images.push_back(cvImage);
@@ -237,8 +318,8 @@ static void trainIdentityBatchEIGEN(OpenCVEIGENFaceRecognizer* const r,
         {
             try
             {
-                cv::Mat cvImage     = d->preprocessingChain(imageList->image());
-                cv::Mat cvImage_rgb = d->preprocessingChainRGB(imageList->image());
+                cv::Mat cvImage     = d->preprocessingChain(r, imageList->image());
+                cv::Mat cvImage_rgb = cvImage;
 
                 labels.push_back(identity.id());
                 images.push_back(cvImage);
@@ -290,8 +371,8 @@ static void trainIdentityBatchDNN(OpenCVDNNFaceRecognizer* const r,
         {
             try
             {
-                cv::Mat cvImage     = d->preprocessingChain(imageList->image());
-                cv::Mat cvImage_rgb = d->preprocessingChainRGB(imageList->image());
+                cv::Mat cvImage     = d->preprocessingChain(r, imageList->image());
+                cv::Mat cvImage_rgb = cvImage;
 
                 labels.push_back(identity.id());
                 images.push_back(cvImage);
@@ -324,15 +405,44 @@ static void trainIdentityBatchDNN(OpenCVDNNFaceRecognizer* const r,
     }
 }
 
+/** Recognition where the recognize method takes one image.
+ *  r is a snapshot, it is not modified.
+ */
+template <class Recognizer>
+static QList<int> recognizeEach(Recognizer* const r, ImageListProvider* const images,
+                                RecognitionDatabase::Private* const d)
+{
+    QList<int> ids;
+
+    for (; !images->atEnd(); images->proceed())
+    {
+        int id = -1;
+
+        try
+        {
+            id = r->recognize(d->preprocessingChain(r, images->image()));
+        }
+        catch (cv::Exception& e)
+        {
+            qCCritical(DIGIKAM_FACESENGINE_LOG) << "cv::Exception:" << e.what();
+        }
+        catch (...)
+        {
+            qCCritical(DIGIKAM_FACESENGINE_LOG) << "Default exception from OpenCV";
+        }
+
+        ids << id;
+    }
+
+    return ids;
+}
+
 // ----------------------------------------------------------------------------------------------
 
 RecognitionDatabase::Private::Private()
-    : mutex(QMutex::Recursive),
-      opencvfisher(0),
-      opencveigen(0),
-      opencvlbph(0),
-      opencvdnn(0),
-      funnel(0)
+    : eigenTrainer(0),
+      lbphTrainer(0),
+      dnnTrainer(0)
 {
     DbEngineParameters params = CoreDbAccess::parameters().faceParameters();
     params.setFaceDatabasePath(CoreDbAccess::parameters().faceParameters().getFaceDatabaseNameOrDir());
@@ -357,11 +467,9 @@ RecognitionDatabase::Private::Private()
 
 RecognitionDatabase::Private::~Private()
 {
-    delete opencvfisher;
-    delete opencveigen;
-    delete opencvlbph;
-    delete opencvdnn;
-    delete funnel;
+    delete eigenTrainer;
+    delete lbphTrainer;
+    delete dnnTrainer;
 }
 
 // NOTE: Takes care that there may be multiple values of attribute in identity's attributes
@@ -415,124 +523,28 @@ Identity RecognitionDatabase::Private::findByAttributes(const QString& attribute
 
 void RecognitionDatabase::Private::applyParameters()
 {
-    if (lbphConst() || eigenConst() || fisherConst() || dnnConst())
+    if (recognizeAlgorithm == RecognitionDatabase::RecognizeAlgorithm::LBP)
     {
-        for (QVariantMap::const_iterator it = parameters.constBegin() ; it != parameters.constEnd() ; ++it)
-        {
-            if (it.key() == QLatin1String("threshold") || it.key() == QLatin1String("accuracy"))
-            {
-                if (recognizeAlgorithm == RecognitionDatabase::RecognizeAlgorithm::LBP)
-                {
-                    lbph()->setThreshold(it.value().toFloat());
-                }
-                else if (recognizeAlgorithm == RecognitionDatabase::RecognizeAlgorithm::EigenFace)
-                {
-                    eigen()->setThreshold(it.value().toFloat());
-                }
-                else if (recognizeAlgorithm == RecognitionDatabase::RecognizeAlgorithm::FisherFace)
-                {
-                    fisher()->setThreshold(it.value().toFloat());
-                }
-                else if (recognizeAlgorithm == RecognitionDatabase::RecognizeAlgorithm::DNN)
-                {
-                    dnn()->setThreshold(it.value().toFloat());
-                }
-                else
-                {
-                    qCCritical(DIGIKAM_FACESENGINE_LOG) << "No obvious recognize algorithm";
-                }
-            }
-        }
+        if (opencvlbph)  applyParameters(opencvlbph.data());
+        if (lbphTrainer) applyParameters(lbphTrainer);
     }
-}
-
-cv::Mat RecognitionDatabase::Private::preprocessingChain(const QImage& image)
-{
-    try
+    else if (recognizeAlgorithm == RecognitionDatabase::RecognizeAlgorithm::EigenFace)
     {
-        cv::Mat cvImage;
-
-        if (recognizeAlgorithm == RecognizeAlgorithm::LBP)
-        {
-            cvImage = lbph()->prepareForRecognition(image);
-        }
-        else if (recognizeAlgorithm == RecognizeAlgorithm::EigenFace)
-        {
-            cvImage = eigen()->prepareForRecognition(image);
-        }
-        else if (recognizeAlgorithm == RecognizeAlgorithm::FisherFace)
-        {
-            cvImage = fisher()->prepareForRecognition(image);
-        }
-        else if (recognizeAlgorithm == RecognizeAlgorithm::DNN)
-        {
-            cvImage = dnn()->prepareForRecognition(image);
-        }
-        else
-        {
-            qCCritical(DIGIKAM_FACESENGINE_LOG) << "No obvious recognize algorithm";
-        }
-/*
-        cvImage         = aligner()->align(cvImage);
-        TanTriggsPreprocessor preprocessor;
-        cvImage         = preprocessor.preprocess(cvImage);
-*/
-        return cvImage;
+        if (opencveigen)  applyParameters(opencveigen.data());
+        if (eigenTrainer) applyParameters(eigenTrainer);
     }
-    catch (cv::Exception& e)
+    else if (recognizeAlgorithm == RecognitionDatabase::RecognizeAlgorithm::FisherFace)
     {
-        qCCritical(DIGIKAM_FACESENGINE_LOG) << "cv::Exception:" << e.what();
-        return cv::Mat();
+        if (opencvfisher) applyParameters(opencvfisher.data());
     }
-    catch (...)
+    else if (recognizeAlgorithm == RecognitionDatabase::RecognizeAlgorithm::DNN)
     {
-        qCCritical(DIGIKAM_FACESENGINE_LOG) << "Default exception from OpenCV";
-        return cv::Mat();
+        if (opencvdnn)  applyParameters(opencvdnn.data());
+        if (dnnTrainer) applyParameters(dnnTrainer);
     }
-}
-
-cv::Mat RecognitionDatabase::Private::preprocessingChainRGB(const QImage& image)
-{
-    try
-    {
-        cv::Mat cvImage;
-
-        if (recognizeAlgorithm == RecognizeAlgorithm::LBP)
-        {
-            cvImage = lbph()->prepareForRecognition(image);
-        }
-        else if (recognizeAlgorithm == RecognizeAlgorithm::EigenFace)
-        {
-            cvImage = eigen()->prepareForRecognition(image);
-        }
-        else if (recognizeAlgorithm == RecognizeAlgorithm::FisherFace)
-        {
-            cvImage = fisher()->prepareForRecognition(image);
-        }
-        else if (recognizeAlgorithm == RecognizeAlgorithm::DNN)
-        {
-            cvImage = dnn()->prepareForRecognition(image);
-        }
-        else
-        {
-            qCCritical(DIGIKAM_FACESENGINE_LOG) << "No obvious recognize algorithm";
-        }
-/*
-        cvImage         = aligner()->align(cvImage);
-        TanTriggsPreprocessor preprocessor;
-        cvImage         = preprocessor.preprocess(cvImage);
-*/
-        return cvImage;
-    }
-    catch (cv::Exception& e)
-    {
-        qCCritical(DIGIKAM_FACESENGINE_LOG) << "cv::Exception:" << e.what();
-        return cv::Mat();
-    }
-    catch (...)
+    else
     {
-        qCCritical(DIGIKAM_FACESENGINE_LOG) << "Default exception from OpenCV";
-        return cv::Mat();
+        qCCritical(DIGIKAM_FACESENGINE_LOG) << "No obvious recognize algorithm";
     }
 }
 
@@ -562,13 +574,11 @@ void RecognitionDatabase::Private::train(OpenCVDNNFaceRecognizer* const r,
     trainIdentityBatchDNN(r, identitiesToBeTrained, data, trainingContext, this);
 }
 
-void RecognitionDatabase::Private::clear(OpenCVLBPHFaceRecognizer* const,
-                                         const QList<int>& idsToClear,
-                                         const QString& trainingContext)
+void RecognitionDatabase::Private::clearLBPH(const QList<int>& idsToClear, const QString& trainingContext)
 {
     // force later reload
-    delete opencvlbph;
-    opencvlbph = 0;
+    delete lbphTrainer;
+    lbphTrainer = 0;
 
     if (idsToClear.isEmpty())
     {
@@ -578,15 +588,15 @@ void RecognitionDatabase::Private::clear(OpenCVLBPHFaceRecognizer* const,
     {
         FaceDbAccess().db()->clearLBPHTraining(idsToClear, trainingContext);
     }
+
+    dropSnapshot(opencvlbph);
 }
 
-void RecognitionDatabase::Private::clear(OpenCVEIGENFaceRecognizer* const,
-                                         const QList<int>& idsToClear,
-                                         const QString& trainingContext)
+void RecognitionDatabase::Private::clearEIGEN(const QList<int>& idsToClear, const QString& trainingContext)
 {
     // force later reload
-    delete opencveigen;
-    opencveigen = 0;
+    delete eigenTrainer;
+    eigenTrainer = 0;
 
     if (idsToClear.isEmpty())
     {
@@ -596,24 +606,26 @@ void RecognitionDatabase::Private::clear(OpenCVEIGENFaceRecognizer* const,
     {
         FaceDbAccess().db()->clearEIGENTraining(idsToClear, trainingContext);
     }
+
+    dropSnapshot(opencveigen);
 }
 
-void RecognitionDatabase::Private::clear(OpenCVFISHERFaceRecognizer* const,
-                                         const QList<int>&,
-                                         const QString&)
+void RecognitionDatabase::Private::clearFISHER()
 {
     // force later reload
-    delete opencvfisher;
-    opencvfisher = 0;
+    dropSnapshot(opencvfisher);
 }
 
-void RecognitionDatabase::Private::clear(OpenCVDNNFaceRecognizer* const,
-                                         const QList<int>&,
-                                         const QString&)
+void RecognitionDatabase::Private::clearDNN()
 {
     // force later reload
-    delete opencvdnn;
-    opencvdnn = 0;
+    delete dnnTrainer;
+    dnnTrainer = 0;
+
+    dropSnapshot(opencvdnn);
+
+    // The cached face vectors are computed again with the new model
+    FaceDbAccess().db()->clearFaceEmbeddings();
 }
 
 // -------------------------------------------------------------------------------------------------
@@ -625,7 +637,6 @@ RecognitionDatabase::RecognitionDatabase()
 
 RecognitionDatabase::~RecognitionDatabase()
 {
-    delete d;
 }
 
 RecognitionDatabase::RecognitionDatabase(const RecognitionDatabase& other)
@@ -638,7 +649,7 @@ QList<Identity> RecognitionDatabase::allIdentities() const
     if (!d || !d->dbAvailable)
         return QList<Identity>();
 
-    QMutexLocker lock(&d->mutex);
+    QReadLocker lock(&d->identityLock);
 
     return (d->identityCache.values());
 }
@@ -650,7 +661,7 @@ Identity RecognitionDatabase::identity(int id) const
         return Identity();
     }
 
-    QMutexLocker lock(&d->mutex);
+    QReadLocker lock(&d->identityLock);
 
     return (d->identityCache.value(id));
 }
@@ -662,7 +673,7 @@ Identity RecognitionDatabase::findIdentity(const QString& attribute, const QStri
         return Identity();
     }
 
-    QMutexLocker lock(&d->mutex);
+    QReadLocker lock(&d->identityLock);
 
     return (d->findByAttribute(attribute, value));
 }
@@ -674,7 +685,7 @@ Identity RecognitionDatabase::findIdentity(const QMap<QString, QString>& attribu
         return Identity();
     }
 
-    QMutexLocker lock(&d->mutex);
+    QReadLocker lock(&d->identityLock);
 
     Identity match;
 
@@ -738,11 +749,11 @@ Identity RecognitionDatabase::addIdentity(const QMap<QString, QString>& attribut
         return Identity();
     }
 
-    QMutexLocker lock(&d->mutex);
+    QWriteLocker lock(&d->identityLock);
 
     if (attributes.contains(QLatin1String("uuid")))
     {
-        Identity matchByUuid = findIdentity(QLatin1String("uuid"), attributes.value(QLatin1String("uuid")));
+        Identity matchByUuid = d->findByAttribute(QLatin1String("uuid"), attributes.value(QLatin1String("uuid")));
 
         if (!matchByUuid.isNull())
         {
@@ -777,7 +788,7 @@ void RecognitionDatabase::addIdentityAttributes(int id, const QMap<QString, QStr
         return;
     }
 
-    QMutexLocker lock(&d->mutex);
+    QWriteLocker lock(&d->identityLock);
 
     QHash<int, Identity>::iterator it = d->identityCache.find(id);
 
@@ -797,7 +808,7 @@ void RecognitionDatabase::addIdentityAttribute(int id, const QString& attribute,
         return;
     }
 
-    QMutexLocker lock(&d->mutex);
+    QWriteLocker lock(&d->identityLock);
     QHash<int, Identity>::iterator it = d->identityCache.find(id);
 
     if (it != d->identityCache.end())
@@ -816,7 +827,7 @@ void RecognitionDatabase::setIdentityAttributes(int id, const QMap<QString, QStr
             return;
     }
 
-    QMutexLocker lock(&d->mutex);
+    QWriteLocker lock(&d->identityLock);
     QHash<int, Identity>::iterator it = d->identityCache.find(id);
 
     if (it != d->identityCache.end())
@@ -828,20 +839,22 @@ void RecognitionDatabase::setIdentityAttributes(int id, const QMap<QString, QStr
 
 QString RecognitionDatabase::backendIdentifier() const
 {
-    if (d->recognizeAlgorithm == RecognizeAlgorithm::LBP)
+    const RecognizeAlgorithm algorithm = d->algorithm();
+
+    if (algorithm == RecognizeAlgorithm::LBP)
     {
         return QLatin1String("opencvlbph");
     }
-    else if (d->recognizeAlgorithm == RecognizeAlgorithm::EigenFace)
+    else if (algorithm == RecognizeAlgorithm::EigenFace)
     {
         return QLatin1String("eigenfaces");
     }
-    else if (d->recognizeAlgorithm == RecognizeAlgorithm::FisherFace)
+    else if (algorithm == RecognizeAlgorithm::FisherFace)
     {
         return QLatin1String("fisherfaces");
     }
 
-    // d->recognizeAlgorithm == RecognizeAlgorithm::DNN
+    // algorithm == RecognizeAlgorithm::DNN
     return QLatin1String("dnn");
 }
 
@@ -912,48 +925,58 @@ QList<Identity> RecognitionDatabase::recognizeFaces(const QList<QImage>& images)
     return recognizeFaces(&provider);
 }
 
+QList<Identity> RecognitionDatabase::recognizeFaces(const QList<QImage>& images, const QStringList& faceKeys)
+{
+    QListImageListProvider provider(images);
+
+    return recognizeFaces(&provider, faceKeys);
+}
+
 void RecognitionDatabase::activeFaceRecognizer(RecognizeAlgorithm algorithmType)
 {
+    QMutexLocker lock(&d->mutex);
+
     d->recognizeAlgorithm = algorithmType;
+    d->applyParameters();
 }
 
-QList<Identity> RecognitionDatabase::recognizeFaces(ImageListProvider* const images)
+QList<Identity> RecognitionDatabase::recognizeFaces(ImageListProvider* const images, const QStringList& faceKeys)
 {
     if (!d || !d->dbAvailable)
     {
         return QList<Identity>();
     }
 
-    QMutexLocker lock(&d->mutex);
+    // No lock is held while recognizing, the snapshots are not modified
 
-    QList<Identity> result;
+    const RecognizeAlgorithm algorithm = d->algorithm();
+    QList<int>               ids;
 
-    for (; !images->atEnd(); images->proceed())
+    if (algorithm == RecognizeAlgorithm::LBP)
     {
-        int id = -1;
+        ids = recognizeEach(d->snapshot(d->opencvlbph).data(), images, d.data());
+    }
+    else if (algorithm == RecognizeAlgorithm::EigenFace)
+    {
+        ids = recognizeEach(d->snapshot(d->opencveigen).data(), images, d.data());
+    }
+    else if (algorithm == RecognizeAlgorithm::FisherFace)
+    {
+        ids = recognizeEach(d->snapshot(d->opencvfisher).data(), images, d.data());
+    }
+    else if (algorithm == RecognizeAlgorithm::DNN)
+    {
+        QSharedPointer<OpenCVDNNFaceRecognizer> r = d->snapshot(d->opencvdnn);
+        std::vector<cv::Mat>                    mats;
+
+        for (; !images->atEnd(); images->proceed())
+        {
+            mats.push_back(d->preprocessingChain(r.data(), images->image()));
+        }
 
         try
         {
-            if (d->recognizeAlgorithm == RecognizeAlgorithm::LBP)
-            {
-                id = d->lbph()->recognize(d->preprocessingChain(images->image()));
-            }
-            else if (d->recognizeAlgorithm == RecognizeAlgorithm::EigenFace)
-            {
-                id = d->eigen()->recognize(d->preprocessingChain(images->image()));
-            }
-            else if (d->recognizeAlgorithm == RecognizeAlgorithm::FisherFace)
-            {
-                id = d->fisher()->recognize(d->preprocessingChain(images->image()));
-            }
-            else if (d->recognizeAlgorithm == RecognizeAlgorithm::DNN)
-            {
-                id = d->dnn()->recognize(d->preprocessingChainRGB(images->image()));
-            }
-            else
-            {
-                qCCritical(DIGIKAM_FACESENGINE_LOG) << "No obvious recognize algorithm";
-            }
+            ids = r->recognize(mats, faceKeys);
         }
         catch (cv::Exception& e)
         {
@@ -964,6 +987,21 @@ QList<Identity> RecognitionDatabase::recognizeFaces(ImageListProvider* const ima
             qCCritical(DIGIKAM_FACESENGINE_LOG) << "Default exception from OpenCV";
         }
 
+        while (ids.size() < (int)mats.size())
+        {
+            ids << -1;
+        }
+    }
+    else
+    {
+        qCCritical(DIGIKAM_FACESENGINE_LOG) << "No obvious recognize algorithm";
+    }
+
+    QList<Identity> result;
+    QReadLocker     lock(&d->identityLock);
+
+    foreach (int id, ids)
+    {
         if (id == -1)
         {
             result << Identity();
@@ -996,23 +1034,30 @@ void RecognitionDatabase::train(const QList<Identity>& identitiesToBeTrained, Tr
         return;
     }
 
-    QMutexLocker lock(&d->mutex);
+    QMutexLocker lock(&d->trainingMutex);
 
-    if (d->recognizeAlgorithm == RecognizeAlgorithm::LBP)
+    const RecognizeAlgorithm algorithm = d->algorithm();
+
+    // The snapshot used for recognition is replaced once the new data are in the database
+
+    if (algorithm == RecognizeAlgorithm::LBP)
     {
-        d->train(d->lbph(),  identitiesToBeTrained, data, trainingContext);
+        d->train(d->trainer(d->lbphTrainer),  identitiesToBeTrained, data, trainingContext);
+        d->dropSnapshot(d->opencvlbph);
     }
-    else if (d->recognizeAlgorithm == RecognizeAlgorithm::EigenFace)
+    else if (algorithm == RecognizeAlgorithm::EigenFace)
     {
-        d->train(d->eigen(), identitiesToBeTrained, data, trainingContext);
+        d->train(d->trainer(d->eigenTrainer), identitiesToBeTrained, data, trainingContext);
+        d->dropSnapshot(d->opencveigen);
     }
-    else if (d->recognizeAlgorithm == RecognizeAlgorithm::FisherFace)
+    else if (algorithm == RecognizeAlgorithm::FisherFace)
     {
         // No method to call
     }
-    else if (d->recognizeAlgorithm == RecognizeAlgorithm::DNN)
+    else if (algorithm == RecognizeAlgorithm::DNN)
     {
-        d->train(d->dnn(),   identitiesToBeTrained, data, trainingContext);
+        d->train(d->trainer(d->dnnTrainer),   identitiesToBeTrained, data, trainingContext);
+        d->dropSnapshot(d->opencvdnn);
     }
     else
     {
@@ -1046,12 +1091,12 @@ void RecognitionDatabase::clearAllTraining(const QString& trainingContext)
         return;
     }
 
-    QMutexLocker lock(&d->mutex);
+    QMutexLocker lock(&d->trainingMutex);
 
-    d->clear(d->lbph(),   QList<int>(), trainingContext);
-    d->clear(d->eigen(),  QList<int>(), trainingContext);
-    d->clear(d->fisher(), QList<int>(), trainingContext);
-    d->clear(d->dnn(),    QList<int>(), trainingContext);
+    d->clearLBPH(QList<int>(),  trainingContext);
+    d->clearEIGEN(QList<int>(), trainingContext);
+    d->clearFISHER();
+    d->clearDNN();
 }
 
 void RecognitionDatabase::clearTraining(const QList<Identity>& identitiesToClean, const QString& trainingContext)
@@ -1061,7 +1106,7 @@ void RecognitionDatabase::clearTraining(const QList<Identity>& identitiesToClean
         return;
     }
 
-    QMutexLocker lock(&d->mutex);
+    QMutexLocker lock(&d->trainingMutex);
     QList<int>   ids;
 
     foreach (const Identity& id, identitiesToClean)
@@ -1069,21 +1114,23 @@ void RecognitionDatabase::clearTraining(const QList<Identity>& identitiesToClean
         ids << id.id();
     }
 
-    if (d->recognizeAlgorithm == RecognizeAlgorithm::LBP)
+    const RecognizeAlgorithm algorithm = d->algorithm();
+
+    if (algorithm == RecognizeAlgorithm::LBP)
     {
-        d->clear(d->lbph(), ids, trainingContext);
+        d->clearLBPH(ids, trainingContext);
     }
-    else if (d->recognizeAlgorithm == RecognizeAlgorithm::EigenFace)
+    else if (algorithm == RecognizeAlgorithm::EigenFace)
     {
-        d->clear(d->eigen(), ids, trainingContext);
+        d->clearEIGEN(ids, trainingContext);
     }
-    else if (d->recognizeAlgorithm == RecognizeAlgorithm::FisherFace)
+    else if (algorithm == RecognizeAlgorithm::FisherFace)
     {
-        d->clear(d->fisher(), ids, trainingContext);
+        d->clearFISHER();
     }
-    else if (d->recognizeAlgorithm == RecognizeAlgorithm::DNN)
+    else if (algorithm == RecognizeAlgorithm::DNN)
     {
-        d->clear(d->dnn(), ids, trainingContext);
+        d->clearDNN();
     }
     else
     {
@@ -1098,12 +1145,38 @@ void RecognitionDatabase::deleteIdentity(const Identity& identityToBeDeleted)
         return;
     }
 
-    QMutexLocker lock(&d->mutex);
+    QWriteLocker lock(&d->identityLock);
 
     FaceDbAccess().db()->deleteIdentity(identityToBeDeleted.id());
     d->identityCache.remove(identityToBeDeleted.id());
 }
 
+QString RecognitionDatabase::faceEmbeddingKey(const QString& uniqueHash, const QRect& region)
+{
+    return QString::fromLatin1("%1-%2,%3,%4,%5").arg(uniqueHash).arg(region.x()).arg(region.y())
+                                                .arg(region.width()).arg(region.height());
+}
+
+QStringList RecognitionDatabase::faceEmbeddingKeys() const
+{
+    if (!d || !d->dbAvailable)
+    {
+        return QStringList();
+    }
+
+    return FaceDbAccess().db()->faceEmbeddingKeys();
+}
+
+void RecognitionDatabase::removeFaceEmbedding(const QString& key)
+{
+    if (!d || !d->dbAvailable)
+    {
+        return;
+    }
+
+    FaceDbAccess().db()->removeFaceEmbedding(key);
+}
+
 bool RecognitionDatabase::integrityCheck()
 {
     if (!d || !d->dbAvailable)
@@ -1111,8 +1184,6 @@ bool RecognitionDatabase::integrityCheck()
         return false;
     }
 
-    QMutexLocker lock(&d->mutex);
-
     return FaceDbAccess().db()->integrityCheck();
 }
 
@@ -1123,8 +1194,6 @@ void RecognitionDatabase::vacuum()
         return;
     }
 
-    QMutexLocker lock(&d->mutex);
-
     return FaceDbAccess().db()->vacuum();
 }
 
@@ -31,6 +31,8 @@
 #include <QImage>
 #include <QList>
 #include <QMap>
+#include <QRect>
+#include <QStringList>
 #include <QVariant>
 
 // Local includes
@@ -49,9 +51,10 @@ namespace Digikam
  *
  * The class guarantees
  * - deferred creation: The backend is created only when used first.
- * - only one instance per configuration path is created
- * - an instance of this class is thread-safe
- *   (this class is also reentrant, for different objects and paths)
+ * - copies of an instance share the same backend
+ * - an instance of this class is thread-safe. recognizeFaces() can run
+ *   in several threads at the same time, it works on a read-only snapshot
+ *   of the trained models which is replaced after training.
  */
 class DIGIKAM_DATABASE_EXPORT RecognitionDatabase
 {
@@ -158,9 +161,15 @@ public:
      * The face details to be recognized are passed by the provider.
      * For each entry in the provider, in 1-to-1 mapping,
      * a recognized identity or the null identity is returned.
+     *
+     * With the DNN algorithm, all faces are processed in batches. faceKeys,
+     * if not empty, gives one unique key per face, see faceEmbeddingKey().
+     * The face vectors are then cached under these keys and are not computed
+     * again for the next recognitions.
      */
-    QList<Identity> recognizeFaces(ImageListProvider* const images);
+    QList<Identity> recognizeFaces(ImageListProvider* const images, const QStringList& faceKeys = QStringList());
     QList<Identity> recognizeFaces(const QList<QImage>& images);
+    QList<Identity> recognizeFaces(const QList<QImage>& images, const QStringList& faceKeys);
     Identity        recognizeFace(const QImage& image);
 
     /**
@@ -214,6 +223,19 @@ public:
      */
     void deleteIdentity(const Identity& identityToBeDeleted);
 
+    /**
+     * Returns the key identifying the face vector of a face region in the cache,
+     * see recognizeFaces().
+     */
+    static QString faceEmbeddingKey(const QString& uniqueHash, const QRect& region);
+
+    /**
+     * Returns the keys of all cached face vectors.
+     * The keys of faces which do not exist anymore can be removed with removeFaceEmbedding().
+     */
+    QStringList faceEmbeddingKeys() const;
+    void        removeFaceEmbedding(const QString& key);
+
     /**
      * Checks the integrity and returns true if everything is fine.
      */
@@ -231,7 +253,7 @@ public:
 
 private:
 
-    Private* const d;
+    QExplicitlySharedDataPointer<Private> d;
 };
 
 } // namespace Digikam
@@ -38,6 +38,7 @@ extern "C"
 #include <QImage>
 #include <QByteArray>
 #include <QFile>
+#include <QRect>
 #include <qplatformdefs.h>
 
 // Windows includes
@@ -60,12 +61,21 @@ namespace Digikam
 namespace PGFUtils
 {
 
-// Private method
+// Private methods
 bool writePGFImageDataToStream(const QImage& image,
                                CPGFStream& stream,
                                int quality,
                                UINT32& nWrittenBytes,
-                               bool verbose);
+                               bool verbose,
+                               bool roi = false,
+                               const QByteArray& userData = QByteArray());
+
+bool writePGFFile(const QImage& image,
+                  const QString& filePath,
+                  int quality,
+                  bool verbose,
+                  bool roi,
+                  const QByteArray& userData);
 
 bool readPGFImageData(const QByteArray& data,
                       QImage& img,
@@ -139,12 +149,31 @@ bool writePGFImageFile(const QImage& image,
                        const QString& filePath,
                        int quality,
                        bool verbose)
+{
+    return writePGFFile(image, filePath, quality, verbose, false, QByteArray());
+}
+
+bool writePGFPyramidFile(const QImage& image,
+                         const QString& filePath,
+                         int quality,
+                         const QByteArray& userData,
+                         bool verbose)
+{
+    return writePGFFile(image, filePath, quality, verbose, true, userData);
+}
+
+bool writePGFFile(const QImage& image,
+                  const QString& filePath,
+                  int quality,
+                  bool verbose,
+                  bool roi,
+                  const QByteArray& userData)
 {
 #ifdef Q_OS_WIN32
 #ifdef UNICODE
-    HANDLE fd = CreateFile((LPCWSTR)(QFile::encodeName(filePath).constData()), GENERIC_READ, 0, 0, OPEN_EXISTING, 0, 0);
+    HANDLE fd = CreateFile((LPCWSTR)(QFile::encodeName(filePath).constData()), GENERIC_READ | GENERIC_WRITE, 0, 0, CREATE_ALWAYS, 0, 0);
 #else
-    HANDLE fd = CreateFile(QFile::encodeName(filePath).constData(), GENERIC_READ, 0, 0, OPEN_EXISTING, 0, 0);
+    HANDLE fd = CreateFile(QFile::encodeName(filePath).constData(), GENERIC_READ | GENERIC_WRITE, 0, 0, CREATE_ALWAYS, 0, 0);
 #endif
 
     if (fd == INVALID_HANDLE_VALUE)
@@ -166,7 +195,7 @@ bool writePGFImageFile(const QImage& image,
 
     CPGFFileStream stream(fd);
     UINT32 nWrittenBytes = 0;
-    bool ret             = writePGFImageDataToStream(image, stream, quality, nWrittenBytes, verbose);
+    bool ret             = writePGFImageDataToStream(image, stream, quality, nWrittenBytes, verbose, roi, userData);
 
     if (!nWrittenBytes)
     {
@@ -248,7 +277,9 @@ bool writePGFImageDataToStream(const QImage& image,
                                CPGFStream& stream,
                                int quality,
                                UINT32& nWrittenBytes,
-                               bool verbose)
+                               bool verbose,
+                               bool roi,
+                               const QByteArray& userData)
 {
     try
     {
@@ -291,7 +322,13 @@ bool writePGFImageDataToStream(const QImage& image,
         header.background.rgbtRed   = 0;
 #   endif
 #endif
-        pgfImg.SetHeader(header);
+
+        // With the ROI encoding scheme, regions of each level can be decoded independently.
+        // See readPGFRegion().
+        pgfImg.SetHeader(header,
+                         roi ? PGFROI : 0,
+                         userData.isEmpty() ? 0 : (const UINT8*)userData.constData(),
+                         (UINT32)userData.size());
 
         // NOTE: see bug #273765 : Loading PGF thumbs with OpenMP support through a separated thread do not work properly with libppgf 6.11.24
         pgfImg.ConfigureEncoder(false);
@@ -473,6 +510,159 @@ bool loadPGFScaled(QImage& img, const QString& path, int maximumSize)
     return true;
 }
 
+bool readPGFRegion(QImage& img,
+                   const QString& path,
+                   int maximumSize,
+                   const QRect& rect,
+                   QByteArray* const userData,
+                   QSize* const fullSize)
+{
+#ifdef Q_OS_WIN32
+#ifdef UNICODE
+    HANDLE fd = CreateFile((LPCWSTR)(QFile::encodeName(path).constData()), GENERIC_READ, 0, 0, OPEN_EXISTING, 0, 0);
+#else
+    HANDLE fd = CreateFile(QFile::encodeName(path).constData(), GENERIC_READ, 0, 0, OPEN_EXISTING, 0, 0);
+#endif
+
+    if (fd == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+#else
+    int fd = QT_OPEN(QFile::encodeName(path).constData(), O_RDONLY);
+
+    if (fd == -1)
+    {
+        return false;
+    }
+
+#endif
+
+    bool ret        = true;
+    bool regionRead = false;
+
+    try
+    {
+        CPGFFileStream stream(fd);
+        CPGFImage      pgf;
+        // NOTE: ConfigureDecoder() always takes prefixSize as user data policy, so the whole
+        // user data is only cached with the largest prefix.
+        pgf.ConfigureDecoder(false, UP_CachePrefix, MaxUserDataSize);
+        pgf.Open(&stream);
+
+        if (pgf.Channels() != 4)
+        {
+            qCDebug(DIGIKAM_GENERAL_LOG) << "PGFUtils: PGF channels not supported";
+            ret = false;
+        }
+        else
+        {
+            const QRect imageRect(0, 0, pgf.Width(), pgf.Height());
+            const QRect roi = rect.isNull() ? imageRect : (rect & imageRect);
+
+            // The smallest level which is still at least as large as the wanted size.
+
+            int level = 0;
+
+            if (maximumSize > 0)
+            {
+                for (level = pgf.Levels() - 1 ; level > 0 ; --level)
+                {
+                    if (qMax((int)pgf.Width(level), (int)pgf.Height(level)) >= maximumSize)
+                    {
+                        break;
+                    }
+                }
+            }
+
+            if (fullSize)
+            {
+                *fullSize = imageRect.size();
+            }
+
+            if (userData)
+            {
+                UINT32 size             = 0;
+                const UINT8* const data = pgf.GetUserData(size);
+                *userData               = data ? QByteArray((const char*)data, size) : QByteArray();
+            }
+
+            if (roi.isEmpty())
+            {
+                ret = false;
+            }
+#ifdef __PGFROISUPPORT__
+            else if (pgf.ROIisSupported() && roi != imageRect)
+            {
+                // Only the wavelet blocks covering the region are decoded.
+
+                PGFRect pgfRect(roi.x(), roi.y(), roi.width(), roi.height());
+                pgf.Read(pgfRect, level);
+                const PGFRect levelRect = pgf.ComputeLevelROI();
+                img                     = QImage(levelRect.Width(), levelRect.Height(), QImage::Format_ARGB32);
+                regionRead              = true;
+            }
+#endif
+            else
+            {
+                pgf.Read(level);
+                img = QImage(pgf.Width(level), pgf.Height(level), QImage::Format_ARGB32);
+
+                if (roi != imageRect)
+                {
+                    qCDebug(DIGIKAM_GENERAL_LOG) << "PGFUtils: PGF file without ROI support, the whole level is decoded";
+                }
+            }
+
+            if (ret)
+            {
+                if (QSysInfo::ByteOrder == QSysInfo::BigEndian)
+                {
+                    int map[] = {3, 2, 1, 0};
+                    pgf.GetBitmap(img.bytesPerLine(), (UINT8*)img.bits(), img.depth(), map);
+                }
+                else
+                {
+                    int map[] = {0, 1, 2, 3};
+                    pgf.GetBitmap(img.bytesPerLine(), (UINT8*)img.bits(), img.depth(), map);
+                }
+
+                // Without ROI support, the region is cut from the decoded level.
+
+                if (!regionRead && roi != imageRect)
+                {
+                    const double factor = (double)img.width() / (double)imageRect.width();
+                    img                 = img.copy(QRect(qRound(roi.x() * factor),
+                                                         qRound(roi.y() * factor),
+                                                         qMax(1, qRound(roi.width()  * factor)),
+                                                         qMax(1, qRound(roi.height() * factor))));
+                }
+            }
+        }
+    }
+    catch (IOException& e)
+    {
+        int err = e.error;
+
+        if (err >= AppError)
+        {
+            err -= AppError;
+        }
+
+        qCDebug(DIGIKAM_GENERAL_LOG) << "PGFUtils: Error running libpgf (" << err << ")!";
+        ret = false;
+    }
+
+#ifdef Q_OS_WIN32
+    CloseHandle(fd);
+#else
+    close(fd);
+#endif
+
+    return ret;
+}
+
 QString libPGFVersion()
 {
     return (QLatin1String(PGFCodecVersion));
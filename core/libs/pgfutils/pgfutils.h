@@ -29,6 +29,8 @@
 #include <QString>
 #include <QImage>
 #include <QByteArray>
+#include <QRect>
+#include <QSize>
 
 // Local includes
 
@@ -75,6 +77,32 @@ DIGIKAM_EXPORT bool writePGFImageFile(const QImage& image,
                                       int quality,
                                       bool verbose=false);
 
+/**
+ * QImage to PGF file using the ROI encoding scheme, which permits to decode
+ * regions of each level independently with readPGFRegion().
+ * 'userData' is stored in the PGF header and returned by readPGFRegion().
+ * Same other arguments than writePGFImageFile().
+ */
+DIGIKAM_EXPORT bool writePGFPyramidFile(const QImage& image,
+                                        const QString& filePath,
+                                        int quality,
+                                        const QByteArray& userData = QByteArray(),
+                                        bool verbose=false);
+
+/**
+ * Load a region of a PGF file at the smallest level which is at least 'maximumSize'
+ * large. 'rect' is given in full size coordinates, a null rect loads the whole level.
+ * Only the region is decoded if the file was written with writePGFPyramidFile().
+ * If not null, 'userData' is set to the user data of the header and 'fullSize'
+ * to the full size of the image.
+ */
+DIGIKAM_EXPORT bool readPGFRegion(QImage& img,
+                                  const QString& path,
+                                  int maximumSize,
+                                  const QRect& rect = QRect(),
+                                  QByteArray* const userData = 0,
+                                  QSize* const fullSize = 0);
+
 /**
  * Load a reduced version of PGF file
  */
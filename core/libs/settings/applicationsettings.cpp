@@ -224,6 +224,8 @@ void ApplicationSettings::readSettings()
     d->previewSettings.convertToEightBit = group.readEntry(d->configPreviewConvertToEightBitEntry,     true);
     d->previewSettings.zoomOrgSize       = group.readEntry(d->configPreviewZoomOrgSizeEntry,           true);
     d->previewShowIcons                  = group.readEntry(d->configPreviewShowIconsEntry,             true);
+    d->previewPyramidCache               = group.readEntry(d->configPreviewPyramidCacheEntry,          false);
+    d->previewPyramidCacheSize           = group.readEntry(d->configPreviewPyramidCacheSizeEntry,      2048);
     d->showThumbbar                      = group.readEntry(d->configShowThumbbarEntry,                 true);
 
     d->showFolderTreeViewItemsCount      = group.readEntry(d->configShowFolderTreeViewItemsCountEntry, false);
@@ -260,6 +262,7 @@ void ApplicationSettings::readSettings()
     setApplicationFont(group.readEntry(d->configApplicationFontEntry, QFontDatabase::systemFont(QFontDatabase::GeneralFont)));
 
     d->scanAtStart                       = group.readEntry(d->configScanAtStartEntry,                                 true);
+    d->fastScanAtStart                   = group.readEntry(d->configFastScanAtStartEntry,                             false);
     d->cleanAtStart                      = group.readEntry(d->configCleanAtStartEntry,                                false);
 
     // ---------------------------------------------------------------------
@@ -420,6 +423,8 @@ void ApplicationSettings::saveSettings()
     group.writeEntry(d->configPreviewConvertToEightBitEntry,           d->previewSettings.convertToEightBit);
     group.writeEntry(d->configPreviewZoomOrgSizeEntry,                 d->previewSettings.zoomOrgSize);
     group.writeEntry(d->configPreviewShowIconsEntry,                   d->previewShowIcons);
+    group.writeEntry(d->configPreviewPyramidCacheEntry,                d->previewPyramidCache);
+    group.writeEntry(d->configPreviewPyramidCacheSizeEntry,            d->previewPyramidCacheSize);
     group.writeEntry(d->configShowThumbbarEntry,                       d->showThumbbar);
     group.writeEntry(d->configShowFolderTreeViewItemsCountEntry,       d->showFolderTreeViewItemsCount);
 
@@ -444,6 +449,7 @@ void ApplicationSettings::saveSettings()
     group.writeEntry(d->configApplicationFontEntry,                    d->applicationFont);
 
     group.writeEntry(d->configScanAtStartEntry,                        d->scanAtStart);
+    group.writeEntry(d->configFastScanAtStartEntry,                    d->fastScanAtStart);
     group.writeEntry(d->configCleanAtStartEntry,                       d->cleanAtStart);
 
     // ---------------------------------------------------------------------
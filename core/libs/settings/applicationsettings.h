@@ -269,6 +269,15 @@ public:
     void setPreviewShowIcons(bool val);
     bool getPreviewShowIcons() const;
 
+    /** The disk cache of decoded previews, see PreviewPyramidCache.
+     *  The size is given in MiB.
+     */
+    void setPreviewPyramidCache(bool val);
+    bool getPreviewPyramidCache() const;
+
+    void setPreviewPyramidCacheSize(int val);
+    int  getPreviewPyramidCacheSize() const;
+
     // -- Mime-Types Settings -------------------------------------------------------
 
     QString getImageFileFilter() const;
@@ -394,6 +403,9 @@ public:
     void setScanAtStart(bool val);
     bool getScanAtStart() const;
 
+    void setFastScanAtStart(bool val);
+    bool getFastScanAtStart() const;
+
     void setCleanAtStart(bool val);
     bool getCleanAtStart() const;
 
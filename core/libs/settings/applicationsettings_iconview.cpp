@@ -263,4 +263,24 @@ bool ApplicationSettings::getPreviewShowIcons() const
     return d->previewShowIcons;
 }
 
+void ApplicationSettings::setPreviewPyramidCache(bool val)
+{
+    d->previewPyramidCache = val;
+}
+
+bool ApplicationSettings::getPreviewPyramidCache() const
+{
+    return d->previewPyramidCache;
+}
+
+void ApplicationSettings::setPreviewPyramidCacheSize(int val)
+{
+    d->previewPyramidCacheSize = val;
+}
+
+int ApplicationSettings::getPreviewPyramidCacheSize() const
+{
+    return d->previewPyramidCacheSize;
+}
+
 } // namespace Digikam
@@ -249,6 +249,16 @@ bool ApplicationSettings::getScanAtStart() const
     return d->scanAtStart;
 }
 
+void ApplicationSettings::setFastScanAtStart(bool val)
+{
+    d->fastScanAtStart = val;
+}
+
+bool ApplicationSettings::getFastScanAtStart() const
+{
+    return d->fastScanAtStart;
+}
+
 void ApplicationSettings::setCleanAtStart(bool val)
 {
     d->cleanAtStart = val;
@@ -123,6 +123,8 @@ const QString ApplicationSettings::Private::configPreviewRawUseHalfSizeData(QLat
 const QString ApplicationSettings::Private::configPreviewConvertToEightBitEntry(QLatin1String("Preview Convert To Eight Bit"));
 const QString ApplicationSettings::Private::configPreviewZoomOrgSizeEntry(QLatin1String("Preview Zoom Use Original Size"));
 const QString ApplicationSettings::Private::configPreviewShowIconsEntry(QLatin1String("Preview Show Icons"));
+const QString ApplicationSettings::Private::configPreviewPyramidCacheEntry(QLatin1String("Preview Pyramid Cache"));
+const QString ApplicationSettings::Private::configPreviewPyramidCacheSizeEntry(QLatin1String("Preview Pyramid Cache Size"));
 const QString ApplicationSettings::Private::configShowThumbbarEntry(QLatin1String("Show Thumbbar"));
 const QString ApplicationSettings::Private::configShowFolderTreeViewItemsCountEntry(QLatin1String("Show Folder Tree View Items Count"));
 const QString ApplicationSettings::Private::configShowSplashEntry(QLatin1String("Show Splash"));
@@ -142,6 +144,7 @@ const QString ApplicationSettings::Private::configApplicationStyleEntry(QLatin1S
 const QString ApplicationSettings::Private::configIconThemeEntry(QLatin1String("Icon Theme"));
 const QString ApplicationSettings::Private::configApplicationFontEntry(QLatin1String("Application Font"));
 const QString ApplicationSettings::Private::configScanAtStartEntry(QLatin1String("Scan At Start"));
+const QString ApplicationSettings::Private::configFastScanAtStartEntry(QLatin1String("Fast Scan At Start"));
 const QString ApplicationSettings::Private::configCleanAtStartEntry(QLatin1String("Clean core DB At Start"));
 const QString ApplicationSettings::Private::configMinimumSimilarityBound(QLatin1String("Lower bound for minimum similarity"));
 const QString ApplicationSettings::Private::configDuplicatesSearchLastMinSimilarity(QLatin1String("Last minimum similarity"));
@@ -223,6 +226,8 @@ ApplicationSettings::Private::Private(ApplicationSettings* const qq)
       tooltipShowAlbumCaption(false),
       tooltipShowAlbumPreview(false),
       previewShowIcons(true),
+      previewPyramidCache(false),
+      previewPyramidCacheSize(2048),
       showThumbbar(false),
       showFolderTreeViewItemsCount(false),
       treeThumbnailSize(0),
@@ -231,6 +236,7 @@ ApplicationSettings::Private::Private(ApplicationSettings* const qq)
       recursiveAlbums(false),
       recursiveTags(false),
       scanAtStart(true),
+      fastScanAtStart(false),
       cleanAtStart(true),
       databaseDirSetAtCmd(false),
       sidebarTitleStyle(DMultiTabBar::AllIconsText),
@@ -356,6 +362,8 @@ void ApplicationSettings::Private::init()
     tooltipShowAlbumPreview              = false;
 
     previewShowIcons                     = true;
+    previewPyramidCache                  = false;
+    previewPyramidCacheSize              = 2048;
     showThumbbar                         = true;
 
     recursiveAlbums                      = false;
@@ -376,6 +384,7 @@ void ApplicationSettings::Private::init()
     duplicatesSearchLastRestrictions     = 0;
 
     scanAtStart                          = true;
+    fastScanAtStart                      = false;
     cleanAtStart                         = true;
     databaseDirSetAtCmd                  = false;
     stringComparisonType                 = ApplicationSettings::Natural;
@@ -137,6 +137,8 @@ public:
     static const QString configPreviewConvertToEightBitEntry;
     static const QString configPreviewZoomOrgSizeEntry;
     static const QString configPreviewShowIconsEntry;
+    static const QString configPreviewPyramidCacheEntry;
+    static const QString configPreviewPyramidCacheSizeEntry;
     static const QString configShowThumbbarEntry;
     static const QString configShowFolderTreeViewItemsCountEntry;
     static const QString configShowSplashEntry;
@@ -145,6 +147,7 @@ public:
     static const QString configShowPermanentDeleteDialogEntry;
     static const QString configApplySidebarChangesDirectlyEntry;
     static const QString configScanAtStartEntry;
+    static const QString configFastScanAtStartEntry;
     static const QString configCleanAtStartEntry;
     static const QString configSyncBalootoDigikamEntry;
     static const QString configSyncDigikamtoBalooEntry;
@@ -237,6 +240,8 @@ public:
     // preview settings
     PreviewSettings                              previewSettings;
     bool                                         previewShowIcons;
+    bool                                         previewPyramidCache;
+    int                                          previewPyramidCacheSize;
     bool                                         showThumbbar;
 
     bool                                         showFolderTreeViewItemsCount;
@@ -257,6 +262,7 @@ public:
     // database settings
     DbEngineParameters                           databaseParams;
     bool                                         scanAtStart;
+    bool                                         fastScanAtStart;
     bool                                         cleanAtStart;
     bool                                         databaseDirSetAtCmd;
 
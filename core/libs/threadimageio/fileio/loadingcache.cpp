@@ -27,8 +27,9 @@
 
 #include <QCoreApplication>
 #include <QEvent>
-#include <QCache>
+#include <QHash>
 #include <QMap>
+#include <QVector>
 
 // Local includes
 
@@ -41,6 +42,473 @@
 namespace Digikam
 {
 
+LoadingCacheStatistics::LoadingCacheStatistics()
+    : hits(0),
+      misses(0),
+      insertions(0),
+      rejections(0),
+      evictions(0),
+      count(0),
+      usedBytes(0),
+      maxBytes(0)
+{
+}
+
+double LoadingCacheStatistics::hitRate() const
+{
+    if (!(hits + misses))
+    {
+        return 0.0;
+    }
+
+    return (double)hits / (hits + misses);
+}
+
+// --------------------------------------------------------------------------------------------------------------
+
+/**
+ * Estimates how often each key was used recently, in a fixed amount of memory.
+ * This is a count-min sketch of four rows of counters saturating at 15.
+ * All counters are halved after ten additions per cached entry, so that old usage is forgotten
+ * at the pace at which the cache content changes.
+ */
+class Q_DECL_HIDDEN LoadingCacheFrequencySketch
+{
+public:
+
+    explicit LoadingCacheFrequencySketch()
+        : m_counters(Rows * Width, 0),
+          m_additions(0),
+          m_agingPeriod(10 * MinimumEntries)
+    {
+    }
+
+    void increment(const QString& key)
+    {
+        const uint hash = qHash(key);
+
+        for (int row = 0 ; row < Rows ; ++row)
+        {
+            quint8& counter = m_counters[row * Width + index(hash, row)];
+
+            if (counter < 15)
+            {
+                ++counter;
+            }
+        }
+
+        if (++m_additions >= m_agingPeriod)
+        {
+            age();
+        }
+    }
+
+    int frequency(const QString& key) const
+    {
+        const uint hash = qHash(key);
+        int frequency   = 15;
+
+        for (int row = 0 ; row < Rows ; ++row)
+        {
+            frequency = qMin(frequency, (int)m_counters.at(row * Width + index(hash, row)));
+        }
+
+        return frequency;
+    }
+
+    /// Adapts the aging period to the number of cached entries
+    void setEntryCount(int count)
+    {
+        m_agingPeriod = 10 * qBound((int)MinimumEntries, count, (int)Width);
+    }
+
+    void clear()
+    {
+        m_counters.fill(0);
+        m_additions = 0;
+    }
+
+private:
+
+    enum
+    {
+        Rows           = 4,
+        WidthBits      = 13,
+        Width          = 1 << WidthBits,
+        MinimumEntries = 32
+    };
+
+    static int index(uint hash, int row)
+    {
+        static const uint seeds[Rows] = { 0x97CB3127, 0xB492B66F, 0x9AE16A3B, 0xC3A5C85C };
+
+        return (int)(((hash ^ seeds[row]) * 0x9E3779B1U) >> (32 - WidthBits));
+    }
+
+    void age()
+    {
+        for (int i = 0 ; i < m_counters.size() ; ++i)
+        {
+            m_counters[i] >>= 1;
+        }
+
+        m_additions = 0;
+    }
+
+private:
+
+    QVector<quint8> m_counters;
+    int             m_additions;
+    int             m_agingPeriod;
+};
+
+// --------------------------------------------------------------------------------------------------------------
+
+/**
+ * One part of the LoadingCache, accounted by the size of its objects in bytes (W-TinyLFU).
+ *
+ * New objects enter a small least recently used window, which takes one percent of the budget
+ * but always keeps the newest object. The objects leaving the window are candidates for the
+ * main least recently used list. If the main list is full, only its least recently used objects
+ * which were not used more frequently than the candidate are evicted (TinyLFU admission), the
+ * others get a second chance at the front of the list. If not enough objects can be evicted,
+ * the candidate is rejected. This keeps frequently used objects while a large number of objects
+ * is loaded once, i.e. while scrolling through an album, and the window gives a new object
+ * the time to be used again before it has to be admitted.
+ */
+template <class T>
+class Q_DECL_HIDDEN LoadingCacheSegment
+{
+public:
+
+    explicit LoadingCacheSegment()
+        : m_maxCost(0)
+    {
+    }
+
+    ~LoadingCacheSegment()
+    {
+        clear();
+    }
+
+    /// Returns the object and marks it as most recently used, or 0. The lookup is counted as hit or miss.
+    T* object(const QString& key)
+    {
+        m_sketch.increment(key);
+
+        typename QHash<QString, Node*>::const_iterator it = m_nodes.constFind(key);
+
+        if (it == m_nodes.constEnd())
+        {
+            ++m_statistics.misses;
+            return 0;
+        }
+
+        ++m_statistics.hits;
+        Node* const node = it.value();
+        List* const list = node->list;
+        unlink(node);
+        prepend(list, node);
+
+        return node->object;
+    }
+
+    bool contains(const QString& key) const
+    {
+        return m_nodes.contains(key);
+    }
+
+    /**
+     * Takes ownership of the object. Returns false and deletes the object
+     * if it is larger than the budget. The object can be rejected later,
+     * when it leaves the window.
+     */
+    bool insert(const QString& key, T* const object, qint64 cost)
+    {
+        m_sketch.increment(key);
+
+        if (cost > m_maxCost)
+        {
+            ++m_statistics.rejections;
+            delete object;
+            return false;
+        }
+
+        remove(key);
+
+        Node* const node = new Node;
+        node->key        = key;
+        node->object     = object;
+        node->cost       = cost;
+        prepend(&m_window, node);
+        m_nodes.insert(key, node);
+        ++m_statistics.insertions;
+
+        // Move the candidates out of the window, keeping the new object
+
+        while (m_window.cost > m_maxCost / 100 && m_window.last != m_window.first)
+        {
+            admit(m_window.last);
+        }
+
+        // The window takes its place from the main list
+
+        while (m_main.last && usedCost() > m_maxCost)
+        {
+            evict(m_main.last);
+        }
+
+        m_sketch.setEntryCount(m_nodes.size());
+
+        return true;
+    }
+
+    bool remove(const QString& key)
+    {
+        Node* const node = m_nodes.take(key);
+
+        if (!node)
+        {
+            return false;
+        }
+
+        destroy(node);
+
+        return true;
+    }
+
+    void clear()
+    {
+        while (m_window.first)
+        {
+            m_nodes.remove(m_window.first->key);
+            destroy(m_window.first);
+        }
+
+        while (m_main.first)
+        {
+            m_nodes.remove(m_main.first->key);
+            destroy(m_main.first);
+        }
+
+        // A cleared cache starts with a new working set
+
+        m_sketch.clear();
+    }
+
+    QList<QString> keys() const
+    {
+        return m_nodes.keys();
+    }
+
+    int size() const
+    {
+        return m_nodes.size();
+    }
+
+    qint64 maxCost() const
+    {
+        return m_maxCost;
+    }
+
+    void setMaxCost(qint64 maxCost)
+    {
+        m_maxCost = maxCost;
+        trim(m_maxCost);
+    }
+
+    LoadingCacheStatistics statistics() const
+    {
+        LoadingCacheStatistics statistics = m_statistics;
+        statistics.count                  = m_nodes.size();
+        statistics.usedBytes              = usedCost();
+        statistics.maxBytes               = m_maxCost;
+
+        return statistics;
+    }
+
+    void resetStatistics()
+    {
+        m_statistics = LoadingCacheStatistics();
+    }
+
+private:
+
+    class Node;
+
+    class Q_DECL_HIDDEN List
+    {
+    public:
+
+        List()
+          : first(0),
+            last(0),
+            cost(0)
+        {
+        }
+
+        Node*  first;
+        Node*  last;
+        qint64 cost;
+    };
+
+    class Q_DECL_HIDDEN Node
+    {
+    public:
+
+        QString key;
+        T*      object;
+        qint64  cost;
+        List*   list;
+        Node*   previous;
+        Node*   next;
+    };
+
+private:
+
+    qint64 usedCost() const
+    {
+        return (m_window.cost + m_main.cost);
+    }
+
+    /// Moves the candidate from the window to the main list, or rejects it
+    void admit(Node* const candidate)
+    {
+        unlink(candidate);
+
+        const int frequency = m_sketch.frequency(candidate->key);
+        qint64 needed       = usedCost() + candidate->cost - m_maxCost;
+        qint64 evictable    = 0;
+
+        // Check first that enough objects are not used more frequently than the candidate
+
+        for (Node* node = m_main.last ; node && (evictable < needed) ; node = node->previous)
+        {
+            if (m_sketch.frequency(node->key) <= frequency)
+            {
+                evictable += node->cost;
+            }
+        }
+
+        if (evictable < needed)
+        {
+            m_nodes.remove(candidate->key);
+            delete candidate->object;
+            delete candidate;
+            ++m_statistics.rejections;
+            return;
+        }
+
+        // Evict them. The more frequently used objects on the way get a second chance at the front.
+
+        Node* node = m_main.last;
+
+        while (needed > 0)
+        {
+            Node* const previous = node->previous;
+
+            if (m_sketch.frequency(node->key) <= frequency)
+            {
+                needed -= node->cost;
+                evict(node);
+            }
+            else
+            {
+                unlink(node);
+                prepend(&m_main, node);
+            }
+
+            node = previous;
+        }
+
+        prepend(&m_main, candidate);
+    }
+
+    /// Evicts least recently used objects, of the main list first, until the used cost is at most maxCost
+    void trim(qint64 maxCost)
+    {
+        while (m_main.last && usedCost() > maxCost)
+        {
+            evict(m_main.last);
+        }
+
+        while (m_window.last && usedCost() > maxCost)
+        {
+            evict(m_window.last);
+        }
+    }
+
+    void evict(Node* const node)
+    {
+        m_nodes.remove(node->key);
+        destroy(node);
+        ++m_statistics.evictions;
+    }
+
+    void destroy(Node* const node)
+    {
+        unlink(node);
+        delete node->object;
+        delete node;
+    }
+
+    void prepend(List* const list, Node* const node)
+    {
+        node->list     = list;
+        node->previous = 0;
+        node->next     = list->first;
+
+        if (list->first)
+        {
+            list->first->previous = node;
+        }
+
+        list->first  = node;
+        list->cost  += node->cost;
+
+        if (!list->last)
+        {
+            list->last = node;
+        }
+    }
+
+    void unlink(Node* const node)
+    {
+        List* const list = node->list;
+
+        if (node->previous)
+        {
+            node->previous->next = node->next;
+        }
+        else
+        {
+            list->first = node->next;
+        }
+
+        if (node->next)
+        {
+            node->next->previous = node->previous;
+        }
+        else
+        {
+            list->last = node->previous;
+        }
+
+        list->cost -= node->cost;
+    }
+
+private:
+
+    QHash<QString, Node*>       m_nodes;
+    List                        m_window;
+    List                        m_main;
+    qint64                      m_maxCost;
+    LoadingCacheFrequencySketch m_sketch;
+    LoadingCacheStatistics      m_statistics;
+};
+
+// --------------------------------------------------------------------------------------------------------------
+
 class Q_DECL_HIDDEN LoadingCache::Private
 {
 public:
@@ -60,9 +528,9 @@ public:
 
 public:
 
-    QCache<QString, DImg>           imageCache;
-    QCache<QString, QImage>         thumbnailImageCache;
-    QCache<QString, QPixmap>        thumbnailPixmapCache;
+    LoadingCacheSegment<DImg>       imageCache;
+    LoadingCacheSegment<QImage>     thumbnailImageCache;
+    LoadingCacheSegment<QPixmap>    thumbnailPixmapCache;
     QMultiMap<QString, QString>     imageFilePathHash;
     QMultiMap<QString, QString>     thumbnailFilePathHash;
     QMap<QString, LoadingProcess*>  loadingDict;
@@ -184,14 +652,14 @@ LoadingCache::~LoadingCache()
 
 DImg* LoadingCache::retrieveImage(const QString& cacheKey) const
 {
-    return d->imageCache[cacheKey];
+    return d->imageCache.object(cacheKey);
 }
 
 bool LoadingCache::putImage(const QString& cacheKey, DImg* img, const QString& filePath) const
 {
     bool successfulyInserted;
 
-    int cost = img->numBytes();
+    qint64 cost = img->numBytes();
 
     successfulyInserted = d->imageCache.insert(cacheKey, img, cost);
 
@@ -217,7 +685,7 @@ void LoadingCache::removeImages()
 bool LoadingCache::isCacheable(const DImg* img) const
 {
     // return whether image fits in cache
-    return (uint)d->imageCache.maxCost() >= img->numBytes();
+    return d->imageCache.maxCost() >= (qint64)img->numBytes();
 }
 
 void LoadingCache::addLoadingProcess(LoadingProcess* const process)
@@ -247,19 +715,68 @@ void LoadingCache::notifyNewLoadingProcess(LoadingProcess* const process, const
 void LoadingCache::setCacheSize(int megabytes)
 {
     qCDebug(DIGIKAM_GENERAL_LOG) << "Allowing a cache size of" << megabytes << "MB";
-    d->imageCache.setMaxCost(megabytes * 1024 * 1024);
+    setCacheBudget(ImageCache, (qint64)megabytes * 1024 * 1024);
+}
+
+void LoadingCache::setCacheBudget(CacheType type, qint64 bytes)
+{
+    switch (type)
+    {
+        case ImageCache:
+            d->imageCache.setMaxCost(bytes);
+            break;
+        case ThumbnailImageCache:
+            d->thumbnailImageCache.setMaxCost(bytes);
+            break;
+        case ThumbnailPixmapCache:
+            d->thumbnailPixmapCache.setMaxCost(bytes);
+            break;
+    }
+}
+
+qint64 LoadingCache::cacheBudget(CacheType type) const
+{
+    switch (type)
+    {
+        case ThumbnailImageCache:
+            return d->thumbnailImageCache.maxCost();
+        case ThumbnailPixmapCache:
+            return d->thumbnailPixmapCache.maxCost();
+        default:
+            return d->imageCache.maxCost();
+    }
+}
+
+LoadingCacheStatistics LoadingCache::statistics(CacheType type) const
+{
+    switch (type)
+    {
+        case ThumbnailImageCache:
+            return d->thumbnailImageCache.statistics();
+        case ThumbnailPixmapCache:
+            return d->thumbnailPixmapCache.statistics();
+        default:
+            return d->imageCache.statistics();
+    }
+}
+
+void LoadingCache::resetStatistics()
+{
+    d->imageCache.resetStatistics();
+    d->thumbnailImageCache.resetStatistics();
+    d->thumbnailPixmapCache.resetStatistics();
 }
 
 // --- Thumbnails ----
 
 const QImage* LoadingCache::retrieveThumbnail(const QString& cacheKey) const
 {
-    return d->thumbnailImageCache[cacheKey];
+    return d->thumbnailImageCache.object(cacheKey);
 }
 
 const QPixmap* LoadingCache::retrieveThumbnailPixmap(const QString& cacheKey) const
 {
-    return d->thumbnailPixmapCache[cacheKey];
+    return d->thumbnailPixmapCache.object(cacheKey);
 }
 
 bool LoadingCache::hasThumbnailPixmap(const QString& cacheKey) const
@@ -269,7 +786,7 @@ bool LoadingCache::hasThumbnailPixmap(const QString& cacheKey) const
 
 void LoadingCache::putThumbnail(const QString& cacheKey, const QImage& thumb, const QString& filePath)
 {
-    int cost = thumb.byteCount();
+    qint64 cost = thumb.byteCount();
 
     if (d->thumbnailImageCache.insert(cacheKey, new QImage(thumb), cost))
     {
@@ -280,7 +797,7 @@ void LoadingCache::putThumbnail(const QString& cacheKey, const QImage& thumb, co
 
 void LoadingCache::putThumbnail(const QString& cacheKey, const QPixmap& thumb, const QString& filePath)
 {
-    int cost = thumb.width() * thumb.height() * thumb.depth() / 8;
+    qint64 cost = (qint64)thumb.width() * thumb.height() * thumb.depth() / 8;
 
     if (d->thumbnailPixmapCache.insert(cacheKey, new QPixmap(thumb), cost))
     {
@@ -303,8 +820,10 @@ void LoadingCache::removeThumbnails()
 
 void LoadingCache::setThumbnailCacheSize(int numberOfQImages, int numberOfQPixmaps)
 {
-    d->thumbnailImageCache.setMaxCost(numberOfQImages * ThumbnailSize::maxThumbsSize() * ThumbnailSize::maxThumbsSize() * 4);
-    d->thumbnailPixmapCache.setMaxCost(numberOfQPixmaps * ThumbnailSize::maxThumbsSize() * ThumbnailSize::maxThumbsSize() * QPixmap::defaultDepth() / 8);
+    const qint64 pixels = (qint64)ThumbnailSize::maxThumbsSize() * ThumbnailSize::maxThumbsSize();
+
+    setCacheBudget(ThumbnailImageCache,  numberOfQImages  * pixels * 4);
+    setCacheBudget(ThumbnailPixmapCache, numberOfQPixmaps * pixels * QPixmap::defaultDepth() / 8);
 }
 
 void LoadingCache::setFileWatch(LoadingCacheFileWatch* const watch)
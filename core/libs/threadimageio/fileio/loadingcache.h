@@ -127,10 +127,51 @@ protected:
 
 // --------------------------------------------------------------------------------------------------------------
 
+/**
+ * Counters of one part of the LoadingCache, since the last reset.
+ */
+class DIGIKAM_EXPORT LoadingCacheStatistics
+{
+public:
+
+    LoadingCacheStatistics();
+
+    /// Returns the ratio of hits to all lookups, or 0 if there was no lookup
+    double hitRate() const;
+
+public:
+
+    qint64 hits;
+    qint64 misses;
+    qint64 insertions;
+
+    /// Entries not admitted, because the entries they would replace were used more frequently
+    qint64 rejections;
+    qint64 evictions;
+
+    int    count;
+    qint64 usedBytes;
+    qint64 maxBytes;
+};
+
+// --------------------------------------------------------------------------------------------------------------
+
 class DIGIKAM_EXPORT LoadingCache : public QObject
 {
     Q_OBJECT
 
+public:
+
+    /**
+     * The parts of the cache. Each part has its own budget in bytes.
+     */
+    enum CacheType
+    {
+        ImageCache = 0,
+        ThumbnailImageCache,
+        ThumbnailPixmapCache
+    };
+
 public:
 
     static LoadingCache* cache();
@@ -210,6 +251,19 @@ public:
      */
     void setCacheSize(int megabytes);
 
+    /**
+     * Sets the budget in bytes of the given part of the cache.
+     * Entries are evicted if the part exceeds its new budget.
+     */
+    void setCacheBudget(CacheType type, qint64 bytes);
+    qint64 cacheBudget(CacheType type) const;
+
+    /**
+     * Returns the counters of the given part of the cache.
+     */
+    LoadingCacheStatistics statistics(CacheType type) const;
+    void resetStatistics();
+
     // ------- Thumbnail cache -----------------------------------
 
     /// The LoadingCache support both the caching of QImage and QPixmap objects.
@@ -249,7 +303,8 @@ public:
      * Note: The main cache is unaffected by this method,
      *       and setCacheSize takes megabytes as parameter.
      * Note: A good caching strategy will be to set one of the numbers to 0
-     * Default values: (0, 100)
+     * Note: The numbers are converted to budgets in bytes, see setCacheBudget().
+     * Default values: (5, 100)
      */
     void setThumbnailCacheSize(int numberOfQImages, int numberOfQPixmaps);
 
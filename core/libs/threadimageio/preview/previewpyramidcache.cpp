@@ -0,0 +1,557 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-11-10
+ * Description : persistent multi-resolution cache of previews
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "previewpyramidcache.h"
+
+// Qt includes
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QMap>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSet>
+#include <QThreadPool>
+#include <QtConcurrent>    // krazy:exclude=includes
+
+// Local includes
+
+#include "digikam_debug.h"
+#include "filteraction.h"
+#include "iccprofile.h"
+#include "pgfutils.h"
+#include "thumbnailinfo.h"
+
+namespace Digikam
+{
+
+/// Previews with less pixels are fast enough to decode from the original file
+static const qint64 s_minimumPixels = 4000000;
+
+/// PGF quality of the stored previews, see PGFUtils::writePGFImageData(). Lossless,
+/// as the high quality previews are loaded from the cache instead of the original file.
+static const int    s_quality       = 0;
+
+class Q_DECL_HIDDEN PreviewPyramidCache::Private
+{
+public:
+
+    class Entry
+    {
+    public:
+
+        Entry()
+          : size(0),
+            lastUse(0)
+        {
+        }
+
+        qint64 size;
+        qint64 lastUse;
+    };
+
+public:
+
+    explicit Private()
+      : maximumSize(0),
+        currentSize(0),
+        provider(0)
+    {
+        // One encoder at a time, it is a background work
+        pool.setMaxThreadCount(1);
+    }
+
+    QString filePath(const QString& key) const
+    {
+        return (directory + QLatin1Char('/') + key + QLatin1String(".pgf"));
+    }
+
+    /** Returns the name of the cache entry of filePath, or an empty string
+     *  if the file is not accessible. Must be called without the mutex locked,
+     *  as the provider may access the database.
+     */
+    QString key(const QString& filePath, const PreviewSettings& settings,
+                const DRawDecoding& rawDecoding) const;
+
+    /** The methods below are called with the mutex locked.
+     */
+    void insertEntry(const QString& key, const Entry& entry);
+    void removeEntry(const QString& key);
+    void touchEntry(const QString& key);
+
+    /** Removes the least recently used entries until the cache fits in its maximum size.
+     */
+    void evict();
+
+public:
+
+    mutable QMutex              mutex;
+    QString                     directory;
+    qint64                      maximumSize;
+    qint64                      currentSize;
+    ThumbnailInfoProvider*      provider;
+    QHash<QString, Entry>       entries;
+
+    /// The keys of the entries, ordered by last use
+    QMultiMap<qint64, QString>  lru;
+
+    /// Entries which are written right now
+    QSet<QString>               storing;
+
+    QThreadPool                 pool;
+};
+
+QString PreviewPyramidCache::Private::key(const QString& filePath, const PreviewSettings& settings,
+                                          const DRawDecoding& rawDecoding) const
+{
+    QFileInfo info(filePath);
+
+    if (!info.isFile())
+    {
+        return QString();
+    }
+
+    QString base;
+
+    if (provider)
+    {
+        ThumbnailInfo thumbInfo = provider->thumbnailInfo(ThumbnailIdentifier(filePath));
+
+        // The hash in the database is outdated until the modified file is scanned again
+
+        if (!thumbInfo.uniqueHash.isEmpty())
+        {
+            base = thumbInfo.uniqueHash + QLatin1Char('-') + QString::number(thumbInfo.fileSize) +
+                   QLatin1Char('-') + QString::number(info.lastModified().toMSecsSinceEpoch());
+        }
+    }
+
+    if (base.isEmpty())
+    {
+        // Files outside of the collections are identified by path and modification time
+
+        QCryptographicHash md5(QCryptographicHash::Md5);
+        md5.addData(filePath.toUtf8());
+        md5.addData(QByteArray::number(info.lastModified().toMSecsSinceEpoch()));
+        md5.addData(QByteArray::number(info.size()));
+        base = QString::fromLatin1(md5.result().toHex());
+    }
+
+    // The preview of a RAW file depends on the way it is loaded and on the decoding settings
+
+    if (DImg::fileFormat(filePath) == DImg::RAW)
+    {
+        FilterAction action;
+        rawDecoding.writeToFilterAction(action);
+
+        QStringList names = action.parameters().uniqueKeys();
+        names.sort();
+
+        QByteArray  data;
+        QDataStream stream(&data, QIODevice::WriteOnly);
+
+        foreach (const QString& name, names)
+        {
+            stream << name << action.parameters().values(name);
+        }
+
+        base += QLatin1String("-raw") + QString::number(settings.rawLoading) + QLatin1Char('-') +
+                QString::fromLatin1(QCryptographicHash::hash(data, QCryptographicHash::Md5).toHex().left(16));
+    }
+
+    return base;
+}
+
+void PreviewPyramidCache::Private::insertEntry(const QString& key, const Entry& entry)
+{
+    removeEntry(key);
+
+    entries.insert(key, entry);
+    lru.insert(entry.lastUse, key);
+    currentSize += entry.size;
+}
+
+void PreviewPyramidCache::Private::removeEntry(const QString& key)
+{
+    QHash<QString, Entry>::iterator it = entries.find(key);
+
+    if (it == entries.end())
+    {
+        return;
+    }
+
+    lru.remove(it.value().lastUse, key);
+    currentSize -= it.value().size;
+    entries.erase(it);
+}
+
+void PreviewPyramidCache::Private::touchEntry(const QString& key)
+{
+    QHash<QString, Entry>::iterator it = entries.find(key);
+
+    if (it == entries.end())
+    {
+        return;
+    }
+
+    lru.remove(it.value().lastUse, key);
+    it.value().lastUse = QDateTime::currentMSecsSinceEpoch();
+    lru.insert(it.value().lastUse, key);
+}
+
+void PreviewPyramidCache::Private::evict()
+{
+    while (currentSize > maximumSize && !lru.isEmpty())
+    {
+        const QString key = lru.begin().value();
+
+        QFile::remove(filePath(key));
+        removeEntry(key);
+    }
+}
+
+// -----------------------------------------------------------------------------------------------
+
+class Q_DECL_HIDDEN PreviewPyramidCacheCreator
+{
+public:
+
+    PreviewPyramidCache object;
+};
+
+Q_GLOBAL_STATIC(PreviewPyramidCacheCreator, creator)
+
+PreviewPyramidCache* PreviewPyramidCache::instance()
+{
+    return &creator->object;
+}
+
+PreviewPyramidCache::PreviewPyramidCache()
+    : d(new Private)
+{
+}
+
+PreviewPyramidCache::~PreviewPyramidCache()
+{
+    // Wait for the files written in the background
+
+    d->pool.waitForDone();
+
+    delete d->provider;
+    delete d;
+}
+
+void PreviewPyramidCache::initialize(const QString& directory, qint64 maximumSize,
+                                     ThumbnailInfoProvider* const provider)
+{
+    QMutexLocker lock(&d->mutex);
+
+    if (d->provider != provider)
+    {
+        delete d->provider;
+        d->provider = provider;
+    }
+
+    d->directory   = directory;
+    d->maximumSize = maximumSize;
+    d->currentSize = 0;
+    d->entries.clear();
+    d->lru.clear();
+
+    if (!QDir().mkpath(directory))
+    {
+        qCWarning(DIGIKAM_GENERAL_LOG) << "Cannot create preview cache directory" << directory;
+        d->directory.clear();
+        return;
+    }
+
+    QDir dir(directory);
+
+    // Remove the files of interrupted writes
+
+    foreach (const QString& name, dir.entryList(QStringList() << QLatin1String("*.part"), QDir::Files))
+    {
+        dir.remove(name);
+    }
+
+    foreach (const QFileInfo& info, dir.entryInfoList(QStringList() << QLatin1String("*.pgf"), QDir::Files))
+    {
+        Private::Entry entry;
+        entry.size    = info.size();
+        entry.lastUse = qMax(info.lastRead().toMSecsSinceEpoch(), info.lastModified().toMSecsSinceEpoch());
+
+        d->insertEntry(info.completeBaseName(), entry);
+    }
+
+    d->evict();
+
+    qCDebug(DIGIKAM_GENERAL_LOG) << "Preview cache in" << directory << "uses" << d->currentSize / 1048576
+                                 << "of" << maximumSize / 1048576 << "MiB";
+}
+
+void PreviewPyramidCache::clear()
+{
+    QMutexLocker lock(&d->mutex);
+
+    foreach (const QString& key, d->entries.keys())
+    {
+        QFile::remove(d->filePath(key));
+    }
+
+    d->entries.clear();
+    d->lru.clear();
+    d->currentSize = 0;
+    d->directory.clear();
+}
+
+bool PreviewPyramidCache::isEnabled() const
+{
+    QMutexLocker lock(&d->mutex);
+
+    return (!d->directory.isEmpty() && d->maximumSize > 0);
+}
+
+bool PreviewPyramidCache::accepts(const QString& filePath, const PreviewSettings& settings) const
+{
+    // The stored previews have 8 bits per channel
+
+    if (!isEnabled() || !settings.convertToEightBit)
+    {
+        return false;
+    }
+
+    switch (DImg::fileFormat(filePath))
+    {
+        case DImg::NONE:
+        case DImg::JPEG:
+        case DImg::PGF:
+            // Can be decoded at a reduced size already
+            return false;
+
+        case DImg::RAW:
+            // Embedded previews are fast to load
+            return (settings.quality    == PreviewSettings::HighQualityPreview &&
+                    settings.rawLoading != PreviewSettings::RawPreviewFromEmbeddedPreview);
+
+        default:
+            return true;
+    }
+}
+
+bool PreviewPyramidCache::contains(const QString& filePath, const PreviewSettings& settings,
+                                   const DRawDecoding& rawDecoding) const
+{
+    if (!accepts(filePath, settings))
+    {
+        return false;
+    }
+
+    const QString key = d->key(filePath, settings, rawDecoding);
+
+    QMutexLocker lock(&d->mutex);
+
+    return (!key.isEmpty() && d->entries.contains(key));
+}
+
+DImg PreviewPyramidCache::load(const QString& filePath, const PreviewSettings& settings,
+                               const DRawDecoding& rawDecoding, int size) const
+{
+    if (!accepts(filePath, settings))
+    {
+        return DImg();
+    }
+
+    const QString key = d->key(filePath, settings, rawDecoding);
+    QString path;
+
+    {
+        QMutexLocker lock(&d->mutex);
+
+        if (key.isEmpty() || !d->entries.contains(key))
+        {
+            return DImg();
+        }
+
+        d->touchEntry(key);
+        path = d->filePath(key);
+    }
+
+    QImage     image;
+    QByteArray userData;
+
+    if (!PGFUtils::readPGFRegion(image, path, size, QRect(), &userData))
+    {
+        qCDebug(DIGIKAM_GENERAL_LOG) << "Cannot read preview cache file" << path;
+
+        QMutexLocker lock(&d->mutex);
+
+        if (d->entries.contains(key))
+        {
+            d->removeEntry(key);
+            QFile::remove(path);
+        }
+
+        return DImg();
+    }
+
+    bool       hasAlpha = true;
+    QByteArray iccData;
+    QDataStream stream(userData);
+    stream >> hasAlpha >> iccData;
+
+    if (!hasAlpha)
+    {
+        image = image.convertToFormat(QImage::Format_RGB32);
+    }
+
+    DImg img(image);
+
+    if (!iccData.isEmpty())
+    {
+        img.setIccProfile(IccProfile(iccData));
+    }
+
+    return img;
+}
+
+QImage PreviewPyramidCache::loadRegion(const QString& filePath, const PreviewSettings& settings,
+                                       const DRawDecoding& rawDecoding, const QRect& rect, int size) const
+{
+    if (!accepts(filePath, settings))
+    {
+        return QImage();
+    }
+
+    const QString key = d->key(filePath, settings, rawDecoding);
+    QString path;
+
+    {
+        QMutexLocker lock(&d->mutex);
+
+        if (key.isEmpty() || !d->entries.contains(key))
+        {
+            return QImage();
+        }
+
+        d->touchEntry(key);
+        path = d->filePath(key);
+    }
+
+    QImage image;
+
+    if (!PGFUtils::readPGFRegion(image, path, size, rect))
+    {
+        return QImage();
+    }
+
+    return image;
+}
+
+void PreviewPyramidCache::store(const QString& filePath, const PreviewSettings& settings,
+                                const DRawDecoding& rawDecoding, const DImg& image)
+{
+    if (image.isNull() || (qint64)image.width() * image.height() < s_minimumPixels ||
+        !accepts(filePath, settings))
+    {
+        return;
+    }
+
+    const QString key = d->key(filePath, settings, rawDecoding);
+
+    if (key.isEmpty())
+    {
+        return;
+    }
+
+    {
+        QMutexLocker lock(&d->mutex);
+
+        if (d->entries.contains(key) || d->storing.contains(key))
+        {
+            return;
+        }
+
+        d->storing << key;
+    }
+
+    QByteArray userData;
+    QDataStream stream(&userData, QIODevice::WriteOnly);
+    stream << image.hasAlpha() << image.getIccProfile().data();
+
+    // Encoding takes longer than decoding, the caller does not wait for it
+
+    QtConcurrent::run(&d->pool, this, &PreviewPyramidCache::storeFile, key, image.copyQImage(), userData);
+}
+
+void PreviewPyramidCache::storeFile(const QString& key, const QImage& image, const QByteArray& userData)
+{
+    QString path;
+
+    {
+        QMutexLocker lock(&d->mutex);
+
+        if (d->directory.isEmpty())
+        {
+            d->storing.remove(key);
+            return;
+        }
+
+        path = d->filePath(key);
+    }
+
+    // Readers never see a partially written file
+
+    const QString partPath = path + QLatin1String(".part");
+    bool ok                = PGFUtils::writePGFPyramidFile(image, partPath, s_quality, userData);
+
+    if (ok)
+    {
+        QFile::remove(path);
+        ok = QFile::rename(partPath, path);
+    }
+
+    QMutexLocker lock(&d->mutex);
+
+    d->storing.remove(key);
+
+    if (!ok)
+    {
+        qCDebug(DIGIKAM_GENERAL_LOG) << "Cannot write preview cache file" << path;
+        QFile::remove(partPath);
+        return;
+    }
+
+    Private::Entry entry;
+    entry.size    = QFileInfo(path).size();
+    entry.lastUse = QDateTime::currentMSecsSinceEpoch();
+    d->insertEntry(key, entry);
+
+    d->evict();
+}
+
+} // namespace Digikam
@@ -0,0 +1,130 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-11-10
+ * Description : persistent multi-resolution cache of previews
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_PREVIEW_PYRAMID_CACHE_H
+#define DIGIKAM_PREVIEW_PYRAMID_CACHE_H
+
+// Qt includes
+
+#include <QImage>
+#include <QRect>
+#include <QString>
+
+// Local includes
+
+#include "digikam_export.h"
+#include "dimg.h"
+#include "previewsettings.h"
+
+namespace Digikam
+{
+
+class ThumbnailInfoProvider;
+
+/** A disk cache of decoded previews, stored as PGF files with the ROI encoding scheme.
+ *  Each file holds all levels of the image pyramid, and any region of any level
+ *  can be decoded without decoding the rest of the file.
+ *
+ *  Only previews of formats which cannot be decoded at a reduced size (RAW half size
+ *  data, TIFF, PNG...) and which are large enough are stored, with 8 bits per channel.
+ *  The files are identified by the unique hash and the modification time of the original
+ *  file, so that an entry remains valid when the file is moved, and a modified file gets
+ *  a new entry even before it is scanned again. Previews of RAW files are also identified
+ *  by their decoding settings.
+ *
+ *  The cache is disabled until initialize() is called. When it grows over its maximum
+ *  size, the least recently used entries are removed.
+ *
+ *  All methods are thread safe.
+ */
+class DIGIKAM_EXPORT PreviewPyramidCache
+{
+public:
+
+    static PreviewPyramidCache* instance();
+
+    /** Enables the cache in directory, limited to maximumSize bytes.
+     *  The provider, if not null, gives the unique hash of the files
+     *  and is owned by the cache.
+     */
+    void initialize(const QString& directory, qint64 maximumSize,
+                    ThumbnailInfoProvider* const provider = 0);
+
+    /** Removes all files of the cache and disables it.
+     */
+    void clear();
+
+    bool isEnabled() const;
+
+    /** Returns true if the preview of filePath loaded with settings is a candidate
+     *  for the cache, i.e. decoding the original file cannot be done at reduced size.
+     *  Previews with 16 bits per channel are never cached.
+     */
+    bool accepts(const QString& filePath, const PreviewSettings& settings) const;
+
+    /** Returns true if the cache contains the preview of filePath loaded with settings.
+     *  The preview of a RAW file is also identified by the rawDecoding settings.
+     */
+    bool contains(const QString& filePath, const PreviewSettings& settings,
+                  const DRawDecoding& rawDecoding) const;
+
+    /** Loads the preview of filePath from the cache. If size is greater than 0, the
+     *  smallest level of the pyramid at least as large as size is loaded.
+     *  The image has the ICC profile of the stored preview.
+     *  Returns a null image if the preview is not in the cache.
+     */
+    DImg load(const QString& filePath, const PreviewSettings& settings,
+              const DRawDecoding& rawDecoding, int size = 0) const;
+
+    /** Loads the region rect, given in full size coordinates, of the preview of filePath.
+     *  The smallest level at least as large as size is used, see load().
+     *  Only the tiles of this level intersecting rect are decoded.
+     */
+    QImage loadRegion(const QString& filePath, const PreviewSettings& settings,
+                      const DRawDecoding& rawDecoding, const QRect& rect, int size = 0) const;
+
+    /** Stores the preview of filePath, as decoded with settings and rawDecoding, in a background
+     *  thread. Nothing is done if the cache does not accept the preview or if image is too small.
+     *  The pixels are stored without loss, a preview loaded from the cache is the decoded one.
+     */
+    void store(const QString& filePath, const PreviewSettings& settings,
+               const DRawDecoding& rawDecoding, const DImg& image);
+
+private:
+
+    PreviewPyramidCache();
+    ~PreviewPyramidCache();
+
+    void storeFile(const QString& key, const QImage& image, const QByteArray& iccData);
+
+private:
+
+    friend class PreviewPyramidCacheCreator;
+
+    class Private;
+    Private* const d;
+};
+
+} // namespace Digikam
+
+#endif // DIGIKAM_PREVIEW_PYRAMID_CACHE_H
@@ -42,6 +42,7 @@
 #include "jpegutils.h"
 #include "metaenginesettings.h"
 #include "previewloadthread.h"
+#include "previewpyramidcache.h"
 
 namespace Digikam
 {
@@ -155,10 +156,15 @@ void PreviewLoadingTask::execute()
     {
         // Preview is not in cache, we will load image from file.
 
-        DImg::FORMAT format      = DImg::fileFormat(m_loadingDescription.filePath);
-        m_fromRawEmbeddedPreview = false;
+        DImg::FORMAT format         = DImg::fileFormat(m_loadingDescription.filePath);
+        m_fromRawEmbeddedPreview    = false;
+        const bool fromPyramidCache = loadPyramidCachePreview();
 
-        if (format == DImg::RAW)
+        if (fromPyramidCache)
+        {
+            qCDebug(DIGIKAM_GENERAL_LOG) << "Preview of" << m_loadingDescription.filePath << "loaded from the preview cache";
+        }
+        else if (format == DImg::RAW)
         {
             MetaEnginePreviews previews(m_loadingDescription.filePath);
             // Check original image size using Exiv2.
@@ -297,6 +303,17 @@ void PreviewLoadingTask::execute()
             }
         }
 
+        // Keep a full size preview for the next time, if the file cannot be decoded at reduced size.
+
+        if (!fromPyramidCache && !m_fromRawEmbeddedPreview && !m_img.isNull() && continueQuery() &&
+            m_loadingDescription.previewParameters.previewSettings.quality != PreviewSettings::FastPreview)
+        {
+            PreviewPyramidCache::instance()->store(m_loadingDescription.filePath,
+                                                   m_loadingDescription.previewParameters.previewSettings,
+                                                   m_loadingDescription.rawDecodingSettings,
+                                                   m_img);
+        }
+
         LoadingCache::CacheLock lock(cache);
 
         // Put valid image into cache of loaded images
@@ -531,6 +548,39 @@ void PreviewLoadingTask::convertQImageToDImg()
     m_qimage = QImage();
 }
 
+bool PreviewLoadingTask::loadPyramidCachePreview()
+{
+    PreviewPyramidCache* const pyramidCache = PreviewPyramidCache::instance();
+    const PreviewSettings& settings         = m_loadingDescription.previewParameters.previewSettings;
+
+    if (!continueQuery() || !pyramidCache->accepts(m_loadingDescription.filePath, settings))
+    {
+        return false;
+    }
+
+    // For a fast preview, only the level of the pyramid matching the preview area is decoded
+
+    const int size = (settings.quality == PreviewSettings::FastPreview) ? m_loadingDescription.previewParameters.size : 0;
+    DImg img       = pyramidCache->load(m_loadingDescription.filePath, settings,
+                                        m_loadingDescription.rawDecodingSettings, size);
+
+    if (img.isNull())
+    {
+        return false;
+    }
+
+    m_img               = img;
+    DImg::FORMAT format = DImg::fileFormat(m_loadingDescription.filePath);
+    m_img.setAttribute(QLatin1String("detectedFileFormat"), format);
+    m_img.setAttribute(QLatin1String("originalFilePath"),   m_loadingDescription.filePath);
+
+    DMetadata metadata(m_loadingDescription.filePath);
+    m_img.setAttribute(QLatin1String("originalSize"),       metadata.getPixelSize());
+    m_img.setMetadata(metadata.data());
+
+    return true;
+}
+
 bool PreviewLoadingTask::loadImagePreview(int sizeLimit)
 {
     DMetadata metadata(m_loadingDescription.filePath);
@@ -56,6 +56,7 @@ private:
     bool loadHalfSizeRaw();
     bool needToScale();
     bool loadImagePreview(int sizeLimit = -1);
+    bool loadPyramidCachePreview();
     void convertQImageToDImg();
 
 private:
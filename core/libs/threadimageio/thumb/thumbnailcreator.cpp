@@ -387,6 +387,68 @@ void ThumbnailCreator::store(const QString& path, const QImage& i) const
     store(path, i, QRect());
 }
 
+void ThumbnailCreator::store(const QString& path, const DImg& i) const
+{
+    if (i.isNull())
+    {
+        return;
+    }
+
+    DImg thumb;
+
+    if ((int)i.width() > d->storageSize() || (int)i.height() > d->storageSize())
+    {
+        thumb = i.smoothScale(d->storageSize(), d->storageSize(), Qt::KeepAspectRatio);
+    }
+    else
+    {
+        thumb = i.copy();
+    }
+
+    ThumbnailInfo info = makeThumbnailInfo(ThumbnailIdentifier(path), QRect());
+    QVariant attribute = thumb.attribute(QLatin1String("fromRawEmbeddedPreview"));
+    int orientation    = exifOrientation(info, DMetadata(thumb.getMetadata()),
+                                         (attribute.isValid() && attribute.toBool()), false);
+
+    // The thumbnails are stored unrotated in the database and rotated in the freedesktop directories
+
+    if (LoadSaveThread::wasExifRotated(thumb) &&
+        (d->thumbnailStorage == ThumbnailDatabase || !d->exifRotate))
+    {
+        LoadSaveThread::reverseExifRotate(thumb, path);
+    }
+    else if (!LoadSaveThread::wasExifRotated(thumb) &&
+             d->thumbnailStorage == FreeDesktopStandard && d->exifRotate)
+    {
+        LoadSaveThread::exifRotate(thumb, path);
+    }
+
+    ThumbnailImage image;
+    image.qimage          = thumb.copyQImage();
+    image.exifOrientation = orientation;
+
+    if (IccSettings::instance()->useManagedPreviews() && !thumb.getIccProfile().isNull())
+    {
+        IccManager::transformToSRGB(image.qimage, thumb.getIccProfile());
+    }
+
+    switch (d->thumbnailStorage)
+    {
+        case ThumbnailDatabase:
+
+            // we must call isInDatabase or loadFromDatabase before storeInDatabase for d->dbIdForReplacement!
+            if (!isInDatabase(info))
+            {
+                storeInDatabase(info, image);
+            }
+
+            break;
+        case FreeDesktopStandard:
+            storeFreedesktop(info, image);
+            break;
+    }
+}
+
 void ThumbnailCreator::storeDetailThumbnail(const QString& path, const QRect& detailRect, const QImage& i) const
 {
     store(path, i, detailRect);
@@ -628,15 +690,42 @@ QImage ThumbnailCreator::loadImageDetail(const ThumbnailInfo& info, const DMetad
     DImg img;
     //TODO: scaledLoading if detailRect is large
     //TODO: use code from PreviewTask, including cache storage
+    int orientation     = exifOrientation(info, metadata, false, false);
+    DImg::FORMAT format = DImg::fileFormat(path);
+
+    if (format == DImg::JPEG || format == DImg::TIFF || format == DImg::PNG || format == DImg::JP2K)
+    {
+        // These loaders skip most of the data outside of the detail. The rect refers to the oriented image,
+        // it is mapped to the image as stored, whose size is read from the file header.
+
+        QRect storedDetail = detailRect;
+
+        if (orientation != DMetadata::ORIENTATION_NORMAL && orientation != DMetadata::ORIENTATION_UNSPECIFIED)
+        {
+            DImg header;
+            header.loadItemInfo(path, false, false, false, false);
+            storedDetail = header.size().isValid() ? TagRegion::mapToStoredOrientation(detailRect, header.size(), orientation)
+                                                   : QRect();
+        }
+
+        if (storedDetail.isValid() &&
+            img.loadRegion(path, storedDetail, 0, false, profile ? true : false, d->observer, d->fastRawSettings))
+        {
+            if (profile)
+                *profile = img.getIccProfile();
+
+            img.rotateAndFlip(orientation);
+            return img.copyQImage();
+        }
+    }
+
     img.load(path, false, profile ? true : false, false, false, d->observer, d->fastRawSettings);
 
     if (profile)
         *profile = img.getIccProfile();
 
     // We must rotate before clipping because the rect refers to the oriented image.
-    // I do not know currently how to back-rotate the rect for clipping before rotation.
-    // If someone has the mathematics, have a go.
-    img.rotateAndFlip(exifOrientation(info, metadata, false, false));
+    img.rotateAndFlip(orientation);
 
     QRect mappedDetail = TagRegion::mapFromOriginalSize(img, detailRect);
     img.crop(mappedDetail.intersected(QRect(0, 0, img.width(), img.height())));
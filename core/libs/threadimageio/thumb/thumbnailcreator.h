@@ -41,6 +41,7 @@
 namespace Digikam
 {
 
+class DImg;
 class IccProfile;
 class DImgLoaderObserver;
 class DMetadata;
@@ -149,6 +150,14 @@ public:
      */
     void store(const QString& path, const QImage& image) const;
 
+    /**
+     * Store a thumbnail of the given path created from image, a preview
+     * of the file already loaded by the caller. The image is scaled down
+     * to storedSize(), color managed and rotated as the stored thumbnails,
+     * whether it was exif rotated when loaded or not.
+     */
+    void store(const QString& path, const DImg& image) const;
+
     void storeDetailThumbnail(const QString& path, const QRect& detailRect, const QImage& image) const;
 
     /**
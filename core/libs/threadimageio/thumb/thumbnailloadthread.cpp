@@ -915,6 +915,11 @@ void ThumbnailLoadThread::storeDetailThumbnail(const QString& filePath, const QR
     d->creator->storeDetailThumbnail(filePath, detailRect, image);
 }
 
+void ThumbnailLoadThread::storeThumbnail(const QString& filePath, const DImg& image)
+{
+    d->creator->store(filePath, image);
+}
+
 int ThumbnailLoadThread::storedSize() const
 {
     return d->creator->storedSize();
@@ -220,6 +220,15 @@ public:
     void storeDetailThumbnail(const QString& filePath, const QRect& detailRect, const QImage& image, bool isFace = false);
     int  storedSize() const;
 
+    /**
+     * Stores a thumbnail of filePath created from image, a preview of the file
+     * already loaded, for example by PreviewLoadThread. This avoids a second
+     * decoding of the file when the caller needs the image for another purpose.
+     * The image should at least have storedSize(). An existing thumbnail
+     * is kept, call deleteThumbnail() before to replace it.
+     */
+    void storeThumbnail(const QString& filePath, const DImg& image);
+
     /**
      * This is a tool to force regeneration of thumbnails.
      * All thumbnail files for the given file will be removed from disk,
@@ -27,14 +27,16 @@
 
 // Qt includes
 
+#include <QList>
+#include <QMultiMap>
 #include <QMutexLocker>
 #include <QWaitCondition>
 #include <QMutex>
-#include <QThreadPool>
 
 // Local includes
 
 #include "digikam_debug.h"
+#include "jobscheduler.h"
 
 namespace Digikam
 {
@@ -61,32 +63,106 @@ void ActionJob::cancel()
 
 class Q_DECL_HIDDEN ActionThreadBase::Private
 {
+public:
+
+    /** Runs a job on the JobScheduler and releases its place when done.
+     */
+    class Q_DECL_HIDDEN JobRunnable : public QRunnable
+    {
+    public:
+
+        explicit JobRunnable(ActionJob* const job, ActionThreadBase::Private* const d)
+            : job(job),
+              d(d)
+        {
+            setAutoDelete(true);
+        }
+
+        virtual void run()
+        {
+            {
+                QMutexLocker lock(&d->mutex);
+                d->scheduled.removeOne(this);
+            }
+
+            job->run();
+
+            QMutexLocker lock(&d->mutex);
+            --d->runningJobs;
+            d->condVarJobs.wakeAll();
+        }
+
+    private:
+
+        ActionJob* const                 job;
+        ActionThreadBase::Private* const d;
+    };
+
 public:
 
     explicit Private()
     {
-        running = false;
-        pool    = 0;
+        running        = false;
+        maximumThreads = 1;
+        runningJobs    = 0;
+        priorityClass  = JobScheduler::BatchClass;
     }
 
-    volatile bool       running;
+    /** Takes the job of todo with the highest priority, the oldest one first
+     *  between jobs of the same priority. Called with the mutex locked.
+     */
+    ActionJob* takeNextJob(int* const priority)
+    {
+        // QMultiMap inserts a value before the values of the same key,
+        // the last item is the oldest job of the highest priority.
+
+        QMultiMap<int, ActionJob*>::iterator next = todo.end();
+        --next;
+
+        ActionJob* const job = next.value();
+        *priority            = next.key();
+        todo.erase(next);
+
+        return job;
+    }
+
+    /** Deletes the jobs of todo, which were never started. Called with the mutex locked.
+     */
+    void clearTodo()
+    {
+        foreach(ActionJob* const job, todo)
+        {
+            delete job;
+        }
+
+        todo.clear();
+    }
+
+public:
+
+    volatile bool                 running;
+
+    QWaitCondition                condVarJobs;
+    QMutex                        mutex;
 
-    QWaitCondition      condVarJobs;
-    QMutex              mutex;
+    /// The jobs not started yet, ordered by priority
+    QMultiMap<int, ActionJob*>    todo;
+    ActionJobCollection           pending;
+    ActionJobCollection           processed;
 
-    ActionJobCollection todo;
-    ActionJobCollection pending;
-    ActionJobCollection processed;
+    /// The jobs started on the JobScheduler which did not return yet
+    int                           maximumThreads;
+    int                           runningJobs;
+    JobScheduler::PriorityClass   priorityClass;
 
-    QThreadPool*        pool;
+    /// The runnables queued on the JobScheduler which did not start yet
+    QList<QRunnable*>             scheduled;
 };
 
 ActionThreadBase::ActionThreadBase(QObject* const parent)
     : QThread(parent),
       d(new Private)
 {
-    d->pool = new QThreadPool(this);
-
     defaultMaximumNumberOfThreads();
 }
 
@@ -98,14 +174,32 @@ ActionThreadBase::~ActionThreadBase()
     wait();
 
     //wait for the jobs to finish
-    d->pool->waitForDone();
-
-    // Cleanup all jobs from memory
-    foreach(ActionJob* const job, d->todo.keys())
     {
-        delete(job);
+        QMutexLocker lock(&d->mutex);
+
+        // The jobs still queued on the scheduler would only start after
+        // the jobs of the other instances, do not wait for them.
+
+        foreach (QRunnable* const runnable, d->scheduled)
+        {
+            if (JobScheduler::instance()->unschedule(runnable))
+            {
+                delete runnable;
+                --d->runningJobs;
+            }
+        }
+
+        d->scheduled.clear();
+
+        while (d->runningJobs)
+        {
+            d->condVarJobs.wait(&d->mutex);
+        }
     }
 
+    // Cleanup all jobs from memory
+    d->clearTodo();
+
     foreach(ActionJob* const job, d->pending.keys())
     {
         delete(job);
@@ -121,21 +215,34 @@ ActionThreadBase::~ActionThreadBase()
 
 void ActionThreadBase::setMaximumNumberOfThreads(int n)
 {
-    d->pool->setMaxThreadCount(n);
+    QMutexLocker lock(&d->mutex);
+    d->maximumThreads = qMax(n, 1);
+    d->condVarJobs.wakeAll();
     qCDebug(DIGIKAM_GENERAL_LOG) << "Using " << n << " CPU core to run threads";
 }
 
 int ActionThreadBase::maximumNumberOfThreads() const
 {
-    return d->pool->maxThreadCount();
+    return d->maximumThreads;
 }
 
 void ActionThreadBase::defaultMaximumNumberOfThreads()
 {
-    const int maximumNumberOfThreads = qMax(QThread::idealThreadCount(), 1);
+    const int maximumNumberOfThreads = JobScheduler::instance()->threadCount();
     setMaximumNumberOfThreads(maximumNumberOfThreads);
 }
 
+void ActionThreadBase::setPriorityClass(JobScheduler::PriorityClass priorityClass)
+{
+    QMutexLocker lock(&d->mutex);
+    d->priorityClass = priorityClass;
+}
+
+JobScheduler::PriorityClass ActionThreadBase::priorityClass() const
+{
+    return d->priorityClass;
+}
+
 void ActionThreadBase::slotJobFinished()
 {
     ActionJob* const job = dynamic_cast<ActionJob*>(sender());
@@ -165,7 +272,7 @@ void ActionThreadBase::cancel()
     qCDebug(DIGIKAM_GENERAL_LOG) << "Cancel Main Thread";
     QMutexLocker lock(&d->mutex);
 
-    d->todo.clear();
+    d->clearTodo();
 
     foreach(ActionJob* const job, d->pending.keys())
     {
@@ -181,12 +288,12 @@ void ActionThreadBase::cancel()
 
 bool ActionThreadBase::isEmpty() const
 {
-    return d->pending.isEmpty();
+    return (d->todo.isEmpty() && d->pending.isEmpty());
 }
 
 int ActionThreadBase::pendingCount() const
 {
-    return d->pending.count();
+    return (d->todo.count() + d->pending.count());
 }
 
 void ActionThreadBase::appendJobs(const ActionJobCollection& jobs)
@@ -195,7 +302,7 @@ void ActionThreadBase::appendJobs(const ActionJobCollection& jobs)
 
     for (ActionJobCollection::const_iterator it = jobs.begin() ; it != jobs.end(); ++it)
     {
-        d->todo.insert(it.key(), it.value());
+        d->todo.insert(it.value(), it.key());
     }
 
     d->condVarJobs.wakeAll();
@@ -209,23 +316,29 @@ void ActionThreadBase::run()
     {
         QMutexLocker lock(&d->mutex);
 
-        if (!d->todo.isEmpty())
+        // The jobs share the threads of the JobScheduler with the other instances,
+        // but no more than maximumNumberOfThreads() jobs of this instance run at once.
+
+        if (!d->todo.isEmpty() && d->runningJobs < d->maximumThreads)
         {
             qCDebug(DIGIKAM_GENERAL_LOG) << "Action Thread run " << d->todo.count() << " new jobs";
 
-            for (ActionJobCollection::iterator it = d->todo.begin() ; it != d->todo.end(); ++it)
+            while (!d->todo.isEmpty() && d->runningJobs < d->maximumThreads)
             {
-                ActionJob* const job = it.key();
-                int priority         = it.value();
+                int priority         = 0;
+                ActionJob* const job = d->takeNextJob(&priority);
 
                 connect(job, SIGNAL(signalDone()),
                         this, SLOT(slotJobFinished()));
 
-                d->pool->start(job, priority);
                 d->pending.insert(job, priority);
-            }
+                ++d->runningJobs;
+
+                QRunnable* const runnable = new Private::JobRunnable(job, d);
+                d->scheduled << runnable;
 
-            d->todo.clear();
+                JobScheduler::instance()->schedule(runnable, d->priorityClass);
+            }
         }
         else
         {
@@ -35,6 +35,7 @@
 // Local includes
 
 #include "digikam_export.h"
+#include "jobscheduler.h"
 
 namespace Digikam
 {
@@ -46,7 +47,7 @@ class DIGIKAM_EXPORT ActionJob : public QObject,
 
 public:
 
-    /** Constructor which delegate deletion of QRunnable instance to ActionThreadBase, not QThreadPool.
+    /** Constructor which delegate deletion of QRunnable instance to ActionThreadBase, not JobScheduler.
      */
     ActionJob();
 
@@ -98,7 +99,7 @@ public:
     explicit ActionThreadBase(QObject* const parent=0);
     virtual ~ActionThreadBase();
 
-    /** Adjust maximum number of threads used to parallelize collection of job processing.
+    /** Adjust maximum number of jobs of this instance running at once on the JobScheduler.
      */
     void setMaximumNumberOfThreads(int n);
 
@@ -106,11 +107,17 @@ public:
      */
     int  maximumNumberOfThreads() const;
 
-    /** Reset maximum number of threads used to parallelize collection of job processing to max core detected on computer.
+    /** Reset maximum number of threads used to parallelize collection of job processing to the threads of the JobScheduler.
      *  This method is called in contructor.
      */
     void defaultMaximumNumberOfThreads();
 
+    /** Set the priority class of the jobs on the JobScheduler, shared by all instances.
+     *  The default is JobScheduler::BatchClass.
+     */
+    void setPriorityClass(JobScheduler::PriorityClass priorityClass);
+    JobScheduler::PriorityClass priorityClass() const;
+
     /** Cancel processing of current jobs under progress.
      */
     void cancel();
@@ -121,8 +128,8 @@ protected:
      */
     void run();
 
-    /** Append a collection of jobs to process into QThreadPool.
-     *  Jobs are add to pending lists and will be deleted by ActionThreadBase, not QThreadPool.
+    /** Append a collection of jobs to process on the JobScheduler.
+     *  Jobs are add to pending lists and will be deleted by ActionThreadBase, not JobScheduler.
      */
     void appendJobs(const ActionJobCollection& jobs);
 
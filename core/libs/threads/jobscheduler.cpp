@@ -0,0 +1,388 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-11-10
+ * Description : Shared job scheduler with priority classes
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "jobscheduler.h"
+
+// Qt includes
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <QWaitCondition>
+
+// Local includes
+
+#include "digikam_debug.h"
+
+namespace Digikam
+{
+
+class Q_DECL_HIDDEN JobScheduler::Worker : public QThread
+{
+public:
+
+    explicit Worker(JobScheduler::Private* const d, int index)
+        : d(d),
+          index(index)
+    {
+    }
+
+    virtual void run();
+
+public:
+
+    JobScheduler::Private* const d;
+    const int                    index;
+
+    /// The jobs queued from this thread, protected by the mutex of the scheduler
+    QList<QRunnable*>            queues[NumberOfPriorityClasses];
+};
+
+// -----------------------------------------------------------------------------------------------
+
+class Q_DECL_HIDDEN JobScheduler::Private
+{
+public:
+
+    explicit Private()
+      : running(true),
+        busy(0)
+    {
+        uptime.start();
+    }
+
+    /** Returns the worker of the current thread, or 0.
+     */
+    Worker* currentWorker() const
+    {
+        foreach (Worker* const worker, workers)
+        {
+            if (worker == QThread::currentThread())
+            {
+                return worker;
+            }
+        }
+
+        return 0;
+    }
+
+    /** Returns true if a job of priorityClass can start now. Called with the mutex locked.
+     */
+    bool canStart(int priorityClass) const
+    {
+        // Each running external work of a higher class takes the place of one thread
+
+        int load = busy;
+
+        for (int c = 0 ; c < priorityClass ; ++c)
+        {
+            load += counters[c].external;
+        }
+
+        // The lower classes leave one thread to the interactive jobs, which would
+        // otherwise wait until a long batch job is done
+
+        int threads = workers.size();
+
+        if (priorityClass != InteractiveClass)
+        {
+            threads = qMax(threads - 1, 1);
+        }
+
+        return (busy == 0 || load < threads);
+    }
+
+    /** Takes the next job for worker, or returns 0. Called with the mutex locked.
+     */
+    QRunnable* takeJob(Worker* const worker, int* const priorityClass)
+    {
+        for (int c = 0 ; c < NumberOfPriorityClasses ; ++c)
+        {
+            if (!counters[c].queued || !canStart(c))
+            {
+                continue;
+            }
+
+            *priorityClass = c;
+
+            if (!worker->queues[c].isEmpty())
+            {
+                return worker->queues[c].takeLast();
+            }
+
+            if (!queues[c].isEmpty())
+            {
+                return queues[c].takeFirst();
+            }
+
+            for (int i = 1 ; i < workers.size() ; ++i)
+            {
+                Worker* const victim = workers.at((worker->index + i) % workers.size());
+
+                if (!victim->queues[c].isEmpty())
+                {
+                    return victim->queues[c].takeFirst();
+                }
+            }
+        }
+
+        return 0;
+    }
+
+    void run(Worker* const worker);
+
+public:
+
+    QList<Worker*>     workers;
+    QElapsedTimer      uptime;
+
+    /// Protects all following members and the queues of the workers
+    mutable QMutex     mutex;
+    QWaitCondition     condVar;
+    bool               running;
+    int                busy;
+    QList<QRunnable*>  queues[NumberOfPriorityClasses];
+    Counters           counters[NumberOfPriorityClasses];
+};
+
+void JobScheduler::Private::run(Worker* const worker)
+{
+    // Lower classes run with a lower thread priority than the user interface
+
+    const QThread::Priority threadPriorities[NumberOfPriorityClasses] =
+    {
+        QThread::NormalPriority,
+        QThread::NormalPriority,
+        QThread::LowPriority
+    };
+
+    forever
+    {
+        QRunnable* job    = 0;
+        int priorityClass = 0;
+
+        {
+            QMutexLocker lock(&mutex);
+
+            while (running && !(job = takeJob(worker, &priorityClass)))
+            {
+                condVar.wait(&mutex);
+            }
+
+            if (!running)
+            {
+                return;
+            }
+
+            --counters[priorityClass].queued;
+            ++counters[priorityClass].running;
+            ++busy;
+        }
+
+        worker->setPriority(threadPriorities[priorityClass]);
+
+        QElapsedTimer timer;
+        timer.start();
+
+        const bool autoDelete = job->autoDelete();
+        job->run();
+
+        if (autoDelete)
+        {
+            delete job;
+        }
+
+        {
+            QMutexLocker lock(&mutex);
+
+            --counters[priorityClass].running;
+            ++counters[priorityClass].finished;
+            counters[priorityClass].busyTime += timer.elapsed();
+            --busy;
+
+            // A thread waiting for a lower class can start now
+
+            condVar.wakeAll();
+        }
+    }
+}
+
+void JobScheduler::Worker::run()
+{
+    d->run(this);
+}
+
+// -----------------------------------------------------------------------------------------------
+
+class Q_DECL_HIDDEN JobSchedulerCreator
+{
+public:
+
+    JobScheduler object;
+};
+
+Q_GLOBAL_STATIC(JobSchedulerCreator, creator)
+
+JobScheduler* JobScheduler::instance()
+{
+    return &creator->object;
+}
+
+JobScheduler::JobScheduler()
+    : d(new Private)
+{
+    const int count = qMax(QThread::idealThreadCount(), 1);
+
+    for (int i = 0 ; i < count ; ++i)
+    {
+        d->workers << new Worker(d, i);
+    }
+
+    foreach (Worker* const worker, d->workers)
+    {
+        worker->start();
+    }
+
+    qCDebug(DIGIKAM_GENERAL_LOG) << "Job scheduler uses" << count << "threads";
+}
+
+JobScheduler::~JobScheduler()
+{
+    {
+        QMutexLocker lock(&d->mutex);
+        d->running = false;
+        d->condVar.wakeAll();
+    }
+
+    foreach (Worker* const worker, d->workers)
+    {
+        worker->wait();
+    }
+
+    // Jobs which did not run are dropped
+
+    for (int c = 0 ; c < NumberOfPriorityClasses ; ++c)
+    {
+        QList<QRunnable*> jobs = d->queues[c];
+
+        foreach (Worker* const worker, d->workers)
+        {
+            jobs << worker->queues[c];
+        }
+
+        foreach (QRunnable* const job, jobs)
+        {
+            if (job->autoDelete())
+            {
+                delete job;
+            }
+        }
+    }
+
+    qDeleteAll(d->workers);
+    delete d;
+}
+
+int JobScheduler::threadCount() const
+{
+    return d->workers.size();
+}
+
+void JobScheduler::schedule(QRunnable* const runnable, PriorityClass priorityClass)
+{
+    QMutexLocker lock(&d->mutex);
+
+    Worker* const worker = d->currentWorker();
+
+    if (worker)
+    {
+        worker->queues[priorityClass] << runnable;
+    }
+    else
+    {
+        d->queues[priorityClass] << runnable;
+    }
+
+    ++d->counters[priorityClass].queued;
+    d->condVar.wakeOne();
+}
+
+bool JobScheduler::unschedule(QRunnable* const runnable)
+{
+    QMutexLocker lock(&d->mutex);
+
+    for (int c = 0 ; c < NumberOfPriorityClasses ; ++c)
+    {
+        bool removed = d->queues[c].removeOne(runnable);
+
+        foreach (Worker* const worker, d->workers)
+        {
+            removed = removed || worker->queues[c].removeOne(runnable);
+        }
+
+        if (removed)
+        {
+            --d->counters[c].queued;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void JobScheduler::beginExternalWork(PriorityClass priorityClass)
+{
+    QMutexLocker lock(&d->mutex);
+    ++d->counters[priorityClass].external;
+}
+
+void JobScheduler::endExternalWork(PriorityClass priorityClass)
+{
+    QMutexLocker lock(&d->mutex);
+    --d->counters[priorityClass].external;
+    d->condVar.wakeAll();
+}
+
+JobScheduler::Counters JobScheduler::counters(PriorityClass priorityClass) const
+{
+    QMutexLocker lock(&d->mutex);
+    return d->counters[priorityClass];
+}
+
+double JobScheduler::utilization(PriorityClass priorityClass) const
+{
+    const qint64 available = d->uptime.elapsed() * d->workers.size();
+
+    if (available <= 0)
+    {
+        return 0.0;
+    }
+
+    QMutexLocker lock(&d->mutex);
+
+    return qMin(1.0, (double)d->counters[priorityClass].busyTime / (double)available);
+}
+
+} // namespace Digikam
@@ -0,0 +1,154 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-11-10
+ * Description : Shared job scheduler with priority classes
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_JOB_SCHEDULER_H
+#define DIGIKAM_JOB_SCHEDULER_H
+
+// Qt includes
+
+#include <QRunnable>
+#include <QtGlobal>
+
+// Local includes
+
+#include "digikam_export.h"
+
+namespace Digikam
+{
+
+/**
+ * Runs the jobs of all ActionThreadBase instances on one set of threads,
+ * one per core, instead of one thread pool per instance.
+ *
+ * A job queued from a thread of the scheduler goes to the queue of this
+ * thread, which takes its own jobs in last-in first-out order. An idle
+ * thread takes the oldest job of the shared queue, or steals the oldest
+ * job of another thread. Jobs of a higher priority class always run first.
+ * Jobs of the lower classes never take the last free thread, which stays
+ * available for the interactive jobs.
+ *
+ * Work running outside of the scheduler, as DynamicThread, can be
+ * registered with beginExternalWork(): while it runs, one less thread
+ * of the scheduler takes jobs of a lower class.
+ */
+class DIGIKAM_EXPORT JobScheduler
+{
+public:
+
+    /** The priority classes, from highest to lowest priority.
+     */
+    enum PriorityClass
+    {
+        InteractiveClass = 0,    ///< Thumbnails, previews and views the user waits for
+        EditorClass,             ///< Image editor operations
+        BatchClass,              ///< Batch queue manager, maintenance tools and other long jobs
+
+        NumberOfPriorityClasses
+    };
+
+    /** Counters of one priority class.
+     */
+    class Counters
+    {
+    public:
+
+        explicit Counters()
+          : queued(0),
+            running(0),
+            external(0),
+            finished(0),
+            busyTime(0)
+        {
+        }
+
+        /// Number of jobs waiting in the queues
+        int    queued;
+
+        /// Number of jobs running on the threads of the scheduler
+        int    running;
+
+        /// Number of external work running, see beginExternalWork()
+        int    external;
+
+        /// Number of jobs finished since the start
+        qint64 finished;
+
+        /// Time in milliseconds spent by the threads of the scheduler on jobs
+        qint64 busyTime;
+    };
+
+public:
+
+    static JobScheduler* instance();
+
+    /** Returns the number of threads running jobs.
+     */
+    int      threadCount() const;
+
+    /** Queues runnable in priorityClass. If runnable->autoDelete() is true,
+     *  the runnable is deleted when it has run.
+     */
+    void     schedule(QRunnable* const runnable, PriorityClass priorityClass);
+
+    /** Removes runnable from the queues if it did not start yet and returns true.
+     *  The runnable is not deleted then, even if runnable->autoDelete() is true.
+     *  Returns false if the runnable already started or finished.
+     */
+    bool     unschedule(QRunnable* const runnable);
+
+    /** Registers work of priorityClass which runs on another thread.
+     *  Each call must be followed by a call to endExternalWork().
+     */
+    void     beginExternalWork(PriorityClass priorityClass);
+    void     endExternalWork(PriorityClass priorityClass);
+
+    /** Returns the current counters of priorityClass.
+     */
+    Counters counters(PriorityClass priorityClass) const;
+
+    /** Returns the part of the time of all threads of the scheduler spent on
+     *  jobs of priorityClass since the start, between 0.0 and 1.0.
+     */
+    double   utilization(PriorityClass priorityClass) const;
+
+private:
+
+    explicit JobScheduler();
+    ~JobScheduler();
+
+    // Disable
+    JobScheduler(const JobScheduler&);
+    JobScheduler& operator=(const JobScheduler&);
+
+private:
+
+    friend class JobSchedulerCreator;
+
+    class Worker;
+    class Private;
+    Private* const d;
+};
+
+} // namespace Digikam
+
+#endif // DIGIKAM_JOB_SCHEDULER_H
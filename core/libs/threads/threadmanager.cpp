@@ -37,6 +37,7 @@
 
 #include "digikam_debug.h"
 #include "dynamicthread.h"
+#include "jobscheduler.h"
 #include "workerobject.h"
 
 namespace Digikam
@@ -211,6 +212,43 @@ void WorkerObjectRunnable::run()
 
 // -------------------------------------------------------------------------------------------------
 
+/** Runs a DynamicThread, registered as interactive work on the JobScheduler: thumbnails,
+ *  previews and editor filters. A DynamicThread only runs while it has something to do.
+ */
+class Q_DECL_HIDDEN InteractiveWorkRunnable : public QRunnable
+{
+public:
+
+    explicit InteractiveWorkRunnable(QRunnable* const runnable)
+        : runnable(runnable)
+    {
+        setAutoDelete(true);
+    }
+
+protected:
+
+    virtual void run()
+    {
+        JobScheduler::instance()->beginExternalWork(JobScheduler::InteractiveClass);
+
+        const bool autoDelete = runnable->autoDelete();
+        runnable->run();
+
+        if (autoDelete)
+        {
+            delete runnable;
+        }
+
+        JobScheduler::instance()->endExternalWork(JobScheduler::InteractiveClass);
+    }
+
+protected:
+
+    QRunnable* const runnable;
+};
+
+// -------------------------------------------------------------------------------------------------
+
 class Q_DECL_HIDDEN ThreadManager::Private
 {
 public:
@@ -283,7 +321,7 @@ void ThreadManager::schedule(WorkerObject* object)
 
 void ThreadManager::schedule(QRunnable* runnable)
 {
-    d->pool->start(runnable);
+    d->pool->start(new InteractiveWorkRunnable(runnable));
 }
 
 void ThreadManager::slotDestroyed(QObject*)
@@ -0,0 +1,503 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-11-10
+ * Description : a test for the collection scanner
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "collectionscannertest.h"
+
+// Qt includes
+
+#include <QTest>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QStandardPaths>
+
+// Local includes
+
+#include "coredb.h"
+#include "coredbalbuminfo.h"
+#include "collectionmanager.h"
+#include "collectionscanner.h"
+#include "collectionscannerobserver.h"
+#include "metaengine.h"
+#include "metaenginesettings.h"
+
+using namespace Digikam;
+
+QTEST_GUILESS_MAIN(CollectionScannerTest)
+
+const QString IMAGE_PATH(QFINDTESTDATA("data/testimages/"));
+
+/** Records the throughput reported by the scanner.
+ */
+class ThroughputObserver : public CollectionScannerObserver
+{
+public:
+
+    ThroughputObserver()
+        : filesScanned(0),
+          msecs(0),
+          reports(0)
+    {
+    }
+
+    bool continueQuery()
+    {
+        return true;
+    }
+
+    void scanThroughput(int files, int elapsed)
+    {
+        filesScanned = files;
+        msecs        = elapsed;
+        ++reports;
+    }
+
+public:
+
+    int filesScanned;
+    int msecs;
+    int reports;
+};
+
+void CollectionScannerTest::initTestCase()
+{
+    m_ready = false;
+
+    QStandardPaths::setTestModeEnabled(true);
+    MetaEngine::initializeExiv2();
+
+    // The rating of the identical files is read from a sidecar
+
+    MetaEngineSettingsContainer settings = MetaEngineSettings::instance()->settings();
+    settings.useXMPSidecar4Reading       = true;
+    MetaEngineSettings::instance()->setSettings(settings);
+
+    if (!initBaseTestCase())
+    {
+        return;
+    }
+
+    QVERIFY(QDir(tempPath()).mkdir(QLatin1String("album")));
+    QVERIFY(QFile::copy(IMAGE_PATH + QLatin1String("a1/jpg/foto001.jpg"),
+                        albumPath() + QLatin1String("/foto001.jpg")));
+    QVERIFY(QFile::copy(IMAGE_PATH + QLatin1String("a1/png/snap001.png"),
+                        albumPath() + QLatin1String("/snap001.png")));
+
+    {
+        CoreDbAccess access;
+        addTestAlbumRoot(access);
+    }
+
+    CollectionManager::instance()->refresh();
+    m_ready = !CollectionManager::instance()->allAvailableLocations().isEmpty();
+}
+
+void CollectionScannerTest::cleanupTestCase()
+{
+    cleanupBaseTestCase();
+    MetaEngine::cleanupExiv2();
+}
+
+QString CollectionScannerTest::albumPath() const
+{
+    return tempPath() + QLatin1String("/album");
+}
+
+qlonglong CollectionScannerTest::imageId(const QString& fileName) const
+{
+    return imageId(QLatin1String("/album"), fileName);
+}
+
+qlonglong CollectionScannerTest::imageId(const QString& album, const QString& fileName) const
+{
+    CoreDbAccess access;
+    const int albumRootId = CollectionManager::instance()->allAvailableLocations().first().id();
+    const int albumId     = access.db()->getAlbumForPath(albumRootId, album, false);
+
+    if (albumId == -1)
+    {
+        return -1;
+    }
+
+    return access.db()->getImageId(albumId, fileName);
+}
+
+void CollectionScannerTest::testNewFiles()
+{
+    if (!m_ready)
+    {
+        QSKIP("The test collection cannot be created");
+    }
+
+    CollectionScanner scanner;
+    scanner.completeScan();
+
+    QVERIFY(imageId(QLatin1String("foto001.jpg")) > 0);
+    QVERIFY(imageId(QLatin1String("snap001.png")) > 0);
+}
+
+void CollectionScannerTest::testModifiedInPlace()
+{
+    if (!m_ready)
+    {
+        QSKIP("The test collection cannot be created");
+    }
+
+    const QString filePath = albumPath() + QLatin1String("/foto001.jpg");
+    const qlonglong id     = imageId(QLatin1String("foto001.jpg"));
+    QVERIFY(id > 0);
+
+    const ItemScanInfo before = CoreDbAccess().db()->getItemScanInfo(id);
+    QCOMPARE(before.fileSize, QFileInfo(filePath).size());
+
+    // An editor saving the file in place does not add, remove or rename an entry of the album
+
+    const QDateTime albumDate = QFileInfo(albumPath()).lastModified();
+
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Append));
+    QVERIFY(file.write(QByteArray(4096, '\0')) == 4096);
+    file.close();
+
+    QCOMPARE(QFileInfo(albumPath()).lastModified(), albumDate);
+
+    // The complete scan of the startup compares all files, not only the albums
+
+    CollectionScanner scanner;
+    scanner.completeScan();
+
+    const ItemScanInfo after = CoreDbAccess().db()->getItemScanInfo(id);
+
+    QCOMPARE(imageId(QLatin1String("foto001.jpg")), id);
+    QCOMPARE(after.fileSize, QFileInfo(filePath).size());
+    QVERIFY(after.fileSize != before.fileSize);
+    QVERIFY(after.uniqueHash != before.uniqueHash);
+}
+
+bool CollectionScannerTest::createAlbum(const QString& album, int copies) const
+{
+    // Some files in the album and in two subalbums, one of them ignored by the scan
+
+    const QStringList sources = QStringList() << QLatin1String("a1/jpg/foto001.jpg")
+                                              << QLatin1String("a1/png/snap001.png")
+                                              << QLatin1String("a2/icc-test-farbkreis.jpg");
+    const QStringList subdirs = QStringList() << QString() << QLatin1String("/sub") << QLatin1String("/@eaDir");
+
+    foreach (const QString& subdir, subdirs)
+    {
+        const QString path = tempPath() + album + subdir;
+
+        if (!QDir().mkpath(path))
+        {
+            return false;
+        }
+
+        for (int i = 0; i < copies; ++i)
+        {
+            foreach (const QString& source, sources)
+            {
+                QFileInfo info(source);
+
+                if (!QFile::copy(IMAGE_PATH + source,
+                                 path + QString::fromLatin1("/%1-%2.%3").arg(info.baseName()).arg(i).arg(info.suffix())))
+                {
+                    return false;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+void CollectionScannerTest::testParallelScan_data()
+{
+    QTest::addColumn<bool>("parallel");
+
+    QTest::newRow("sequential") << false;
+    QTest::newRow("parallel")   << true;
+}
+
+void CollectionScannerTest::testParallelScan()
+{
+    if (!m_ready)
+    {
+        QSKIP("The test collection cannot be created");
+    }
+
+    QFETCH(bool, parallel);
+
+    const int copies    = 10;
+    const QString album = parallel ? QLatin1String("/parallel") : QLatin1String("/sequential");
+    QVERIFY(createAlbum(album, copies));
+
+    ThroughputObserver observer;
+    CollectionScanner  scanner;
+    scanner.setObserver(&observer);
+    scanner.setParallelScanning(parallel);
+
+    QBENCHMARK_ONCE
+    {
+        scanner.completeScan();
+    }
+
+    // Every album reports the files scanned since the start, at least the new files
+
+    QVERIFY(observer.reports > 0);
+    QVERIFY(observer.filesScanned >= 2 * 3 * copies);
+    QVERIFY(observer.msecs >= 0);
+
+    qDebug() << (parallel ? "Parallel" : "Sequential") << "scan:" << observer.filesScanned << "files in"
+             << observer.msecs << "msecs";
+
+    for (int i = 0; i < copies; ++i)
+    {
+        const QString name = QString::fromLatin1("foto001-%1.jpg").arg(i);
+
+        QVERIFY(imageId(album, name) > 0);
+        QVERIFY(imageId(album + QLatin1String("/sub"), name) > 0);
+        QCOMPARE(imageId(album + QLatin1String("/@eaDir"), name), -1LL);
+    }
+
+    if (!parallel)
+    {
+        return;
+    }
+
+    // The parallel scan gives the same entries as the sequential scan
+
+    CoreDbAccess access;
+
+    foreach (const QString& subdir, QStringList() << QString() << QLatin1String("/sub"))
+    {
+        const QStringList names = QDir(tempPath() + album + subdir).entryList(QDir::Files, QDir::Name);
+        QCOMPARE(names.size(), 3 * copies);
+
+        foreach (const QString& name, names)
+        {
+            const qlonglong sequentialId = imageId(QLatin1String("/sequential") + subdir, name);
+            const qlonglong parallelId   = imageId(album + subdir, name);
+            QVERIFY(sequentialId > 0);
+            QVERIFY(parallelId   > 0);
+
+            const ItemScanInfo sequential = access.db()->getItemScanInfo(sequentialId);
+            const ItemScanInfo scanned    = access.db()->getItemScanInfo(parallelId);
+
+            QCOMPARE(scanned.itemName,   sequential.itemName);
+            QCOMPARE(scanned.category,   sequential.category);
+            QCOMPARE(scanned.fileSize,   sequential.fileSize);
+            QCOMPARE(scanned.uniqueHash, sequential.uniqueHash);
+        }
+    }
+}
+
+QByteArray CollectionScannerTest::testFileData(const QString& trailer) const
+{
+    // The trailer appended to the image changes the unique hash, not the image
+
+    QFile source(IMAGE_PATH + QLatin1String("a1/jpg/foto001.jpg"));
+
+    if (!source.open(QIODevice::ReadOnly))
+    {
+        return QByteArray();
+    }
+
+    return source.readAll() + trailer.toLatin1();
+}
+
+bool CollectionScannerTest::writeTestFile(const QString& filePath, const QByteArray& data, bool withRating) const
+{
+    QFile file(filePath);
+
+    if (data.isEmpty() || !file.open(QIODevice::WriteOnly) || (file.write(data) != data.size()))
+    {
+        return false;
+    }
+
+    file.close();
+
+    if (!withRating)
+    {
+        return true;
+    }
+
+    QFile sidecar(MetaEngine::sidecarPath(filePath));
+
+    if (!sidecar.open(QIODevice::WriteOnly))
+    {
+        return false;
+    }
+
+    sidecar.write("<?xpacket begin=\"\" id=\"W5M0MpCehiHzreSzNTczkc9d\"?>\n"
+                  "<x:xmpmeta xmlns:x=\"adobe:ns:meta/\">\n"
+                  " <rdf:RDF xmlns:rdf=\"http://www.w3.org/1999/02/22-rdf-syntax-ns#\">\n"
+                  "  <rdf:Description rdf:about=\"\" xmlns:xmp=\"http://ns.adobe.com/xap/1.0/\" xmp:Rating=\"4\"/>\n"
+                  " </rdf:RDF>\n"
+                  "</x:xmpmeta>\n"
+                  "<?xpacket end=\"w\"?>\n");
+
+    return true;
+}
+
+bool CollectionScannerTest::createIdenticalFiles(const QString& album, int copies) const
+{
+    // Identical copies of one image, only the first one has a sidecar with a rating.
+    // The album name appended to the data makes the files differ from those of the other albums.
+
+    const QByteArray data = testFileData(album);
+    const QString path    = tempPath() + album;
+
+    if (!QDir().mkpath(path))
+    {
+        return false;
+    }
+
+    for (int i = 0; i < copies; ++i)
+    {
+        if (!writeTestFile(path + QString::fromLatin1("/copy-%1.jpg").arg(i, 3, 10, QLatin1Char('0')), data, (i == 0)))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int CollectionScannerTest::rating(qlonglong id) const
+{
+    const QVariantList values = CoreDbAccess().db()->getItemInformation(id, DatabaseFields::Rating);
+
+    return values.isEmpty() ? -2 : values.first().toInt();
+}
+
+void CollectionScannerTest::testIdenticalFiles_data()
+{
+    QTest::addColumn<bool>("parallel");
+
+    QTest::newRow("sequential") << false;
+    QTest::newRow("parallel")   << true;
+}
+
+void CollectionScannerTest::testIdenticalFiles()
+{
+    if (!m_ready)
+    {
+        QSKIP("The test collection cannot be created");
+    }
+
+    QFETCH(bool, parallel);
+
+    // The parallel scan writes new files in batches. A file identical to a file
+    // of the same batch is still recognized and copies the attributes of the first file.
+
+    const int copies    = 5;
+    const QString album = parallel ? QLatin1String("/identical-parallel") : QLatin1String("/identical-sequential");
+    QVERIFY(createIdenticalFiles(album, copies));
+
+    CollectionScanner scanner;
+    scanner.setParallelScanning(parallel);
+    scanner.completeScan();
+
+    const QStringList names = QDir(tempPath() + album).entryList(QStringList() << QLatin1String("*.jpg"),
+                                                                 QDir::Files, QDir::Name);
+    QCOMPARE(names.size(), copies);
+
+    CoreDbAccess access;
+
+    foreach (const QString& name, names)
+    {
+        const qlonglong id = imageId(album, name);
+        QVERIFY(id > 0);
+
+        QCOMPARE(rating(id), 4);
+
+        if (!parallel)
+        {
+            continue;
+        }
+
+        // Same entries as the sequential scan, apart from the data which makes the albums differ
+
+        const qlonglong sequentialId  = imageId(QLatin1String("/identical-sequential"), name);
+        QVERIFY(sequentialId > 0);
+
+        const ItemScanInfo sequential = access.db()->getItemScanInfo(sequentialId);
+        const ItemScanInfo scanned    = access.db()->getItemScanInfo(id);
+
+        QCOMPARE(scanned.itemName, sequential.itemName);
+        QCOMPARE(scanned.category, sequential.category);
+        QCOMPARE(rating(id),       rating(sequentialId));
+        QCOMPARE(access.db()->getItemTagIDs(id).size(), access.db()->getItemTagIDs(sequentialId).size());
+    }
+}
+
+void CollectionScannerTest::testIdenticalFilesAcrossBatches()
+{
+    if (!m_ready)
+    {
+        QSKIP("The test collection cannot be created");
+    }
+
+    // More distinct files than fit in one batch and in the window of files loaded ahead,
+    // followed by copies of some of them. The copy of a file from a written batch
+    // and the copy of a file from the pending batch are both recognized.
+
+    const int files     = 120;
+    const QString album = QLatin1String("/identical-batches");
+    const QString path  = tempPath() + album;
+    QVERIFY(QDir().mkpath(path));
+
+    for (int i = 0; i < files; ++i)
+    {
+        const QByteArray data = testFileData(album + QString::number(i));
+        const bool copied     = (i % 10 == 0);
+
+        QVERIFY(writeTestFile(path + QString::fromLatin1("/a-%1.jpg").arg(i, 3, 10, QLatin1Char('0')), data, copied));
+
+        if (copied)
+        {
+            QVERIFY(writeTestFile(path + QString::fromLatin1("/b-%1.jpg").arg(i, 3, 10, QLatin1Char('0')), data, false));
+        }
+    }
+
+    CollectionScanner scanner;
+    scanner.setParallelScanning(true);
+    scanner.completeScan();
+
+    for (int i = 0; i < files; ++i)
+    {
+        const qlonglong id = imageId(album, QString::fromLatin1("a-%1.jpg").arg(i, 3, 10, QLatin1Char('0')));
+        QVERIFY(id > 0);
+
+        if (i % 10 != 0)
+        {
+            continue;
+        }
+
+        const qlonglong copyId = imageId(album, QString::fromLatin1("b-%1.jpg").arg(i, 3, 10, QLatin1Char('0')));
+        QVERIFY(copyId > 0);
+
+        QCOMPARE(rating(id),     4);
+        QCOMPARE(rating(copyId), 4);
+    }
+}
@@ -0,0 +1,69 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-11-10
+ * Description : a test for the collection scanner
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_COLLECTION_SCANNER_TEST_H
+#define DIGIKAM_COLLECTION_SCANNER_TEST_H
+
+// Qt includes
+
+#include <QByteArray>
+
+// Local includes
+
+#include "dbabstracttest.h"
+
+class CollectionScannerTest : public DatabaseAbstractTest
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void initTestCase();
+    void cleanupTestCase();
+
+    void testNewFiles();
+    void testModifiedInPlace();
+    void testParallelScan();
+    void testParallelScan_data();
+    void testIdenticalFiles();
+    void testIdenticalFiles_data();
+    void testIdenticalFilesAcrossBatches();
+
+private:
+
+    QString   albumPath()                      const;
+    qlonglong imageId(const QString& fileName) const;
+    qlonglong imageId(const QString& album, const QString& fileName) const;
+    bool      createAlbum(const QString& album, int copies) const;
+    bool      createIdenticalFiles(const QString& album, int copies) const;
+    int       rating(qlonglong id)                                   const;
+
+    QByteArray testFileData(const QString& trailer)                                          const;
+    bool       writeTestFile(const QString& filePath, const QByteArray& data, bool withRating) const;
+
+private:
+
+    bool m_ready;
+};
+
+#endif // DIGIKAM_COLLECTION_SCANNER_TEST_H
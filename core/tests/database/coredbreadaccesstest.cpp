@@ -0,0 +1,183 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-11-10
+ * Description : Benchmark of album listings while the core database is written
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "coredbreadaccesstest.h"
+
+// Qt includes
+
+#include <QTest>
+#include <QAtomicInt>
+#include <QDateTime>
+#include <QFuture>
+#include <QtConcurrent>    // krazy:exclude=includes
+
+// Local includes
+
+#include "coredb.h"
+#include "coredbaccess.h"
+#include "coredbbackend.h"
+#include "coredbtransaction.h"
+
+using namespace Digikam;
+
+QTEST_GUILESS_MAIN(CoreDbReadAccessTest)
+
+/** Number of items in the listed album, the order of magnitude of a large collection.
+ */
+static const int s_numberOfItems = 50000;
+
+/** Number of items changed by each transaction of the writer.
+ */
+static const int s_itemsPerTransaction = 200;
+
+static const QString s_listingQuery = QLatin1String("SELECT Images.id, Images.name, ImageInformation.rating "
+                                                    " FROM Images "
+                                                    "   LEFT JOIN ImageInformation ON Images.id=ImageInformation.imageid "
+                                                    " WHERE Images.status=1 AND Images.album=?;");
+
+template <class Access>
+static int listAlbum(int albumId)
+{
+    QList<QVariant> values;
+    Access access;
+    access.backend()->execSql(s_listingQuery, albumId, &values);
+
+    return values.size() / 3;
+}
+
+static int writeItems(QAtomicInt* const stop)
+{
+    // Changes the ratings in short transactions, like the scanner and the metadata hub do
+    int transactions = 0;
+
+    do
+    {
+        CoreDbAccess access;
+        CoreDbTransaction transaction(&access);
+
+        for (int i = 0 ; i < s_itemsPerTransaction ; ++i)
+        {
+            const qlonglong id = 1 + (transactions * s_itemsPerTransaction + i) % s_numberOfItems;
+            access.db()->changeItemInformation(id, QVariantList() << (transactions % 6), DatabaseFields::Rating);
+        }
+
+        ++transactions;
+    }
+    while (!stop->load());
+
+    return transactions;
+}
+
+void CoreDbReadAccessTest::initTestCase()
+{
+    m_albumId = -1;
+    m_ready   = false;
+
+    if (!initBaseTestCase())
+    {
+        return;
+    }
+
+    const QDateTime date = testDate();
+
+    CoreDbAccess access;
+    CoreDbTransaction transaction(&access);
+
+    const int rootId = addTestAlbumRoot(access);
+    m_albumId        = access.db()->addAlbum(rootId, QLatin1String("/"), QString(), date.date(), QString());
+
+    for (int i = 0 ; i < s_numberOfItems ; ++i)
+    {
+        const qlonglong id = access.db()->addItem(m_albumId, QString::fromLatin1("image%1.jpg").arg(i),
+                                                  DatabaseItem::Visible, DatabaseItem::Image,
+                                                  date, 1000 + i, QString::number(i));
+
+        access.db()->addItemInformation(id, QVariantList() << (i % 6), DatabaseFields::Rating);
+    }
+
+    m_ready = true;
+}
+
+void CoreDbReadAccessTest::cleanupTestCase()
+{
+    cleanupBaseTestCase();
+}
+
+void CoreDbReadAccessTest::testListing()
+{
+    if (!m_ready)
+    {
+        QSKIP("The test database cannot be created");
+    }
+
+    QCOMPARE(listAlbum<CoreDbAccess>(m_albumId),     s_numberOfItems);
+    QCOMPARE(listAlbum<CoreDbReadAccess>(m_albumId), s_numberOfItems);
+
+    // A read access nests in a write access of the same thread, and the other way round
+
+    {
+        CoreDbAccess access;
+        QCOMPARE(listAlbum<CoreDbReadAccess>(m_albumId), s_numberOfItems);
+    }
+
+    {
+        CoreDbReadAccess access;
+        QCOMPARE(listAlbum<CoreDbAccess>(m_albumId), s_numberOfItems);
+    }
+}
+
+void CoreDbReadAccessTest::testListingWhileWriting_data()
+{
+    QTest::addColumn<bool>("concurrent");
+
+    QTest::newRow("CoreDbAccess")     << false;
+    QTest::newRow("CoreDbReadAccess") << true;
+}
+
+void CoreDbReadAccessTest::testListingWhileWriting()
+{
+    if (!m_ready)
+    {
+        QSKIP("The test database cannot be created");
+    }
+
+    QFETCH(bool, concurrent);
+
+    // With CoreDbAccess, each listing waits for the writer to leave its transaction.
+    // With CoreDbReadAccess, the listing reads the last committed state meanwhile.
+
+    QAtomicInt stop(0);
+    QFuture<int> writer = QtConcurrent::run(writeItems, &stop);
+    int count           = 0;
+
+    QBENCHMARK
+    {
+        count = concurrent ? listAlbum<CoreDbReadAccess>(m_albumId)
+                           : listAlbum<CoreDbAccess>(m_albumId);
+    }
+
+    stop.store(1);
+
+    QVERIFY(writer.result() > 0);
+    QCOMPARE(count, s_numberOfItems);
+}
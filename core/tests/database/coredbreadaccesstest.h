@@ -0,0 +1,50 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-11-10
+ * Description : Benchmark of album listings while the core database is written
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_CORE_DB_READ_ACCESS_TEST_H
+#define DIGIKAM_CORE_DB_READ_ACCESS_TEST_H
+
+// Local includes
+
+#include "dbabstracttest.h"
+
+class CoreDbReadAccessTest : public DatabaseAbstractTest
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void initTestCase();
+    void cleanupTestCase();
+
+    void testListing();
+    void testListingWhileWriting();
+    void testListingWhileWriting_data();
+
+private:
+
+    int  m_albumId;
+    bool m_ready;
+};
+
+#endif // DIGIKAM_CORE_DB_READ_ACCESS_TEST_H
@@ -0,0 +1,83 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-11-10
+ * Description : base class of the tests using a temporary core database
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "dbabstracttest.h"
+
+// Qt includes
+
+#include <QUrl>
+#include <QUrlQuery>
+#include <QDebug>
+
+// Local includes
+
+#include "coredb.h"
+#include "dbengineparameters.h"
+
+QDateTime DatabaseAbstractTest::testDate()
+{
+    return QDateTime(QDate(2018, 11, 10), QTime(12, 0));
+}
+
+bool DatabaseAbstractTest::initBaseTestCase()
+{
+    if (!m_tempDir.isValid())
+    {
+        qWarning() << "Cannot create a temporary directory for the test database";
+        return false;
+    }
+
+    DbEngineParameters params;
+    params.databaseType = DbEngineParameters::SQLiteDatabaseType();
+    params.setCoreDatabasePath(m_tempDir.path() + QLatin1String("/digikam-core-test.db"));
+    params.setThumbsDatabasePath(m_tempDir.path() + QLatin1String("/digikam-thumbs-test.db"));
+    params.setFaceDatabasePath(m_tempDir.path() + QLatin1String("/digikam-faces-test.db"));
+    params.legacyAndDefaultChecks();
+    CoreDbAccess::setParameters(params, CoreDbAccess::MainApplication);
+
+    return CoreDbAccess::checkReadyForUse();
+}
+
+void DatabaseAbstractTest::cleanupBaseTestCase()
+{
+    CoreDbAccess::cleanUpDatabase();
+}
+
+int DatabaseAbstractTest::addTestAlbumRoot(CoreDbAccess& access) const
+{
+    // An identifier with the path only, as CollectionManager adds it when Solid does not find a volume
+    QUrl url;
+    url.setScheme(QLatin1String("volumeid"));
+
+    QUrlQuery q(url);
+    q.addQueryItem(QLatin1String("path"), m_tempDir.path());
+    url.setQuery(q);
+
+    return access.db()->addAlbumRoot(AlbumRoot::VolumeHardWired, url.url(),
+                                     QLatin1String("/"), QLatin1String("Test"));
+}
+
+QString DatabaseAbstractTest::tempPath() const
+{
+    return m_tempDir.path();
+}
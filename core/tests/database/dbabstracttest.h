@@ -0,0 +1,69 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-11-10
+ * Description : base class of the tests using a temporary core database
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_DATABASE_ABSTRACT_TEST_H
+#define DIGIKAM_DATABASE_ABSTRACT_TEST_H
+
+// Qt includes
+
+#include <QObject>
+#include <QDateTime>
+#include <QTemporaryDir>
+
+// Local includes
+
+#include "coredbaccess.h"
+
+using namespace Digikam;
+
+class DatabaseAbstractTest : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    /** The creation and modification date of all test items.
+     */
+    static QDateTime testDate();
+
+protected:
+
+    /** Sets up a SQLite core database in a temporary directory.
+     *  Returns false if the database cannot be opened and the schema created.
+     */
+    bool initBaseTestCase();
+    void cleanupBaseTestCase();
+
+    /** Adds an album root on the temporary directory and returns its id.
+     *  The collection is available after CollectionManager::refresh().
+     */
+    int addTestAlbumRoot(CoreDbAccess& access) const;
+
+    QString tempPath() const;
+
+private:
+
+    QTemporaryDir m_tempDir;
+};
+
+#endif // DIGIKAM_DATABASE_ABSTRACT_TEST_H
@@ -0,0 +1,219 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-11-10
+ * Description : Benchmark of the prepared statement cache of the database backend
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "dbenginequerycachetest.h"
+
+// Qt includes
+
+#include <QTest>
+#include <QDateTime>
+
+// Local includes
+
+#include "coredb.h"
+#include "coredbaccess.h"
+#include "coredbbackend.h"
+#include "coredbtransaction.h"
+
+using namespace Digikam;
+
+QTEST_GUILESS_MAIN(DbEngineQueryCacheTest)
+
+/** Number of albums, and number of items in each album, of the test database.
+ */
+static const int s_numberOfAlbums  = 200;
+static const int s_itemsPerAlbum   = 50;
+
+/** Number of items added by each run of the addItem() benchmark.
+ */
+static const int s_numberOfAdded   = 2000;
+
+static void addItems(CoreDbAccess& access, int albumId, int count)
+{
+    for (int i = 0 ; i < count ; ++i)
+    {
+        access.db()->addItem(albumId, QString::fromLatin1("image%1.jpg").arg(i),
+                             DatabaseItem::Visible, DatabaseItem::Image,
+                             DatabaseAbstractTest::testDate(), 1000 + i, QString::fromLatin1("%1-%2").arg(albumId).arg(i));
+    }
+}
+
+void DbEngineQueryCacheTest::initTestCase()
+{
+    m_albumRootId = -1;
+    m_addedAlbums = 0;
+    m_ready       = false;
+
+    if (!initBaseTestCase())
+    {
+        return;
+    }
+
+    CoreDbAccess access;
+    CoreDbTransaction transaction(&access);
+
+    m_albumRootId = addTestAlbumRoot(access);
+
+    for (int i = 0 ; i < s_numberOfAlbums ; ++i)
+    {
+        const int albumId = access.db()->addAlbum(m_albumRootId, QString::fromLatin1("/album%1").arg(i),
+                                                  QString(), testDate().date(), QString());
+        addItems(access, albumId, s_itemsPerAlbum);
+        m_albumIds << albumId;
+    }
+
+    m_ready = true;
+}
+
+void DbEngineQueryCacheTest::cleanupTestCase()
+{
+    cleanupBaseTestCase();
+}
+
+void DbEngineQueryCacheTest::testResults()
+{
+    if (!m_ready)
+    {
+        QSKIP("The test database cannot be created");
+    }
+
+    CoreDbAccess access;
+
+    access.backend()->setQueryCacheEnabled(false);
+    const QList<ItemScanInfo> reference = access.db()->getItemScanInfos(m_albumIds.first());
+    access.backend()->setQueryCacheEnabled(true);
+
+    QCOMPARE(reference.size(), s_itemsPerAlbum);
+
+    // The second call takes the statement from the cache
+
+    for (int pass = 0 ; pass < 2 ; ++pass)
+    {
+        const int hits                  = access.backend()->queryCacheHits();
+        const QList<ItemScanInfo> infos = access.db()->getItemScanInfos(m_albumIds.first());
+
+        QCOMPARE(infos.size(), reference.size());
+
+        for (int i = 0 ; i < infos.size() ; ++i)
+        {
+            QCOMPARE(infos.at(i).id,         reference.at(i).id);
+            QCOMPARE(infos.at(i).itemName,   reference.at(i).itemName);
+            QCOMPARE(infos.at(i).uniqueHash, reference.at(i).uniqueHash);
+        }
+
+        if (pass)
+        {
+            QVERIFY(access.backend()->queryCacheHits() > hits);
+        }
+    }
+}
+
+void DbEngineQueryCacheTest::testSchemaChange()
+{
+    if (!m_ready)
+    {
+        QSKIP("The test database cannot be created");
+    }
+
+    CoreDbAccess access;
+    access.db()->getItemScanInfos(m_albumIds.first());
+
+    // The cached statements are dropped, the next call prepares the statement again
+
+    access.backend()->execDirectSql(QLatin1String("CREATE TABLE QueryCacheTest (id INTEGER PRIMARY KEY);"));
+
+    const int misses = access.backend()->queryCacheMisses();
+    QCOMPARE(access.db()->getItemScanInfos(m_albumIds.first()).size(), s_itemsPerAlbum);
+    QVERIFY(access.backend()->queryCacheMisses() > misses);
+
+    access.backend()->execDirectSql(QLatin1String("DROP TABLE QueryCacheTest;"));
+}
+
+void DbEngineQueryCacheTest::testAddItem_data()
+{
+    QTest::addColumn<bool>("cached");
+
+    QTest::newRow("without cache") << false;
+    QTest::newRow("with cache")    << true;
+}
+
+void DbEngineQueryCacheTest::testAddItem()
+{
+    if (!m_ready)
+    {
+        QSKIP("The test database cannot be created");
+    }
+
+    QFETCH(bool, cached);
+
+    CoreDbAccess access;
+    access.backend()->setQueryCacheEnabled(cached);
+
+    QBENCHMARK
+    {
+        // Like the collection scanner, which adds the items of an album in a transaction
+        CoreDbTransaction transaction(&access);
+        const int albumId = access.db()->addAlbum(m_albumRootId, QString::fromLatin1("/added%1").arg(m_addedAlbums++),
+                                                  QString(), testDate().date(), QString());
+        addItems(access, albumId, s_numberOfAdded);
+    }
+
+    access.backend()->setQueryCacheEnabled(true);
+}
+
+void DbEngineQueryCacheTest::testGetItemScanInfos_data()
+{
+    QTest::addColumn<bool>("cached");
+
+    QTest::newRow("without cache") << false;
+    QTest::newRow("with cache")    << true;
+}
+
+void DbEngineQueryCacheTest::testGetItemScanInfos()
+{
+    if (!m_ready)
+    {
+        QSKIP("The test database cannot be created");
+    }
+
+    QFETCH(bool, cached);
+
+    CoreDbAccess access;
+    access.backend()->setQueryCacheEnabled(cached);
+
+    int count = 0;
+
+    QBENCHMARK
+    {
+        count = 0;
+
+        foreach (int albumId, m_albumIds)
+        {
+            count += access.db()->getItemScanInfos(albumId).size();
+        }
+    }
+
+    access.backend()->setQueryCacheEnabled(true);
+
+    QCOMPARE(count, s_numberOfAlbums * s_itemsPerAlbum);
+}
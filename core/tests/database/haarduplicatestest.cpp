@@ -0,0 +1,203 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-11-10
+ * Description : Duplicates search in parallel compared to the sequential search
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "haarduplicatestest.h"
+
+// Qt includes
+
+#include <QTest>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+
+// Local includes
+
+#include "coredb.h"
+#include "collectionmanager.h"
+#include "collectionscanner.h"
+#include "dbengineparameters.h"
+#include "haariface.h"
+#include "metaengine.h"
+#include "similaritydbaccess.h"
+
+using namespace Digikam;
+
+QTEST_GUILESS_MAIN(HaarDuplicatesTest)
+
+const QString IMAGE_PATH(QFINDTESTDATA("data/testimages/"));
+
+typedef QMap<double, QMap<qlonglong, QList<qlonglong> > > DuplicatesResults;
+
+void HaarDuplicatesTest::initTestCase()
+{
+    m_ready = false;
+
+    MetaEngine::initializeExiv2();
+
+    if (!initBaseTestCase())
+    {
+        return;
+    }
+
+    DbEngineParameters params = CoreDbAccess::parameters();
+    params.setSimilarityDatabasePath(tempPath() + QLatin1String("/digikam-similarity-test.db"));
+    SimilarityDbAccess::setParameters(params.similarityParameters());
+
+    if (!SimilarityDbAccess::checkReadyForUse(0))
+    {
+        return;
+    }
+
+    QVERIFY(createAlbum());
+
+    {
+        CoreDbAccess access;
+        addTestAlbumRoot(access);
+    }
+
+    CollectionManager::instance()->refresh();
+
+    if (CollectionManager::instance()->allAvailableLocations().isEmpty())
+    {
+        return;
+    }
+
+    CollectionScanner scanner;
+    scanner.completeScan();
+
+    // Index the signatures of all items of the album
+
+    const int albumRootId = CollectionManager::instance()->allAvailableLocations().first().id();
+    const int albumId     = CoreDbAccess().db()->getAlbumForPath(albumRootId, QLatin1String("/album"), false);
+    QVERIFY(albumId != -1);
+
+    const QString path    = tempPath() + QLatin1String("/album/");
+    HaarIface haarIface;
+
+    foreach (const QString& name, QDir(path).entryList(QDir::Files, QDir::Name))
+    {
+        const qlonglong imageId = CoreDbAccess().db()->getImageId(albumId, name);
+        QVERIFY(imageId > 0);
+
+        QVERIFY(haarIface.indexImage(imageId, QImage(path + name)));
+        m_imageIds << imageId;
+    }
+
+    m_ready = (m_imageIds.count() > 0);
+}
+
+void HaarDuplicatesTest::cleanupTestCase()
+{
+    SimilarityDbAccess::cleanUpDatabase();
+    cleanupBaseTestCase();
+    MetaEngine::cleanupExiv2();
+}
+
+bool HaarDuplicatesTest::createAlbum() const
+{
+    // Exact copies and similar versions of some images, and images without duplicates
+
+    const QStringList sources = QStringList() << QLatin1String("a1/jpg/foto001.jpg")
+                                              << QLatin1String("a1/jpg/foto001bw.jpg")
+                                              << QLatin1String("a1/png/snap001.png")
+                                              << QLatin1String("a1/png/snap002.png")
+                                              << QLatin1String("a2/icc-test-farbkreis.jpg")
+                                              << QLatin1String("a2/icc-test-farbkreis_v1.png")
+                                              << QLatin1String("a2/icc-test-no-profile.jpg")
+                                              << QLatin1String("a2/Martian_face_viking.jpg");
+    const QString path        = tempPath() + QLatin1String("/album");
+    const int copies          = 5;
+
+    if (!QDir().mkpath(path))
+    {
+        return false;
+    }
+
+    for (int i = 0; i < copies; ++i)
+    {
+        foreach (const QString& source, sources)
+        {
+            // The images without duplicates are copied once
+
+            if ((i > 0) && source.contains(QLatin1String("Martian")))
+            {
+                continue;
+            }
+
+            QFileInfo info(source);
+
+            if (!QFile::copy(IMAGE_PATH + source,
+                             path + QString::fromLatin1("/%1-%2.%3").arg(info.baseName()).arg(i).arg(info.suffix())))
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+void HaarDuplicatesTest::testParallelSearch_data()
+{
+    QTest::addColumn<int>("threads");
+    QTest::addColumn<double>("requiredPercentage");
+
+    QTest::newRow("2 threads, exact")    << 2 << 1.0;
+    QTest::newRow("2 threads, similar")  << 2 << 0.8;
+    QTest::newRow("4 threads, similar")  << 4 << 0.8;
+    QTest::newRow("4 threads, distant")  << 4 << 0.5;
+    QTest::newRow("16 threads, similar") << 16 << 0.8;
+}
+
+void HaarDuplicatesTest::testParallelSearch()
+{
+    if (!m_ready)
+    {
+        QSKIP("The test collection cannot be created");
+    }
+
+    QFETCH(int,    threads);
+    QFETCH(double, requiredPercentage);
+
+    HaarIface sequentialIface;
+    sequentialIface.setNumberOfThreads(1);
+    const DuplicatesResults sequential = sequentialIface.findDuplicates(m_imageIds, requiredPercentage, 1.0);
+
+    HaarIface parallelIface;
+    parallelIface.setNumberOfThreads(threads);
+    const DuplicatesResults parallel   = parallelIface.findDuplicates(m_imageIds, requiredPercentage, 1.0);
+
+    // The copies of each image are found in both searches
+
+    QVERIFY(!sequential.isEmpty());
+
+    // The parallel search gives the same groups with the same similarity
+
+    QCOMPARE(parallel.keys(), sequential.keys());
+
+    for (DuplicatesResults::const_iterator it = sequential.constBegin() ; it != sequential.constEnd() ; ++it)
+    {
+        QCOMPARE(parallel.value(it.key()), it.value());
+    }
+}
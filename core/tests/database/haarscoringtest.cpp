@@ -0,0 +1,225 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-11-10
+ * Description : Benchmark of the parallel Haar signature scoring
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "haarscoringtest.h"
+
+// C++ includes
+
+#include <algorithm>
+
+// Qt includes
+
+#include <QTest>
+#include <QList>
+#include <QFuture>
+#include <QtConcurrent>    // krazy:exclude=includes
+
+// Local includes
+
+#include "haarindex.h"
+
+using namespace Digikam;
+using namespace Digikam::Haar;
+
+QTEST_GUILESS_MAIN(HaarScoringTest)
+
+/** Number of synthetic signatures in the store. This is the order of magnitude of a large collection.
+ */
+static const int s_numberOfSignatures = 100000;
+
+static void createSignature(SignatureData* const sig)
+{
+    for (int channel = 0; channel < 3; ++channel)
+    {
+        sig->avg[channel] = (double)qrand() / RAND_MAX;
+
+        for (int coef = 0; coef < NumberOfCoefficients; ++coef)
+        {
+            Idx  x;
+            bool known;
+
+            // Coefficients of one channel are unique, like in a real signature
+
+            do
+            {
+                x     = 1 + qrand() % (NumberOfPixelsSquared - 1);
+                x     = (qrand() % 2) ? x : -x;
+                known = false;
+
+                for (int i = 0; i < coef; ++i)
+                {
+                    known |= (qAbs(sig->sig[channel][i]) == qAbs(x));
+                }
+            }
+            while (known);
+
+            sig->sig[channel][coef] = x;
+        }
+    }
+}
+
+void HaarScoringTest::initTestCase()
+{
+    qsrand(20181110);
+
+    m_store = QSharedPointer<SignatureStore>(new SignatureStore);
+    m_store->reserve(s_numberOfSignatures);
+
+    SignatureData sig;
+
+    for (int i = 0; i < s_numberOfSignatures; ++i)
+    {
+        createSignature(&sig);
+        m_store->append(i + 1, sig);
+        m_positions << i;
+    }
+}
+
+void HaarScoringTest::cleanupTestCase()
+{
+    m_positions.clear();
+    m_store.clear();
+}
+
+QVector<double> HaarScoringTest::scoreAll(const ScoreTable& query, int threads) const
+{
+    QVector<double> scores(m_positions.size());
+    QList<QFuture<void> > tasks;
+    const int chunkSize = (m_positions.size() + threads - 1) / threads;
+
+    for (int begin = 0; begin < m_positions.size(); begin += chunkSize)
+    {
+        const int count = qMin(chunkSize, m_positions.size() - begin);
+
+        tasks.append(QtConcurrent::run(m_store.data(),
+                                       &SignatureStore::calculateScores,
+                                       query,
+                                       m_positions.constData() + begin,
+                                       count,
+                                       scores.data() + begin));
+    }
+
+    foreach (QFuture<void> t, tasks)
+    {
+        t.waitForFinished();
+    }
+
+    return scores;
+}
+
+void HaarScoringTest::testIndexCandidates()
+{
+    SignatureIndex index(m_store);
+
+    for (int i = 0; i < m_positions.size(); ++i)
+    {
+        index.add(m_positions.at(i), 1);
+    }
+
+    index.build();
+
+    Weights                     weights;
+    WeightBin                   bin;
+    SignatureIndex::Accumulator accumulator;
+    SignatureData               querySig;
+
+    for (int query = 0; query < 10; ++query)
+    {
+        m_store->signature(query * 1000, &querySig);
+
+        QVector<double> scores = scoreAll(ScoreTable(querySig, weights, bin), 1);
+
+        // Take the score of the 100th best match as limit, like a strict similarity threshold
+
+        QVector<double> sorted = scores;
+        std::sort(sorted.begin(), sorted.end());
+        const double maximumScore = sorted.at(99);
+
+        QVector<int> candidates   = index.candidates(querySig, weights, bin, maximumScore, accumulator);
+
+        for (int pos = 0; pos < scores.size(); ++pos)
+        {
+            if (scores.at(pos) <= maximumScore)
+            {
+                QVERIFY(std::binary_search(candidates.constBegin(), candidates.constEnd(), pos));
+            }
+        }
+
+        QVERIFY(candidates.size() < m_positions.size());
+    }
+}
+
+void HaarScoringTest::testReusedScoreTable()
+{
+    Weights       weights;
+    WeightBin     bin;
+    SignatureData querySig;
+    ScoreTable    reused;
+
+    for (int query = 0; query < 10; ++query)
+    {
+        m_store->signature(query * 1000, &querySig);
+        reused.setQuery(querySig, weights, bin);
+
+        // No weight of the previous queries is left in the table
+
+        QCOMPARE(scoreAll(reused, 1), scoreAll(ScoreTable(querySig, weights, bin), 1));
+    }
+}
+
+void HaarScoringTest::testParallelScoring_data()
+{
+    QTest::addColumn<int>("threads");
+
+    QTest::newRow("1 thread")   << 1;
+    QTest::newRow("2 threads")  << 2;
+    QTest::newRow("4 threads")  << 4;
+    QTest::newRow("8 threads")  << 8;
+    QTest::newRow("16 threads") << 16;
+    QTest::newRow("32 threads") << 32;
+}
+
+void HaarScoringTest::testParallelScoring()
+{
+    QFETCH(int, threads);
+
+    QThreadPool::globalInstance()->setMaxThreadCount(qMax(threads, QThread::idealThreadCount()));
+
+    Weights       weights;
+    WeightBin     bin;
+    SignatureData querySig;
+    m_store->signature(0, &querySig);
+
+    ScoreTable query(querySig, weights, bin);
+    QVector<double> reference = scoreAll(query, 1);
+    QVector<double> scores;
+
+    QBENCHMARK
+    {
+        scores = scoreAll(query, threads);
+    }
+
+    // The split into chunks must not change any score
+
+    QCOMPARE(scores, reference);
+}
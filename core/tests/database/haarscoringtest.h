@@ -0,0 +1,61 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-11-10
+ * Description : Benchmark of the parallel Haar signature scoring
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_HAAR_SCORING_TEST_H
+#define DIGIKAM_HAAR_SCORING_TEST_H
+
+// Qt includes
+
+#include <QObject>
+#include <QSharedPointer>
+#include <QVector>
+
+// Local includes
+
+#include "haarstore.h"
+
+class HaarScoringTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void initTestCase();
+    void cleanupTestCase();
+
+    void testIndexCandidates();
+    void testReusedScoreTable();
+    void testParallelScoring();
+    void testParallelScoring_data();
+
+private:
+
+    QVector<double> scoreAll(const Digikam::Haar::ScoreTable& query, int threads) const;
+
+private:
+
+    QSharedPointer<Digikam::Haar::SignatureStore> m_store;
+    QVector<int>                                  m_positions;
+};
+
+#endif // DIGIKAM_HAAR_SCORING_TEST_H
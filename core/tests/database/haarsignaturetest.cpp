@@ -0,0 +1,180 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-11-10
+ * Description : Haar signatures computed from a single decoding of the combined analysis
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "haarsignaturetest.h"
+
+// Qt includes
+
+#include <QTest>
+#include <QByteArray>
+#include <QDataStream>
+#include <QSet>
+
+// Local includes
+
+#include "dimg.h"
+#include "haar.h"
+#include "haariface.h"
+#include "previewloadthread.h"
+
+using namespace Digikam;
+
+QTEST_MAIN(HaarSignatureTest)
+
+const QString IMAGE_PATH(QFINDTESTDATA("data/testimages/"));
+
+/** Size of the preview decoded by the combined analysis for the image quality sorter.
+ */
+static const int s_qualitySize = 1024;
+
+/** Size of the preview decoded by the combined analysis for the thumbnails.
+ */
+static const int s_thumbnailSize = 256;
+
+static bool readSignature(const QByteArray& array, Haar::SignatureData* const sig)
+{
+    QDataStream stream(array);
+    qint32      version;
+    stream >> version;
+
+    if (version != 1)
+    {
+        return false;
+    }
+
+    stream.setVersion(QDataStream::Qt_4_3);
+
+    for (int i = 0; i < 3; ++i)
+    {
+        stream >> sig->avg[i];
+    }
+
+    for (int i = 0; i < 3; ++i)
+    {
+        for (int j = 0; j < Haar::NumberOfCoefficients; ++j)
+        {
+            stream >> sig->sig[i][j];
+        }
+    }
+
+    return (stream.status() == QDataStream::Ok);
+}
+
+void HaarSignatureTest::testPreferredImage()
+{
+    const int size = HaarIface::preferredSize();
+
+    // Scaled to fit the preferred size, keeping the aspect ratio
+
+    DImg large(8 * size, 4 * size, false);
+    DImg scaled = HaarIface::preferredImage(large);
+    QCOMPARE(scaled.size(), QSize(size, size / 2));
+
+    // Images up to 1.25 times the preferred size are not scaled by the fast preview loader
+
+    DImg small(size + size / 8, size, false);
+    QCOMPARE(HaarIface::preferredImage(small).size(), small.size());
+
+    QVERIFY(HaarIface::preferredImage(DImg()).isNull());
+}
+
+void HaarSignatureTest::testSignature_data()
+{
+    QTest::addColumn<QString>("file");
+    QTest::addColumn<int>("size");
+    QTest::addColumn<bool>("exact");
+
+    // A PNG image is decoded completely, and scaled once to the preferred size
+
+    QTest::newRow("png, quality size")      << QString::fromLatin1("a2/icc-test-farbkreis_v1.png") << s_qualitySize   << true;
+    QTest::newRow("png, thumbnail size")    << QString::fromLatin1("a2/icc-test-farbkreis_v1.png") << s_thumbnailSize << false;
+    QTest::newRow("large png")              << QString::fromLatin1("a1/png/snap001.png")           << s_qualitySize   << false;
+
+    // A JPEG image is scaled while decoding, depending on the requested size
+
+    QTest::newRow("jpeg, quality size")     << QString::fromLatin1("a1/jpg/foto001.jpg")           << s_qualitySize   << false;
+    QTest::newRow("jpeg, thumbnail size")   << QString::fromLatin1("a1/jpg/foto001.jpg")           << s_thumbnailSize << false;
+    QTest::newRow("jpeg color wheel")       << QString::fromLatin1("a2/icc-test-farbkreis.jpg")    << s_qualitySize   << false;
+}
+
+void HaarSignatureTest::testSignature()
+{
+    QFETCH(QString, file);
+    QFETCH(int, size);
+    QFETCH(bool, exact);
+
+    const QString path = IMAGE_PATH + file;
+    HaarIface     haarIface;
+
+    // As FingerprintsTask
+
+    DImg fingerprintsImage    = PreviewLoadThread::loadFastSynchronously(path, HaarIface::preferredSize());
+    QVERIFY(!fingerprintsImage.isNull());
+    QByteArray fingerprints   = haarIface.signatureData(fingerprintsImage);
+
+    // As ImageAnalysisTask, from the image decoded for all analyses
+
+    DImg analysisImage        = PreviewLoadThread::loadFastSynchronously(path, size);
+    QVERIFY(!analysisImage.isNull());
+    QByteArray analysis       = haarIface.signatureData(HaarIface::preferredImage(analysisImage));
+
+    if (exact)
+    {
+        QCOMPARE(analysis, fingerprints);
+        return;
+    }
+
+    // Otherwise the source pixels differ a little, the signatures must still match
+
+    Haar::SignatureData fingerprintsSig;
+    Haar::SignatureData analysisSig;
+    QVERIFY(readSignature(fingerprints, &fingerprintsSig));
+    QVERIFY(readSignature(analysis,     &analysisSig));
+
+    for (int i = 0; i < 3; ++i)
+    {
+        QVERIFY(qAbs(analysisSig.avg[i] - fingerprintsSig.avg[i]) < 0.02);
+    }
+
+    // The largest coefficients of the luminance are mostly the same
+
+    QSet<int> coefficients;
+
+    for (int j = 0; j < Haar::NumberOfCoefficients; ++j)
+    {
+        coefficients << fingerprintsSig.sig[0][j];
+    }
+
+    int common = 0;
+
+    for (int j = 0; j < Haar::NumberOfCoefficients; ++j)
+    {
+        if (coefficients.contains(analysisSig.sig[0][j]))
+        {
+            ++common;
+        }
+    }
+
+    QVERIFY2(common >= Haar::NumberOfCoefficients / 2,
+             qPrintable(QString::fromLatin1("%1 of %2 coefficients in common").arg(common).arg(Haar::NumberOfCoefficients)));
+}
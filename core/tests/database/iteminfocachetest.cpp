@@ -0,0 +1,169 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-11-10
+ * Description : Benchmark of concurrent reads from the ItemInfo cache
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "iteminfocachetest.h"
+
+// Qt includes
+
+#include <QTest>
+#include <QList>
+#include <QFuture>
+#include <QThreadPool>
+#include <QtConcurrent>    // krazy:exclude=includes
+
+// Local includes
+
+#include "itemlisterrecord.h"
+
+using namespace Digikam;
+
+QTEST_GUILESS_MAIN(ItemInfoCacheTest)
+
+/** Number of cached items, the order of magnitude of a large album view.
+ */
+static const int s_numberOfItems = 50000;
+
+/** Each thread reads all items this number of times.
+ */
+static const int s_numberOfPasses = 4;
+
+static qlonglong readInfos(const QList<ItemInfo>* const infos, int offset)
+{
+    // All accessors below return cached values and do not touch the database
+    qlonglong sum = 0;
+
+    for (int pass = 0; pass < s_numberOfPasses; ++pass)
+    {
+        for (int i = 0; i < infos->size(); ++i)
+        {
+            // Threads start at different items, like filter workers on different chunks
+            const ItemInfo& info = infos->at((i + offset) % infos->size());
+            ItemInfo lookup(info.id());
+
+            sum += lookup.rating();
+            sum += info.fileSize();
+            sum += info.name().size();
+            sum += info.dateTime().date().day();
+        }
+    }
+
+    return sum;
+}
+
+void ItemInfoCacheTest::initTestCase()
+{
+    // The cache only needs the change notifications, the items are not read from the database
+    initBaseTestCase();
+
+    const QDateTime date = testDate();
+
+    for (int i = 0; i < s_numberOfItems; ++i)
+    {
+        ItemListerRecord record;
+        record.imageID          = i + 1;
+        record.albumID          = 1 + i / 1000;
+        record.albumRootID      = 1;
+        record.name             = QString::fromLatin1("image%1.jpg").arg(i);
+        record.rating           = i % 6;
+        record.category         = DatabaseItem::Image;
+        record.format           = QLatin1String("JPG");
+        record.creationDate     = date.addDays(i % 28);
+        record.modificationDate = date;
+        record.fileSize         = 1000 + i;
+        record.imageSize        = QSize(4000, 3000);
+
+        m_infos << ItemInfo(record);
+    }
+}
+
+void ItemInfoCacheTest::cleanupTestCase()
+{
+    m_infos.clear();
+    cleanupBaseTestCase();
+}
+
+qlonglong ItemInfoCacheTest::readAll(int threads) const
+{
+    QThreadPool pool;
+    pool.setMaxThreadCount(threads);
+
+    QList<QFuture<qlonglong> > tasks;
+
+    for (int i = 0; i < threads; ++i)
+    {
+        tasks << QtConcurrent::run(&pool, readInfos, &m_infos, i * (m_infos.size() / threads));
+    }
+
+    qlonglong sum = 0;
+
+    foreach (QFuture<qlonglong> t, tasks)
+    {
+        sum += t.result();
+    }
+
+    return sum;
+}
+
+void ItemInfoCacheTest::testLookup()
+{
+    // Cached data is shared, not created again
+
+    for (int i = 0; i < m_infos.size(); i += 997)
+    {
+        ItemInfo info(m_infos.at(i).id());
+
+        QCOMPARE(info, m_infos.at(i));
+        QCOMPARE(info.name(),     m_infos.at(i).name());
+        QCOMPARE(info.rating(),   i % 6);
+        QCOMPARE(info.fileSize(), (qlonglong)(1000 + i));
+    }
+}
+
+void ItemInfoCacheTest::testConcurrentReads_data()
+{
+    QTest::addColumn<int>("threads");
+
+    QTest::newRow("1 thread")   << 1;
+    QTest::newRow("2 threads")  << 2;
+    QTest::newRow("4 threads")  << 4;
+    QTest::newRow("8 threads")  << 8;
+    QTest::newRow("16 threads") << 16;
+}
+
+void ItemInfoCacheTest::testConcurrentReads()
+{
+    QFETCH(int, threads);
+
+    // Every thread reads all items, so the work grows with the number of threads.
+    // With perfect scalability, the time stays constant up to the number of cores.
+
+    const qlonglong reference = readInfos(&m_infos, 0);
+    qlonglong sum             = 0;
+
+    QBENCHMARK
+    {
+        sum = readAll(threads);
+    }
+
+    QCOMPARE(sum, reference * threads);
+}
@@ -0,0 +1,58 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-11-10
+ * Description : Benchmark of concurrent reads from the ItemInfo cache
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_ITEM_INFO_CACHE_TEST_H
+#define DIGIKAM_ITEM_INFO_CACHE_TEST_H
+
+// Qt includes
+
+#include <QList>
+
+// Local includes
+
+#include "dbabstracttest.h"
+#include "iteminfo.h"
+
+class ItemInfoCacheTest : public DatabaseAbstractTest
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void initTestCase();
+    void cleanupTestCase();
+
+    void testLookup();
+    void testConcurrentReads();
+    void testConcurrentReads_data();
+
+private:
+
+    qlonglong readAll(int threads) const;
+
+private:
+
+    QList<Digikam::ItemInfo> m_infos;
+};
+
+#endif // DIGIKAM_ITEM_INFO_CACHE_TEST_H
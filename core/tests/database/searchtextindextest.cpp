@@ -0,0 +1,295 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-11-10
+ * Description : Full-text search index of the core database
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "searchtextindextest.h"
+
+// Qt includes
+
+#include <QTest>
+#include <QDateTime>
+
+// Local includes
+
+#include "coredb.h"
+#include "coredbaccess.h"
+#include "coredbbackend.h"
+#include "coredbsearchtextindexer.h"
+#include "coredbsearchxml.h"
+#include "coredbtransaction.h"
+#include "itemquerybuilder.h"
+
+using namespace Digikam;
+
+QTEST_GUILESS_MAIN(SearchTextIndexTest)
+
+void SearchTextIndexTest::initTestCase()
+{
+    m_ready = false;
+
+    if (!initBaseTestCase())
+    {
+        return;
+    }
+
+    if (CoreDbAccess().db()->getSearchTextIndexVersion() <= 0)
+    {
+        return;
+    }
+
+    // The index of the new database is built in the background
+
+    QTRY_VERIFY_WITH_TIMEOUT(CoreDbAccess().db()->hasSearchTextIndex(), 10000);
+
+    CoreDbAccess access;
+    const QDateTime date = testDate();
+
+    {
+        CoreDbTransaction transaction(&access);
+
+        const int albumRootId = addTestAlbumRoot(access);
+        const int albumId     = access.db()->addAlbum(albumRootId, QLatin1String("/Holidays/Brittany"),
+                                                      QString(), date.date(), QString());
+
+        m_beachId = access.db()->addItem(albumId, QLatin1String("beach.jpg"), DatabaseItem::Visible,
+                                         DatabaseItem::Image, date, 1000, QLatin1String("1"));
+        m_houseId = access.db()->addItem(albumId, QLatin1String("house.jpg"), DatabaseItem::Visible,
+                                         DatabaseItem::Image, date, 1000, QLatin1String("2"));
+        m_cafeId  = access.db()->addItem(albumId, QString::fromUtf8("caf\xc3\xa9.jpg"), DatabaseItem::Visible,
+                                         DatabaseItem::Image, date, 1000, QLatin1String("3"));
+
+        access.db()->setImageComment(m_beachId, QLatin1String("Sunset over the ocean"), DatabaseComment::Comment);
+        access.db()->setImageComment(m_cafeId,  QLatin1String("Lighthouse"),            DatabaseComment::Title);
+
+        const int placesId = access.db()->addTag(0, QLatin1String("Places"), QString(), 0);
+        m_tagId            = access.db()->addTag(placesId, QLatin1String("France"), QString(), 0);
+        access.db()->addItemTag(m_houseId, m_tagId);
+    }
+
+    access.db()->updateSearchTextIndex(QList<qlonglong>() << m_beachId << m_houseId << m_cafeId);
+
+    m_ready = true;
+}
+
+void SearchTextIndexTest::cleanupTestCase()
+{
+    cleanupBaseTestCase();
+}
+
+QSet<qlonglong> SearchTextIndexTest::search(const QString& keyword) const
+{
+    QList<QVariant>    boundValues;
+    QList<QVariant>    values;
+    ItemQueryBuilder   builder;
+    ItemQueryPostHooks hooks;
+
+    QString sql = QLatin1String("SELECT DISTINCT Images.id FROM Images "
+                                "INNER JOIN Albums ON Albums.id=Images.album WHERE ( ");
+    sql        += builder.buildQuery(SearchXmlWriter::keywordSearch(keyword), &boundValues, &hooks);
+    sql        += QLatin1String(" );");
+
+    CoreDbAccess access;
+    access.backend()->execSql(sql, boundValues, &values);
+
+    QSet<qlonglong> ids;
+
+    foreach (const QVariant& value, values)
+    {
+        ids << value.toLongLong();
+    }
+
+    return ids;
+}
+
+QSet<qlonglong> SearchTextIndexTest::indexEntries(const QString& text) const
+{
+    QList<QVariant> values;
+
+    CoreDbAccess access;
+    access.backend()->execSql(QLatin1String("SELECT rowid FROM ImageSearchText WHERE ImageSearchText MATCH ?;"),
+                              QString::fromUtf8("{name album tags comments} : \"%1\"").arg(text), &values);
+
+    QSet<qlonglong> ids;
+
+    foreach (const QVariant& value, values)
+    {
+        ids << value.toLongLong();
+    }
+
+    return ids;
+}
+
+void SearchTextIndexTest::testKeywords()
+{
+    if (!m_ready)
+    {
+        QSKIP("The full-text search index is not supported by this SQLite library");
+    }
+
+    const QSet<qlonglong> all = QSet<qlonglong>() << m_beachId << m_houseId << m_cafeId;
+
+    QCOMPARE(search(QLatin1String("sunset")),       QSet<qlonglong>() << m_beachId);
+    QCOMPARE(search(QLatin1String("over the oce")), QSet<qlonglong>() << m_beachId);
+    QCOMPARE(search(QLatin1String("Beach")),        QSet<qlonglong>() << m_beachId);
+    QCOMPARE(search(QLatin1String("france")),       QSet<qlonglong>() << m_houseId);
+
+    // Any substring matches, as with the LIKE comparisons
+    QCOMPARE(search(QLatin1String("ach")),          QSet<qlonglong>() << m_beachId);
+    QCOMPARE(search(QLatin1String("ouse")),         QSet<qlonglong>() << m_houseId << m_cafeId);
+    QCOMPARE(search(QLatin1String("ranc")),         QSet<qlonglong>() << m_houseId);
+
+    // Titles are searched as well as comments
+    QCOMPARE(search(QLatin1String("lighthouse")),   QSet<qlonglong>() << m_cafeId);
+
+    // Diacritics are compared as they are
+    QCOMPARE(search(QString::fromUtf8("caf\xc3\xa9")), QSet<qlonglong>() << m_cafeId);
+    QVERIFY(search(QLatin1String("cafe")).isEmpty());
+
+    QCOMPARE(search(QLatin1String("britt")),        all);
+    QCOMPARE(search(QLatin1String("holidays")),     all);
+    QVERIFY(search(QLatin1String("mountain")).isEmpty());
+}
+
+void SearchTextIndexTest::testFallback()
+{
+    if (!m_ready)
+    {
+        QSKIP("The full-text search index is not supported by this SQLite library");
+    }
+
+    // The index gives the same result as the LIKE comparisons, including
+    // short texts, wildcards and parent tags, which are only in the index.
+
+    const QStringList keywords = QStringList() << QLatin1String("sunset")   << QLatin1String("france")
+                                               << QLatin1String("holidays") << QLatin1String("mountain")
+                                               << QLatin1String("ach")      << QLatin1String("se")
+                                               << QLatin1String("h_use")    << QLatin1String("places")
+                                               << QLatin1String("jpg")      << QLatin1String("\"sun");
+    QList<QSet<qlonglong> > indexed;
+
+    foreach (const QString& keyword, keywords)
+    {
+        indexed << search(keyword);
+    }
+
+    CoreDbAccess().db()->setSearchTextIndexComplete(false);
+
+    for (int i = 0 ; i < keywords.size() ; ++i)
+    {
+        QCOMPARE(search(keywords.at(i)), indexed.at(i));
+    }
+
+    CoreDbAccess().db()->setSearchTextIndexComplete(true);
+}
+void SearchTextIndexTest::testTagRenamed()
+{
+    if (!m_ready)
+    {
+        QSKIP("The full-text search index is not supported by this SQLite library");
+    }
+
+    {
+        CoreDbAccess access;
+        access.db()->setTagName(m_tagId, QLatin1String("Bretagne"));
+        access.db()->updateSearchTextIndex(QList<qlonglong>(), QList<int>(), QList<int>() << m_tagId);
+    }
+
+    QCOMPARE(search(QLatin1String("bretagne")), QSet<qlonglong>() << m_houseId);
+    QVERIFY(search(QLatin1String("france")).isEmpty());
+}
+
+void SearchTextIndexTest::testIndexerChanges()
+{
+    if (!m_ready)
+    {
+        QSKIP("The full-text search index is not supported by this SQLite library");
+    }
+
+    // The indexer of the main application applies the changesets in the background
+
+    CoreDbAccess().db()->setImageComment(m_houseId, QLatin1String("Garden party"), DatabaseComment::Headline);
+
+    QTRY_COMPARE_WITH_TIMEOUT(indexEntries(QLatin1String("garden")), QSet<qlonglong>() << m_houseId, 10000);
+
+    CoreDbAccess().db()->removeItemTag(m_houseId, m_tagId);
+
+    QTRY_VERIFY_WITH_TIMEOUT(indexEntries(QLatin1String("bretagne")).isEmpty(), 10000);
+    QVERIFY(search(QLatin1String("bretagne")).isEmpty());
+}
+
+void SearchTextIndexTest::testPendingChanges()
+{
+    if (!m_ready)
+    {
+        QSKIP("The full-text search index is not supported by this SQLite library");
+    }
+
+    // The changed images are found before the indexer writes their entries
+
+    CoreDbAccess().db()->setImageComment(m_cafeId, QLatin1String("Picnic by the lake"), DatabaseComment::Comment);
+
+    QVERIFY(indexEntries(QLatin1String("picnic")).isEmpty());
+    QCOMPARE(search(QLatin1String("picnic")), QSet<qlonglong>() << m_cafeId);
+
+    QTRY_COMPARE_WITH_TIMEOUT(indexEntries(QLatin1String("picnic")), QSet<qlonglong>() << m_cafeId, 10000);
+    QCOMPARE(search(QLatin1String("picnic")), QSet<qlonglong>() << m_cafeId);
+
+    // A renamed tag changes the entries of all its images, the LIKE comparisons are used until they are written
+
+    CoreDbAccess().db()->addItemTag(m_beachId, m_tagId);
+    QTRY_COMPARE_WITH_TIMEOUT(indexEntries(QLatin1String("bretagne")), QSet<qlonglong>() << m_beachId, 10000);
+
+    CoreDbAccess().db()->setTagName(m_tagId, QLatin1String("Normandie"));
+
+    QCOMPARE(search(QLatin1String("normandie")), QSet<qlonglong>() << m_beachId);
+    QVERIFY(search(QLatin1String("bretagne")).isEmpty());
+
+    QTRY_COMPARE_WITH_TIMEOUT(indexEntries(QLatin1String("normandie")), QSet<qlonglong>() << m_beachId, 10000);
+}
+
+void SearchTextIndexTest::testIndexerRebuild()
+{
+    if (!m_ready)
+    {
+        QSKIP("The full-text search index is not supported by this SQLite library");
+    }
+
+    {
+        CoreDbAccess access;
+        access.backend()->execSql(QLatin1String("DELETE FROM ImageSearchText;"));
+        access.db()->setSearchTextIndexComplete(false);
+    }
+
+    // An incomplete index is not used by searches
+
+    QCOMPARE(search(QLatin1String("sunset")), QSet<qlonglong>() << m_beachId);
+
+    CoreDbSearchTextIndexer indexer(CoreDbAccess::databaseWatch());
+    indexer.scheduleRebuild();
+
+    QTRY_VERIFY_WITH_TIMEOUT(CoreDbAccess().db()->hasSearchTextIndex(), 10000);
+
+    QCOMPARE(indexEntries(QLatin1String("sunset")),   QSet<qlonglong>() << m_beachId);
+    QCOMPARE(indexEntries(QLatin1String("garden")),   QSet<qlonglong>() << m_houseId);
+    QCOMPARE(indexEntries(QLatin1String("holidays")), QSet<qlonglong>() << m_beachId << m_houseId << m_cafeId);
+    QCOMPARE(search(QLatin1String("ach")),            QSet<qlonglong>() << m_beachId);
+}
@@ -0,0 +1,68 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-11-10
+ * Description : Full-text search index of the core database
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_SEARCH_TEXT_INDEX_TEST_H
+#define DIGIKAM_SEARCH_TEXT_INDEX_TEST_H
+
+// Qt includes
+
+#include <QSet>
+
+// Local includes
+
+#include "dbabstracttest.h"
+
+class SearchTextIndexTest : public DatabaseAbstractTest
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void initTestCase();
+    void cleanupTestCase();
+
+    void testKeywords();
+    void testFallback();
+    void testTagRenamed();
+    void testIndexerChanges();
+    void testPendingChanges();
+    void testIndexerRebuild();
+
+private:
+
+    QSet<qlonglong> search(const QString& keyword) const;
+
+    /** Returns the images whose index entry contains the text, without the LIKE comparisons.
+     */
+    QSet<qlonglong> indexEntries(const QString& text) const;
+
+private:
+
+    qlonglong m_beachId;
+    qlonglong m_houseId;
+    qlonglong m_cafeId;
+    int       m_tagId;
+    bool      m_ready;
+};
+
+#endif // DIGIKAM_SEARCH_TEXT_INDEX_TEST_H
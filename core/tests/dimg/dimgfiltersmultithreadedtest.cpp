@@ -0,0 +1,328 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-11-10
+ * Description : a test comparing the multithreaded and the
+ *               single threaded results of the pixel-wise filters
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "dimgfiltersmultithreadedtest.h"
+
+// C++ includes
+
+#include <cstring>
+
+// Qt includes
+
+#include <QTest>
+#include <QThreadPool>
+
+// Local includes
+
+#include "antivignettingfilter.h"
+#include "bcgfilter.h"
+#include "cbfilter.h"
+#include "curvesfilter.h"
+#include "filmfilter.h"
+#include "freerotationfilter.h"
+#include "hslfilter.h"
+#include "iccprofile.h"
+#include "icctransform.h"
+#include "imagecurves.h"
+#include "lensdistortionfilter.h"
+#include "levelsfilter.h"
+#include "mixerfilter.h"
+#include "wbfilter.h"
+
+using namespace Digikam;
+
+QTEST_GUILESS_MAIN(DImgFiltersMultithreadedTest)
+
+/// Size of the synthetic image. The height is not a multiple of the number of threads.
+static const int s_width  = 641;
+static const int s_height = 427;
+
+void DImgFiltersMultithreadedTest::initTestCase()
+{
+    m_threads = QThreadPool::globalInstance()->maxThreadCount();
+}
+
+void DImgFiltersMultithreadedTest::cleanupTestCase()
+{
+    QThreadPool::globalInstance()->setMaxThreadCount(m_threads);
+}
+
+DImg DImgFiltersMultithreadedTest::createImage(bool sixteenBit) const
+{
+    DImg img(s_width, s_height, sixteenBit, true);
+    uchar* const data   = img.bits();
+    const quint64 bytes = img.numBytes();
+    quint32 seed        = 20181110;
+
+    // A gradient with noise, so that no pixel is equal to its neighbours
+
+    for (quint64 i = 0 ; i < bytes ; ++i)
+    {
+        seed    = seed * 1664525 + 1013904223;
+        data[i] = (uchar)((i / 1024 + (seed >> 24)) & 0xFF);
+    }
+
+    return img;
+}
+
+DImg DImgFiltersMultithreadedTest::filteredImage(int type, const DImg& img) const
+{
+    DImg org = img.copy();
+    DImgThreadedFilter* filter = 0;
+
+    switch (type)
+    {
+        case WhiteBalance:
+        {
+            WBContainer settings;
+            settings.temperature = 4200.0;
+            settings.green       = 1.2;
+            settings.dark        = 0.3;
+            settings.saturation  = 1.4;
+            filter               = new WBFilter(&org, 0, settings);
+            break;
+        }
+
+        case Curves:
+        {
+            ImageCurves curves(org.sixteenBit());
+            int max = org.sixteenBit() ? 65535 : 255;
+            curves.setCurvePoint(LuminosityChannel, 8, QPoint(max / 2, max / 3));
+            curves.setCurvePoint(RedChannel,        8, QPoint(max / 3, max / 2));
+            curves.curvesCalculateAllCurves();
+            filter = new CurvesFilter(&org, 0, curves.getContainer());
+            break;
+        }
+
+        case BCG:
+        {
+            BCGContainer settings;
+            settings.brightness = 0.1;
+            settings.contrast   = 1.3;
+            settings.gamma      = 1.2;
+            filter              = new BCGFilter(&org, 0, settings);
+            break;
+        }
+
+        case HSL:
+        {
+            HSLContainer settings;
+            settings.hue        = 30.0;
+            settings.saturation = 20.0;
+            settings.lightness  = 10.0;
+            settings.vibrance   = 15.0;
+            filter              = new HSLFilter(&org, 0, settings);
+            break;
+        }
+
+        case Mixer:
+        {
+            MixerContainer settings;
+            settings.redGreenGain  = 0.3;
+            settings.greenBlueGain = 0.2;
+            settings.blueRedGain   = 0.4;
+            settings.bPreserveLum  = true;
+            filter                 = new MixerFilter(&org, 0, settings);
+            break;
+        }
+
+        case Levels:
+        {
+            LevelsContainer settings;
+            int max = org.sixteenBit() ? 65535 : 255;
+
+            for (int i = 0 ; i < 5 ; ++i)
+            {
+                settings.lInput[i]  = max / 10;
+                settings.hInput[i]  = max - max / 10;
+                settings.hOutput[i] = max;
+                settings.gamma[i]   = 1.4;
+            }
+
+            filter = new LevelsFilter(&org, 0, settings);
+            break;
+        }
+
+        case ColorBalance:
+        {
+            CBContainer settings;
+            settings.red   = 1.2;
+            settings.blue  = 0.8;
+            settings.gamma = 1.3;
+            filter         = new CBFilter(&org, 0, settings);
+            break;
+        }
+
+        case Film:
+        {
+            FilmContainer settings(FilmContainer::CNKodakGold200, 2.2, org.sixteenBit());
+            filter = new FilmFilter(&org, 0, settings);
+            break;
+        }
+
+        case FreeRotation:
+        {
+            FreeRotationContainer settings;
+            settings.angle     = 12.5;
+            settings.antiAlias = true;
+            settings.orgW      = org.width();
+            settings.orgH      = org.height();
+            filter             = new FreeRotationFilter(&org, 0, settings);
+            break;
+        }
+
+        case AntiVignetting:
+        {
+            AntiVignettingContainer settings;
+            settings.innerradius = 0.4;
+            settings.xshift      = 10.0;
+            settings.yshift      = -5.0;
+            filter               = new AntiVignettingFilter(&org, 0, settings);
+            break;
+        }
+
+        case LensDistortion:
+        {
+            filter = new LensDistortionFilter(&org, 0, 20.0, 10.0, -5.0, 8.0, 5, -3);
+            break;
+        }
+
+        default:
+            return DImg();
+    }
+
+    filter->startFilterDirectly();
+    DImg result = filter->getTargetImage();
+    delete filter;
+
+    return result;
+}
+
+DImg DImgFiltersMultithreadedTest::transformedImage(const DImg& img) const
+{
+    DImg out = img.copy();
+
+    IccTransform trans;
+    trans.setInputProfile(IccProfile::sRGB());
+    trans.setOutputProfile(IccProfile::wideGamutRGB());
+    trans.setIntent(IccTransform::Perceptual);
+
+    if (!trans.apply(out))
+    {
+        return DImg();
+    }
+
+    return out;
+}
+
+void DImgFiltersMultithreadedTest::testFilter_data()
+{
+    QTest::addColumn<int>("type");
+    QTest::addColumn<bool>("sixteenBit");
+
+    const char* const names[] =
+    {
+        "WhiteBalance",
+        "Curves",
+        "BCG",
+        "HSL",
+        "Mixer",
+        "Levels",
+        "ColorBalance",
+        "Film",
+        "FreeRotation",
+        "AntiVignetting",
+        "LensDistortion"
+    };
+
+    for (int type = WhiteBalance ; type <= LensDistortion ; ++type)
+    {
+        QTest::newRow(QString::fromLatin1("%1 8 bits").arg(QLatin1String(names[type])).toLatin1().constData())
+            << type << false;
+        QTest::newRow(QString::fromLatin1("%1 16 bits").arg(QLatin1String(names[type])).toLatin1().constData())
+            << type << true;
+    }
+}
+
+void DImgFiltersMultithreadedTest::testFilter()
+{
+    QFETCH(int,  type);
+    QFETCH(bool, sixteenBit);
+
+    DImg img = createImage(sixteenBit);
+
+    // With only one thread, the filters process the whole image in the current thread.
+
+    QThreadPool::globalInstance()->setMaxThreadCount(1);
+    DImg single = filteredImage(type, img);
+
+    // Force several bands, also on a single core machine.
+
+    QThreadPool::globalInstance()->setMaxThreadCount(qMax(m_threads, 4));
+    DImg multi  = filteredImage(type, img);
+
+    QThreadPool::globalInstance()->setMaxThreadCount(m_threads);
+
+    QVERIFY(!single.isNull());
+    QVERIFY(!multi.isNull());
+    QCOMPARE(multi.size(),       single.size());
+    QCOMPARE(multi.sixteenBit(), single.sixteenBit());
+    QVERIFY(memcmp(multi.bits(), single.bits(), single.numBytes()) == 0);
+}
+
+void DImgFiltersMultithreadedTest::testIccTransform_data()
+{
+    QTest::addColumn<bool>("sixteenBit");
+
+    QTest::newRow("8 bits")  << false;
+    QTest::newRow("16 bits") << true;
+}
+
+void DImgFiltersMultithreadedTest::testIccTransform()
+{
+    QFETCH(bool, sixteenBit);
+
+    IccTransform::init();
+
+    IccProfile profile = IccProfile::wideGamutRGB();
+
+    if (!profile.open())
+    {
+        QSKIP("The ICC profiles shipped with digiKam are not installed");
+    }
+
+    DImg img = createImage(sixteenBit);
+
+    QThreadPool::globalInstance()->setMaxThreadCount(1);
+    DImg single = transformedImage(img);
+
+    QThreadPool::globalInstance()->setMaxThreadCount(qMax(m_threads, 4));
+    DImg multi  = transformedImage(img);
+
+    QThreadPool::globalInstance()->setMaxThreadCount(m_threads);
+
+    QVERIFY(!single.isNull());
+    QVERIFY(!multi.isNull());
+    QVERIFY(memcmp(multi.bits(), single.bits(), single.numBytes()) == 0);
+}
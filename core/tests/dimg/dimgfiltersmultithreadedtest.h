@@ -0,0 +1,79 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-11-10
+ * Description : a test comparing the multithreaded and the
+ *               single threaded results of the pixel-wise filters
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_DIMG_FILTERS_MULTITHREADED_TEST_H
+#define DIGIKAM_DIMG_FILTERS_MULTITHREADED_TEST_H
+
+// Qt includes
+
+#include <QObject>
+
+// Local includes
+
+#include "dimg.h"
+
+class DImgFiltersMultithreadedTest : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    enum FilterType
+    {
+        WhiteBalance = 0,
+        Curves,
+        BCG,
+        HSL,
+        Mixer,
+        Levels,
+        ColorBalance,
+        Film,
+        FreeRotation,
+        AntiVignetting,
+        LensDistortion
+    };
+
+private Q_SLOTS:
+
+    void initTestCase();
+    void cleanupTestCase();
+
+    void testFilter();
+    void testFilter_data();
+
+    void testIccTransform();
+    void testIccTransform_data();
+
+private:
+
+    Digikam::DImg createImage(bool sixteenBit) const;
+    Digikam::DImg filteredImage(int type, const Digikam::DImg& img) const;
+    Digikam::DImg transformedImage(const Digikam::DImg& img) const;
+
+private:
+
+    int m_threads;
+};
+
+#endif // DIGIKAM_DIMG_FILTERS_MULTITHREADED_TEST_H
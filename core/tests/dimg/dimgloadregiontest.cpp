@@ -0,0 +1,412 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-11-10
+ * Description : DImg regions decoded by the loaders, compared with a cropped full image
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "dimgloadregiontest.h"
+
+// C ANSI includes
+
+extern "C"
+{
+#include <tiffio.h>
+}
+
+// C++ includes
+
+#include <cstring>
+
+// Qt includes
+
+#include <QTest>
+#include <QByteArray>
+#include <QFile>
+#include <QList>
+#include <QPoint>
+#include <QRect>
+
+// Local includes
+
+#include "digikam_config.h"
+#include "dimg.h"
+#include "metaengine.h"
+#include "tagregion.h"
+
+using namespace Digikam;
+
+QTEST_GUILESS_MAIN(DImgLoadRegionTest)
+
+/// Size of the JPEG image, a multiple of neither the 16 x 16 blocks of 4:2:0 nor the scaled sizes
+static const int s_jpegWidth  = 1021;
+static const int s_jpegHeight = 763;
+
+/// Size of the other images, with partial strips and tiles at the right and bottom borders
+static const int s_width      = 301;
+static const int s_height     = 203;
+
+/// Rows per strip and size of the tiles of the TIFF images
+static const int s_tiffBlock  = 32;
+
+static DImg createImage(int width, int height, bool sixteenBit, bool alpha)
+{
+    DImg img(width, height, sixteenBit, alpha);
+    quint32 seed = 20181110;
+
+    // Gradients with noise, so that the chroma changes from pixel to pixel
+
+    for (int y = 0 ; y < height ; ++y)
+    {
+        for (int x = 0 ; x < width ; ++x)
+        {
+            for (int c = 0 ; c < 4 ; ++c)
+            {
+                seed            = seed * 1664525 + 1013904223;
+                const uint v    = (x * 3 + y * 5 + c * 40 + (seed >> 28)) & 0xFF;
+                const int index = (y * width + x) * 4 + c;
+
+                if (sixteenBit)
+                {
+                    reinterpret_cast<ushort*>(img.bits())[index] = (c == 3 && !alpha) ? 0xFFFF : ((v << 8) | (seed >> 24));
+                }
+                else
+                {
+                    img.bits()[index] = (c == 3 && !alpha) ? 0xFF : v;
+                }
+            }
+        }
+    }
+
+    return img;
+}
+
+/** Writes img as a striped or tiled TIFF file, with contiguous or separate planes of samples.
+ */
+static bool writeTiff(const QString& path, const DImg& img, bool separate, bool tiled)
+{
+    TIFF* const tif = TIFFOpen(QFile::encodeName(path).constData(), "w");
+
+    if (!tif)
+    {
+        return false;
+    }
+
+    const uint16 bits    = img.sixteenBit() ? 16 : 8;
+    const uint16 samples = img.hasAlpha()   ? 4  : 3;
+    const int    width   = img.width();
+    const int    height  = img.height();
+
+    TIFFSetField(tif, TIFFTAG_IMAGEWIDTH,      (uint32)width);
+    TIFFSetField(tif, TIFFTAG_IMAGELENGTH,     (uint32)height);
+    TIFFSetField(tif, TIFFTAG_BITSPERSAMPLE,   bits);
+    TIFFSetField(tif, TIFFTAG_SAMPLESPERPIXEL, samples);
+    TIFFSetField(tif, TIFFTAG_PHOTOMETRIC,     PHOTOMETRIC_RGB);
+    TIFFSetField(tif, TIFFTAG_PLANARCONFIG,    separate ? PLANARCONFIG_SEPARATE : PLANARCONFIG_CONTIG);
+    TIFFSetField(tif, TIFFTAG_COMPRESSION,     COMPRESSION_ADOBE_DEFLATE);
+    TIFFSetField(tif, TIFFTAG_ORIENTATION,     ORIENTATION_TOPLEFT);
+
+    if (img.hasAlpha())
+    {
+        uint16 extra = EXTRASAMPLE_UNASSALPHA;
+        TIFFSetField(tif, TIFFTAG_EXTRASAMPLES, 1, &extra);
+    }
+
+    if (tiled)
+    {
+        TIFFSetField(tif, TIFFTAG_TILEWIDTH,  (uint32)s_tiffBlock);
+        TIFFSetField(tif, TIFFTAG_TILELENGTH, (uint32)s_tiffBlock);
+    }
+    else
+    {
+        TIFFSetField(tif, TIFFTAG_ROWSPERSTRIP, (uint32)s_tiffBlock);
+    }
+
+    // A tile, or one row of a strip, of one plane or of all samples
+
+    const int  planes       = separate ? samples : 1;
+    const int  pixelSamples = separate ? 1       : samples;
+    const int  blockWidth   = tiled    ? s_tiffBlock : width;
+    const int  blockRows    = tiled    ? s_tiffBlock : 1;
+    QByteArray block(blockWidth * blockRows * pixelSamples * (bits / 8), 0);
+    bool       ok           = true;
+
+    for (int plane = 0 ; plane < planes ; ++plane)
+    {
+        for (int y0 = 0 ; y0 < height ; y0 += blockRows)
+        {
+            for (int x0 = 0 ; x0 < width ; x0 += blockWidth)
+            {
+                block.fill(0);
+
+                for (int y = y0 ; y < qMin(y0 + blockRows, height) ; ++y)
+                {
+                    for (int x = x0 ; x < qMin(x0 + blockWidth, width) ; ++x)
+                    {
+                        for (int s = 0 ; s < pixelSamples ; ++s)
+                        {
+                            // The samples are red, green, blue and alpha, the channels of DImg blue, green, red and alpha
+
+                            const int sample  = separate ? plane : s;
+                            const int channel = (sample < 3) ? (2 - sample) : 3;
+                            const int pixel   = (y * width + x) * 4 + channel;
+                            const int index   = ((y - y0) * blockWidth + (x - x0)) * pixelSamples + s;
+
+                            if (img.sixteenBit())
+                            {
+                                reinterpret_cast<ushort*>(block.data())[index] = reinterpret_cast<const ushort*>(img.bits())[pixel];
+                            }
+                            else
+                            {
+                                block.data()[index] = img.bits()[pixel];
+                            }
+                        }
+                    }
+                }
+
+                if (tiled)
+                {
+                    ok = ok && (TIFFWriteTile(tif, block.data(), x0, y0, 0, plane) != -1);
+                }
+                else
+                {
+                    ok = ok && (TIFFWriteScanline(tif, block.data(), y0, plane) != -1);
+                }
+            }
+        }
+    }
+
+    TIFFClose(tif);
+
+    return ok;
+}
+
+static QString tiffName(bool sixteenBit, bool alpha, bool separate, bool tiled)
+{
+    return QString::fromLatin1("%1-%2-%3-%4.tif").arg(sixteenBit ? QLatin1String("16") : QLatin1String("8"))
+                                                 .arg(alpha      ? QLatin1String("rgba")     : QLatin1String("rgb"))
+                                                 .arg(separate   ? QLatin1String("separate") : QLatin1String("contig"))
+                                                 .arg(tiled      ? QLatin1String("tiles")    : QLatin1String("strips"));
+}
+
+/** Returns a description of the first different pixel, or an empty string for identical images.
+ */
+static QString difference(const DImg& expected, const DImg& actual)
+{
+    if (expected.size()       != actual.size()       ||
+        expected.sixteenBit() != actual.sixteenBit() ||
+        expected.hasAlpha()   != actual.hasAlpha())
+    {
+        return QString::fromLatin1("%1 x %2 image instead of %3 x %4").arg(actual.width()).arg(actual.height())
+                                                                    .arg(expected.width()).arg(expected.height());
+    }
+
+    for (uint i = 0 ; i < expected.numBytes() ; ++i)
+    {
+        if (expected.bits()[i] != actual.bits()[i])
+        {
+            const int pixel = i / expected.bytesDepth();
+
+            return QString::fromLatin1("pixel (%1, %2) differs").arg(pixel % expected.width())
+                                                                .arg(pixel / expected.width());
+        }
+    }
+
+    return QString();
+}
+
+QString DImgLoadRegionTest::filePath(const QString& name) const
+{
+    return (m_tempDir.path() + QLatin1Char('/') + name);
+}
+
+void DImgLoadRegionTest::initTestCase()
+{
+    QVERIFY(m_tempDir.isValid());
+
+    DImg jpeg = createImage(s_jpegWidth, s_jpegHeight, false, false);
+    jpeg.setAttribute(QLatin1String("quality"),     90);
+    jpeg.setAttribute(QLatin1String("subsampling"), 2);     // 4:2:0
+    QVERIFY(jpeg.save(filePath(QLatin1String("420.jpg")), QLatin1String("JPG")));
+
+    QVERIFY(createImage(s_width, s_height, false, true).save(filePath(QLatin1String("8-rgba.png")),  QLatin1String("PNG")));
+    QVERIFY(createImage(s_width, s_height, true,  false).save(filePath(QLatin1String("16-rgb.png")), QLatin1String("PNG")));
+
+#ifdef HAVE_JASPER
+    QVERIFY(createImage(s_width, s_height, false, false).save(filePath(QLatin1String("8-rgb.jp2")),  QLatin1String("JP2")));
+    QVERIFY(createImage(s_width, s_height, true,  true).save(filePath(QLatin1String("16-rgba.jp2")), QLatin1String("JP2")));
+#endif
+
+    for (int i = 0 ; i < 16 ; ++i)
+    {
+        const bool sixteenBit = (i & 1);
+        const bool alpha      = (i & 2);
+        const bool separate   = (i & 4);
+        const bool tiled      = (i & 8);
+
+        QVERIFY(writeTiff(filePath(tiffName(sixteenBit, alpha, separate, tiled)),
+                          createImage(s_width, s_height, sixteenBit, alpha), separate, tiled));
+    }
+}
+
+void DImgLoadRegionTest::testLoadRegion_data()
+{
+    QTest::addColumn<QString>("name");
+    QTest::addColumn<QRect>("region");
+
+    // JPEG 4:2:0, with odd offsets and sizes, at the borders and smaller than a block
+
+    QTest::newRow("jpeg odd offsets")  << QString::fromLatin1("420.jpg") << QRect(37, 53, 201, 117);
+    QTest::newRow("jpeg 3 x 3")        << QString::fromLatin1("420.jpg") << QRect(1, 1, 3, 3);
+    QTest::newRow("jpeg bottom right") << QString::fromLatin1("420.jpg") << QRect(899, 651, 122, 112);
+    QTest::newRow("jpeg column")       << QString::fromLatin1("420.jpg") << QRect(501, 0, 1, s_jpegHeight);
+    QTest::newRow("jpeg row")          << QString::fromLatin1("420.jpg") << QRect(0, 379, s_jpegWidth, 1);
+
+    const QList<QRect> regions = QList<QRect>() << QRect(37, 53, 101, 67)
+                                                << QRect(250, 180, 51, 23)
+                                                << QRect(0, 202, s_width, 1);
+
+    QStringList names;
+
+    for (int i = 0 ; i < 16 ; ++i)
+    {
+        names << tiffName(i & 1, i & 2, i & 4, i & 8);
+    }
+
+    names << QString::fromLatin1("8-rgba.png") << QString::fromLatin1("16-rgb.png");
+
+#ifdef HAVE_JASPER
+    names << QString::fromLatin1("8-rgb.jp2") << QString::fromLatin1("16-rgba.jp2");
+#endif
+
+    foreach (const QString& name, names)
+    {
+        foreach (const QRect& region, regions)
+        {
+            QTest::newRow(QString::fromLatin1("%1 at %2,%3 %4 x %5").arg(name)
+                          .arg(region.x()).arg(region.y()).arg(region.width()).arg(region.height()).toLatin1().constData())
+                << name << region;
+        }
+    }
+}
+
+void DImgLoadRegionTest::testLoadRegion()
+{
+    QFETCH(QString, name);
+    QFETCH(QRect, region);
+
+    const QString path = filePath(name);
+
+    DImg full;
+    QVERIFY(full.load(path, false, true, false, false));
+
+    DImg img;
+    QVERIFY(img.loadRegion(path, region));
+    QCOMPARE(img.attribute(QLatin1String("originalSize")).toSize(), full.size());
+
+    const QString error = difference(full.copy(region), img);
+    QVERIFY2(error.isEmpty(), qPrintable(error));
+}
+
+void DImgLoadRegionTest::testScaledJpegRegion_data()
+{
+    QTest::addColumn<QRect>("region");
+    QTest::addColumn<int>("scaledLoadingSize");
+
+    // The scaled loading size applies to the region. The regions do not touch the borders,
+    // whose partial blocks are scaled with rounded sizes.
+
+    QTest::newRow("1/2")             << QRect(137, 91, 403, 301)  << 150;
+    QTest::newRow("1/4")             << QRect(137, 91, 403, 301)  << 100;
+    QTest::newRow("1/2 odd offsets") << QRect(251, 333, 301, 203) << 120;
+    QTest::newRow("1/8 odd offsets") << QRect(63, 17, 811, 651)   << 100;
+}
+
+void DImgLoadRegionTest::testScaledJpegRegion()
+{
+    QFETCH(QRect, region);
+    QFETCH(int, scaledLoadingSize);
+
+    const QString path = filePath(QLatin1String("420.jpg"));
+
+    // As the JPEG loader, which supports 1/1, 1/2, 1/4 and 1/8
+
+    int scale = 1;
+
+    while (scaledLoadingSize * scale * 2 <= qMax(region.width(), region.height()) && scale < 8)
+    {
+        scale *= 2;
+    }
+
+    // The full image loaded with the same scale
+
+    DImg full;
+    full.setAttribute(QLatin1String("scaledLoadingSize"), qMax(s_jpegWidth, s_jpegHeight) / scale);
+    QVERIFY(full.load(path, false, true, false, false));
+    QCOMPARE(full.width(), (s_jpegWidth + scale - 1) / scale);
+
+    DImg img;
+    QVERIFY(img.loadRegion(path, region, scaledLoadingSize));
+
+    const QRect scaled(qRound((double)region.x()      / scale), qRound((double)region.y()      / scale),
+                       qRound((double)region.width()  / scale), qRound((double)region.height() / scale));
+
+    const QString error = difference(full.copy(scaled), img);
+    QVERIFY2(error.isEmpty(), qPrintable(error));
+}
+
+void DImgLoadRegionTest::testMapToStoredOrientation()
+{
+    // Each pixel of the stored image has its own value
+
+    DImg stored(7, 5, false, false);
+
+    for (int i = 0 ; i < 7 * 5 ; ++i)
+    {
+        stored.bits()[i * 4]     = i;
+        stored.bits()[i * 4 + 1] = 0;
+        stored.bits()[i * 4 + 2] = 0;
+        stored.bits()[i * 4 + 3] = 0xFF;
+    }
+
+    for (int orientation = MetaEngine::ORIENTATION_NORMAL ; orientation <= MetaEngine::ORIENTATION_ROT_270 ; ++orientation)
+    {
+        DImg oriented = stored.copy();
+        oriented.rotateAndFlip(orientation);
+
+        const QList<QRect> rects = QList<QRect>() << QRect(1, 2, 3, 2)
+                                                  << QRect(0, 0, oriented.width(), 1)
+                                                  << QRect(oriented.width() - 2, 1, 2, oriented.height() - 1)
+                                                  << QRect(QPoint(0, 0), oriented.size());
+
+        foreach (const QRect& rect, rects)
+        {
+            // The stored part, displayed with the orientation, is the part of the oriented image
+
+            const QRect storedRect = TagRegion::mapToStoredOrientation(rect, stored.size(), orientation);
+            QVERIFY(QRect(QPoint(0, 0), stored.size()).contains(storedRect));
+
+            DImg part = stored.copy(storedRect);
+            part.rotateAndFlip(orientation);
+
+            const QString error = difference(oriented.copy(rect), part);
+            QVERIFY2(error.isEmpty(), qPrintable(QString::fromLatin1("orientation %1: %2").arg(orientation).arg(error)));
+        }
+    }
+}
@@ -0,0 +1,56 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-11-10
+ * Description : DImg regions decoded by the loaders, compared with a cropped full image
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_DIMG_LOAD_REGION_TEST_H
+#define DIGIKAM_DIMG_LOAD_REGION_TEST_H
+
+// Qt includes
+
+#include <QObject>
+#include <QString>
+#include <QTemporaryDir>
+
+class DImgLoadRegionTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void initTestCase();
+
+    void testLoadRegion();
+    void testLoadRegion_data();
+    void testScaledJpegRegion();
+    void testScaledJpegRegion_data();
+    void testMapToStoredOrientation();
+
+private:
+
+    QString filePath(const QString& name) const;
+
+private:
+
+    QTemporaryDir m_tempDir;
+};
+
+#endif // DIGIKAM_DIMG_LOAD_REGION_TEST_H
@@ -0,0 +1,132 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-11-10
+ * Description : DImg smooth scale benchmark CLI tool.
+ *               It scales a synthetic 50 megapixels image down to
+ *               256 px, 1920 px and 50 %, with 8 and 16 bits depth,
+ *               using one thread and all threads of the global pool.
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+// Qt includes
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QThreadPool>
+#include <QDebug>
+
+// Local includes
+
+#include "dimg.h"
+
+using namespace Digikam;
+
+/// Size of the synthetic image, 50 megapixels with a 3:2 aspect ratio
+static const int s_width  = 8660;
+static const int s_height = 5773;
+
+// --------------------------------------------------------------------------------------------------
+
+DImg createImage(bool sixteenBit)
+{
+    DImg img(s_width, s_height, sixteenBit, true);
+    uchar* const data   = img.bits();
+    const quint64 bytes = img.numBytes();
+    quint32 seed        = 20181110;
+
+    // A gradient with noise, so that no pixel is equal to its neighbours
+
+    for (quint64 i = 0 ; i < bytes ; ++i)
+    {
+        seed    = seed * 1664525 + 1013904223;
+        data[i] = (uchar)((i / 4096 + (seed >> 24)) & 0xFF);
+    }
+
+    return img;
+}
+
+double benchmark(const DImg& img, const QSize& size, int iterations)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int i = 0 ; i < iterations ; ++i)
+    {
+        DImg scaled = img.smoothScale(size, Qt::KeepAspectRatio);
+
+        if (scaled.isNull())
+        {
+            qDebug() << "Scaling failed";
+            return 0.0;
+        }
+    }
+
+    return (double)timer.nsecsElapsed() / 1000000.0 / iterations;
+}
+
+// --------------------------------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    QCoreApplication app(argc, argv);
+
+    if (argc > 2)
+    {
+        qDebug() << "Bad Arguments!!!\nUsage: " << argv[0] << " [number of iterations]";
+        return 0;
+    }
+
+    const int iterations = (argc > 1) ? qMax(1, QString::fromLocal8Bit(argv[1]).toInt()) : 3;
+    const int threads    = QThreadPool::globalInstance()->maxThreadCount();
+
+    const QSize sizes[]  =
+    {
+        QSize(256,  256),
+        QSize(1920, 1920),
+        QSize(s_width / 2, s_height / 2)
+    };
+
+    const char* const names[] =
+    {
+        "256 px",
+        "1920 px",
+        "50 %"
+    };
+
+    for (int depth = 0 ; depth < 2 ; ++depth)
+    {
+        const bool sixteenBit = (depth == 1);
+        DImg img              = createImage(sixteenBit);
+
+        for (int s = 0 ; s < 3 ; ++s)
+        {
+            QThreadPool::globalInstance()->setMaxThreadCount(1);
+            const double single = benchmark(img, sizes[s], iterations);
+
+            QThreadPool::globalInstance()->setMaxThreadCount(threads);
+            const double all    = benchmark(img, sizes[s], iterations);
+
+            qDebug() << (sixteenBit ? "16 bits," : "8 bits,") << "50 MP to" << names[s] << ":"
+                     << single << "ms with 1 thread," << all << "ms with" << threads << "threads,"
+                     << (double)s_width * s_height / all / 1000.0 << "MP/s";
+        }
+    }
+
+    return 0;
+}
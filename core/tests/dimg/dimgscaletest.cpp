@@ -0,0 +1,223 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-11-10
+ * Description : DImg smooth scaling with the SSE4.1 code and in bands of rows,
+ *               compared with the scalar code in one thread
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "dimgscaletest.h"
+
+// Qt includes
+
+#include <QTest>
+#include <QList>
+#include <QRect>
+#include <QSize>
+#include <QThreadPool>
+
+// Local includes
+
+#include "dimg.h"
+
+using namespace Digikam;
+
+QTEST_GUILESS_MAIN(DImgScaleTest)
+
+static DImg createImage(const QSize& size, bool sixteenBit, bool alpha)
+{
+    DImg img(size.width(), size.height(), sixteenBit, alpha);
+    uchar* const data   = img.bits();
+    const quint64 bytes = img.numBytes();
+    quint32 seed        = 20181110;
+
+    // Noise over the full range of the channels, including the alpha channel of the RGB images
+
+    for (quint64 i = 0 ; i < bytes ; ++i)
+    {
+        seed    = seed * 1664525 + 1013904223;
+        data[i] = (uchar)(seed >> 24);
+    }
+
+    return img;
+}
+
+/** Returns the results of the three smooth scaling functions, the clip and the section
+ *  starting at odd offsets.
+ */
+static QList<DImg> scale(const DImg& img, const QSize& destSize)
+{
+    const QRect clip(QPoint((destSize.width() / 3) | 1, (destSize.height() / 5) | 1),
+                     QSize(destSize.width() / 2, destSize.height() / 2));
+    const QRect section(QPoint((img.width() / 7) | 1, (img.height() / 9) | 1),
+                        QSize(img.width() / 2 + 1, img.height() / 2 + 1));
+
+    return QList<DImg>() << img.smoothScale(destSize)
+                         << img.smoothScaleClipped(destSize, clip)
+                         << img.smoothScaleSection(section, QSize(destSize.width() / 2 + 1, destSize.height() / 2 + 1));
+}
+
+/** Returns a description of the first different pixel, or an empty string for identical images.
+ */
+static QString difference(const DImg& expected, const DImg& actual)
+{
+    if (expected.size() != actual.size() || expected.sixteenBit() != actual.sixteenBit())
+    {
+        return QString::fromLatin1("size or depth differs");
+    }
+
+    const int bytesDepth = expected.bytesDepth();
+
+    for (uint i = 0 ; i < expected.numBytes() ; ++i)
+    {
+        if (expected.bits()[i] != actual.bits()[i])
+        {
+            const int pixel = i / bytesDepth;
+
+            return QString::fromLatin1("pixel (%1, %2) differs")
+                   .arg(pixel % expected.width()).arg(pixel / expected.width());
+        }
+    }
+
+    return QString();
+}
+
+static void compareImages(const QList<DImg>& expected, const QList<DImg>& actual)
+{
+    const char* const names[] = { "smoothScale", "smoothScaleClipped", "smoothScaleSection" };
+
+    QCOMPARE(actual.size(), expected.size());
+
+    for (int i = 0 ; i < expected.size() ; ++i)
+    {
+        QVERIFY(!expected.at(i).isNull());
+
+        const QString error = difference(expected.at(i), actual.at(i));
+        QVERIFY2(error.isEmpty(), qPrintable(QString::fromLatin1("%1: %2").arg(QLatin1String(names[i])).arg(error)));
+    }
+}
+
+void DImgScaleTest::initTestCase()
+{
+    // The images are scaled in bands even on a computer with one core
+
+    m_maxThreadCount = QThreadPool::globalInstance()->maxThreadCount();
+    QThreadPool::globalInstance()->setMaxThreadCount(qMax(m_maxThreadCount, 4));
+}
+
+void DImgScaleTest::cleanupTestCase()
+{
+    QThreadPool::globalInstance()->setMaxThreadCount(m_maxThreadCount);
+    DImg::setSmoothScaleSimd(true);
+    DImg::setSmoothScaleThreads(true);
+}
+
+void DImgScaleTest::addRows()
+{
+    QTest::addColumn<bool>("sixteenBit");
+    QTest::addColumn<bool>("alpha");
+    QTest::addColumn<QSize>("size");
+    QTest::addColumn<QSize>("destSize");
+
+    // Only the scaling down in both directions has a SSE4.1 version. The images
+    // have more than one megapixel, so that they are scaled in bands.
+
+    QTest::newRow("8 bits rgb")        << false << false << QSize(1200, 1000) << QSize(300, 250);
+    QTest::newRow("8 bits rgba")       << false << true  << QSize(1200, 1000) << QSize(300, 250);
+    QTest::newRow("16 bits rgb")       << true  << false << QSize(1200, 1000) << QSize(300, 250);
+    QTest::newRow("16 bits rgba")      << true  << true  << QSize(1200, 1000) << QSize(300, 250);
+
+    // Odd sizes, where the source span of the pixels varies along the rows and the columns
+
+    QTest::newRow("8 bits rgb odd")    << false << false << QSize(1301, 829)  << QSize(97, 33);
+    QTest::newRow("8 bits rgba odd")   << false << true  << QSize(1301, 829)  << QSize(97, 33);
+    QTest::newRow("16 bits rgb odd")   << true  << false << QSize(1301, 829)  << QSize(97, 33);
+    QTest::newRow("16 bits rgba odd")  << true  << true  << QSize(1301, 829)  << QSize(97, 33);
+    QTest::newRow("8 bits rgba small") << false << true  << QSize(37, 29)     << QSize(11, 7);
+    QTest::newRow("16 bits rgb small") << true  << false << QSize(7, 5)       << QSize(3, 2);
+
+    // The other directions use the scalar code in all cases
+
+    QTest::newRow("8 bits rgba up")    << false << true  << QSize(301, 201)   << QSize(1303, 805);
+    QTest::newRow("16 bits rgb mixed") << true  << false << QSize(1301, 201)  << QSize(433, 1203);
+}
+
+void DImgScaleTest::testSimd_data()
+{
+    addRows();
+}
+
+void DImgScaleTest::testSimd()
+{
+    QFETCH(bool, sixteenBit);
+    QFETCH(bool, alpha);
+    QFETCH(QSize, size);
+    QFETCH(QSize, destSize);
+
+    const DImg img = createImage(size, sixteenBit, alpha);
+
+    DImg::setSmoothScaleThreads(false);
+
+    DImg::setSmoothScaleSimd(false);
+    const QList<DImg> scalar = scale(img, destSize);
+
+    DImg::setSmoothScaleSimd(true);
+    const QList<DImg> simd   = scale(img, destSize);
+
+    DImg::setSmoothScaleThreads(true);
+
+    compareImages(scalar, simd);
+}
+
+void DImgScaleTest::testBands_data()
+{
+    addRows();
+}
+
+void DImgScaleTest::testBands()
+{
+    QFETCH(bool, sixteenBit);
+    QFETCH(bool, alpha);
+    QFETCH(QSize, size);
+    QFETCH(QSize, destSize);
+
+    const DImg img = createImage(size, sixteenBit, alpha);
+
+    // With and without the SSE4.1 code, each band must give the rows of a single pass
+
+    for (int simd = 0 ; simd < 2 ; ++simd)
+    {
+        DImg::setSmoothScaleSimd(simd == 1);
+
+        DImg::setSmoothScaleThreads(false);
+        const QList<DImg> single = scale(img, destSize);
+
+        DImg::setSmoothScaleThreads(true);
+        const QList<DImg> bands  = scale(img, destSize);
+
+        compareImages(single, bands);
+
+        if (QTest::currentTestFailed())
+        {
+            break;
+        }
+    }
+
+    DImg::setSmoothScaleSimd(true);
+}
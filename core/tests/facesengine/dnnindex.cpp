@@ -0,0 +1,176 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-11-10
+ * Description : DNN face index CLI tool.
+ *               It compares the nearest neighbour search of the index
+ *               with a linear scan on synthetic face vectors, clustered
+ *               by identity like the vectors computed by the DNN.
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+// C++ includes
+
+#include <random>
+#include <vector>
+
+// Qt includes
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QDebug>
+
+// Local includes
+
+#include "../../libs/facesengine/recognition/dlib-dnn/dnnfaceindex.h"
+
+using namespace Digikam;
+
+/// Size of the vectors computed by the DNN, and distance threshold used by DNNFaceModel
+static const int    s_dimension     = 128;
+static const double s_threshold     = 0.6;
+
+/// Number of vectors of each synthetic identity
+static const int    s_facesPerIdentity = 20;
+
+// --------------------------------------------------------------------------------------------------
+
+std::vector<float> createFace(const std::vector<float>& identity, std::mt19937& generator)
+{
+    std::normal_distribution<float> noise(0.0F, 0.025F);
+    std::vector<float> face(s_dimension);
+
+    for (int i = 0 ; i < s_dimension ; ++i)
+    {
+        face[i] = identity[i] + noise(generator);
+    }
+
+    return face;
+}
+
+int linearNearest(const std::vector<std::vector<float> >& faces, const std::vector<float>& query)
+{
+    double minDist = s_threshold;
+    int nearest    = -1;
+
+    for (size_t i = 0 ; i < faces.size() ; ++i)
+    {
+        double dist = DNNFaceIndex::distance(faces[i].data(), query.data(), s_dimension);
+
+        if (dist < minDist)
+        {
+            minDist = dist;
+            nearest = (int)i;
+        }
+    }
+
+    return nearest;
+}
+
+// --------------------------------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    QCoreApplication app(argc, argv);
+
+    if (argc > 3)
+    {
+        qDebug() << "Bad Arguments!!!\nUsage: " << argv[0] << " [number of faces] [number of queries]";
+        return 0;
+    }
+
+    const int numberOfFaces   = (argc > 1) ? QString::fromLocal8Bit(argv[1]).toInt() : 100000;
+    const int numberOfQueries = (argc > 2) ? QString::fromLocal8Bit(argv[2]).toInt() : 1000;
+
+    std::mt19937 generator(20181110);
+    std::normal_distribution<float> center(0.0F, 0.09F);
+
+    std::vector<std::vector<float> > identities((numberOfFaces + s_facesPerIdentity - 1) / s_facesPerIdentity);
+
+    for (size_t i = 0 ; i < identities.size() ; ++i)
+    {
+        for (int j = 0 ; j < s_dimension ; ++j)
+        {
+            identities[i].push_back(center(generator));
+        }
+    }
+
+    std::vector<std::vector<float> > faces;
+
+    for (int i = 0 ; i < numberOfFaces ; ++i)
+    {
+        faces.push_back(createFace(identities[i / s_facesPerIdentity], generator));
+    }
+
+    std::vector<std::vector<float> > queries;
+    std::uniform_int_distribution<int> identity(0, (int)identities.size() - 1);
+
+    for (int i = 0 ; i < numberOfQueries ; ++i)
+    {
+        queries.push_back(createFace(identities[identity(generator)], generator));
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    DNNFaceIndex index;
+    index.build(faces);
+
+    if (!index.isValid())
+    {
+        qDebug() << "Less than" << DNNFaceIndex::MinimumCount << "faces, the index is not used";
+        return 0;
+    }
+
+    qDebug() << "Built index of" << index.count() << "faces in" << timer.elapsed() << "ms";
+
+    std::vector<int> reference;
+    timer.start();
+
+    for (int i = 0 ; i < numberOfQueries ; ++i)
+    {
+        reference.push_back(linearNearest(faces, queries[i]));
+    }
+
+    qDebug() << "Linear scan:" << (double)timer.nsecsElapsed() / 1000.0 / numberOfQueries << "us per query";
+
+    const int probes[] = { 0, 32, 16, 8 };
+
+    for (int p = 0 ; p < 4 ; ++p)
+    {
+        const int maxProbes = probes[p];
+        int found = 0;
+        timer.start();
+
+        for (int i = 0 ; i < numberOfQueries ; ++i)
+        {
+            double dist;
+
+            if (index.nearest(faces, queries[i], s_threshold, &dist, maxProbes) == reference[i])
+            {
+                ++found;
+            }
+        }
+
+        qDebug() << "Index with" << (maxProbes ? QString::number(maxProbes) : QString::fromLatin1("all"))
+                 << "lists:" << (double)timer.nsecsElapsed() / 1000.0 / numberOfQueries << "us per query,"
+                 << "recall" << (double)found / numberOfQueries;
+    }
+
+    return 0;
+}
@@ -0,0 +1,277 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-11-10
+ * Description : a test for the budget and admission of the LoadingCache
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "loadingcachetest.h"
+
+// C++ includes
+
+#include <algorithm>
+
+// Qt includes
+
+#include <QTest>
+#include <QDebug>
+
+// Local includes
+
+#include "loadingcache.h"
+
+using namespace Digikam;
+
+QTEST_GUILESS_MAIN(LoadingCacheTest)
+
+/// Budget of the thumbnail cache in the tests: 16 thumbnails of 256 x 256 pixels
+static const qint64 s_budget = 16 * 256 * 256 * 4;
+
+bool LoadingCacheTest::lookup(const QString& key, const QImage& thumb)
+{
+    LoadingCache* const cache = LoadingCache::cache();
+    LoadingCache::CacheLock lock(cache);
+
+    if (cache->retrieveThumbnail(key))
+    {
+        return true;
+    }
+
+    cache->putThumbnail(key, thumb, QString());
+
+    return false;
+}
+
+void LoadingCacheTest::init()
+{
+    LoadingCache* const cache = LoadingCache::cache();
+    LoadingCache::CacheLock lock(cache);
+
+    cache->removeThumbnails();
+    cache->setCacheBudget(LoadingCache::ThumbnailImageCache, s_budget);
+    cache->resetStatistics();
+}
+
+void LoadingCacheTest::cleanupTestCase()
+{
+    LoadingCache::cleanUp();
+}
+
+void LoadingCacheTest::testByteBudget()
+{
+    QImage large(256, 256, QImage::Format_ARGB32);
+    QImage small(64,  64,  QImage::Format_ARGB32);
+
+    for (int i = 0 ; i < 32 ; ++i)
+    {
+        lookup(QString::fromLatin1("large%1").arg(i), large);
+    }
+
+    LoadingCacheStatistics stats = LoadingCache::cache()->statistics(LoadingCache::ThumbnailImageCache);
+
+    QCOMPARE(stats.count, 16);
+    QVERIFY(stats.usedBytes <= s_budget);
+    QCOMPARE(stats.maxBytes, s_budget);
+
+    // Small thumbnails take less of the budget
+
+    {
+        LoadingCache::CacheLock lock(LoadingCache::cache());
+        LoadingCache::cache()->removeThumbnails();
+    }
+
+    for (int i = 0 ; i < 300 ; ++i)
+    {
+        lookup(QString::fromLatin1("small%1").arg(i), small);
+    }
+
+    stats = LoadingCache::cache()->statistics(LoadingCache::ThumbnailImageCache);
+
+    QCOMPARE(stats.count, 256);
+    QVERIFY(stats.usedBytes <= s_budget);
+
+    // Reducing the budget evicts entries
+
+    {
+        LoadingCache::CacheLock lock(LoadingCache::cache());
+        LoadingCache::cache()->setCacheBudget(LoadingCache::ThumbnailImageCache, s_budget / 2);
+    }
+
+    stats = LoadingCache::cache()->statistics(LoadingCache::ThumbnailImageCache);
+
+    QCOMPARE(stats.count, 128);
+}
+
+void LoadingCacheTest::testStatistics()
+{
+    QImage thumb(256, 256, QImage::Format_ARGB32);
+
+    QVERIFY(!lookup(QLatin1String("a"), thumb));
+    QVERIFY(lookup(QLatin1String("a"), thumb));
+    QVERIFY(lookup(QLatin1String("a"), thumb));
+    QVERIFY(!lookup(QLatin1String("b"), thumb));
+
+    LoadingCacheStatistics stats = LoadingCache::cache()->statistics(LoadingCache::ThumbnailImageCache);
+
+    QCOMPARE(stats.hits,       (qint64)2);
+    QCOMPARE(stats.misses,     (qint64)2);
+    QCOMPARE(stats.insertions, (qint64)2);
+    QCOMPARE(stats.evictions,  (qint64)0);
+    QCOMPARE(stats.hitRate(),  0.5);
+
+    // A thumbnail larger than the budget is never cached
+
+    QVERIFY(!lookup(QLatin1String("huge"), QImage(1024, 1025, QImage::Format_ARGB32)));
+    QVERIFY(!lookup(QLatin1String("huge"), QImage(1024, 1025, QImage::Format_ARGB32)));
+
+    stats = LoadingCache::cache()->statistics(LoadingCache::ThumbnailImageCache);
+
+    QCOMPARE(stats.rejections, (qint64)2);
+
+    LoadingCache::cache()->resetStatistics();
+    stats = LoadingCache::cache()->statistics(LoadingCache::ThumbnailImageCache);
+
+    QCOMPARE(stats.hits,  (qint64)0);
+    QCOMPARE(stats.count, 2);
+}
+
+void LoadingCacheTest::testFrequentEntriesSurviveScan()
+{
+    QImage thumb(256, 256, QImage::Format_ARGB32);
+
+    // Thumbnails of the current album, shown several times
+
+    for (int round = 0 ; round < 4 ; ++round)
+    {
+        for (int i = 0 ; i < 8 ; ++i)
+        {
+            lookup(QString::fromLatin1("album%1").arg(i), thumb);
+        }
+    }
+
+    // Scrolling once through an album six times larger than the cache must not evict them.
+    // Much longer scans age their frequencies, see testShiftedWorkingSet().
+
+    for (int i = 0 ; i < 100 ; ++i)
+    {
+        lookup(QString::fromLatin1("scroll%1").arg(i), thumb);
+    }
+
+    LoadingCache::cache()->resetStatistics();
+
+    for (int i = 0 ; i < 8 ; ++i)
+    {
+        QVERIFY(lookup(QString::fromLatin1("album%1").arg(i), thumb));
+    }
+
+    // The scrolled thumbnails still use the remaining budget
+
+    LoadingCacheStatistics stats = LoadingCache::cache()->statistics(LoadingCache::ThumbnailImageCache);
+
+    QCOMPARE(stats.count, 16);
+}
+
+void LoadingCacheTest::testShiftedWorkingSet()
+{
+    QImage thumb(256, 256, QImage::Format_ARGB32);
+
+    // Thumbnails of an album which was browsed for a long time
+
+    for (int round = 0 ; round < 16 ; ++round)
+    {
+        for (int i = 0 ; i < 8 ; ++i)
+        {
+            lookup(QString::fromLatin1("old%1").arg(i), thumb);
+        }
+    }
+
+    // The user switched to another album, which fills the whole cache
+
+    for (int round = 0 ; round < 16 ; ++round)
+    {
+        for (int i = 0 ; i < 16 ; ++i)
+        {
+            lookup(QString::fromLatin1("new%1").arg(i), thumb);
+        }
+    }
+
+    // The frequencies of the old thumbnails were aged, they are replaced
+
+    LoadingCache* const cache = LoadingCache::cache();
+    LoadingCache::CacheLock lock(cache);
+
+    for (int i = 0 ; i < 8 ; ++i)
+    {
+        QVERIFY(!cache->retrieveThumbnail(QString::fromLatin1("old%1").arg(i)));
+    }
+
+    for (int i = 0 ; i < 16 ; ++i)
+    {
+        QVERIFY(cache->retrieveThumbnail(QString::fromLatin1("new%1").arg(i)));
+    }
+}
+
+void LoadingCacheTest::testHitRate_data()
+{
+    QTest::addColumn<int>("numberOfKeys");
+
+    QTest::newRow("64 thumbnails")   << 64;
+    QTest::newRow("256 thumbnails")  << 256;
+    QTest::newRow("1024 thumbnails") << 1024;
+}
+
+void LoadingCacheTest::testHitRate()
+{
+    QFETCH(int, numberOfKeys);
+
+    QImage thumb(256, 256, QImage::Format_ARGB32);
+
+    // Access the thumbnails with a Zipf distribution: few are used often, most are used rarely
+
+    QVector<double> cumulated;
+    double sum = 0.0;
+
+    for (int i = 0 ; i < numberOfKeys ; ++i)
+    {
+        sum += 1.0 / (i + 1);
+        cumulated << sum;
+    }
+
+    qsrand(20181110);
+
+    QBENCHMARK
+    {
+        init();
+
+        for (int n = 0 ; n < 20000 ; ++n)
+        {
+            const double r = sum * qrand() / RAND_MAX;
+            const int key  = std::lower_bound(cumulated.constBegin(), cumulated.constEnd(), r) - cumulated.constBegin();
+
+            lookup(QString::number(key), thumb);
+        }
+    }
+
+    LoadingCacheStatistics stats = LoadingCache::cache()->statistics(LoadingCache::ThumbnailImageCache);
+
+    qDebug() << numberOfKeys << "thumbnails, hit rate:" << stats.hitRate()
+             << "evictions:" << stats.evictions << "rejections:" << stats.rejections;
+
+    QVERIFY(stats.usedBytes <= s_budget);
+}
@@ -0,0 +1,54 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-11-10
+ * Description : a test for the budget and admission of the LoadingCache
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_LOADING_CACHE_TEST_H
+#define DIGIKAM_LOADING_CACHE_TEST_H
+
+// Qt includes
+
+#include <QObject>
+#include <QImage>
+#include <QString>
+
+class LoadingCacheTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void init();
+    void cleanupTestCase();
+
+    void testByteBudget();
+    void testStatistics();
+    void testFrequentEntriesSurviveScan();
+    void testShiftedWorkingSet();
+    void testHitRate();
+    void testHitRate_data();
+
+private:
+
+    bool lookup(const QString& key, const QImage& thumb);
+};
+
+#endif // DIGIKAM_LOADING_CACHE_TEST_H
@@ -0,0 +1,273 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-11-10
+ * Description : persistent multi-resolution cache of previews
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "previewpyramidcachetest.h"
+
+// Qt includes
+
+#include <QTest>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+
+// Local includes
+
+#include "dimg.h"
+#include "drawdecoding.h"
+#include "previewpyramidcache.h"
+#include "previewsettings.h"
+
+using namespace Digikam;
+
+QTEST_GUILESS_MAIN(PreviewPyramidCacheTest)
+
+/// Size of the test images, large enough to be stored in the cache
+static const int    s_size      = 2048;
+
+/// Maximum size of the cache, when not testing the eviction
+static const qint64 s_cacheSize = 1024 * 1048576;
+
+/// Time to wait for a preview written in the background, in milliseconds
+static const int    s_timeout   = 60000;
+
+QString PreviewPyramidCacheTest::writeImage(const QString& name, int seed)
+{
+    // The images differ by their first pixel
+
+    QImage image = m_image;
+    image.setPixel(0, 0, qRgb(seed, seed, seed));
+
+    const QString path = m_tempDir.path() + QLatin1String("/") + name;
+
+    // The RAW test files are PNG files with a RAW extension, only their name matters to the cache
+
+    return (image.save(path, "PNG") ? path : QString());
+}
+
+qint64 PreviewPyramidCacheTest::storedSize() const
+{
+    QDir   dir(m_tempDir.path() + QLatin1String("/cache"));
+    qint64 size = 0;
+
+    foreach (const QFileInfo& info, dir.entryInfoList(QStringList() << QLatin1String("*.pgf"), QDir::Files))
+    {
+        size += info.size();
+    }
+
+    return size;
+}
+
+void PreviewPyramidCacheTest::initTestCase()
+{
+    QVERIFY(m_tempDir.isValid());
+
+    m_image = QImage(s_size, s_size, QImage::Format_RGB32);
+
+    for (int y = 0 ; y < s_size ; ++y)
+    {
+        for (int x = 0 ; x < s_size ; ++x)
+        {
+            m_image.setPixel(x, y, qRgb(((x * 7) ^ y) & 0xFF, (y * 3) & 0xFF, (x + y) & 0xFF));
+        }
+    }
+}
+
+void PreviewPyramidCacheTest::init()
+{
+    PreviewPyramidCache* const cache = PreviewPyramidCache::instance();
+
+    cache->clear();
+    cache->initialize(m_tempDir.path() + QLatin1String("/cache"), s_cacheSize);
+
+    QVERIFY(cache->isEnabled());
+}
+
+void PreviewPyramidCacheTest::cleanupTestCase()
+{
+    PreviewPyramidCache::instance()->clear();
+}
+
+void PreviewPyramidCacheTest::testHitAndMiss()
+{
+    PreviewPyramidCache* const cache = PreviewPyramidCache::instance();
+    const PreviewSettings settings(PreviewSettings::HighQualityPreview);
+    const DRawDecoding    rawDecoding;
+    const QString         path       = writeImage(QLatin1String("hit.png"), 1);
+    const QImage          original(path);
+
+    QVERIFY(!path.isEmpty());
+    QVERIFY(cache->accepts(path, settings));
+    QVERIFY(!cache->contains(path, settings, rawDecoding));
+    QVERIFY(cache->load(path, settings, rawDecoding).isNull());
+
+    cache->store(path, settings, rawDecoding, DImg(original));
+
+    QTRY_VERIFY_WITH_TIMEOUT(cache->contains(path, settings, rawDecoding), s_timeout);
+
+    // The stored pixels are the decoded ones
+
+    DImg preview = cache->load(path, settings, rawDecoding);
+    QVERIFY(!preview.isNull());
+    QVERIFY(!preview.hasAlpha());
+    QCOMPARE(preview.copyQImage().convertToFormat(QImage::Format_ARGB32),
+             original.convertToFormat(QImage::Format_ARGB32));
+
+    // Previews with 16 bits per channel are not cached
+
+    PreviewSettings sixteenBit(PreviewSettings::HighQualityPreview);
+    sixteenBit.convertToEightBit = false;
+    QVERIFY(!cache->accepts(path, sixteenBit));
+
+    // Small previews are decoded from the original file
+
+    const QString small = m_tempDir.path() + QLatin1String("/small.png");
+    QVERIFY(original.copy(0, 0, 256, 256).save(small, "PNG"));
+
+    cache->store(small, settings, rawDecoding, DImg(QImage(small)));
+    QVERIFY(!cache->contains(small, settings, rawDecoding));
+}
+
+void PreviewPyramidCacheTest::testLevels()
+{
+    PreviewPyramidCache* const cache = PreviewPyramidCache::instance();
+    const PreviewSettings settings(PreviewSettings::FastPreview);
+    const DRawDecoding    rawDecoding;
+    const QString         path       = writeImage(QLatin1String("levels.png"), 2);
+    const QImage          original   = QImage(path).convertToFormat(QImage::Format_ARGB32);
+
+    cache->store(path, settings, rawDecoding, DImg(QImage(path)));
+
+    QTRY_VERIFY_WITH_TIMEOUT(cache->contains(path, settings, rawDecoding), s_timeout);
+
+    // The smallest level at least as large as the requested size
+
+    DImg level = cache->load(path, settings, rawDecoding, 512);
+    QVERIFY(!level.isNull());
+    QVERIFY(qMax(level.width(), level.height()) >= 512);
+    QVERIFY(qMax(level.width(), level.height()) <  s_size);
+
+    // A region of the full size level, given in full size coordinates
+
+    const QRect rect(101, 203, 517, 331);
+    QImage region = cache->loadRegion(path, settings, rawDecoding, rect);
+    QCOMPARE(region.size(), rect.size());
+    QCOMPARE(region.convertToFormat(QImage::Format_ARGB32), original.copy(rect));
+}
+
+void PreviewPyramidCacheTest::testModifiedFile()
+{
+    PreviewPyramidCache* const cache = PreviewPyramidCache::instance();
+    const PreviewSettings settings(PreviewSettings::HighQualityPreview);
+    const DRawDecoding    rawDecoding;
+    const QString         path       = writeImage(QLatin1String("modified.png"), 3);
+
+    cache->store(path, settings, rawDecoding, DImg(QImage(path)));
+
+    QTRY_VERIFY_WITH_TIMEOUT(cache->contains(path, settings, rawDecoding), s_timeout);
+
+    // A new modification time invalidates the entry, without a new scan of the file
+
+    const QDateTime modified = QFileInfo(path).lastModified();
+
+    while (QFileInfo(path).lastModified() == modified)
+    {
+        QTest::qSleep(10);
+        QVERIFY(!writeImage(QLatin1String("modified.png"), 4).isEmpty());
+    }
+
+    QVERIFY(!cache->contains(path, settings, rawDecoding));
+    QVERIFY(cache->load(path, settings, rawDecoding).isNull());
+}
+
+void PreviewPyramidCacheTest::testRawSettings()
+{
+    PreviewPyramidCache* const cache = PreviewPyramidCache::instance();
+    const PreviewSettings settings(PreviewSettings::HighQualityPreview, PreviewSettings::RawPreviewFromRawHalfSize);
+    const DRawDecoding    rawDecoding;
+    const QString         path       = writeImage(QLatin1String("raw.nef"), 5);
+
+    QCOMPARE(DImg::fileFormat(path), DImg::RAW);
+    QVERIFY(cache->accepts(path, settings));
+
+    // The embedded previews are not cached
+
+    QVERIFY(!cache->accepts(path, PreviewSettings(PreviewSettings::HighQualityPreview,
+                                                  PreviewSettings::RawPreviewFromEmbeddedPreview)));
+    QVERIFY(!cache->accepts(path, PreviewSettings(PreviewSettings::FastPreview,
+                                                  PreviewSettings::RawPreviewFromRawHalfSize)));
+
+    cache->store(path, settings, rawDecoding, DImg(m_image));
+
+    QTRY_VERIFY_WITH_TIMEOUT(cache->contains(path, settings, rawDecoding), s_timeout);
+
+    // The preview decoded with other settings is another entry
+
+    DRawDecoding other;
+    other.rawPrm.autoBrightness = !rawDecoding.rawPrm.autoBrightness;
+
+    QVERIFY(!cache->contains(path, settings, other));
+    QVERIFY(cache->load(path, settings, other).isNull());
+    QVERIFY(cache->contains(path, settings, DRawDecoding()));
+}
+
+void PreviewPyramidCacheTest::testEviction()
+{
+    PreviewPyramidCache* const cache = PreviewPyramidCache::instance();
+    const PreviewSettings settings(PreviewSettings::HighQualityPreview);
+    const DRawDecoding    rawDecoding;
+    const QString         first      = writeImage(QLatin1String("first.png"),  6);
+    const QString         second     = writeImage(QLatin1String("second.png"), 7);
+    const QString         third      = writeImage(QLatin1String("third.png"),  8);
+
+    cache->store(first, settings, rawDecoding, DImg(QImage(first)));
+
+    QTRY_VERIFY_WITH_TIMEOUT(cache->contains(first, settings, rawDecoding), s_timeout);
+
+    // The files of the three images have about the same size, the cache can hold two of them.
+    // The entries already in the directory are kept by the new initialization.
+
+    const qint64 entrySize = storedSize();
+    QVERIFY(entrySize > 0);
+
+    cache->initialize(m_tempDir.path() + QLatin1String("/cache"), 2 * entrySize + entrySize / 2);
+    QVERIFY(cache->contains(first, settings, rawDecoding));
+
+    QTest::qSleep(10);
+    cache->store(second, settings, rawDecoding, DImg(QImage(second)));
+
+    QTRY_VERIFY_WITH_TIMEOUT(cache->contains(second, settings, rawDecoding), s_timeout);
+
+    // The first entry is used again, the second one is now the least recently used
+
+    QTest::qSleep(10);
+    QVERIFY(!cache->load(first, settings, rawDecoding).isNull());
+
+    QTest::qSleep(10);
+    cache->store(third, settings, rawDecoding, DImg(QImage(third)));
+
+    QTRY_VERIFY_WITH_TIMEOUT(cache->contains(third, settings, rawDecoding), s_timeout);
+
+    QVERIFY(cache->contains(first, settings, rawDecoding));
+    QVERIFY(!cache->contains(second, settings, rawDecoding));
+    QVERIFY(storedSize() <= 2 * entrySize + entrySize / 2);
+}
@@ -0,0 +1,61 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-11-10
+ * Description : persistent multi-resolution cache of previews
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_PREVIEW_PYRAMID_CACHE_TEST_H
+#define DIGIKAM_PREVIEW_PYRAMID_CACHE_TEST_H
+
+// Qt includes
+
+#include <QObject>
+#include <QImage>
+#include <QString>
+#include <QTemporaryDir>
+
+class PreviewPyramidCacheTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void initTestCase();
+    void init();
+    void cleanupTestCase();
+
+    void testHitAndMiss();
+    void testLevels();
+    void testModifiedFile();
+    void testRawSettings();
+    void testEviction();
+
+private:
+
+    QString writeImage(const QString& name, int seed);
+    qint64  storedSize() const;
+
+private:
+
+    QTemporaryDir m_tempDir;
+    QImage        m_image;
+};
+
+#endif // DIGIKAM_PREVIEW_PYRAMID_CACHE_TEST_H
@@ -0,0 +1,306 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-11-10
+ * Description : Unit tests of the shared job scheduler
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "jobschedulertest.h"
+
+// Qt includes
+
+#include <QAtomicInt>
+#include <QList>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSemaphore>
+#include <QTest>
+
+// Local includes
+
+#include "jobscheduler.h"
+
+using namespace Digikam;
+
+QTEST_GUILESS_MAIN(JobSchedulerTest)
+
+/// Time in milliseconds to wait for jobs before a test fails
+static const int s_timeout = 30000;
+
+class CountingJob : public QRunnable
+{
+public:
+
+    CountingJob(QAtomicInt* const counter, QSemaphore* const done)
+        : counter(counter),
+          done(done)
+    {
+    }
+
+    void run()
+    {
+        counter->ref();
+        done->release();
+    }
+
+private:
+
+    QAtomicInt* const counter;
+    QSemaphore* const done;
+};
+
+class ParentJob : public QRunnable
+{
+public:
+
+    ParentJob(int children, QAtomicInt* const counter, QSemaphore* const done)
+        : children(children),
+          counter(counter),
+          done(done)
+    {
+    }
+
+    void run()
+    {
+        // The children go to the queue of this thread, the other threads steal them
+
+        for (int i = 0 ; i < children ; ++i)
+        {
+            JobScheduler::instance()->schedule(new CountingJob(counter, done), JobScheduler::BatchClass);
+        }
+    }
+
+private:
+
+    const int         children;
+    QAtomicInt* const counter;
+    QSemaphore* const done;
+};
+
+class BlockingJob : public QRunnable
+{
+public:
+
+    BlockingJob(QSemaphore* const started, QSemaphore* const release)
+        : started(started),
+          release(release)
+    {
+    }
+
+    void run()
+    {
+        started->release();
+        release->acquire();
+    }
+
+private:
+
+    QSemaphore* const started;
+    QSemaphore* const release;
+};
+
+class RecordingJob : public QRunnable
+{
+public:
+
+    RecordingJob(int id, QList<int>* const order, QMutex* const mutex, QSemaphore* const done)
+        : id(id),
+          order(order),
+          mutex(mutex),
+          done(done)
+    {
+    }
+
+    void run()
+    {
+        {
+            QMutexLocker lock(mutex);
+            *order << id;
+        }
+
+        done->release();
+    }
+
+private:
+
+    const int         id;
+    QList<int>* const order;
+    QMutex* const     mutex;
+    QSemaphore* const done;
+};
+
+// --------------------------------------------------------------------------------------------------
+
+void JobSchedulerTest::testAllJobsRun()
+{
+    const int count = 1000;
+    QAtomicInt counter(0);
+    QSemaphore done;
+
+    for (int i = 0 ; i < count ; ++i)
+    {
+        JobScheduler::instance()->schedule(new CountingJob(&counter, &done),
+                                           (JobScheduler::PriorityClass)(i % JobScheduler::NumberOfPriorityClasses));
+    }
+
+    QVERIFY(done.tryAcquire(count, s_timeout));
+    QCOMPARE(counter.load(), count);
+}
+
+void JobSchedulerTest::testNestedJobs()
+{
+    const int parents  = 20;
+    const int children = 50;
+    QAtomicInt counter(0);
+    QSemaphore done;
+
+    for (int i = 0 ; i < parents ; ++i)
+    {
+        JobScheduler::instance()->schedule(new ParentJob(children, &counter, &done), JobScheduler::BatchClass);
+    }
+
+    QVERIFY(done.tryAcquire(parents * children, s_timeout));
+    QCOMPARE(counter.load(), parents * children);
+}
+
+void JobSchedulerTest::testPriorityClasses()
+{
+    const int threads = JobScheduler::instance()->threadCount();
+    QSemaphore started;
+    QSemaphore release;
+
+    // Keep all threads busy while the jobs are queued
+
+    for (int i = 0 ; i < threads ; ++i)
+    {
+        JobScheduler::instance()->schedule(new BlockingJob(&started, &release), JobScheduler::InteractiveClass);
+    }
+
+    QVERIFY(started.tryAcquire(threads, s_timeout));
+
+    QList<int> order;
+    QMutex     mutex;
+    QSemaphore done;
+
+    JobScheduler::instance()->schedule(new RecordingJob(3, &order, &mutex, &done), JobScheduler::BatchClass);
+    JobScheduler::instance()->schedule(new RecordingJob(2, &order, &mutex, &done), JobScheduler::EditorClass);
+    JobScheduler::instance()->schedule(new RecordingJob(4, &order, &mutex, &done), JobScheduler::BatchClass);
+    JobScheduler::instance()->schedule(new RecordingJob(0, &order, &mutex, &done), JobScheduler::InteractiveClass);
+    JobScheduler::instance()->schedule(new RecordingJob(1, &order, &mutex, &done), JobScheduler::InteractiveClass);
+
+    // One thread runs the interactive jobs, the others are still blocked
+
+    release.release(1);
+
+    QVERIFY(done.tryAcquire(2, s_timeout));
+
+    int blocked = threads - 1;
+
+    if (threads > 1)
+    {
+        // The lower classes do not take the last free thread
+
+        QVERIFY(!done.tryAcquire(1, 200));
+
+        release.release(1);
+        --blocked;
+    }
+
+    // One thread runs the other jobs, in the order of their class
+
+    QVERIFY(done.tryAcquire(3, s_timeout));
+    QCOMPARE(order, QList<int>() << 0 << 1 << 2 << 3 << 4);
+
+    release.release(blocked);
+}
+
+void JobSchedulerTest::testUnschedule()
+{
+    const int threads = JobScheduler::instance()->threadCount();
+    QSemaphore started;
+    QSemaphore release;
+
+    for (int i = 0 ; i < threads ; ++i)
+    {
+        JobScheduler::instance()->schedule(new BlockingJob(&started, &release), JobScheduler::InteractiveClass);
+    }
+
+    QVERIFY(started.tryAcquire(threads, s_timeout));
+
+    QAtomicInt counter(0);
+    QSemaphore done;
+    CountingJob job(&counter, &done);
+    job.setAutoDelete(false);
+
+    JobScheduler::instance()->schedule(&job, JobScheduler::BatchClass);
+    QCOMPARE(JobScheduler::instance()->counters(JobScheduler::BatchClass).queued, 1);
+
+    QVERIFY(JobScheduler::instance()->unschedule(&job));
+    QVERIFY(!JobScheduler::instance()->unschedule(&job));
+    QCOMPARE(JobScheduler::instance()->counters(JobScheduler::BatchClass).queued, 0);
+
+    release.release(threads);
+
+    QVERIFY(!done.tryAcquire(1, 200));
+    QCOMPARE(counter.load(), 0);
+}
+
+void JobSchedulerTest::testCounters()
+{
+    JobScheduler::Counters before = JobScheduler::instance()->counters(JobScheduler::EditorClass);
+
+    const int count = 10;
+    QAtomicInt counter(0);
+    QSemaphore done;
+
+    for (int i = 0 ; i < count ; ++i)
+    {
+        JobScheduler::instance()->schedule(new CountingJob(&counter, &done), JobScheduler::EditorClass);
+    }
+
+    QVERIFY(done.tryAcquire(count, s_timeout));
+
+    // The counters are updated after the job returned
+
+    JobScheduler::Counters after;
+
+    for (int i = 0 ; i < 100 ; ++i)
+    {
+        after = JobScheduler::instance()->counters(JobScheduler::EditorClass);
+
+        if (after.finished - before.finished == count)
+        {
+            break;
+        }
+
+        QTest::qWait(10);
+    }
+
+    QCOMPARE(after.finished - before.finished, (qint64)count);
+    QCOMPARE(after.queued, 0);
+    QCOMPARE(after.running, 0);
+
+    JobScheduler::instance()->beginExternalWork(JobScheduler::InteractiveClass);
+    QCOMPARE(JobScheduler::instance()->counters(JobScheduler::InteractiveClass).external, 1);
+    JobScheduler::instance()->endExternalWork(JobScheduler::InteractiveClass);
+    QCOMPARE(JobScheduler::instance()->counters(JobScheduler::InteractiveClass).external, 0);
+
+    const double utilization = JobScheduler::instance()->utilization(JobScheduler::EditorClass);
+    QVERIFY(utilization >= 0.0 && utilization <= 1.0);
+}
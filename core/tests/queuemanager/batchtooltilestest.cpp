@@ -0,0 +1,137 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-11-10
+ * Description : a test comparing the tiled and the untiled results
+ *               of the batch tools point operations
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "batchtooltilestest.h"
+
+// C++ includes
+
+#include <cstring>
+
+// Qt includes
+
+#include <QTest>
+
+// Local includes
+
+#include "wbfilter.h"
+#include "whitebalance.h"
+
+using namespace Digikam;
+
+QTEST_GUILESS_MAIN(BatchToolTilesTest)
+
+/// Size of the synthetic image, and height of the tiles. The last tile is not full.
+static const int s_width    = 641;
+static const int s_height   = 427;
+static const int s_tileRows = 64;
+
+DImg BatchToolTilesTest::createImage(bool sixteenBit) const
+{
+    DImg img(s_width, s_height, sixteenBit, true);
+    uchar* const data         = img.bits();
+    const quint64 bytesPerRow = (quint64)img.width() * img.bytesDepth();
+    quint32 seed              = 20181110;
+
+    // The brightness grows from the top to the bottom, so that the channel
+    // maximums of each tile differ from the ones of the whole image
+
+    for (int y = 0 ; y < s_height ; ++y)
+    {
+        const int base = y * 192 / s_height;
+
+        for (quint64 x = 0 ; x < bytesPerRow ; ++x)
+        {
+            seed                      = seed * 1664525 + 1013904223;
+            data[y * bytesPerRow + x] = (uchar)(base + (seed >> 26));
+        }
+    }
+
+    return img;
+}
+
+void BatchToolTilesTest::testWhiteBalanceTiles_data()
+{
+    QTest::addColumn<bool>("sixteenBit");
+
+    QTest::newRow("8 bits")  << false;
+    QTest::newRow("16 bits") << true;
+}
+
+void BatchToolTilesTest::testWhiteBalanceTiles()
+{
+    QFETCH(bool, sixteenBit);
+
+    BatchToolSettings settings;
+    settings.insert(QLatin1String("black"),          0.0);
+    settings.insert(QLatin1String("temperature"),    4200.0);
+    settings.insert(QLatin1String("green"),          1.2);
+    settings.insert(QLatin1String("dark"),           0.3);
+    settings.insert(QLatin1String("gamma"),          1.0);
+    settings.insert(QLatin1String("saturation"),     1.4);
+    settings.insert(QLatin1String("expositionMain"), 0.0);
+    settings.insert(QLatin1String("expositionFine"), 0.0);
+
+    const DImg img = createImage(sixteenBit);
+
+    // Untiled: the filter applied to the whole image, as WhiteBalance::toolOperations() does
+
+    WBContainer prm;
+    prm.black          = settings[QLatin1String("black")].toDouble();
+    prm.temperature    = settings[QLatin1String("temperature")].toDouble();
+    prm.green          = settings[QLatin1String("green")].toDouble();
+    prm.dark           = settings[QLatin1String("dark")].toDouble();
+    prm.gamma          = settings[QLatin1String("gamma")].toDouble();
+    prm.saturation     = settings[QLatin1String("saturation")].toDouble();
+    prm.expositionMain = settings[QLatin1String("expositionMain")].toDouble();
+    prm.expositionFine = settings[QLatin1String("expositionFine")].toDouble();
+
+    DImg whole = img.copy();
+    WBFilter filter(&whole, 0, prm);
+    filter.startFilterDirectly();
+    const DImg untiled = filter.getTargetImage();
+
+    // Tiled: the bands processed one by one, as Task does for chained point operations
+
+    WhiteBalance tool;
+    tool.setSettings(settings);
+    QVERIFY(tool.isPointOperation());
+
+    DImg tiled = img.copy();
+    tool.prepareTileOperations(tiled);
+
+    const size_t bytesPerRow = (size_t)tiled.width() * tiled.bytesDepth();
+
+    for (int row = 0 ; row < s_height ; row += s_tileRows)
+    {
+        const int rows = qMin(s_tileRows, s_height - row);
+        DImg tile      = tiled.copy(0, row, s_width, rows);
+
+        QVERIFY(tool.applyToTile(tile));
+
+        memcpy(tiled.bits() + row * bytesPerRow, tile.bits(), rows * bytesPerRow);
+    }
+
+    QCOMPARE(tiled.numBytes(), untiled.numBytes());
+    QVERIFY(memcmp(tiled.bits(), untiled.bits(), untiled.numBytes()) == 0);
+}
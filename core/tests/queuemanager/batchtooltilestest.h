@@ -0,0 +1,50 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-11-10
+ * Description : a test comparing the tiled and the untiled results
+ *               of the batch tools point operations
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_BATCH_TOOL_TILES_TEST_H
+#define DIGIKAM_BATCH_TOOL_TILES_TEST_H
+
+// Qt includes
+
+#include <QObject>
+
+// Local includes
+
+#include "dimg.h"
+
+class BatchToolTilesTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void testWhiteBalanceTiles_data();
+    void testWhiteBalanceTiles();
+
+private:
+
+    Digikam::DImg createImage(bool sixteenBit) const;
+};
+
+#endif // DIGIKAM_BATCH_TOOL_TILES_TEST_H
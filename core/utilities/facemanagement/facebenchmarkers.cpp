@@ -217,7 +217,8 @@ RecognitionBenchmarker::Statistics::Statistics()
 }
 
 RecognitionBenchmarker::RecognitionBenchmarker(FacePipeline::Private* const d)
-    : d(d)
+    : processedFaces(0),
+      d(d)
 {
 }
 
@@ -231,11 +232,18 @@ QString RecognitionBenchmarker::result() const
         totalImages += stat.knownFaces;
     }
 
+    const qint64 elapsed = timer.isValid() ? timer.elapsed() : 0;
+    const double rate    = (elapsed > 0) ? (processedFaces * 1000.0 / elapsed) : 0.0;
+
     QString s = QString::fromUtf8("<p>"
                         "<u>Collection Properties:</u><br/>"
                         "%1 Images <br/>"
                         "%2 Identities <br/>"
-                        "</p><p>").arg(totalImages).arg(results.size());
+                        "</p><p>"
+                        "<u>Throughput:</u><br/>"
+                        "%3 faces in %4 s, %5 faces/s <br/>"
+                        "</p><p>").arg(totalImages).arg(results.size())
+                                  .arg(processedFaces).arg(elapsed / 1000.0, 0, 'f', 1).arg(rate, 0, 'f', 1);
 
     for (QMap<int, Statistics>::const_iterator it = results.begin() ; it != results.end() ; ++it)
     {
@@ -254,6 +262,13 @@ void RecognitionBenchmarker::process(FacePipelineExtendedPackage::Ptr package)
 {
     FaceUtils utils;
 
+    if (!timer.isValid())
+    {
+        timer.start();
+    }
+
+    processedFaces += package->recognitionResults.size();
+
     for (int i = 0 ; i < package->databaseFaces.size() ; ++i)
     {
         Identity identity  = utils.identityForTag(package->databaseFaces[i].tagId(), database);
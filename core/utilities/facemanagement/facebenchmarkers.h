@@ -27,6 +27,7 @@
 // Qt includes
 
 #include <QExplicitlySharedDataPointer>
+#include <QElapsedTimer>
 #include <QMetaMethod>
 #include <QMutex>
 #include <QSharedData>
@@ -115,6 +116,10 @@ protected:
 
     QMap<int, Statistics>        results;
 
+    /// Throughput of the pipeline, from the first processed package on
+    QElapsedTimer                timer;
+    int                          processedFaces;
+
     FacePipeline::Private* const d;
     RecognitionDatabase          database;
 };
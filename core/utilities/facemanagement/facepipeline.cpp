@@ -46,6 +46,7 @@
 #include "faceworkers.h"
 #include "faceimageretriever.h"
 #include "parallelpipes.h"
+#include "parallelworkers.h"
 #include "scanstatefilter.h"
 
 namespace Digikam
@@ -169,6 +170,7 @@ FacePipeline::~FacePipeline()
     delete d->detectionWorker;
     delete d->parallelDetectors;
     delete d->recognitionWorker;
+    delete d->parallelRecognizers;
     delete d->databaseWriter;
     delete d->trainer;
     qDeleteAll(d->thumbnailLoadThreads);
@@ -257,11 +259,33 @@ void FacePipeline::plugParallelFaceDetectors()
 
 void FacePipeline::plugFaceRecognizer()
 {
-    d->recognitionWorker = new RecognitionWorker(d);
-    d->createThumbnailLoadThread();
+    // All workers share the same database, and so the trained models loaded in memory
 
-    connect(d, SIGNAL(accuracyChanged(double)),
-            d->recognitionWorker, SLOT(setThreshold(double)));
+    RecognitionDatabase database;
+    const int n = ParallelWorkers::optimalWorkerCount();
+
+    if (n <= 1)
+    {
+        d->recognitionWorker = new RecognitionWorker(d, database);
+        d->createThumbnailLoadThread();
+
+        connect(d, SIGNAL(accuracyChanged(double)),
+                d->recognitionWorker, SLOT(setThreshold(double)));
+
+        return;
+    }
+
+    d->parallelRecognizers = new ParallelPipes;
+
+    for (int i = 0 ; i < n ; ++i)
+    {
+        RecognitionWorker* const worker = new RecognitionWorker(d, database);
+
+        connect(d, SIGNAL(accuracyChanged(double)),
+                worker, SLOT(setThreshold(double)));
+
+        d->parallelRecognizers->add(worker);
+    }
 }
 
 void FacePipeline::plugDatabaseWriter(WriteMode mode)
@@ -312,7 +336,12 @@ void FacePipeline::construct()
         qCDebug(DIGIKAM_GENERAL_LOG) << "Face PipeLine: add single thread detector";
     }
 
-    if (d->recognitionWorker)
+    if (d->parallelRecognizers)
+    {
+        d->pipeline << d->parallelRecognizers;
+        qCDebug(DIGIKAM_GENERAL_LOG) << "Face PipeLine: add parallel recognition workers";
+    }
+    else if (d->recognitionWorker)
     {
         d->pipeline << d->recognitionWorker;
         qCDebug(DIGIKAM_GENERAL_LOG) << "Face PipeLine: add recognition worker";
@@ -385,6 +414,14 @@ void FacePipeline::activeFaceRecognizer(RecognitionDatabase::RecognizeAlgorithm
     {
         d->recognitionWorker->activeFaceRecognizer(algorithmType);
     }
+
+    if (d->parallelRecognizers != 0)
+    {
+        foreach (WorkerObject* const object, d->parallelRecognizers->m_workers)
+        {
+            static_cast<RecognitionWorker*>(object)->activeFaceRecognizer(algorithmType);
+        }
+    }
 }
 
 void FacePipeline::cancel()
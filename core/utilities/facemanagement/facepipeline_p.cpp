@@ -78,6 +78,7 @@ FacePipeline::Private::Private(FacePipeline* const q)
     detectionWorker        = 0;
     parallelDetectors      = 0;
     recognitionWorker      = 0;
+    parallelRecognizers    = 0;
     databaseWriter         = 0;
     trainer                = 0;
     detectionBenchmarker   = 0;
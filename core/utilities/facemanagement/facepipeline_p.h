@@ -125,6 +125,7 @@ public:
     DetectionWorker*                        detectionWorker;
     ParallelPipes*                          parallelDetectors;
     RecognitionWorker*                      recognitionWorker;
+    ParallelPipes*                          parallelRecognizers;
     DatabaseWriter*                         databaseWriter;
     Trainer*                                trainer;
     DetectionBenchmarker*                   detectionBenchmarker;
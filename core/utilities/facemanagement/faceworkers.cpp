@@ -87,8 +87,9 @@ void DetectionWorker::setAccuracy(double accuracy)
 
 // ----------------------------------------------------------------------------------------
 
-RecognitionWorker::RecognitionWorker(FacePipeline::Private* const d)
+RecognitionWorker::RecognitionWorker(FacePipeline::Private* const d, const RecognitionDatabase& database)
     : imageRetriever(d),
+      database(database),
       d(d)
 {
 }
@@ -102,6 +103,7 @@ void RecognitionWorker::process(FacePipelineExtendedPackage::Ptr package)
 {
     FaceUtils     utils;
     QList<QImage> images;
+    QStringList   faceKeys;
 
     if (package->processFlags & FacePipelinePackage::ProcessedByDetector)
     {
@@ -110,10 +112,23 @@ void RecognitionWorker::process(FacePipelineExtendedPackage::Ptr package)
     }
     else if (!package->databaseFaces.isEmpty())
     {
-        images = imageRetriever.getThumbnails(package->filePath, package->databaseFaces.toFaceTagsIfaceList());
+        QList<FaceTagsIface> faces = package->databaseFaces.toFaceTagsIfaceList();
+        images                     = imageRetriever.getThumbnails(package->filePath, faces);
+
+        // The face vectors of known regions are cached, identified by the image content and the region
+
+        const QString hash = package->info.uniqueHash();
+
+        if (!hash.isEmpty())
+        {
+            foreach (const FaceTagsIface& face, faces)
+            {
+                faceKeys << RecognitionDatabase::faceEmbeddingKey(hash, face.region().toRect());
+            }
+        }
     }
 
-    package->recognitionResults  = database.recognizeFaces(images);
+    package->recognitionResults  = database.recognizeFaces(images, faceKeys);
     package->processFlags       |= FacePipelinePackage::ProcessedByRecognizer;
 
     emit processed(package);
@@ -82,7 +82,11 @@ class Q_DECL_HIDDEN RecognitionWorker : public WorkerObject
 
 public:
 
-    explicit RecognitionWorker(FacePipeline::Private* const d);
+    /**
+     * Workers created with the same database share its trained models
+     * and recognize faces in parallel.
+     */
+    RecognitionWorker(FacePipeline::Private* const d, const RecognitionDatabase& database);
     ~RecognitionWorker()
     {
         wait();    // protect database
@@ -30,6 +30,9 @@
 
 #include <QMutex>
 #include <QWaitCondition>
+#include <QElapsedTimer>
+#include <QThreadPool>
+#include <QtConcurrent>    // krazy:exclude=includes
 #include <QVariant>
 #include <QImage>
 #include <QFile>
@@ -59,6 +62,9 @@
 namespace Digikam
 {
 
+/// Number of files copied at the same time from USB mass storage devices
+static const int s_parallelDownloads = 4;
+
 class Q_DECL_HIDDEN CameraCommand
 {
 public:
@@ -98,8 +104,22 @@ public:
         conflictRule(SetupCamera::DIFFNAME),
         parent(0),
         timer(0),
-        camera(0)
+        camera(0),
+        activeDownloads(0),
+        downloadIndex(0),
+        downloadedBytes(0)
+    {
+        downloadPool.setMaxThreadCount(s_parallelDownloads);
+    }
+
+    /** Returns true if cmd can run while other downloads are running.
+     *  This is only the case of USB mass storage devices, GPhoto2 devices
+     *  process one command at a time.
+     */
+    bool isParallelDownload(CameraCommand* const cmd) const
     {
+        return (cmd->action == CameraCommand::cam_download &&
+                camera->cameraDriverType() == DKCamera::UMSDriver);
     }
 
     bool                      close;
@@ -121,6 +141,15 @@ public:
 
     QList<CameraCommand*>     cmdThumbs;
     QList<CameraCommand*>     commands;
+
+    /// The downloads running in downloadPool, protected by mutex
+    int                       activeDownloads;
+    int                       downloadIndex;
+    QThreadPool               downloadPool;
+
+    /// Bytes downloaded since downloadTimer was started, protected by mutex
+    qint64                    downloadedBytes;
+    QElapsedTimer             downloadTimer;
 };
 
 CameraController::CameraController(QWidget* const parent,
@@ -371,14 +400,51 @@ void CameraController::run()
     while (d->running)
     {
         CameraCommand* command = 0;
+        bool parallel          = false;
 
         {
             QMutexLocker lock(&d->mutex);
 
             if (!d->commands.isEmpty())
             {
+                parallel = d->isParallelDownload(d->commands.first());
+
+                // Wait for a free download thread, or for the end of all
+                // downloads before a command which can depend on them.
+
+                if (( parallel && d->activeDownloads >= s_parallelDownloads) ||
+                    (!parallel && d->activeDownloads > 0))
+                {
+                    d->condVar.wait(&d->mutex);
+                    continue;
+                }
+
                 command = d->commands.takeFirst();
                 emit signalBusy(true);
+
+                if (command->action == CameraCommand::cam_download && !d->downloadTimer.isValid())
+                {
+                    d->downloadTimer.start();
+                }
+
+                if (parallel)
+                {
+                    // The downloads of a series share the cancel flag of the camera:
+                    // clear it once before the first one, not in each download.
+
+                    if (d->activeDownloads == 0)
+                    {
+                        static_cast<UMSCamera*>(d->camera)->resetCancel();
+                    }
+
+                    ++d->activeDownloads;
+                }
+            }
+            else if (d->activeDownloads > 0)
+            {
+                // The last downloads are still running
+                d->condVar.wait(&d->mutex);
+                continue;
             }
             else if (!d->cmdThumbs.isEmpty())
             {
@@ -387,22 +453,41 @@ void CameraController::run()
             }
             else
             {
+                d->downloadedBytes = 0;
+                d->downloadTimer.invalidate();
+
                 emit signalBusy(false);
                 d->condVar.wait(&d->mutex);
                 continue;
             }
         }
 
-        if (command)
+        if (command && parallel)
+        {
+            QtConcurrent::run(&d->downloadPool, this, &CameraController::executeDownload, command);
+        }
+        else if (command)
         {
             executeCommand(command);
             delete command;
         }
     }
 
+    d->downloadPool.waitForDone();
+
     emit signalBusy(false);
 }
 
+void CameraController::executeDownload(CameraCommand* const cmd)
+{
+    executeCommand(cmd);
+    delete cmd;
+
+    QMutexLocker lock(&d->mutex);
+    --d->activeDownloads;
+    d->condVar.wakeAll();
+}
+
 void CameraController::executeCommand(CameraCommand* const cmd)
 {
     if (!cmd)
@@ -603,8 +688,18 @@ void CameraController::executeCommand(CameraCommand* const cmd)
 
             emit signalDownloaded(folder, file, CamItemInfo::DownloadStarted);
 
+            // Files with the same name from different folders can be downloaded at the same time
+
+            int index        = 0;
+
+            {
+                QMutexLocker lock(&d->mutex);
+                index = ++d->downloadIndex;
+            }
+
             QString tempFile = QLatin1String("/Camera-tmp%1-") +
                                QString::number(QCoreApplication::applicationPid()) +
+                               QLatin1Char('-') + QString::number(index) +
                                QLatin1String(".digikamtempfile.");
             QUrl tempURL     = QUrl::fromLocalFile(dest).adjusted(QUrl::RemoveFilename |
                                                                   QUrl::StripTrailingSlash);
@@ -621,7 +716,18 @@ void CameraController::executeCommand(CameraCommand* const cmd)
                 emit signalDownloaded(folder, file, CamItemInfo::DownloadFailed);
                 break;
             }
-            else if (mime == QLatin1String("image/jpeg"))
+
+            qint64 rate = 0;
+
+            {
+                QMutexLocker lock(&d->mutex);
+                d->downloadedBytes += QFileInfo(temp).size();
+                rate                = d->downloadedBytes * 1000 / qMax(d->downloadTimer.elapsed(), (qint64)1);
+            }
+
+            emit signalDownloadRate(rate);
+
+            if (mime == QLatin1String("image/jpeg"))
             {
                 // Possible modification operations. Only apply it to JPEG for the moment.
                 qCDebug(DIGIKAM_IMPORTUI_LOG) << "Set metadata from: " << file << " using " << temp;
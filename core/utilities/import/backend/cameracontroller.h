@@ -109,6 +109,11 @@ Q_SIGNALS:
     void signalFileList(const CamItemInfoList& infoList);
     void signalUploaded(const CamItemInfo& itemInfo);
     void signalDownloaded(const QString& folder, const QString& file, int status);
+
+    /** Emitted when a file is downloaded, with the number of bytes per second
+     *  downloaded since the current series of downloads was started.
+     */
+    void signalDownloadRate(qint64 bytesPerSecond);
     void signalDownloadComplete(const QString& sourceFolder, const QString& sourceFile,
                                 const QString& destFolder, const QString& destFile);
     void signalSkipped(const QString& folder, const QString& file);
@@ -136,6 +141,10 @@ protected:
     void run();
     void executeCommand(CameraCommand* const cmd);
 
+    /** Runs a download command in a thread of the download pool, and deletes it.
+     */
+    void executeDownload(CameraCommand* const cmd);
+
 private Q_SLOTS:
 
     void slotCheckRename(const QString& folder, const QString& file,
@@ -70,9 +70,9 @@ namespace Digikam
 
 UMSCamera::UMSCamera(const QString& title, const QString& model,
                      const QString& port, const QString& path)
-    : DKCamera(title, model, port, path)
+    : DKCamera(title, model, port, path),
+      m_cancel(0)
 {
-    m_cancel = false;
     getUUIDFromSolid();
 }
 
@@ -149,12 +149,17 @@ bool UMSCamera::doConnect()
 void UMSCamera::cancel()
 {
     // set the cancel flag
-    m_cancel = true;
+    m_cancel.storeRelease(1);
+}
+
+void UMSCamera::resetCancel()
+{
+    m_cancel.storeRelease(0);
 }
 
 bool UMSCamera::getFolders(const QString& folder)
 {
-    if (m_cancel)
+    if (m_cancel.loadAcquire())
     {
         return false;
     }
@@ -172,7 +177,7 @@ bool UMSCamera::getFolders(const QString& folder)
     QFileInfoList::const_iterator fi;
     QStringList subFolderList;
 
-    for (fi = list.constBegin() ; !m_cancel && (fi != list.constEnd()) ; ++fi)
+    for (fi = list.constBegin() ; !m_cancel.loadAcquire() && (fi != list.constEnd()) ; ++fi)
     {
         if (fi->fileName() == QLatin1String(".") || fi->fileName() == QLatin1String(".."))
         {
@@ -195,7 +200,7 @@ bool UMSCamera::getFolders(const QString& folder)
 
 bool UMSCamera::getItemsInfoList(const QString& folder, bool useMetadata, CamItemInfoList& infoList)
 {
-    m_cancel = false;
+    resetCancel();
     infoList.clear();
 
     QDir dir(folder);
@@ -213,7 +218,7 @@ bool UMSCamera::getItemsInfoList(const QString& folder, bool useMetadata, CamIte
         return true;    // Nothing to do.
     }
 
-    for (QFileInfoList::const_iterator fi = list.constBegin() ; !m_cancel && (fi != list.constEnd()) ; ++fi)
+    for (QFileInfoList::const_iterator fi = list.constBegin() ; !m_cancel.loadAcquire() && (fi != list.constEnd()) ; ++fi)
     {
         CamItemInfo info;
         getItemInfo(folder, fi->fileName(), info, useMetadata);
@@ -270,7 +275,7 @@ void UMSCamera::getItemInfo(const QString& folder, const QString& itemName, CamI
 
 bool UMSCamera::getThumbnail(const QString& folder, const QString& itemName, QImage& thumbnail)
 {
-    m_cancel     = false;
+    resetCancel();
     QString path = folder + QLatin1Char('/') + itemName;
 
     // Try to get preview from Exif data (good quality). Can work with Raw files
@@ -377,7 +382,7 @@ bool UMSCamera::getMetadata(const QString& folder, const QString& itemName, DMet
 
 bool UMSCamera::downloadItem(const QString& folder, const QString& itemName, const QString& saveFile)
 {
-    m_cancel     = false;
+    // The cancel flag is not reset here, a parallel download could clear a cancel request
     QString src  = folder + QLatin1Char('/') + itemName;
     QString dest = saveFile;
 
@@ -397,21 +402,46 @@ bool UMSCamera::downloadItem(const QString& folder, const QString& itemName, con
         return false;
     }
 
-    const int MAX_IPC_SIZE = (1024 * 32);
-    char      buffer[MAX_IPC_SIZE];
-    qint64    len;
+    // Large blocks keep card readers busy. The data is hashed while copying
+    // and the copy is verified by reading it again, from the cache of the system.
+
+    const int          bufferSize = (4 * 1024 * 1024);
+    QByteArray         buffer(bufferSize, Qt::Uninitialized);
+    QCryptographicHash srcHash(QCryptographicHash::Md5);
+    qint64             len;
 
-    while (((len = sFile.read(buffer, MAX_IPC_SIZE)) != 0) && !m_cancel)
+    while (((len = sFile.read(buffer.data(), bufferSize)) != 0) && !m_cancel.loadAcquire())
     {
-        if ((len == -1) || (dFile.write(buffer, (quint64)len) != len))
+        if ((len == -1) || (dFile.write(buffer.constData(), (quint64)len) != len))
         {
             sFile.close();
             dFile.close();
             return false;
         }
+
+        srcHash.addData(buffer.constData(), len);
     }
 
     sFile.close();
+
+    if (!dFile.flush() || m_cancel.loadAcquire())
+    {
+        dFile.close();
+        return false;
+    }
+
+    dFile.close();
+
+    QCryptographicHash destHash(QCryptographicHash::Md5);
+
+    if (!dFile.open(QIODevice::ReadOnly) || !destHash.addData(&dFile) ||
+        destHash.result() != srcHash.result())
+    {
+        dFile.close();
+        qCWarning(DIGIKAM_IMPORTUI_LOG) << "Checksum of downloaded file does not match the source file: " << src;
+        return false;
+    }
+
     dFile.close();
 
     // Set the file modification time of the downloaded file to the original file.
@@ -456,7 +486,7 @@ bool UMSCamera::setLockItem(const QString& folder, const QString& itemName, bool
 
 bool UMSCamera::deleteItem(const QString& folder, const QString& itemName)
 {
-    m_cancel = false;
+    resetCancel();
 
     // Any camera provide THM (thumbnail) file with real image. We need to remove it also.
 
@@ -482,7 +512,7 @@ bool UMSCamera::deleteItem(const QString& folder, const QString& itemName)
 
 bool UMSCamera::uploadItem(const QString& folder, const QString& itemName, const QString& localFile, CamItemInfo& info)
 {
-    m_cancel     = false;
+    resetCancel();
     QString dest = folder + QLatin1Char('/') + itemName;
     QString src  = localFile;
 
@@ -508,7 +538,7 @@ bool UMSCamera::uploadItem(const QString& folder, const QString& itemName, const
 
     qint64 len;
 
-    while (((len = sFile.read(buffer, MAX_IPC_SIZE)) != 0) && !m_cancel)
+    while (((len = sFile.read(buffer, MAX_IPC_SIZE)) != 0) && !m_cancel.loadAcquire())
     {
         if ((len == -1) || (dFile.write(buffer, (quint64)len) == -1))
         {
@@ -28,6 +28,7 @@
 // Qt includes
 
 #include <QStringList>
+#include <QAtomicInt>
 
 // Local includes
 
@@ -53,6 +54,11 @@ public:
     bool doConnect();
     void cancel();
 
+    /** Clears the cancel flag. The commands reset it themselves, except the downloads,
+     *  which run in parallel: the caller resets it once before the first download.
+     */
+    void resetCancel();
+
     bool getFolders(const QString& folder);
     bool getItemsInfoList(const QString& folder, bool useMetadata, CamItemInfoList& infoList);
     void getItemInfo(const QString& folder, const QString& itemName, CamItemInfo& info, bool useMetadata);
@@ -85,7 +91,8 @@ private:
 
 private:
 
-    bool m_cancel;
+    /// Read by the downloads running in parallel, see resetCancel()
+    QAtomicInt m_cancel;
 };
 
 } // namespace Digikam
@@ -802,6 +802,9 @@ void ImportUI::setupCameraController(const QString& model, const QString& port,
     connect(d->controller, SIGNAL(signalDownloaded(QString,QString,int)),
             this, SLOT(slotDownloaded(QString,QString,int)));
 
+    connect(d->controller, SIGNAL(signalDownloadRate(qint64)),
+            this, SLOT(slotDownloadRate(qint64)));
+
     connect(d->controller, SIGNAL(signalDownloadComplete(QString,QString,QString,QString)),
             this, SLOT(slotDownloadComplete(QString,QString,QString,QString)));
 
@@ -1504,6 +1507,12 @@ void ImportUI::slotDownload(bool onlySelected, bool deleteAfter, Album* album)
     downloadCameraItems(pAlbum, onlySelected, deleteAfter);
 }
 
+void ImportUI::slotDownloadRate(qint64 bytesPerSecond)
+{
+    d->statusProgressBar->setProgressText(i18nc("@info:status download speed", "%1/s",
+                                                ItemPropertiesTab::humanReadableBytesCount(bytesPerSecond)));
+}
+
 void ImportUI::slotDownloaded(const QString& folder, const QString& file, int status)
 {
     // Is auto-rotate option checked?
@@ -193,6 +193,7 @@ private Q_SLOTS:
 
     void slotUploaded(const CamItemInfo&);
     void slotDownloaded(const QString&, const QString&, int);
+    void slotDownloadRate(qint64);
     void slotDownloadComplete(const QString& sourceFolder, const QString& sourceFile,
                               const QString& destFolder, const QString& destFile);
     void slotSkipped(const QString&, const QString&);
@@ -245,6 +245,7 @@ void DatabaseTask::run()
         QList<qlonglong> staleImageIds;
         QList<int>       staleThumbIds;
         QList<Identity>  staleIdentities;
+        QStringList      staleFaceEmbeddings;
         QList<qlonglong> staleSimilarityImageIds;
         int additionalItemsToProcess = 0;
 
@@ -263,6 +264,7 @@ void DatabaseTask::run()
         if (d->scanRecognitionDb)
         {
             additionalItemsToProcess += RecognitionDatabase().allIdentities().size();
+            additionalItemsToProcess += coredbItems.size();
         }
 
         if (d->scanSimilarityDb)
@@ -384,6 +386,34 @@ void DatabaseTask::run()
                 emit signalFinished();
             }
 
+            // The cached face vectors of removed faces are stale.
+
+            QSet<QString> faceKeys = RecognitionDatabase().faceEmbeddingKeys().toSet();
+            FaceTagsEditor editor;
+
+            foreach (const qlonglong& item, coredbItems)
+            {
+                if (m_cancel)
+                {
+                    return;
+                }
+
+                if (!faceKeys.isEmpty())
+                {
+                    QString hash = CoreDbAccess().db()->getImagesFields(item, DatabaseFields::ImagesField::UniqueHash).value(0).toString();
+
+                    foreach (const FaceTagsIface& face, editor.databaseFaces(item))
+                    {
+                        faceKeys.remove(RecognitionDatabase::faceEmbeddingKey(hash, face.region().toRect()));
+                    }
+                }
+
+                // Signal that this item was processed.
+                emit signalFinished();
+            }
+
+            staleFaceEmbeddings = faceKeys.toList();
+
             // Signal that the database was processed.
             emit signalFinished();
         }
@@ -413,7 +443,7 @@ void DatabaseTask::run()
             signalFinished();
         }
 
-        emit signalData(staleImageIds, staleThumbIds, staleIdentities, staleSimilarityImageIds);
+        emit signalData(staleImageIds, staleThumbIds, staleIdentities, staleFaceEmbeddings, staleSimilarityImageIds);
     }
     else if (d->mode == Mode::CleanCoreDb)
     {
@@ -515,6 +545,24 @@ void DatabaseTask::run()
             RecognitionDatabase().deleteIdentity(identity);
             emit signalFinished();
         }
+
+        while (d->data)
+        {
+            if (m_cancel)
+            {
+                return;
+            }
+
+            QString key = d->data->getFaceEmbeddingKey();
+
+            if (key.isEmpty())
+            {
+                break;
+            }
+
+            RecognitionDatabase().removeFaceEmbedding(key);
+            emit signalFinished();
+        }
     }
     else if (d->mode == Mode::CleanSimilarityDb)
     {
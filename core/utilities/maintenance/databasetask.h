@@ -24,6 +24,10 @@
 #ifndef DIGIKAM_DATABASE_TASK_H
 #define DIGIKAM_DATABASE_TASK_H
 
+// Qt includes
+
+#include <QStringList>
+
 // Local includes
 
 #include "actionthreadbase.h"
@@ -72,6 +76,7 @@ Q_SIGNALS:
     void signalData(const QList<qlonglong>& staleImageIds,
                     const QList<int>& staleThumbIds,
                     const QList<Identity>& staleIdentities,
+                    const QStringList& staleFaceEmbeddings,
                     const QList<qlonglong>& staleSimilarityImageIds);
 
     void signalStarted();
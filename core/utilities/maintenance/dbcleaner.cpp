@@ -71,6 +71,7 @@ public:
     QList<qlonglong>   imagesToRemove;
     QList<int>         staleThumbnails;
     QList<Identity>    staleIdentities;
+    QStringList        staleFaceEmbeddings;
     QList<qlonglong>   staleImageSimilarities;
 
     int                databasesToAnalyseCount;
@@ -149,8 +150,8 @@ void DbCleaner::slotStart()
             this, SLOT(slotAddItemsToProcess(int)));
 
     // Set the wiring from the data signal to the data slot.
-    connect(d->thread,SIGNAL(signalData(QList<qlonglong>,QList<int>,QList<Identity>,QList<qlonglong>)),
-            this, SLOT(slotFetchedData(QList<qlonglong>,QList<int>,QList<Identity>,QList<qlonglong>)));
+    connect(d->thread,SIGNAL(signalData(QList<qlonglong>,QList<int>,QList<Identity>,QStringList,QList<qlonglong>)),
+            this, SLOT(slotFetchedData(QList<qlonglong>,QList<int>,QList<Identity>,QStringList,QList<qlonglong>)));
 
     // Compute the database junk. This will lead to the call of the slot
     // slotFetchedData.
@@ -166,25 +167,28 @@ void DbCleaner::slotAddItemsToProcess(int count)
 void DbCleaner::slotFetchedData(const QList<qlonglong>& staleImageIds,
                                 const QList<int>& staleThumbIds,
                                 const QList<Identity>& staleIdentities,
+                                const QStringList& staleFaceEmbeddings,
                                 const QList<qlonglong>& staleImageSimilarities)
 {
     // We have data now. Store it and trigger the core db cleaning
     d->imagesToRemove         = staleImageIds;
     d->staleThumbnails        = staleThumbIds;
     d->staleIdentities        = staleIdentities;
+    d->staleFaceEmbeddings    = staleFaceEmbeddings;
     d->staleImageSimilarities = staleImageSimilarities;
 
     // If we have nothing to do, finish.
     // Signal done if no elements cleanup is necessary
 
-    if (d->imagesToRemove.isEmpty() && d->staleThumbnails.isEmpty() && d->staleIdentities.isEmpty())
+    if (d->imagesToRemove.isEmpty() && d->staleThumbnails.isEmpty() &&
+        d->staleIdentities.isEmpty() && d->staleFaceEmbeddings.isEmpty())
     {
         qCDebug(DIGIKAM_GENERAL_LOG) << "Nothing to do. Databases are clean.";
 
         if (d->shrinkDatabases)
         {
-            disconnect(d->thread, SIGNAL(signalData(QList<qlonglong>,QList<int>,QList<Identity>)),
-                       this, SLOT(slotFetchedData(QList<qlonglong>,QList<int>,QList<Identity>)));
+            disconnect(d->thread, SIGNAL(signalData(QList<qlonglong>,QList<int>,QList<Identity>,QStringList,QList<qlonglong>)),
+                       this, SLOT(slotFetchedData(QList<qlonglong>,QList<int>,QList<Identity>,QStringList,QList<qlonglong>)));
 
             disconnect(d->thread, SIGNAL(signalCompleted()),
                         this, SLOT(slotCleanItems()));
@@ -198,7 +202,8 @@ void DbCleaner::slotFetchedData(const QList<qlonglong>& staleImageIds,
         }
     }
 
-    setTotalItems(totalItems() + d->imagesToRemove.size() + d->staleThumbnails.size() + d->staleIdentities.size());
+    setTotalItems(totalItems() + d->imagesToRemove.size() + d->staleThumbnails.size() +
+                  d->staleIdentities.size() + d->staleFaceEmbeddings.size());
     //qCDebug(DIGIKAM_GENERAL_LOG) << "Completed items after analysis: " << completedItems() << "/" << totalItems();
 }
 
@@ -269,9 +274,10 @@ void DbCleaner::slotCleanedThumbnails()
 
     if (d->cleanFacesDb)
     {
-        if (d->staleIdentities.count() > 0)
+        if ((d->staleIdentities.count() > 0) || (d->staleFaceEmbeddings.count() > 0))
         {
-            qCDebug(DIGIKAM_GENERAL_LOG) << "Found " << d->staleIdentities.size() << " stale face identities.";
+            qCDebug(DIGIKAM_GENERAL_LOG) << "Found " << d->staleIdentities.size() << " stale face identities and "
+                                         << d->staleFaceEmbeddings.size() << " stale face vectors.";
             setLabel(i18n("Clean up the databases : ") + i18n("cleaning recognition db"));
 
             // GO! and don't forget the signal!
@@ -279,7 +285,7 @@ void DbCleaner::slotCleanedThumbnails()
                     this, SLOT(slotCleanedFaces()));
 
             // We cleaned the thumbs db. Now clean the faces db.
-            d->thread->cleanFacesDb(d->staleIdentities);
+            d->thread->cleanFacesDb(d->staleIdentities, d->staleFaceEmbeddings);
             d->thread->start();
         }
         else
@@ -28,6 +28,7 @@
 
 #include <QDialog>
 #include <QString>
+#include <QStringList>
 #include <QWidget>
 
 // Local includes
@@ -69,6 +70,7 @@ private Q_SLOTS:
     void slotFetchedData(const QList<qlonglong>& staleImageIds,
                          const QList<int>& staleThumbIds,
                          const QList<Identity>& staleIdentities,
+                         const QStringList& staleFaceEmbeddings,
                          const QList<qlonglong>& staleImageSimilarities);
 
     void slotAddItemsToProcess(int count);
@@ -24,6 +24,8 @@
 #include "fingerprintstask.h"
 
 // Qt includes
+
+#include <QElapsedTimer>
 #include <QQueue>
 
 // Local includes
@@ -34,6 +36,8 @@
 #include "haariface.h"
 #include "previewloadthread.h"
 #include "maintenancedata.h"
+#include "fingerprintswriter.h"
+#include "iteminfo.h"
 
 namespace Digikam
 {
@@ -43,11 +47,13 @@ class Q_DECL_HIDDEN FingerprintsTask::Private
 public:
 
     explicit Private()
-        : data(0)
+        : data(0),
+          writer(0)
     {
     }
 
-    MaintenanceData* data;
+    MaintenanceData*    data;
+    FingerprintsWriter* writer;
 };
 
 // -------------------------------------------------------
@@ -69,8 +75,16 @@ void FingerprintsTask::setMaintenanceData(MaintenanceData* const data)
     d->data = data;
 }
 
+void FingerprintsTask::setFingerprintsWriter(FingerprintsWriter* const writer)
+{
+    d->writer = writer;
+}
+
 void FingerprintsTask::run()
 {
+    HaarIface     haarIface;
+    QElapsedTimer timer;
+
     // While we have data (using this as check for non-null)
     while (d->data)
     {
@@ -88,17 +102,47 @@ void FingerprintsTask::run()
 
         qCDebug(DIGIKAM_GENERAL_LOG) << "Updating fingerprints for file: " << path ;
 
-        DImg dimg = PreviewLoadThread::loadFastSynchronously(path, HaarIface::preferredSize());
+        timer.start();
+
+        DImg dimg           = PreviewLoadThread::loadFastSynchronously(path, HaarIface::preferredSize());
+        qint64 decodingTime = timer.nsecsElapsed();
+
+        timer.restart();
+
+        qlonglong  imageid = -1;
+        QByteArray signature;
 
         if (!dimg.isNull())
         {
-            // compute Haar fingerprint and store it to DB
-            HaarIface haarIface;
-            haarIface.indexImage(path, dimg);
+            ItemInfo info = ItemInfo::fromLocalFile(path);
+
+            if (!info.isNull())
+            {
+                // compute Haar fingerprint
+                imageid   = info.id();
+                signature = haarIface.signatureData(dimg);
+            }
         }
 
-        QImage qimg = dimg.smoothScale(22, 22, Qt::KeepAspectRatio).copyQImage();
-        emit signalFinished(qimg);
+        qint64 signatureTime = timer.nsecsElapsed();
+        QImage qimg          = dimg.smoothScale(22, 22, Qt::KeepAspectRatio).copyQImage();
+
+        if (d->writer)
+        {
+            // The writer stores the fingerprint to DB and reports the item
+            d->writer->addSignature(imageid, signature, qimg, decodingTime, signatureTime);
+        }
+        else
+        {
+            if (imageid != -1)
+            {
+                QMap<qlonglong, QByteArray> signatures;
+                signatures.insert(imageid, signature);
+                HaarIface::storeSignatures(signatures);
+            }
+
+            emit signalFinished(qimg);
+        }
     }
 
     emit signalDone();
@@ -38,6 +38,7 @@ namespace Digikam
 
 class LoadingDescription;
 class MaintenanceData;
+class FingerprintsWriter;
 class DImg;
 
 class FingerprintsTask : public ActionJob
@@ -51,6 +52,11 @@ public:
 
     void setMaintenanceData(MaintenanceData* const data=0);
 
+    /** Sets the writer which stores the signatures. Without writer, each
+     *  signature is stored by the task and signalFinished() is emitted.
+     */
+    void setFingerprintsWriter(FingerprintsWriter* const writer);
+
 Q_SIGNALS:
 
     void signalFinished(const QImage&);
@@ -0,0 +1,249 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-11-10
+ * Description : Writer thread for finger-prints generator.
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "fingerprintswriter.h"
+
+// Qt includes
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QMap>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QWaitCondition>
+
+// Local includes
+
+#include "digikam_debug.h"
+#include "haariface.h"
+
+namespace Digikam
+{
+
+/// Number of signatures written in one transaction
+static const int s_batchSize      = 100;
+
+/// Maximum number of pending signatures before the tasks wait for the writer
+static const int s_maximumPending = 4 * s_batchSize;
+
+/// Pending signatures are written at least after this time, in milliseconds
+static const int s_flushInterval  = 1000;
+
+class Q_DECL_HIDDEN FingerprintsWriter::Private
+{
+public:
+
+    class Entry
+    {
+    public:
+
+        qlonglong  imageid;
+        QByteArray signature;
+        QImage     thumbnail;
+    };
+
+public:
+
+    explicit Private()
+      : running(true),
+        count(0),
+        received(0),
+        written(0),
+        decodingTime(0),
+        signatureTime(0),
+        writingTime(0)
+    {
+    }
+
+    /** Returns the number of images per second for count images processed in nsecs.
+     */
+    static double rate(int count, qint64 nsecs)
+    {
+        return ((nsecs > 0) ? (count * 1000000000.0 / nsecs) : 0.0);
+    }
+
+    /** Prints the statistics of the run. Called with the mutex locked.
+     */
+    void report() const
+    {
+        qCDebug(DIGIKAM_GENERAL_LOG) << "Fingerprints of" << written << "images generated at"
+                                     << rate(written, timer.nsecsElapsed()) << "images/s. Per thread, decoding:"
+                                     << rate(written, decodingTime)  << "images/s, signatures:"
+                                     << rate(written, signatureTime) << "images/s. Database writer:"
+                                     << rate(written, writingTime)   << "images/s";
+    }
+
+public:
+
+    QMutex          mutex;
+    QWaitCondition  condVar;
+    QWaitCondition  condVarPending;
+    bool            running;
+    QList<Entry>    pending;
+
+    /// Statistics of the current run
+    QElapsedTimer   timer;
+    int             count;
+    int             received;
+    int             written;
+    qint64          decodingTime;
+    qint64          signatureTime;
+    qint64          writingTime;
+};
+
+FingerprintsWriter::FingerprintsWriter(QObject* const parent)
+    : QThread(parent),
+      d(new Private)
+{
+    setObjectName(QLatin1String("FingerprintsWriter"));
+    d->timer.start();
+
+    // The signature cache file is written once, when the writer is done
+
+    HaarIface::beginSignatureUpdates();
+}
+
+FingerprintsWriter::~FingerprintsWriter()
+{
+    {
+        QMutexLocker lock(&d->mutex);
+        d->running = false;
+        d->condVar.wakeAll();
+        d->condVarPending.wakeAll();
+    }
+
+    wait();
+
+    HaarIface::endSignatureUpdates();
+
+    delete d;
+}
+
+void FingerprintsWriter::setImageCount(int count)
+{
+    QMutexLocker lock(&d->mutex);
+
+    d->count         = count;
+    d->received      = 0;
+    d->written       = 0;
+    d->decodingTime  = 0;
+    d->signatureTime = 0;
+    d->writingTime   = 0;
+    d->timer.restart();
+}
+
+void FingerprintsWriter::addSignature(qlonglong imageid, const QByteArray& signature, const QImage& thumbnail,
+                                      qint64 decodingTime, qint64 signatureTime)
+{
+    QMutexLocker lock(&d->mutex);
+
+    while (d->running && d->pending.size() >= s_maximumPending)
+    {
+        d->condVarPending.wait(&d->mutex);
+    }
+
+    Private::Entry entry;
+    entry.imageid   = imageid;
+    entry.signature = signature;
+    entry.thumbnail = thumbnail;
+
+    d->pending       << entry;
+    d->decodingTime  += decodingTime;
+    d->signatureTime += signatureTime;
+    ++d->received;
+
+    // Write a full batch, and the last images of the run at once
+
+    if (d->pending.size() >= s_batchSize || d->received >= d->count)
+    {
+        d->condVar.wakeAll();
+    }
+}
+
+void FingerprintsWriter::run()
+{
+    forever
+    {
+        QList<Private::Entry> batch;
+
+        {
+            QMutexLocker lock(&d->mutex);
+
+            if (d->running && d->pending.isEmpty())
+            {
+                d->condVar.wait(&d->mutex);
+            }
+            else if (d->running && d->pending.size() < s_batchSize && d->received < d->count)
+            {
+                d->condVar.wait(&d->mutex, s_flushInterval);
+            }
+
+            if (d->pending.isEmpty())
+            {
+                if (!d->running)
+                {
+                    return;
+                }
+
+                continue;
+            }
+
+            batch.swap(d->pending);
+            d->condVarPending.wakeAll();
+        }
+
+        QMap<qlonglong, QByteArray> signatures;
+
+        foreach (const Private::Entry& entry, batch)
+        {
+            if (entry.imageid != -1 && !entry.signature.isEmpty())
+            {
+                signatures.insert(entry.imageid, entry.signature);
+            }
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+
+        HaarIface::storeSignatures(signatures);
+
+        {
+            QMutexLocker lock(&d->mutex);
+
+            d->writingTime += timer.nsecsElapsed();
+            d->written     += batch.size();
+
+            if (d->written == d->count)
+            {
+                d->report();
+            }
+        }
+
+        foreach (const Private::Entry& entry, batch)
+        {
+            emit signalWritten(entry.thumbnail);
+        }
+    }
+}
+
+} // namespace Digikam
@@ -0,0 +1,85 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-11-10
+ * Description : Writer thread for finger-prints generator.
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_FINGERPRINTS_WRITER_H
+#define DIGIKAM_FINGERPRINTS_WRITER_H
+
+// Qt includes
+
+#include <QByteArray>
+#include <QImage>
+#include <QThread>
+
+namespace Digikam
+{
+
+/** Writes the signatures calculated by the fingerprints tasks to the similarity
+ *  database, in batches of one transaction, so that the tasks do not wait for
+ *  each other on the database.
+ *
+ *  An image is reported with signalWritten() once its signature is stored.
+ *  When all images announced with setImageCount() are written, the number of
+ *  images per second of each stage is printed to the debug log.
+ *  The signature cache file of HaarIface is written once, when the writer is destroyed.
+ */
+class FingerprintsWriter : public QThread
+{
+    Q_OBJECT
+
+public:
+
+    explicit FingerprintsWriter(QObject* const parent = 0);
+
+    /** Writes the pending signatures and stops the thread.
+     */
+    ~FingerprintsWriter();
+
+    /** Sets the number of images of the next run and resets the statistics.
+     */
+    void setImageCount(int count);
+
+    /** Queues the signature of an image, blocking while too many signatures are pending.
+     *  An empty signature or an imageid of -1 only reports the image.
+     *  The times, in nanoseconds, are the time spent by the task to load the image
+     *  and to calculate the signature.
+     */
+    void addSignature(qlonglong imageid, const QByteArray& signature, const QImage& thumbnail,
+                      qint64 decodingTime, qint64 signatureTime);
+
+Q_SIGNALS:
+
+    void signalWritten(const QImage&);
+
+protected:
+
+    void run();
+
+private:
+
+    class Private;
+    Private* const d;
+};
+
+} // namespace Digikam
+
+#endif // DIGIKAM_FINGERPRINTS_WRITER_H
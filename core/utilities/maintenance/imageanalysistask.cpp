@@ -0,0 +1,338 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-11-10
+ * Description : Thread actions task to analyze items with one decoding.
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "imageanalysistask.h"
+
+// Qt includes
+
+#include <QElapsedTimer>
+#include <QMap>
+#include <QMutexLocker>
+
+// Local includes
+
+#include "digikam_debug.h"
+#include "dimg.h"
+#include "haariface.h"
+#include "imagequalitycontainer.h"
+#include "imagequalityparser.h"
+#include "iteminfo.h"
+#include "maintenancedata.h"
+#include "fingerprintswriter.h"
+#include "previewloadthread.h"
+#include "thumbnailloadthread.h"
+
+namespace Digikam
+{
+
+/// Size of the preview used for the quality analysis, see ImageQualityTask
+static const int s_qualitySize = 1024;
+
+ImageAnalysisStats::ImageAnalysisStats()
+{
+    reset();
+}
+
+void ImageAnalysisStats::reset()
+{
+    QMutexLocker lock(&mutex);
+
+    images          = 0;
+    decodingTime    = 0;
+    thumbnailTime   = 0;
+    fingerprintTime = 0;
+    qualityTime     = 0;
+}
+
+void ImageAnalysisStats::add(int count, qint64 decoding, qint64 thumbnail,
+                             qint64 fingerprint, qint64 quality)
+{
+    QMutexLocker lock(&mutex);
+
+    images          += count;
+    decodingTime    += decoding;
+    thumbnailTime   += thumbnail;
+    fingerprintTime += fingerprint;
+    qualityTime     += quality;
+}
+
+void ImageAnalysisStats::report() const
+{
+    QMutexLocker lock(&mutex);
+
+    const qint64 total = decodingTime + thumbnailTime + fingerprintTime + qualityTime;
+
+    if (images == 0 || total == 0)
+    {
+        return;
+    }
+
+    qCDebug(DIGIKAM_GENERAL_LOG) << "Analysis of" << images << "images. Per thread:"
+                                 << images * 1000000000.0 / total << "images/s. Share of decoding:"
+                                 << 100.0 * decodingTime    / total << "%, thumbnails:"
+                                 << 100.0 * thumbnailTime   / total << "%, fingerprints:"
+                                 << 100.0 * fingerprintTime / total << "%, quality:"
+                                 << 100.0 * qualityTime     / total << "%";
+}
+
+// -------------------------------------------------------------------
+
+class Q_DECL_HIDDEN ImageAnalysisTask::Private
+{
+public:
+
+    explicit Private()
+        : data(0),
+          writer(0),
+          stats(0),
+          catcher(0),
+          imgqsort(0)
+    {
+    }
+
+    MaintenanceData*      data;
+    FingerprintsWriter*   writer;
+    ImageAnalysisStats*    stats;
+    ThumbnailImageCatcher* catcher;
+
+    QHash<QString, int>   analyses;
+    ImageQualityContainer quality;
+
+    QMutex                mutex;
+    ImageQualityParser*   imgqsort;
+};
+
+// -------------------------------------------------------
+
+ImageAnalysisTask::ImageAnalysisTask()
+    : ActionJob(),
+      d(new Private)
+{
+    ThumbnailLoadThread* const thread = new ThumbnailLoadThread;
+    thread->setPixmapRequested(false);
+    thread->setThumbnailSize(ThumbnailLoadThread::maximumThumbnailSize());
+    d->catcher                        = new ThumbnailImageCatcher(thread, this);
+}
+
+ImageAnalysisTask::~ImageAnalysisTask()
+{
+    slotCancel();
+    cancel();
+
+    d->catcher->setActive(false);
+    d->catcher->thread()->stopAllTasks();
+
+    delete d->catcher->thread();
+    delete d->catcher;
+    delete d;
+}
+
+void ImageAnalysisTask::setMaintenanceData(MaintenanceData* const data)
+{
+    d->data = data;
+}
+
+void ImageAnalysisTask::setAnalyses(const QHash<QString, int>& analyses)
+{
+    d->analyses = analyses;
+}
+
+void ImageAnalysisTask::setQuality(const ImageQualityContainer& quality)
+{
+    d->quality = quality;
+}
+
+void ImageAnalysisTask::setFingerprintsWriter(FingerprintsWriter* const writer)
+{
+    d->writer = writer;
+}
+
+void ImageAnalysisTask::setStats(ImageAnalysisStats* const stats)
+{
+    d->stats = stats;
+}
+
+void ImageAnalysisTask::slotCancel()
+{
+    QMutexLocker lock(&d->mutex);
+
+    if (d->imgqsort)
+    {
+        d->imgqsort->cancelAnalyse();
+    }
+}
+
+void ImageAnalysisTask::run()
+{
+    HaarIface     haarIface;
+    QElapsedTimer timer;
+    int           images          = 0;
+    qint64        decodingTime    = 0;
+    qint64        thumbnailTime   = 0;
+    qint64        fingerprintTime = 0;
+    qint64        qualityTime     = 0;
+
+    d->catcher->setActive(true);
+
+    // While we have data (using this as check for non-null)
+    while (d->data)
+    {
+        if (m_cancel)
+        {
+            d->catcher->setActive(false);
+            d->catcher->thread()->stopAllTasks();
+            return;
+        }
+
+        QString path = d->data->getImagePath();
+
+        if (path.isEmpty())
+        {
+            break;
+        }
+
+        const int analyses = d->analyses.value(path);
+
+        // Decode once, at the largest size needed by the analyses
+
+        int size = 0;
+
+        if (analyses & Thumbnail)
+        {
+            size = qMax(size, d->catcher->thread()->storedSize());
+        }
+
+        if (analyses & Fingerprint)
+        {
+            size = qMax(size, HaarIface::preferredSize());
+        }
+
+        if (analyses & Quality)
+        {
+            size = qMax(size, s_qualitySize);
+        }
+
+        timer.start();
+
+        DImg dimg     = PreviewLoadThread::loadFastSynchronously(path, size);
+        ItemInfo info = ItemInfo::fromLocalFile(path);
+        qint64 decode = timer.nsecsElapsed();
+        decodingTime += decode;
+
+        if ((analyses & Thumbnail) && !m_cancel)
+        {
+            timer.restart();
+
+            d->catcher->thread()->deleteThumbnail(path);
+
+            if (!dimg.isNull())
+            {
+                d->catcher->thread()->storeThumbnail(path, dimg);
+            }
+            else
+            {
+                // Items which cannot be decoded as an image, as videos, are left to the thumbnail loader
+
+                d->catcher->thread()->find(ThumbnailIdentifier(path));
+                d->catcher->enqueue();
+                d->catcher->waitForThumbnails();
+            }
+
+            thumbnailTime += timer.nsecsElapsed();
+        }
+
+        qlonglong  imageid = -1;
+        QByteArray signature;
+        qint64     signatureTime = 0;
+
+        if ((analyses & Fingerprint) && !dimg.isNull() && !info.isNull() && !m_cancel)
+        {
+            timer.restart();
+
+            // Downscaled like the image decoded by the fingerprints tool
+
+            imageid          = info.id();
+            signature        = haarIface.signatureData(HaarIface::preferredImage(dimg));
+            signatureTime    = timer.nsecsElapsed();
+            fingerprintTime += signatureTime;
+        }
+
+        if ((analyses & Quality) && !dimg.isNull() && !m_cancel)
+        {
+            timer.restart();
+
+            // The parser only reads the image, it is shared with the other analyses
+
+            PickLabel pick;
+
+            {
+                QMutexLocker lock(&d->mutex);
+                d->imgqsort = new ImageQualityParser(dimg, d->quality, &pick);
+            }
+
+            d->imgqsort->startAnalyse();
+            info.setPickLabel(pick);
+
+            {
+                QMutexLocker lock(&d->mutex);
+                delete d->imgqsort;
+                d->imgqsort = 0;
+            }
+
+            qualityTime += timer.nsecsElapsed();
+        }
+
+        ++images;
+
+        // Dispatch progress to Progress Manager
+
+        QImage qimg = dimg.smoothScale(22, 22, Qt::KeepAspectRatio).copyQImage();
+
+        if ((analyses & Fingerprint) && d->writer)
+        {
+            d->writer->addSignature(imageid, signature, qimg, decode, signatureTime);
+        }
+        else
+        {
+            if (imageid != -1 && !signature.isEmpty())
+            {
+                QMap<qlonglong, QByteArray> signatures;
+                signatures.insert(imageid, signature);
+                HaarIface::storeSignatures(signatures);
+            }
+
+            emit signalFinished(qimg);
+        }
+    }
+
+    if (d->stats)
+    {
+        d->stats->add(images, decodingTime, thumbnailTime, fingerprintTime, qualityTime);
+    }
+
+    emit signalDone();
+
+    d->catcher->setActive(false);
+}
+
+} // namespace Digikam
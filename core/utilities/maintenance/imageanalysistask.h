@@ -0,0 +1,130 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-11-10
+ * Description : Thread actions task to analyze items with one decoding.
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_IMAGE_ANALYSIS_TASK_H
+#define DIGIKAM_IMAGE_ANALYSIS_TASK_H
+
+// Qt includes
+
+#include <QHash>
+#include <QImage>
+#include <QMutex>
+#include <QString>
+
+// Local includes
+
+#include "actionthreadbase.h"
+
+namespace Digikam
+{
+
+class ImageQualityContainer;
+class MaintenanceData;
+class FingerprintsWriter;
+
+/** The time spent by the analysis tasks in each stage of the pipeline, summed over all threads.
+ */
+class ImageAnalysisStats
+{
+public:
+
+    explicit ImageAnalysisStats();
+
+    void reset();
+
+    void add(int images, qint64 decodingTime, qint64 thumbnailTime,
+             qint64 fingerprintTime, qint64 qualityTime);
+
+    /** Prints the number of images per second of each stage to the debug log.
+     */
+    void report() const;
+
+private:
+
+    mutable QMutex mutex;
+    int            images;
+    qint64         decodingTime;
+    qint64         thumbnailTime;
+    qint64         fingerprintTime;
+    qint64         qualityTime;
+};
+
+// -------------------------------------------------------------------
+
+/** Decodes each item once, at the largest size needed, and passes the
+ *  image to all requested analyses: thumbnail, fingerprint and quality.
+ */
+class ImageAnalysisTask : public ActionJob
+{
+    Q_OBJECT
+
+public:
+
+    enum Analysis
+    {
+        Thumbnail   = 0x01,
+        Fingerprint = 0x02,
+        Quality     = 0x04
+    };
+
+public:
+
+    explicit ImageAnalysisTask();
+    ~ImageAnalysisTask();
+
+    void setMaintenanceData(MaintenanceData* const data=0);
+
+    /** Sets the analyses to run for each path, as an OR of Analysis values.
+     */
+    void setAnalyses(const QHash<QString, int>& analyses);
+
+    void setQuality(const ImageQualityContainer& quality);
+
+    /** Sets the writer which stores the signatures. The items with a fingerprint
+     *  are reported by the writer, the others with signalFinished().
+     */
+    void setFingerprintsWriter(FingerprintsWriter* const writer);
+
+    void setStats(ImageAnalysisStats* const stats);
+
+Q_SIGNALS:
+
+    void signalFinished(const QImage&);
+
+public Q_SLOTS:
+
+    void slotCancel();
+
+protected:
+
+    void run();
+
+private:
+
+    class Private;
+    Private* const d;
+};
+
+} // namespace Digikam
+
+#endif // DIGIKAM_IMAGE_ANALYSIS_TASK_H
@@ -0,0 +1,266 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-11-10
+ * Description : batch thumbnails, finger-prints and quality analyzer
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ * Copyright (C) 2012      by Andi Clemens <andi dot clemens at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#include "imageanalyzer.h"
+
+// Qt includes
+
+#include <QHash>
+#include <QIcon>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+// KDE includes
+
+#include <kconfiggroup.h>
+#include <ksharedconfig.h>
+#include <klocalizedstring.h>
+
+// Local includes
+
+#include "digikam_debug.h"
+#include "digikam_globals.h"
+#include "albummanager.h"
+#include "coredb.h"
+#include "coredbaccess.h"
+#include "iteminfo.h"
+#include "imageanalysistask.h"
+#include "maintenancesettings.h"
+#include "maintenancethread.h"
+#include "similaritydb.h"
+#include "similaritydbaccess.h"
+#include "tagscache.h"
+#include "thumbsdb.h"
+#include "thumbsdbaccess.h"
+
+namespace Digikam
+{
+
+class Q_DECL_HIDDEN ImageAnalyzer::Private
+{
+public:
+
+    explicit Private()
+      : thread(0)
+    {
+    }
+
+    MaintenanceSettings settings;
+
+    QStringList         allPicturesPath;
+
+    /// The analyses to run for each path, see ImageAnalysisTask::Analysis
+    QHash<QString, int> analyses;
+
+    ImageAnalysisStats  stats;
+
+    MaintenanceThread*  thread;
+};
+
+ImageAnalyzer::ImageAnalyzer(const MaintenanceSettings& settings, ProgressItem* const parent)
+    : MaintenanceTool(QLatin1String("ImageAnalyzer"), parent),
+      d(new Private)
+{
+    setLabel(i18n("Thumbs, Finger-prints and Quality"));
+    ProgressManager::addProgressItem(this);
+
+    d->settings = settings;
+    d->thread   = new MaintenanceThread(this);
+
+    connect(d->thread, SIGNAL(signalCompleted()),
+            this, SLOT(slotDone()));
+
+    connect(d->thread, SIGNAL(signalAdvance(QImage)),
+            this, SLOT(slotAdvance(QImage)));
+}
+
+ImageAnalyzer::~ImageAnalyzer()
+{
+    delete d;
+}
+
+bool ImageAnalyzer::isNeeded(const MaintenanceSettings& settings)
+{
+    return (settings.thumbnails   ||
+            settings.fingerPrints ||
+            (settings.qualitySort && settings.quality.enableSorter));
+}
+
+void ImageAnalyzer::setUseMultiCoreCPU(bool b)
+{
+    d->thread->setUseMultiCore(b);
+}
+
+void ImageAnalyzer::slotCancel()
+{
+    d->thread->cancel();
+    MaintenanceTool::slotCancel();
+}
+
+void ImageAnalyzer::slotStart()
+{
+    MaintenanceTool::slotStart();
+
+    const bool thumbnails   = d->settings.thumbnails;
+    const bool fingerPrints = d->settings.fingerPrints;
+    const bool quality      = d->settings.qualitySort && d->settings.quality.enableSorter;
+
+    AlbumList albumList;
+    albumList << d->settings.albums;
+    albumList << d->settings.tags;
+
+    if (albumList.isEmpty())
+    {
+        albumList = AlbumManager::instance()->allPAlbums();
+    }
+
+    // The items already processed, for the tools which only scan the missing ones.
+    // See ThumbsGenerator, FingerPrintsGenerator and ImageQualitySorter.
+
+    QHash<QString, int> withThumbnail;
+    QSet<QString>       dirtyFingerPrints;
+    QSet<QString>       noPickLabel;
+
+    if (thumbnails && d->settings.scanThumbs)
+    {
+        withThumbnail = ThumbsDbAccess().db()->getFilePathsWithThumbnail();
+    }
+
+    if (fingerPrints && d->settings.scanFingerPrints)
+    {
+        QList<ItemInfo> imageInfos;
+        QList<qlonglong> imageIds = CoreDbAccess().db()->getImageIds(DatabaseItem::Status::Visible, DatabaseItem::Category::Image);
+
+        foreach (const qlonglong& id, imageIds)
+        {
+            imageInfos << ItemInfo(id);
+        }
+
+        dirtyFingerPrints = SimilarityDbAccess().db()->getDirtyOrMissingFingerprintURLs(imageInfos).toSet();
+    }
+
+    if (quality && d->settings.qualityScanMode == ImageQualitySorter::NonAssignedItems)
+    {
+        noPickLabel = CoreDbAccess().db()->getItemsURLsWithTag(TagsCache::instance()->tagForPickLabel(NoPickLabel)).toSet();
+    }
+
+    for (AlbumList::ConstIterator it = albumList.constBegin() ;
+         !canceled() && (it != albumList.constEnd()) ; ++it)
+    {
+        if (!(*it))
+        {
+            continue;
+        }
+
+        QStringList aPaths;
+
+        if ((*it)->type() == Album::PHYSICAL)
+        {
+            aPaths = CoreDbAccess().db()->getItemURLsInAlbum((*it)->id());
+        }
+        else if ((*it)->type() == Album::TAG)
+        {
+            aPaths = CoreDbAccess().db()->getItemURLsInTag((*it)->id());
+        }
+
+        foreach (const QString& path, aPaths)
+        {
+            if (d->analyses.contains(path))
+            {
+                continue;
+            }
+
+            // Only the thumbnails of videos and audio files are generated
+
+            ItemInfo info = ItemInfo::fromLocalFile(path);
+            int analyses  = 0;
+
+            if (info.category() != DatabaseItem::Image &&
+                info.category() != DatabaseItem::Video &&
+                info.category() != DatabaseItem::Audio)
+            {
+                continue;
+            }
+
+            if (thumbnails && !withThumbnail.contains(path))
+            {
+                analyses |= ImageAnalysisTask::Thumbnail;
+            }
+
+            if (info.category() == DatabaseItem::Image)
+            {
+                if (fingerPrints && (!d->settings.scanFingerPrints || dirtyFingerPrints.contains(path)))
+                {
+                    analyses |= ImageAnalysisTask::Fingerprint;
+                }
+
+                if (quality && (d->settings.qualityScanMode != ImageQualitySorter::NonAssignedItems ||
+                                noPickLabel.contains(path)))
+                {
+                    analyses |= ImageAnalysisTask::Quality;
+                }
+            }
+
+            if (analyses)
+            {
+                d->analyses.insert(path, analyses);
+                d->allPicturesPath << path;
+            }
+        }
+    }
+
+    if (d->allPicturesPath.isEmpty())
+    {
+        slotDone();
+        return;
+    }
+
+    setTotalItems(d->allPicturesPath.count());
+
+    d->stats.reset();
+    d->thread->analyzeImages(d->allPicturesPath, d->analyses, d->settings.quality, &d->stats);
+    d->thread->start();
+}
+
+void ImageAnalyzer::slotAdvance(const QImage& img)
+{
+    setThumbnail(QIcon(QPixmap::fromImage(img)));
+    advance(1);
+}
+
+void ImageAnalyzer::slotDone()
+{
+    d->stats.report();
+
+    if (d->settings.fingerPrints)
+    {
+        // Switch on scanned for finger-prints flag on digiKam config file.
+        KSharedConfig::openConfig()->group(QLatin1String("General Settings")).writeEntry(QLatin1String("Finger Prints Generator First Run"), true);
+    }
+
+    MaintenanceTool::slotDone();
+}
+
+} // namespace Digikam
@@ -0,0 +1,79 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * http://www.digikam.org
+ *
+ * Date        : 2018-11-10
+ * Description : batch thumbnails, finger-prints and quality analyzer
+ *
+ * Copyright (C) 2018 by Gilles Caulier <caulier dot gilles at gmail dot com>
+ *
+ * This program is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation;
+ * either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_IMAGE_ANALYZER_H
+#define DIGIKAM_IMAGE_ANALYZER_H
+
+// Qt includes
+
+#include <QObject>
+#include <QImage>
+
+// Local includes
+
+#include "maintenancetool.h"
+
+namespace Digikam
+{
+
+class MaintenanceSettings;
+
+/** Runs the thumbnails generator, the finger-prints generator and the image quality
+ *  sorter of the maintenance settings in one pass. Each item is decoded once, at the
+ *  largest size needed, and the image is shared by the analyses, instead of being
+ *  decoded again by each tool.
+ */
+class ImageAnalyzer : public MaintenanceTool
+{
+    Q_OBJECT
+
+public:
+
+    /** The albums, the tags and the options of the three tools are taken from settings.
+     *  If no album or tag is selected, whole Albums collection is processed.
+     */
+    explicit ImageAnalyzer(const MaintenanceSettings& settings, ProgressItem* const parent = 0);
+    ~ImageAnalyzer();
+
+    void setUseMultiCoreCPU(bool b);
+
+    /** Returns true if settings enable one of the tools run by the analyzer.
+     */
+    static bool isNeeded(const MaintenanceSettings& settings);
+
+private Q_SLOTS:
+
+    void slotStart();
+    void slotDone();
+    void slotCancel();
+    void slotAdvance(const QImage&);
+
+private:
+
+    class Private;
+    Private* const d;
+};
+
+} // namespace Digikam
+
+#endif // DIGIKAM_IMAGE_ANALYZER_H
@@ -47,6 +47,7 @@ public:
     QList<QString>                imagePathList;
     QList<ItemInfo>              imageInfoList;
     QList<Identity>               identitiesList;
+    QStringList                   faceEmbeddingKeyList;
     QList<qlonglong>              similarityImageIdList;
 
     QMutex                        mutex;
@@ -92,6 +93,11 @@ void MaintenanceData::setIdentities(const QList<Identity>& identities)
     d->identitiesList = identities;
 }
 
+void MaintenanceData::setFaceEmbeddingKeys(const QStringList& keys)
+{
+    d->faceEmbeddingKeyList = keys;
+}
+
 qlonglong MaintenanceData::getImageId() const
 {
     d->mutex.lock();
@@ -162,6 +168,20 @@ Identity MaintenanceData::getIdentity() const
     return identity;
 }
 
+QString MaintenanceData::getFaceEmbeddingKey() const
+{
+    d->mutex.lock();
+    QString key;
+
+    if (!d->faceEmbeddingKeyList.isEmpty())
+    {
+        key = d->faceEmbeddingKeyList.takeFirst();
+    }
+
+    d->mutex.unlock();
+    return key;
+}
+
 qlonglong MaintenanceData::getSimilarityImageId() const
 {
     d->mutex.lock();
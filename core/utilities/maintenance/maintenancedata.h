@@ -24,6 +24,10 @@
 #ifndef DIGIKAM_MAINTENANCE_DATA_H
 #define DIGIKAM_MAINTENANCE_DATA_H
 
+// Qt includes
+
+#include <QStringList>
+
 // Local includes
 
 #include "iteminfo.h"
@@ -46,6 +50,7 @@ public:
     void      setImagePaths(const QList<QString>& paths);
     void      setItemInfos(const QList<ItemInfo>& infos);
     void      setIdentities(const QList<Identity>& identities);
+    void      setFaceEmbeddingKeys(const QStringList& keys);
     void      setSimilarityImageIds(const QList<qlonglong>& ids);
 
     qlonglong getImageId()           const;
@@ -53,6 +58,7 @@ public:
     QString   getImagePath()         const;
     ItemInfo getItemInfo()         const;
     Identity  getIdentity()          const;
+    QString   getFaceEmbeddingKey()  const;
     qlonglong getSimilarityImageId() const;
 
 private:
@@ -85,6 +85,7 @@ public:
         scanThumbs(0),
         scanFingerPrints(0),
         useMutiCoreCPU(0),
+        combinedAnalysis(0),
         cleanThumbsDb(0),
         cleanFacesDb(0),
         shrinkDatabases(0),
@@ -109,6 +110,7 @@ public:
 
     static const QString configGroupName;
     static const QString configUseMutiCoreCPU;
+    static const QString configCombinedAnalysis;
     static const QString configNewItems;
     static const QString configThumbnails;
     static const QString configScanThumbs;
@@ -135,6 +137,7 @@ public:
     QCheckBox*           scanThumbs;
     QCheckBox*           scanFingerPrints;
     QCheckBox*           useMutiCoreCPU;
+    QCheckBox*           combinedAnalysis;
     QCheckBox*           cleanThumbsDb;
     QCheckBox*           cleanFacesDb;
     QCheckBox*           shrinkDatabases;
@@ -158,6 +161,7 @@ public:
 
 const QString MaintenanceDlg::Private::configGroupName(QLatin1String("MaintenanceDlg Settings"));
 const QString MaintenanceDlg::Private::configUseMutiCoreCPU(QLatin1String("UseMutiCoreCPU"));
+const QString MaintenanceDlg::Private::configCombinedAnalysis(QLatin1String("CombinedAnalysis"));
 const QString MaintenanceDlg::Private::configNewItems(QLatin1String("NewItems"));
 const QString MaintenanceDlg::Private::configThumbnails(QLatin1String("Thumbnails"));
 const QString MaintenanceDlg::Private::configScanThumbs(QLatin1String("ScanThumbs"));
@@ -210,6 +214,10 @@ MaintenanceDlg::MaintenanceDlg(QWidget* const parent)
     DVBox* const options       = new DVBox;
     d->albumSelectors          = new AlbumSelectors(i18nc("@label", "Process items from:"), d->configGroupName, options);
     d->useMutiCoreCPU          = new QCheckBox(i18nc("@option:check", "Work on all processor cores (when it possible)"), options);
+    d->combinedAnalysis        = new QCheckBox(i18nc("@option:check", "Load each item once for thumbnails, finger-prints and quality"), options);
+    d->combinedAnalysis->setWhatsThis(i18n("If this option is enabled, the thumbnails, the finger-prints and the "
+                                           "image quality are computed in one pass over the items, which "
+                                           "are only loaded once."));
     d->expanderBox->insertItem(Private::Options, options, QIcon::fromTheme(QLatin1String("configure")), i18n("Common Options"), QLatin1String("Options"), true);
 
     // --------------------------------------------------------------------------------------
@@ -413,6 +421,7 @@ MaintenanceSettings MaintenanceDlg::settings() const
     prm.albums                              = d->albumSelectors->selectedAlbums();
     prm.tags                                = d->albumSelectors->selectedTags();
     prm.useMutiCoreCPU                      = d->useMutiCoreCPU->isChecked();
+    prm.combinedAnalysis                    = d->combinedAnalysis->isChecked();
     prm.newItems                            = d->expanderBox->isChecked(Private::NewItems);
     prm.databaseCleanup                     = d->expanderBox->isChecked(Private::DbCleanup);
     prm.cleanThumbDb                        = d->cleanThumbsDb->isChecked();
@@ -449,6 +458,7 @@ void MaintenanceDlg::readSettings()
     MaintenanceSettings prm;
 
     d->useMutiCoreCPU->setChecked(group.readEntry(d->configUseMutiCoreCPU,                               prm.useMutiCoreCPU));
+    d->combinedAnalysis->setChecked(group.readEntry(d->configCombinedAnalysis,                           prm.combinedAnalysis));
     d->expanderBox->setChecked(Private::NewItems,           group.readEntry(d->configNewItems,           prm.newItems));
 
     d->expanderBox->setChecked(Private::DbCleanup,          group.readEntry(d->configCleanupDatabase,       prm.databaseCleanup));
@@ -498,6 +508,7 @@ void MaintenanceDlg::writeSettings()
     MaintenanceSettings prm   = settings();
 
     group.writeEntry(d->configUseMutiCoreCPU,        prm.useMutiCoreCPU);
+    group.writeEntry(d->configCombinedAnalysis,      prm.combinedAnalysis);
     group.writeEntry(d->configNewItems,              prm.newItems);
     group.writeEntry(d->configCleanupDatabase,       prm.databaseCleanup);
     group.writeEntry(d->configCleanupThumbDatabase,  prm.cleanThumbDb);
@@ -41,6 +41,7 @@
 #include "maintenancesettings.h"
 #include "newitemsfinder.h"
 #include "thumbsgenerator.h"
+#include "imageanalyzer.h"
 #include "fingerprintsgenerator.h"
 #include "duplicatesfinder.h"
 #include "imagequalitysorter.h"
@@ -62,6 +63,7 @@ public:
         running               = false;
         newItemsFinder        = 0;
         thumbsGenerator       = 0;
+        imageAnalyzer         = 0;
         fingerPrintsGenerator = 0;
         duplicatesFinder      = 0;
         metadataSynchronizer  = 0;
@@ -78,6 +80,7 @@ public:
 
     NewItemsFinder*        newItemsFinder;
     ThumbsGenerator*       thumbsGenerator;
+    ImageAnalyzer*         imageAnalyzer;
     FingerPrintsGenerator* fingerPrintsGenerator;
     DuplicatesFinder*      duplicatesFinder;
     MetadataSynchronizer*  metadataSynchronizer;
@@ -137,6 +140,12 @@ void MaintenanceMngr::slotToolCompleted(ProgressItem* tool)
         d->thumbsGenerator = 0;
         stage4();
     }
+    else if (tool == dynamic_cast<ProgressItem*>(d->imageAnalyzer))
+    {
+        // Finger-prints were generated with the thumbnails
+        d->imageAnalyzer = 0;
+        stage5();
+    }
     else if (tool == dynamic_cast<ProgressItem*>(d->fingerPrintsGenerator))
     {
         d->fingerPrintsGenerator = 0;
@@ -168,6 +177,7 @@ void MaintenanceMngr::slotToolCanceled(ProgressItem* tool)
 {
     if (tool == dynamic_cast<ProgressItem*>(d->newItemsFinder)        ||
         tool == dynamic_cast<ProgressItem*>(d->thumbsGenerator)       ||
+        tool == dynamic_cast<ProgressItem*>(d->imageAnalyzer)         ||
         tool == dynamic_cast<ProgressItem*>(d->fingerPrintsGenerator) ||
         tool == dynamic_cast<ProgressItem*>(d->duplicatesFinder)      ||
         tool == dynamic_cast<ProgressItem*>(d->databaseCleaner)       ||
@@ -235,7 +245,17 @@ void MaintenanceMngr::stage3()
 {
     qCDebug(DIGIKAM_GENERAL_LOG) << "stage3";
 
-    if (d->settings.thumbnails)
+    if (d->settings.combinedAnalysis && ImageAnalyzer::isNeeded(d->settings))
+    {
+        // Thumbnails, finger-prints and quality sorting in one pass, with one decoding per item.
+        // The stage 4 and the quality sorting in stage 7 are skipped.
+
+        d->imageAnalyzer = new ImageAnalyzer(d->settings);
+        d->imageAnalyzer->setNotificationEnabled(false);
+        d->imageAnalyzer->setUseMultiCoreCPU(d->settings.useMutiCoreCPU);
+        d->imageAnalyzer->start();
+    }
+    else if (d->settings.thumbnails)
     {
         bool rebuildAll = (d->settings.scanThumbs == false);
         AlbumList list;
@@ -314,7 +334,7 @@ void MaintenanceMngr::stage7()
 {
     qCDebug(DIGIKAM_GENERAL_LOG) << "stage7";
 
-    if (d->settings.qualitySort && d->settings.quality.enableSorter)
+    if (d->settings.qualitySort && d->settings.quality.enableSorter && !d->settings.combinedAnalysis)
     {
         AlbumList list;
         list << d->settings.albums;
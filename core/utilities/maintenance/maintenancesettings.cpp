@@ -31,6 +31,7 @@ MaintenanceSettings::MaintenanceSettings()
     wholeAlbums           = true;
     wholeTags             = true;
     useMutiCoreCPU        = false;
+    combinedAnalysis      = false;
 
     newItems              = false;
 
@@ -72,6 +73,7 @@ QDebug operator<<(QDebug dbg, const MaintenanceSettings& s)
     dbg.nospace() << "Albums                : " << s.albums.count() << endl;
     dbg.nospace() << "Tags                  : " << s.tags.count() << endl;
     dbg.nospace() << "useMutiCoreCPU        : " << s.useMutiCoreCPU << endl;
+    dbg.nospace() << "combinedAnalysis      : " << s.combinedAnalysis << endl;
     dbg.nospace() << "newItems              : " << s.newItems << endl;
     dbg.nospace() << "thumbnails            : " << s.thumbnails << endl;
     dbg.nospace() << "scanThumbs            : " << s.scanThumbs << endl;
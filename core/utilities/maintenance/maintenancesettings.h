@@ -59,6 +59,9 @@ public:
     /// Use Multi-core CPU to process items.
     bool                                    useMutiCoreCPU;
 
+    /// Load each item once to generate thumbnails, finger-prints and quality Pick Labels together.
+    bool                                    combinedAnalysis;
+
     /// Find new items on whole collection.
     bool                                    newItems;
 
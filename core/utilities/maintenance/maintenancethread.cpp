@@ -35,7 +35,9 @@
 #include "metadatatask.h"
 #include "thumbstask.h"
 #include "fingerprintstask.h"
+#include "fingerprintswriter.h"
 #include "imagequalitytask.h"
+#include "imageanalysistask.h"
 #include "imagequalitycontainer.h"
 #include "databasetask.h"
 #include "maintenancedata.h"
@@ -45,7 +47,8 @@ namespace Digikam
 
 MaintenanceThread::MaintenanceThread(QObject* const parent)
     : ActionThreadBase(parent),
-      data(new MaintenanceData)
+      data(new MaintenanceData),
+      writer(0)
 {
     setObjectName(QLatin1String("MaintenanceThread"));
 
@@ -57,6 +60,7 @@ MaintenanceThread::~MaintenanceThread()
 {
     cancel();
     wait();
+    delete writer;
     delete data;
 }
 
@@ -126,11 +130,26 @@ void MaintenanceThread::generateFingerprints(const QStringList& paths)
 
     data->setImagePaths(paths);
 
+    // The signatures of all tasks are written by one thread, in batches
+
+    if (!writer)
+    {
+        writer = new FingerprintsWriter;
+
+        connect(writer, SIGNAL(signalWritten(QImage)),
+                this, SIGNAL(signalAdvance(QImage)));
+
+        writer->start();
+    }
+
+    writer->setImageCount(paths.size());
+
     for (int i = 1 ; i <= (maximumNumberOfThreads()) ; ++i)
     {
         FingerprintsTask* const t = new FingerprintsTask();
 
         t->setMaintenanceData(data);
+        t->setFingerprintsWriter(writer);
 
         connect(t, SIGNAL(signalFinished(QImage)),
                 this, SIGNAL(signalAdvance(QImage)));
@@ -169,6 +188,63 @@ void MaintenanceThread::sortByImageQuality(const QStringList& paths, const Image
     appendJobs(collection);
 }
 
+void MaintenanceThread::analyzeImages(const QStringList& paths, const QHash<QString, int>& analyses,
+                                      const ImageQualityContainer& quality, ImageAnalysisStats* const stats)
+{
+    ActionJobCollection collection;
+
+    data->setImagePaths(paths);
+
+    int fingerprints = 0;
+
+    foreach (int flags, analyses)
+    {
+        if (flags & ImageAnalysisTask::Fingerprint)
+        {
+            ++fingerprints;
+        }
+    }
+
+    // The signatures of all tasks are written by one thread, in batches
+
+    if (fingerprints && !writer)
+    {
+        writer = new FingerprintsWriter;
+
+        connect(writer, SIGNAL(signalWritten(QImage)),
+                this, SIGNAL(signalAdvance(QImage)));
+
+        writer->start();
+    }
+
+    if (writer)
+    {
+        writer->setImageCount(fingerprints);
+    }
+
+    for (int i = 1 ; i <= maximumNumberOfThreads() ; ++i)
+    {
+        ImageAnalysisTask* const t = new ImageAnalysisTask();
+        t->setMaintenanceData(data);
+        t->setAnalyses(analyses);
+        t->setQuality(quality);
+        t->setFingerprintsWriter(writer);
+        t->setStats(stats);
+
+        connect(t, SIGNAL(signalFinished(QImage)),
+                this, SIGNAL(signalAdvance(QImage)));
+
+        connect(this, SIGNAL(signalCanceled()),
+                t, SLOT(slotCancel()), Qt::QueuedConnection);
+
+        collection.insert(t, 0);
+
+        qCDebug(DIGIKAM_GENERAL_LOG) << "Creating an image analysis task for thumbnails, fingerprints and quality.";
+    }
+
+    appendJobs(collection);
+}
+
 void MaintenanceThread::computeDatabaseJunk(bool thumbsDb, bool facesDb, bool similarityDb)
 {
     ActionJobCollection collection;
@@ -183,8 +259,8 @@ void MaintenanceThread::computeDatabaseJunk(bool thumbsDb, bool facesDb, bool si
     connect(t,SIGNAL(signalAddItemsToProcess(int)),
             this, SIGNAL(signalAddItemsToProcess(int)));
 
-    connect(t,SIGNAL(signalData(QList<qlonglong>,QList<int>,QList<Identity>,QList<qlonglong>)),
-            this, SIGNAL(signalData(QList<qlonglong>,QList<int>,QList<Identity>,QList<qlonglong>)));
+    connect(t,SIGNAL(signalData(QList<qlonglong>,QList<int>,QList<Identity>,QStringList,QList<qlonglong>)),
+            this, SIGNAL(signalData(QList<qlonglong>,QList<int>,QList<Identity>,QStringList,QList<qlonglong>)));
 
     collection.insert(t, 0);
 
@@ -239,11 +315,12 @@ void MaintenanceThread::cleanThumbsDb(const QList<int>& thumbnailIds)
     appendJobs(collection);
 }
 
-void MaintenanceThread::cleanFacesDb(const QList<Identity>& staleIdentities)
+void MaintenanceThread::cleanFacesDb(const QList<Identity>& staleIdentities, const QStringList& staleFaceEmbeddings)
 {
     ActionJobCollection collection;
 
     data->setIdentities(staleIdentities);
+    data->setFaceEmbeddingKeys(staleFaceEmbeddings);
 
     for (int i = 1 ; i <= maximumNumberOfThreads() ; ++i)
     {
@@ -257,7 +334,7 @@ void MaintenanceThread::cleanFacesDb(const QList<Identity>& staleIdentities)
 
         collection.insert(t, 0);
 
-        qCDebug(DIGIKAM_GENERAL_LOG) << "Creating a database task for removing stale identities.";
+        qCDebug(DIGIKAM_GENERAL_LOG) << "Creating a database task for removing stale identities and face vectors.";
     }
 
     appendJobs(collection);
@@ -25,6 +25,11 @@
 #ifndef DIGIKAM_MAINTENANCE_THREAD_H
 #define DIGIKAM_MAINTENANCE_THREAD_H
 
+// Qt includes
+
+#include <QHash>
+#include <QStringList>
+
 // Local includes
 
 #include "actionthreadbase.h"
@@ -37,8 +42,10 @@ class QImage;
 namespace Digikam
 {
 
+class ImageAnalysisStats;
 class ImageQualityContainer;
 class MaintenanceData;
+class FingerprintsWriter;
 
 class MaintenanceThread : public ActionThreadBase
 {
@@ -56,10 +63,15 @@ public:
     void generateFingerprints(const QStringList& paths);
     void sortByImageQuality(const QStringList& paths, const ImageQualityContainer& quality);
 
+    /** Decodes each item once and runs the analyses of ImageAnalysisTask set for its path.
+     */
+    void analyzeImages(const QStringList& paths, const QHash<QString, int>& analyses,
+                       const ImageQualityContainer& quality, ImageAnalysisStats* const stats);
+
     void computeDatabaseJunk(bool thumbsDb=false, bool facesDb=false, bool similarityDb=false);
     void cleanCoreDb(const QList<qlonglong>& imageIds);
     void cleanThumbsDb(const QList<int>& thumbnailIds);
-    void cleanFacesDb(const QList<Identity>& staleIdentities);
+    void cleanFacesDb(const QList<Identity>& staleIdentities, const QStringList& staleFaceEmbeddings);
     void cleanSimilarityDb(const QList<qlonglong>& imageIds);
     void shrinkDatabases();
 
@@ -94,6 +106,7 @@ Q_SIGNALS:
     void signalData(const QList<qlonglong>& staleImageIds,
                     const QList<int>& staleThumbIds,
                     const QList<Identity>& staleIdentities,
+                    const QStringList& staleFaceEmbeddings,
                     const QList<qlonglong>& staleSimilarityImageIds);
 
     /**
@@ -155,6 +168,7 @@ private:
     */
 
     MaintenanceData* const data;
+    FingerprintsWriter*    writer;
 };
 
 } // namespace Digikam
@@ -37,6 +37,7 @@
 // Local includes
 
 #include "digikam_debug.h"
+#include "applicationsettings.h"
 #include "scancontroller.h"
 
 namespace Digikam
@@ -115,7 +116,10 @@ void NewItemsFinder::slotStart()
             connect(ScanController::instance(), SIGNAL(completeScanDone()),
                     this, SLOT(slotDone()));
 
-            ScanController::instance()->completeCollectionScanInBackground(false);
+            // Check for changes since the last session. Albums without added, removed or renamed
+            // items are only skipped on demand, as files modified in place are not detected then.
+            ScanController::instance()->completeCollectionScanInBackground(false,
+                ApplicationSettings::instance()->getFastScanAtStart());
             ScanController::instance()->allowToScanDeferredFiles();
             break;
         }
@@ -29,6 +29,7 @@
 #include <QDateTime>
 #include <QFileInfo>
 #include <QPolygon>
+#include <QScopedPointer>
 #include <QTemporaryFile>
 #include <QWidget>
 #include <QLabel>
@@ -499,6 +500,55 @@ bool BatchTool::apply()
     return toolOperations();
 }
 
+bool BatchTool::isPointOperation() const
+{
+    return false;
+}
+
+bool BatchTool::needsWholeInput() const
+{
+    return false;
+}
+
+void BatchTool::prepareTileOperations(const DImg&)
+{
+}
+
+DImgThreadedFilter* BatchTool::createFilter(DImg* const) const
+{
+    return 0;
+}
+
+bool BatchTool::applyToTile(DImg& tile) const
+{
+    QScopedPointer<DImgThreadedFilter> filter(createFilter(&tile));
+
+    if (!filter)
+    {
+        return false;
+    }
+
+    filter->startFilterDirectly();
+    tile = filter->getTargetImage();
+
+    return true;
+}
+
+FilterAction BatchTool::tileFilterAction() const
+{
+    // The filter action only depends on the settings
+
+    DImg null;
+    QScopedPointer<DImgThreadedFilter> filter(createFilter(&null));
+
+    if (!filter)
+    {
+        return FilterAction();
+    }
+
+    return filter->filterAction();
+}
+
 void BatchTool::applyFilter(DImgThreadedFilter* const filter)
 {
     filter->startFilterDirectly();
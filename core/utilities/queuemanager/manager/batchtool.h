@@ -30,8 +30,10 @@
 
 // Local includes
 
+#include "digikam_export.h"
 #include "drawdecodersettings.h"
 #include "dimg.h"
+#include "filteraction.h"
 #include "iteminfo.h"
 #include "queuesettings.h"
 #include "iofilesettings.h"
@@ -48,7 +50,7 @@ class DImgThreadedFilter;
  */
 typedef QMap<QString, QVariant> BatchToolSettings;
 
-class BatchTool : public QObject
+class DIGIKAM_EXPORT BatchTool : public QObject
 {
     Q_OBJECT
 
@@ -199,6 +201,33 @@ public:
      */
     bool apply();
 
+    /** Re-implement this method to return true if the tool computes each pixel only from the same pixel
+        of its input, without changing the size or the color depth of the image, and with createFilter().
+        Following tools of this kind are applied together by Task, tile by tile, with applyToTile()
+        in place of apply(). This method return false by default.
+     */
+    virtual bool isPointOperation() const;
+
+    /** Re-implement this method to return true if the point operation also depends on statistics of
+        the whole input image. Such a tool always starts a new chain of tiled tools, and its
+        prepareTileOperations() method is called with the input image. This method return false by default.
+     */
+    virtual bool needsWholeInput() const;
+
+    /** Re-implement this method to compute what the point operation needs from the whole input image,
+        before the tiles are processed. See needsWholeInput() for details.
+     */
+    virtual void prepareTileOperations(const DImg& image);
+
+    /** Apply the point operation to tile, a part of the image. This method is called from several
+        threads at once. Return false if the tool is not a point operation.
+     */
+    bool applyToTile(DImg& tile) const;
+
+    /** Return the filter action of the point operation, to add to the image history once for all tiles.
+     */
+    FilterAction tileFilterAction() const;
+
     /** Return version of tool. By default, ID is 1. Re-implement this method and increase this ID when tool settings change.
      */
     virtual int toolVersion() const { return 1; };
@@ -259,6 +288,12 @@ protected:
     void applyFilterChangedProperties(DImgThreadedFilter* const filter);
     void applyFilter(DImgBuiltinFilter* const filter);
 
+    /** Re-implement this method with isPointOperation() to create the filter of the tool for image,
+        using the current settings. The caller takes ownership of the filter. This method is called
+        from several threads at once and must not change the tool. It returns 0 by default.
+     */
+    virtual DImgThreadedFilter* createFilter(DImg* const image) const;
+
     /** Re-implement this method to customize all batch operations done by this tool.
         This method is called by apply().
      */
@@ -26,7 +26,11 @@
 
 // Qt includes
 
+#include <QAtomicInt>
 #include <QFileInfo>
+#include <QFuture>
+#include <QThreadPool>
+#include <QtConcurrent>    // krazy:exclude=includes
 
 // KDE includes
 
@@ -56,6 +60,11 @@ public:
         tool   = 0;
     }
 
+    bool applyPointOperations(const QList<BatchTool*>& chain, DImg& image);
+    void applyTiles(const QList<BatchTool*>& chain, DImg* const image, QAtomicInt* const nextRow, int tileRows);
+
+public:
+
     bool               cancel;
 
     BatchTool*         tool;
@@ -64,6 +73,106 @@ public:
     AssignedBatchTools tools;
 };
 
+/// Size in bytes of the tiles processed by point operations
+static const int s_tileSize = 8 * 1024 * 1024;
+
+bool Task::Private::applyPointOperations(const QList<BatchTool*>& chain, DImg& image)
+{
+    BatchTool* const first = chain.first();
+    BatchTool* const last  = chain.last();
+
+    foreach (BatchTool* const t, chain)
+    {
+        qCDebug(DIGIKAM_GENERAL_LOG) << "Tool applied by tiles: " << t->toolTitle();
+    }
+
+    // The tiles are written back in place: the image must not be shared with another instance
+
+    tool  = first;
+    first->setImageData(image);
+    image = DImg();
+
+    if (!first->loadToDImg())
+    {
+        return false;
+    }
+
+    image = first->imageData();
+    first->setImageData(DImg());
+
+    if (image.isNull())
+    {
+        return false;
+    }
+
+    image.detach();
+
+    first->prepareTileOperations(image);
+
+    // Each thread processes the next unprocessed tile with all tools of the chain
+
+    const int bytesPerLine = image.width() * image.bytesDepth();
+    const int tileRows     = qMax(1, s_tileSize / bytesPerLine);
+    const int threads      = qMin(QThreadPool::globalInstance()->maxThreadCount(),
+                                  ((int)image.height() + tileRows - 1) / tileRows);
+    QAtomicInt nextRow(0);
+    QList<QFuture<void> > tasks;
+
+    for (int i = 0 ; i < threads ; ++i)
+    {
+        tasks.append(QtConcurrent::run(this,
+                                       &Task::Private::applyTiles,
+                                       chain,
+                                       &image,
+                                       &nextRow,
+                                       tileRows
+                                      ));
+    }
+
+    foreach (QFuture<void> t, tasks)
+    {
+        t.waitForFinished();
+    }
+
+    if (cancel)
+    {
+        return false;
+    }
+
+    foreach (BatchTool* const t, chain)
+    {
+        image.addFilterAction(t->tileFilterAction());
+    }
+
+    tool = last;
+    last->setImageData(image);
+    image = DImg();
+
+    return last->savefromDImg();
+}
+
+void Task::Private::applyTiles(const QList<BatchTool*>& chain, DImg* const image,
+                               QAtomicInt* const nextRow, int tileRows)
+{
+    const int    width        = image->width();
+    const int    height       = image->height();
+    const size_t bytesPerLine = (size_t)width * image->bytesDepth();
+    int          row          = 0;
+
+    while (!cancel && (row = nextRow->fetchAndAddOrdered(tileRows)) < height)
+    {
+        const int rows = qMin(tileRows, height - row);
+        DImg tile      = image->copy(0, row, width, rows);
+
+        foreach (BatchTool* const t, chain)
+        {
+            t->applyToTile(tile);
+        }
+
+        memcpy(image->bits() + row * bytesPerLine, tile.bits(), rows * bytesPerLine);
+    }
+}
+
 // -------------------------------------------------------
 
 Task::Task()
@@ -129,8 +238,6 @@ void Task::run()
 
     emitActionData(ActionData::BatchStarted);
 
-    // Loop with all batch tools operations to apply on item.
-
     bool        success = false;
     int         index   = 0;
     QUrl        outUrl  = d->tools.m_itemUrl;
@@ -145,57 +252,96 @@ void Task::run()
     ItemInfo source = ItemInfo::fromUrl(d->tools.m_itemUrl);
     bool timeAdjust  = false;
 
+    // Set up all batch tools operations to apply on item.
+
+    QList<BatchTool*> tools;
+
     foreach (const BatchToolSet& set, d->tools.m_toolsList)
     {
-        d->tool     = BatchToolsFactory::instance()->findTool(set.name, set.group)->clone();
-        timeAdjust |= (set.name == QLatin1String("TimeAdjust"));
-        inUrl       = outUrl;
-        index       = set.index + 1;
+        BatchTool* const tool = BatchToolsFactory::instance()->findTool(set.name, set.group)->clone();
+        timeAdjust           |= (set.name == QLatin1String("TimeAdjust"));
+        inUrl                 = outUrl;
+        index                 = set.index + 1;
 
         qCDebug(DIGIKAM_GENERAL_LOG) << "Tool : index= " << index
                  << " :: name= "     << set.name
                  << " :: group= "    << set.group
                  << " :: wurl= "     << workUrl;
 
-        d->tool->setImageData(tmpImage);
-        d->tool->setItemInfo(source);
-        d->tool->setInputUrl(inUrl);
-        d->tool->setWorkingUrl(workUrl);
-        d->tool->setSettings(set.settings);
-        d->tool->setIOFileSettings(d->settings.ioFileSettings);
-        d->tool->setRawLoadingRules(d->settings.rawLoadingRule);
-        d->tool->setDRawDecoderSettings(d->settings.rawDecodingSettings);
-        d->tool->setResetExifOrientationAllowed(d->settings.exifSetOrientation);
+        tool->setItemInfo(source);
+        tool->setInputUrl(inUrl);
+        tool->setWorkingUrl(workUrl);
+        tool->setSettings(set.settings);
+        tool->setIOFileSettings(d->settings.ioFileSettings);
+        tool->setRawLoadingRules(d->settings.rawLoadingRule);
+        tool->setDRawDecoderSettings(d->settings.rawDecodingSettings);
+        tool->setResetExifOrientationAllowed(d->settings.exifSetOrientation);
 
         if (index == d->tools.m_toolsList.count())
         {
-            d->tool->setLastChainedTool(true);
+            tool->setLastChainedTool(true);
         }
         // If the next tool is under the custom group (user script)
         // treat as the last chained tool, i.e. save image to file
         else if (d->tools.m_toolsList[index].group == BatchTool::CustomTool)
         {
-            d->tool->setLastChainedTool(true);
+            tool->setLastChainedTool(true);
         }
         else
         {
-            d->tool->setLastChainedTool(false);
+            tool->setLastChainedTool(false);
         }
 
-        d->tool->setOutputUrlFromInputUrl();
-        d->tool->setBranchHistory(true);
+        tool->setOutputUrlFromInputUrl();
+        tool->setBranchHistory(true);
 
-        outUrl   = d->tool->outputUrl();
-        success  = d->tool->apply();
-        tmpImage = d->tool->imageData();
-        errMsg   = d->tool->errorDescription();
+        outUrl = tool->outputUrl();
         tmp2del.append(outUrl);
+        tools << tool;
+    }
 
-        delete d->tool;
-        d->tool = 0;
+    // Loop with all batch tools operations to apply on item.
+    // Following point operations are applied together, tile by tile, without
+    // a copy of the whole image for each tool.
+
+    for (int i = 0 ; i < tools.count() ; )
+    {
+        int last = i;
+
+        if (tools[i]->isPointOperation())
+        {
+            while ((last + 1 < tools.count())                &&
+                   !tools[last]->isLastChainedTool()         &&
+                   tools[last]->outputSuffix().isEmpty()     &&
+                   tools[last + 1]->isPointOperation()       &&
+                   !tools[last + 1]->needsWholeInput())
+            {
+                ++last;
+            }
+
+            success = d->applyPointOperations(tools.mid(i, last - i + 1), tmpImage);
+        }
+        else
+        {
+            d->tool = tools[i];
+            d->tool->setImageData(tmpImage);
+            success = d->tool->apply();
+        }
+
+        outUrl   = tools[last]->outputUrl();
+        tmpImage = tools[last]->imageData();
+        errMsg   = tools[last]->errorDescription();
+        d->tool  = 0;
+
+        for ( ; i <= last ; ++i)
+        {
+            delete tools[i];
+            tools[i] = 0;
+        }
 
         if (d->cancel)
         {
+            qDeleteAll(tools);
             emitActionData(ActionData::BatchCanceled);
             removeTempFiles(tmp2del);
             emit signalDone();
@@ -208,6 +354,8 @@ void Task::run()
         }
     }
 
+    qDeleteAll(tools);
+
     // Clean up all tmp url.
 
     // We don't remove last output tmp url.
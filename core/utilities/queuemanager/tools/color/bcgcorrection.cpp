@@ -25,6 +25,7 @@
 
 // Qt includes
 
+#include <QScopedPointer>
 #include <QWidget>
 
 // KDE includes
@@ -97,20 +98,30 @@ void BCGCorrection::slotSettingsChanged()
     BatchTool::slotSettingsChanged(prm);
 }
 
-bool BCGCorrection::toolOperations()
+bool BCGCorrection::isPointOperation() const
 {
-    if (!loadToDImg())
-    {
-        return false;
-    }
+    return true;
+}
 
+DImgThreadedFilter* BCGCorrection::createFilter(DImg* const image) const
+{
     BCGContainer prm;
     prm.brightness = settings()[QLatin1String("Brightness")].toDouble();
     prm.contrast   = settings()[QLatin1String("Contrast")].toDouble();
     prm.gamma      = settings()[QLatin1String("Gamma")].toDouble();
 
-    BCGFilter bcg(&image(), 0L, prm);
-    applyFilter(&bcg);
+    return (new BCGFilter(image, 0L, prm));
+}
+
+bool BCGCorrection::toolOperations()
+{
+    if (!loadToDImg())
+    {
+        return false;
+    }
+
+    QScopedPointer<DImgThreadedFilter> bcg(createFilter(&image()));
+    applyFilter(bcg.data());
 
     return (savefromDImg());
 }
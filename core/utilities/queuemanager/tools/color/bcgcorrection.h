@@ -48,9 +48,12 @@ public:
 
     void registerSettingsWidget();
 
+    bool isPointOperation() const;
+
 private:
 
     bool toolOperations();
+    DImgThreadedFilter* createFilter(DImg* const image) const;
 
 private Q_SLOTS:
 
@@ -150,13 +150,13 @@ void ChannelMixer::slotSettingsChanged()
     BatchTool::slotSettingsChanged(prm);
 }
 
-bool ChannelMixer::toolOperations()
+bool ChannelMixer::isPointOperation() const
 {
-    if (!loadToDImg())
-    {
-        return false;
-    }
+    return true;
+}
 
+DImgThreadedFilter* ChannelMixer::createFilter(DImg* const image) const
+{
     MixerContainer prm;
 
     prm.bPreserveLum   = settings()[QLatin1String("bPreserveLum")].toBool();
@@ -178,8 +178,18 @@ bool ChannelMixer::toolOperations()
     prm.blackGreenGain = settings()[QLatin1String("blackGreenGain")].toDouble();
     prm.blackBlueGain  = settings()[QLatin1String("blackBlueGain")].toDouble();
 
-    MixerFilter mixer(&image(), 0L, prm);
-    applyFilter(&mixer);
+    return (new MixerFilter(image, 0L, prm));
+}
+
+bool ChannelMixer::toolOperations()
+{
+    if (!loadToDImg())
+    {
+        return false;
+    }
+
+    QScopedPointer<DImgThreadedFilter> mixer(createFilter(&image()));
+    applyFilter(mixer.data());
 
     return (savefromDImg());
 }
@@ -25,6 +25,7 @@
 
 // Qt includes
 
+#include <QScopedPointer>
 #include <QWidget>
 
 // KDE includes
@@ -98,20 +99,30 @@ void ColorBalance::slotSettingsChanged()
     BatchTool::slotSettingsChanged(prm);
 }
 
-bool ColorBalance::toolOperations()
+bool ColorBalance::isPointOperation() const
 {
-    if (!loadToDImg())
-    {
-        return false;
-    }
+    return true;
+}
 
+DImgThreadedFilter* ColorBalance::createFilter(DImg* const image) const
+{
     CBContainer prm;
     prm.red   = settings()[QLatin1String("Red")].toDouble();
     prm.green = settings()[QLatin1String("Green")].toDouble();
     prm.blue  = settings()[QLatin1String("Blue")].toDouble();
 
-    CBFilter cb(&image(), 0L, prm);
-    applyFilter(&cb);
+    return (new CBFilter(image, 0L, prm));
+}
+
+bool ColorBalance::toolOperations()
+{
+    if (!loadToDImg())
+    {
+        return false;
+    }
+
+    QScopedPointer<DImgThreadedFilter> cb(createFilter(&image()));
+    applyFilter(cb.data());
 
     return (savefromDImg());
 }
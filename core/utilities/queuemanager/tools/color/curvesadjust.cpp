@@ -26,6 +26,7 @@
 // Qt includes
 
 #include <QLabel>
+#include <QScopedPointer>
 #include <QWidget>
 #include <QComboBox>
 #include <QPushButton>
@@ -167,13 +168,13 @@ void CurvesAdjust::slotSettingsLoad()
     slotSettingsChanged();
 }
 
-bool CurvesAdjust::toolOperations()
+bool CurvesAdjust::isPointOperation() const
 {
-    if (!loadToDImg())
-    {
-        return false;
-    }
+    return true;
+}
 
+DImgThreadedFilter* CurvesAdjust::createFilter(DImg* const image) const
+{
     CurvesContainer prm((ImageCurves::CurveType)settings()[QLatin1String("curvesType")].toInt(),
                         settings()[QLatin1String("curvesDepth")].toBool());
     prm.initialize();
@@ -183,8 +184,18 @@ bool CurvesAdjust::toolOperations()
     prm.values[BlueChannel]       = settings()[QLatin1String("values[BlueChannel]")].value<QPolygon>();
     prm.values[AlphaChannel]      = settings()[QLatin1String("values[AlphaChannel]")].value<QPolygon>();
 
-    CurvesFilter curves(&image(), 0L, prm);
-    applyFilter(&curves);
+    return (new CurvesFilter(image, 0L, prm));
+}
+
+bool CurvesAdjust::toolOperations()
+{
+    if (!loadToDImg())
+    {
+        return false;
+    }
+
+    QScopedPointer<DImgThreadedFilter> curves(createFilter(&image()));
+    applyFilter(curves.data());
 
     return (savefromDImg());
 }
@@ -50,6 +50,8 @@ public:
 
     void registerSettingsWidget();
 
+    bool isPointOperation() const;
+
 public Q_SLOTS:
 
     void slotResetSettingsToDefault();
@@ -57,6 +59,7 @@ public Q_SLOTS:
 private:
 
     bool toolOperations();
+    DImgThreadedFilter* createFilter(DImg* const image) const;
 
 private Q_SLOTS:
 
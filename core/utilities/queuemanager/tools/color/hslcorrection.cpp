@@ -25,6 +25,7 @@
 
 // Qt includes
 
+#include <QScopedPointer>
 #include <QWidget>
 
 // KDE includes
@@ -100,21 +101,31 @@ void HSLCorrection::slotSettingsChanged()
     BatchTool::slotSettingsChanged(prm);
 }
 
-bool HSLCorrection::toolOperations()
+bool HSLCorrection::isPointOperation() const
 {
-    if (!loadToDImg())
-    {
-        return false;
-    }
+    return true;
+}
 
+DImgThreadedFilter* HSLCorrection::createFilter(DImg* const image) const
+{
     HSLContainer prm;
     prm.hue        = settings()[QLatin1String("Hue")].toDouble();
     prm.saturation = settings()[QLatin1String("Saturation")].toDouble();
     prm.lightness  = settings()[QLatin1String("Lightness")].toDouble();
     prm.vibrance   = settings()[QLatin1String("Vibrance")].toDouble();
 
-    HSLFilter hsl(&image(), 0L, prm);
-    applyFilter(&hsl);
+    return (new HSLFilter(image, 0L, prm));
+}
+
+bool HSLCorrection::toolOperations()
+{
+    if (!loadToDImg())
+    {
+        return false;
+    }
+
+    QScopedPointer<DImgThreadedFilter> hsl(createFilter(&image()));
+    applyFilter(hsl.data());
 
     return (savefromDImg());
 }
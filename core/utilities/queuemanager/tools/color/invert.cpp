@@ -25,6 +25,7 @@
 
 // Qt includes
 
+#include <QScopedPointer>
 #include <QWidget>
 
 // KDE includes
@@ -51,6 +52,16 @@ Invert::~Invert()
 {
 }
 
+bool Invert::isPointOperation() const
+{
+    return true;
+}
+
+DImgThreadedFilter* Invert::createFilter(DImg* const image) const
+{
+    return (new InvertFilter(image, 0L));
+}
+
 bool Invert::toolOperations()
 {
     if (!loadToDImg())
@@ -58,8 +69,8 @@ bool Invert::toolOperations()
         return false;
     }
 
-    InvertFilter inv(&image(), 0L);
-    applyFilter(&inv);
+    QScopedPointer<DImgThreadedFilter> inv(createFilter(&image()));
+    applyFilter(inv.data());
 
     return (savefromDImg());
 }
@@ -47,9 +47,12 @@ public:
 
     BatchTool* clone(QObject* const parent=0) const { return new Invert(parent); };
 
+    bool isPointOperation() const;
+
 private:
 
     bool toolOperations();
+    DImgThreadedFilter* createFilter(DImg* const image) const;
 
 private Q_SLOTS:
 
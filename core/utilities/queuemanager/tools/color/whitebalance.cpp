@@ -25,6 +25,7 @@
 
 // Qt includes
 
+#include <QScopedPointer>
 #include <QWidget>
 
 // KDE includes
@@ -44,6 +45,9 @@ WhiteBalance::WhiteBalance(QObject* const parent)
     : BatchTool(QLatin1String("WhiteBalance"), ColorTool, parent)
 {
     m_settingsView = 0;
+    m_maxr         = -1;
+    m_maxg         = -1;
+    m_maxb         = -1;
 
     setToolTitle(i18n("White Balance"));
     setToolDescription(i18n("Adjust White Balance."));
@@ -116,13 +120,25 @@ void WhiteBalance::slotSettingsChanged()
     BatchTool::slotSettingsChanged(prm);
 }
 
-bool WhiteBalance::toolOperations()
+bool WhiteBalance::isPointOperation() const
 {
-    if (!loadToDImg())
-    {
-        return false;
-    }
+    return true;
+}
+
+bool WhiteBalance::needsWholeInput() const
+{
+    return true;
+}
+
+void WhiteBalance::prepareTileOperations(const DImg& image)
+{
+    // The multipliers are scaled down to prevent clipping of the whole image, see WBFilter
 
+    WBFilter::findChanelsMax(&image, m_maxr, m_maxg, m_maxb);
+}
+
+DImgThreadedFilter* WhiteBalance::createFilter(DImg* const image) const
+{
     WBContainer prm;
 
     prm.black          = settings()[QLatin1String("black")].toDouble();
@@ -134,8 +150,30 @@ bool WhiteBalance::toolOperations()
     prm.expositionMain = settings()[QLatin1String("expositionMain")].toDouble();
     prm.expositionFine = settings()[QLatin1String("expositionFine")].toDouble();
 
-    WBFilter wb(&image(), 0L, prm);
-    applyFilter(&wb);
+    // With tiles, the multipliers are scaled from the maximums of the whole image, not of the tile
+
+    prm.maxr           = m_maxr;
+    prm.maxg           = m_maxg;
+    prm.maxb           = m_maxb;
+
+    return (new WBFilter(image, 0L, prm));
+}
+
+bool WhiteBalance::toolOperations()
+{
+    if (!loadToDImg())
+    {
+        return false;
+    }
+
+    // The filter finds the maximums of the whole image itself
+
+    m_maxr = -1;
+    m_maxg = -1;
+    m_maxb = -1;
+
+    QScopedPointer<DImgThreadedFilter> wb(createFilter(&image()));
+    applyFilter(wb.data());
 
     return (savefromDImg());
 }
@@ -26,6 +26,7 @@
 
 // Local includes
 
+#include "digikam_export.h"
 #include "batchtool.h"
 
 namespace Digikam
@@ -33,7 +34,7 @@ namespace Digikam
 
 class WBSettings;
 
-class WhiteBalance : public BatchTool
+class DIGIKAM_EXPORT WhiteBalance : public BatchTool
 {
     Q_OBJECT
 
@@ -48,9 +49,14 @@ public:
 
     void registerSettingsWidget();
 
+    bool isPointOperation() const;
+    bool needsWholeInput() const;
+    void prepareTileOperations(const DImg& image);
+
 private:
 
     bool toolOperations();
+    DImgThreadedFilter* createFilter(DImg* const image) const;
 
 private Q_SLOTS:
 
@@ -60,6 +66,11 @@ private Q_SLOTS:
 private:
 
     WBSettings* m_settingsView;
+
+    /// Channel maximums of the whole input image, computed by the filter if -1
+    int         m_maxr;
+    int         m_maxg;
+    int         m_maxb;
 };
 
 } // namespace Digikam
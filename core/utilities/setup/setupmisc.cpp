@@ -76,6 +76,7 @@ public:
         scrollItemToCenterCheck(0),
         showOnlyPersonTagsInPeopleSidebarCheck(0),
         scanAtStart(0),
+        fastScanAtStart(0),
         cleanAtStart(0),
         sidebarType(0),
         stringComparisonType(0),
@@ -104,6 +105,7 @@ public:
     QCheckBox*                scrollItemToCenterCheck;
     QCheckBox*                showOnlyPersonTagsInPeopleSidebarCheck;
     QCheckBox*                scanAtStart;
+    QCheckBox*                fastScanAtStart;
     QCheckBox*                cleanAtStart;
 
     QComboBox*                sidebarType;
@@ -159,6 +161,11 @@ SetupMisc::SetupMisc(QWidget* const parent)
                                     "this can introduce low latency, and it is recommended to disable this option and to plan\n"
                                     "a manual scan through the maintenance tool at the right moment."));
 
+    d->fastScanAtStart                = new QCheckBox(i18n("Only scan albums with added, removed or renamed items at startup"), behaviourPanel);
+    d->fastScanAtStart->setToolTip(i18n("Set this option to skip the items of all albums whose folder was not modified since\n"
+                                        "the last scan. This makes the startup scan much faster with large collections, but\n"
+                                        "files modified in place, for example by an external editor, are not detected.\n"
+                                        "Use the maintenance tool to scan the whole collections in this case."));
 
     d->cleanAtStart                   = new QCheckBox(i18n("Remove obsolete core database objects (makes startup slower)"), behaviourPanel);
     d->cleanAtStart->setToolTip(i18n("Set this option to force digiKam to clean up the core database from obsolete item entries.\n"
@@ -192,6 +199,7 @@ SetupMisc::SetupMisc(QWidget* const parent)
     layout->setSpacing(spacing);
     layout->addWidget(stringComparisonHbox);
     layout->addWidget(d->scanAtStart);
+    layout->addWidget(d->fastScanAtStart);
     layout->addWidget(d->cleanAtStart);
     layout->addWidget(d->showTrashDeleteDialogCheck);
     layout->addWidget(d->showPermanentDeleteDialogCheck);
@@ -349,7 +357,11 @@ SetupMisc::SetupMisc(QWidget* const parent)
 
     // --------------------------------------------------------
 
+    connect(d->scanAtStart, SIGNAL(toggled(bool)),
+            d->fastScanAtStart, SLOT(setEnabled(bool)));
+
     readSettings();
+    d->fastScanAtStart->setEnabled(d->scanAtStart->isChecked());
     adjustSize();
 }
 
@@ -368,6 +380,7 @@ void SetupMisc::applySettings()
     settings->setMinimumSimilarityBound(d->minimumSimilarityBound->value());
     settings->setApplySidebarChangesDirectly(d->sidebarApplyDirectlyCheck->isChecked());
     settings->setScanAtStart(d->scanAtStart->isChecked());
+    settings->setFastScanAtStart(d->fastScanAtStart->isChecked());
     settings->setCleanAtStart(d->cleanAtStart->isChecked());
     settings->setUseNativeFileDialog(d->useNativeFileDialogCheck->isChecked());
     settings->setDrawFramesToGrouped(d->drawFramesToGroupedCheck->isChecked());
@@ -403,6 +416,7 @@ void SetupMisc::readSettings()
     d->sidebarApplyDirectlyCheck->setChecked(settings->getApplySidebarChangesDirectly());
     d->sidebarApplyDirectlyCheck->setChecked(settings->getApplySidebarChangesDirectly());
     d->scanAtStart->setChecked(settings->getScanAtStart());
+    d->fastScanAtStart->setChecked(settings->getFastScanAtStart());
     d->cleanAtStart->setChecked(settings->getCleanAtStart());
     d->useNativeFileDialogCheck->setChecked(settings->getUseNativeFileDialog());
     d->drawFramesToGroupedCheck->setChecked(settings->getDrawFramesToGrouped());